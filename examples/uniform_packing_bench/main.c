@@ -0,0 +1,88 @@
+#include "internal.h"
+
+#include "stdio.h"
+#include "time.h"
+
+// NOTE(blackedout): Measures the per call cost of `PackUniformElements` for the layouts the glUniform* functions hand it,
+// e.g. a skinning palette of a few hundred (transposed) matrices uploaded before every draw. Every case is also checked
+// against a plain per scalar packer, so a broken SIMD path shows up here as well.
+
+typedef struct bench_case {
+    const char *Name;
+    uniform_pack_info Info;
+    u32 Count;
+    int Transpose;
+} bench_case;
+
+#define MAX_ELEMENT_COUNT 256
+#define MAX_ELEMENT_BYTE_COUNT 64
+#define PACKED_ELEMENT_TARGET_COUNT 8000000
+
+static void PackReference(u8 *Dst, const float *Src, u32 Count, int Transpose, const uniform_pack_info *Info) {
+    u32 ElementScalarCount = Info->ColumnCount*Info->RowCount;
+    for(u32 I = 0; I < Count; ++I) {
+        for(u32 Column = 0; Column < Info->ColumnCount; ++Column) {
+            for(u32 Row = 0; Row < Info->RowCount; ++Row) {
+                u32 SrcIndex = I*ElementScalarCount + (Transpose ? Row*Info->ColumnCount + Column : Column*Info->RowCount + Row);
+                memcpy(Dst + I*Info->ArrayStride + Column*Info->MatrixStride + Row*sizeof(float), Src + SrcIndex, sizeof(float));
+            }
+        }
+    }
+}
+
+static double GetSeconds(void) {
+    struct timespec Time;
+    timespec_get(&Time, TIME_UTC);
+    return (double)Time.tv_sec + 1e-9*(double)Time.tv_nsec;
+}
+
+int main(void) {
+    // NOTE(blackedout): Strides as `GlslangProgramLink` lays them out in std140, `ArrayStride` is zero for non-arrays
+    bench_case Cases[] = {
+        { "mat4[256]", { 4, 4, 4, 16, 64 }, 256, 0 },
+        { "mat4[256] transposed", { 4, 4, 4, 16, 64 }, 256, 1 },
+        { "mat4x3[256] transposed", { 4, 3, 4, 16, 64 }, 256, 1 },
+        { "mat3[256]", { 3, 3, 4, 16, 48 }, 256, 0 },
+        { "mat3[256] transposed", { 3, 3, 4, 16, 48 }, 256, 1 },
+        { "mat2x3[256]", { 2, 3, 4, 16, 32 }, 256, 0 },
+        { "vec3[256]", { 1, 3, 4, 0, 16 }, 256, 0 },
+        { "float[256]", { 1, 1, 4, 0, 16 }, 256, 0 },
+        { "mat4", { 4, 4, 4, 16, 0 }, 1, 0 },
+        { "mat3", { 3, 3, 4, 16, 0 }, 1, 0 },
+        { "mat3 transposed", { 3, 3, 4, 16, 0 }, 1, 1 },
+    };
+
+    static float Src[MAX_ELEMENT_COUNT*16];
+    static u8 Dst[MAX_ELEMENT_COUNT*MAX_ELEMENT_BYTE_COUNT];
+    static u8 Expected[MAX_ELEMENT_COUNT*MAX_ELEMENT_BYTE_COUNT];
+    for(u32 I = 0; I < ArrayCount(Src); ++I) {
+        Src[I] = (float)I*0.25f - 100.0f;
+    }
+
+    int Result = 0;
+    u32 Checksum = 0;
+    printf("%-26s %12s %14s\n", "case", "ns/call", "ns/element");
+    for(u32 I = 0; I < ArrayCount(Cases); ++I) {
+        bench_case *Case = Cases + I;
+        memset(Dst, 0, sizeof(Dst));
+        memset(Expected, 0, sizeof(Expected));
+        PackUniformElements(Dst, Src, Case->Count, Case->Transpose, &Case->Info);
+        PackReference(Expected, Src, Case->Count, Case->Transpose, &Case->Info);
+        if(memcmp(Dst, Expected, sizeof(Dst)) != 0) {
+            printf("%-26s does not match the reference packing\n", Case->Name);
+            Result = 1;
+            continue;
+        }
+
+        u32 CallCount = Max(1, PACKED_ELEMENT_TARGET_COUNT/Case->Count);
+        double Start = GetSeconds();
+        for(u32 J = 0; J < CallCount; ++J) {
+            PackUniformElements(Dst, Src, Case->Count, Case->Transpose, &Case->Info);
+            Checksum += Dst[J % MAX_ELEMENT_BYTE_COUNT];
+        }
+        double Nanoseconds = 1e9*(GetSeconds() - Start);
+        printf("%-26s %12.1f %14.2f\n", Case->Name, Nanoseconds/CallCount, Nanoseconds/((double)CallCount*Case->Count));
+    }
+    printf("checksum %u\n", Checksum);
+    return Result;
+}
@@ -11,10 +11,46 @@ typedef struct context_create_params {
     SurfaceCreateCallback CreateSurface;
     void *User;
     int IsSingleBuffered;
+    // NOTE(blackedout): Upper bound of the persistently mapped staging ring used for uploads, zero selects the default
+    uint64_t MaxStagingByteCount;
+    // NOTE(blackedout): Runs dispatches that share no buffer ranges with the other work of their frame on a compute only queue,
+    // overlapping the graphics work. Ignored if the device has no such queue family or no timeline semaphores.
+    int IsAsyncComputeEnabled;
 } context_create_params;
 
+typedef struct frame_stats {
+    // NOTE(blackedout): Uniform snapshots finished by draws and how many of them needed their own slot after deduplication
+    uint32_t UniformSnapshotCount;
+    uint32_t UniqueUniformSnapshotCount;
+    // NOTE(blackedout): Vertex buffer binds that were dropped because the same buffer range was bound already
+    uint32_t SkippedVertexBufferBindCount;
+    // NOTE(blackedout): glMemoryBarrier calls and the pipeline barriers they resulted in after merging and dropping redundant ones
+    uint32_t RequestedMemoryBarrierCount;
+    uint32_t EmittedMemoryBarrierCount;
+    // NOTE(blackedout): Dispatches that ran on the async compute queue
+    uint32_t AsyncDispatchCount;
+    // NOTE(blackedout): Render passes that had to be created because no framebuffer with the same signature had one cached
+    uint32_t CreatedRenderPassCount;
+    // NOTE(blackedout): Render passes begun by the recorded commands and how many were left after merging those of the same framebuffer
+    uint32_t RecordedRenderPassCount;
+    uint32_t MergedRenderPassCount;
+} frame_stats;
+
+typedef struct buffer_memory_info {
+    // NOTE(blackedout): Of the memory currently backing the buffer's data store
+    uint32_t MemoryTypeIndex;
+    VkMemoryPropertyFlags MemoryPropertyFlags;
+    uint64_t ByteCount;
+    // NOTE(blackedout): Set if the buffer is a range of a buffer shared with other small buffers
+    int IsPooled;
+} buffer_memory_info;
+
 int cuglCreateContext(const context_create_params *);
 void cuglSwapBuffers(void);
+// NOTE(blackedout): Returns the stats of the last frame that was finished by `cuglSwapBuffers`
+void cuglGetFrameStats(frame_stats *OutStats);
+// NOTE(blackedout): Returns nonzero if `Buffer` isn't the name of a buffer object with a data store
+int cuglGetBufferMemoryInfo(uint32_t Buffer, buffer_memory_info *OutInfo);
 
 
 // The following part was generated using `scripts/gen_gl.py`
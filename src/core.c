@@ -167,6 +167,9 @@ void GenerateError(context *C, gl_error_type Type, const char *FunctionName) {
     MakeCaseApp(gl_error_UNIFORM_COUNT_NEGATIVE, GL_INVALID_VALUE, "An INVALID_VALUE error is generated if count is negative.");
     MakeCaseApp(gl_error_UNIFORM_NO_PROGRAM, GL_INVALID_OPERATION, "An INVALID_OPERATION error is generated if there is no active program object in use.");
     MakeCaseApp(gl_error_UNIFORM_INVALID_LOCATION, GL_INVALID_OPERATION, "An INVALID_OPERATION error is generated if no variable with a location of location exists in the program object currently in use and location is not -1.");
+    MakeCaseApp(gl_error_UNIFORM_SIZE_MISMATCH, GL_INVALID_OPERATION, "An INVALID_OPERATION error is generated if the size indicated in the name of the Uniform* command used does not match the size of the uniform declared in the shader.");
+    MakeCaseApp(gl_error_UNIFORM_TYPE_MISMATCH, GL_INVALID_OPERATION, "An INVALID_OPERATION error is generated if a floating-point, double, signed or unsigned integer variant of the Uniform* command is used to load a uniform variable of another base type, except for boolean uniforms, which may be loaded by the floating-point and integer variants.");
+    MakeCaseApp(gl_error_UNIFORM_COUNT_NOT_ARRAY, GL_INVALID_OPERATION, "An INVALID_OPERATION error is generated if count is greater than one, and the uniform declared in the shader is not an array variable.");
 
     MakeCaseApp(gl_error_VERTEX_ATTRIB_FORMAT_NONE_BOUND, GL_INVALID_OPERATION, "An INVALID_OPERATION error is generated by VertexAttrib*Format if no vertex array object is currently bound (see section 10.3.1).");
     MakeCaseApp(gl_error_VERTEX_ARRAY_ATTRIB_FORMAT_VAO_INVALID, GL_INVALID_OPERATION, "An INVALID_OPERATION error is generated by VertexArrayAttrib*Format if vaobj is not the name of an existing vertex array object.");
@@ -192,6 +195,11 @@ void GenerateError(context *C, gl_error_type Type, const char *FunctionName) {
     MakeCaseApp(gl_error_VERTEX_ARRAY_ATTRIB_BINDING_ATTRIB_INDEX, GL_INVALID_VALUE, "An INVALID_VALUE error is generated if attribindex is greater than or equal to the value of MAX_VERTEX_ATTRIBS.");
     MakeCaseApp(gl_error_VERTEX_ARRAY_ATTRIB_BINDING_BINDING_INDEX, GL_INVALID_VALUE, "An INVALID_VALUE error is generated if bindingindex is greater than or equal to the value of MAX_VERTEX_ATTRIB_BINDINGS.");
 
+    MakeCaseApp(gl_error_VERTEX_BINDING_DIVISOR_NONE_BOUND, GL_INVALID_OPERATION, "An INVALID_OPERATION error is generated by VertexAttribDivisor and VertexBindingDivisor if no vertex array object is bound.");
+    MakeCaseApp(gl_error_VERTEX_ARRAY_BINDING_DIVISOR_VAO_INVALID, GL_INVALID_OPERATION, "An INVALID_OPERATION error is generated by VertexArrayBindingDivisor if vaobj is not the name of an existing vertex array object.");
+    MakeCaseApp(gl_error_VERTEX_BINDING_DIVISOR_INDEX, GL_INVALID_VALUE, "An INVALID_VALUE error is generated if bindingindex is greater than or equal to the value of MAX_VERTEX_ATTRIB_BINDINGS.");
+    MakeCaseApp(gl_error_VERTEX_ATTRIB_DIVISOR_INDEX, GL_INVALID_VALUE, "An INVALID_VALUE error is generated if index is greater than or equal to the value of MAX_VERTEX_ATTRIBS.");
+
     MakeCaseApp(gl_error_VERTEX_ATTRIB_POINTER_NONE_BOUND, GL_INVALID_OPERATION, "An INVALID_OPERATION error is generated if no vertex array object is bound.");
 
     MakeCaseApp(gl_error_XABLE_VERTEX_ATTRIB_ARRAY_NONE_BOUND, GL_INVALID_OPERATION, "An INVALID_OPERATION error is generated by EnableVertexAttribArray and DisableVertexAttribArray if no vertex array object is bound.");
@@ -221,6 +229,90 @@ void GenerateError(context *C, gl_error_type Type, const char *FunctionName) {
     MakeCaseApp(gl_error_SCISSOR_COUNT_NEGATIVE, GL_INVALID_VALUE, "An INVALID_VALUE error is generated by ScissorArrayv if count is negative.");
     MakeCaseApp(gl_error_SCISSOR_WIDTH_HEIGHT_NEGATIVE, GL_INVALID_VALUE, "An INVALID_VALUE error is generated by ScissorIndexed and Scissor if width or height is negative.");
 
+    MakeCaseApp(gl_error_BUFFER_TARGET, GL_INVALID_ENUM, "An INVALID_ENUM error is generated if target is not one of the targets listed in table 6.1.");
+    MakeCaseApp(gl_error_BUFFER_TARGET_ZERO_BOUND, GL_INVALID_OPERATION, "An INVALID_OPERATION error is generated if zero is bound to target.");
+    MakeCaseApp(gl_error_BUFFER_NAME_INVALID, GL_INVALID_OPERATION, "An INVALID_OPERATION error is generated by Named* commands if buffer is not the name of an existing buffer object.");
+
+    MakeCaseApp(gl_error_MAP_BUFFER_ACCESS, GL_INVALID_ENUM, "An INVALID_ENUM error is generated if access is not READ_ONLY, WRITE_ONLY, or READ_WRITE.");
+    MakeCaseApp(gl_error_MAP_BUFFER_RANGE_VALUE, GL_INVALID_VALUE, "An INVALID_VALUE error is generated if offset or length is negative, if offset + length is greater than the value of BUFFER_SIZE for the buffer object, or if access has any bits set other than those defined above.");
+    MakeCaseApp(gl_error_MAP_BUFFER_RANGE_LENGTH_ZERO, GL_INVALID_OPERATION, "An INVALID_OPERATION error is generated if length is zero.");
+    MakeCaseApp(gl_error_MAP_BUFFER_RANGE_MAPPED, GL_INVALID_OPERATION, "An INVALID_OPERATION error is generated if the buffer object is in a mapped state.");
+    MakeCaseApp(gl_error_MAP_BUFFER_RANGE_NO_READ_WRITE, GL_INVALID_OPERATION, "An INVALID_OPERATION error is generated if neither MAP_READ_BIT nor MAP_WRITE_BIT is set.");
+    MakeCaseApp(gl_error_MAP_BUFFER_RANGE_READ_INVALIDATE, GL_INVALID_OPERATION, "An INVALID_OPERATION error is generated if MAP_READ_BIT is set and any of MAP_INVALIDATE_RANGE_BIT, MAP_INVALIDATE_BUFFER_BIT or MAP_UNSYNCHRONIZED_BIT is set.");
+    MakeCaseApp(gl_error_MAP_BUFFER_RANGE_FLUSH_NO_WRITE, GL_INVALID_OPERATION, "An INVALID_OPERATION error is generated if MAP_FLUSH_EXPLICIT_BIT is set and MAP_WRITE_BIT is not set.");
+    MakeCaseApp(gl_error_UNMAP_BUFFER_NOT_MAPPED, GL_INVALID_OPERATION, "An INVALID_OPERATION error is generated if the buffer object is not in a mapped state.");
+    MakeCaseApp(gl_error_FLUSH_MAPPED_BUFFER_RANGE_VALUE, GL_INVALID_VALUE, "An INVALID_VALUE error is generated if offset or length is negative, or if offset + length exceeds the size of the mapping.");
+    MakeCaseApp(gl_error_FLUSH_MAPPED_BUFFER_RANGE_NOT_MAPPED, GL_INVALID_OPERATION, "An INVALID_OPERATION error is generated if the buffer object is not mapped, or is mapped without the MAP_FLUSH_EXPLICIT_BIT flag.");
+    MakeCaseApp(gl_error_BUFFER_SUB_DATA_VALUE, GL_INVALID_VALUE, "An INVALID_VALUE error is generated if offset or size is negative, or if offset + size is greater than the value of BUFFER_SIZE for the buffer object.");
+    MakeCaseApp(gl_error_BUFFER_SUB_DATA_MAPPED, GL_INVALID_OPERATION, "An INVALID_OPERATION error is generated if any part of the specified buffer range is mapped with MapBufferRange or MapBuffer (see section 6.3), unless it was mapped with MAP_PERSISTENT_BIT set in the MapBufferRange access flags.");
+    MakeCaseApp(gl_error_BUFFER_SUB_DATA_IMMUTABLE, GL_INVALID_OPERATION, "An INVALID_OPERATION error is generated if the value of the BUFFER_IMMUTABLE_STORAGE flag of the buffer object is TRUE and the value of BUFFER_STORAGE_FLAGS for the buffer object does not have the DYNAMIC_STORAGE_BIT bit set.");
+    MakeCaseApp(gl_error_MAP_BUFFER_RANGE_STORAGE_FLAGS, GL_INVALID_OPERATION, "An INVALID_OPERATION error is generated if any of MAP_READ_BIT, MAP_WRITE_BIT, MAP_PERSISTENT_BIT or MAP_COHERENT_BIT are set in access, but the same bit is not included in the buffer's storage flags.");
+    MakeCaseApp(gl_error_BUFFER_DATA_SIZE, GL_INVALID_VALUE, "An INVALID_VALUE error is generated if size is negative.");
+    MakeCaseApp(gl_error_BUFFER_DATA_USAGE, GL_INVALID_ENUM, "An INVALID_ENUM error is generated if usage is not one of the nine usage values.");
+    MakeCaseApp(gl_error_BUFFER_DATA_IMMUTABLE, GL_INVALID_OPERATION, "An INVALID_OPERATION error is generated if the BUFFER_IMMUTABLE_STORAGE flag of the buffer object is TRUE.");
+    MakeCaseApp(gl_error_BUFFER_STORAGE_SIZE, GL_INVALID_VALUE, "An INVALID_VALUE error is generated if size is less than or equal to zero.");
+    MakeCaseApp(gl_error_BUFFER_STORAGE_FLAGS, GL_INVALID_VALUE, "An INVALID_VALUE error is generated if flags has any bits set other than those defined above.");
+    MakeCaseApp(gl_error_BUFFER_STORAGE_PERSISTENT, GL_INVALID_VALUE, "An INVALID_VALUE error is generated if flags contains MAP_PERSISTENT_BIT but does not contain at least one of MAP_READ_BIT or MAP_WRITE_BIT.");
+    MakeCaseApp(gl_error_BUFFER_STORAGE_COHERENT, GL_INVALID_VALUE, "An INVALID_VALUE error is generated if flags contains MAP_COHERENT_BIT, but does not also contain MAP_PERSISTENT_BIT.");
+    MakeCaseApp(gl_error_BUFFER_STORAGE_IMMUTABLE, GL_INVALID_OPERATION, "An INVALID_OPERATION error is generated if the BUFFER_IMMUTABLE_STORAGE flag of the buffer object is TRUE.");
+    MakeCaseApp(gl_error_COPY_BUFFER_SUB_DATA_NEGATIVE, GL_INVALID_VALUE, "An INVALID_VALUE error is generated if any of readOffset, writeOffset, or size are negative.");
+    MakeCaseApp(gl_error_COPY_BUFFER_SUB_DATA_RANGE, GL_INVALID_VALUE, "An INVALID_VALUE error is generated if readOffset + size exceeds the size of the source buffer object, or if writeOffset + size exceeds the size of the destination buffer object.");
+    MakeCaseApp(gl_error_COPY_BUFFER_SUB_DATA_OVERLAP, GL_INVALID_VALUE, "An INVALID_VALUE error is generated if the source and destination are the same buffer object, and the ranges [readOffset, readOffset + size) and [writeOffset, writeOffset + size) overlap.");
+    MakeCaseApp(gl_error_COPY_BUFFER_SUB_DATA_MAPPED, GL_INVALID_OPERATION, "An INVALID_OPERATION error is generated if either the source or destination buffer object is mapped, unless they were mapped with MAP_PERSISTENT_BIT set in the MapBufferRange access flags.");
+    MakeCaseApp(gl_error_GET_BUFFER_SUB_DATA_VALUE, GL_INVALID_VALUE, "An INVALID_VALUE error is generated if offset or size is negative, or if offset + size is greater than the value of BUFFER_SIZE for the buffer object.");
+    MakeCaseApp(gl_error_GET_BUFFER_SUB_DATA_MAPPED, GL_INVALID_OPERATION, "An INVALID_OPERATION error is generated if the buffer object is mapped with MapBufferRange or MapBuffer, unless it was mapped with MAP_PERSISTENT_BIT set in the MapBufferRange access flags.");
+    MakeCaseApp(gl_error_READ_PIXELS_SIZE_NEGATIVE, GL_INVALID_VALUE, "An INVALID_VALUE error is generated if either width or height is negative.");
+    MakeCaseApp(gl_error_READ_PIXELS_PACK_MAPPED, GL_INVALID_OPERATION, "An INVALID_OPERATION error is generated if a pixel pack buffer object is bound and the buffer object's data store is currently mapped.");
+    MakeCaseApp(gl_error_READ_PIXELS_PACK_RANGE, GL_INVALID_OPERATION, "An INVALID_OPERATION error is generated if a pixel pack buffer object is bound and packing the pixel data according to the pixel pack storage state would access memory beyond the size of the pixel pack buffer's memory size.");
+    MakeCaseApp(gl_error_FENCE_SYNC_CONDITION, GL_INVALID_ENUM, "An INVALID_ENUM error is generated if condition is not SYNC_GPU_COMMANDS_COMPLETE.");
+    MakeCaseApp(gl_error_FENCE_SYNC_FLAGS, GL_INVALID_VALUE, "An INVALID_VALUE error is generated if flags is not zero.");
+    MakeCaseApp(gl_error_SYNC_INVALID, GL_INVALID_VALUE, "An INVALID_VALUE error is generated if sync is not the name of a sync object.");
+    MakeCaseApp(gl_error_CLIENT_WAIT_SYNC_FLAGS, GL_INVALID_VALUE, "An INVALID_VALUE error is generated if flags contains any bits other than SYNC_FLUSH_COMMANDS_BIT.");
+    MakeCaseApp(gl_error_GET_SYNCIV_PNAME, GL_INVALID_ENUM, "An INVALID_ENUM error is generated if pname is not one of the values in table 4.1.");
+    MakeCaseApp(gl_error_GET_SYNCIV_COUNT, GL_INVALID_VALUE, "An INVALID_VALUE error is generated if count is negative.");
+    MakeCaseApp(gl_error_INVALIDATE_BUFFER_SUB_DATA_VALUE, GL_INVALID_VALUE, "An INVALID_VALUE error is generated if offset or length is negative, or if offset + length is greater than the value of BUFFER_SIZE for buffer.");
+    MakeCaseApp(gl_error_INVALIDATE_BUFFER_MAPPED, GL_INVALID_OPERATION, "An INVALID_OPERATION error is generated if buffer is currently mapped by MapBuffer or if the invalidate range intersects the range currently mapped by MapBufferRange, unless it was mapped with MAP_PERSISTENT_BIT set in the MapBufferRange access flags.");
+    MakeCaseApp(gl_error_INVALIDATE_FRAMEBUFFER_TARGET, GL_INVALID_ENUM, "An INVALID_ENUM error is generated by InvalidateSubFramebuffer if target is not DRAW_FRAMEBUFFER, READ_FRAMEBUFFER, or FRAMEBUFFER.");
+    MakeCaseApp(gl_error_INVALIDATE_FRAMEBUFFER_NAME, GL_INVALID_OPERATION, "An INVALID_OPERATION error is generated by InvalidateNamedFramebufferSubData if framebuffer is not zero or the name of an existing framebuffer object.");
+    MakeCaseApp(gl_error_INVALIDATE_FRAMEBUFFER_NEGATIVE, GL_INVALID_VALUE, "An INVALID_VALUE error is generated if numAttachments, width, or height is negative.");
+    MakeCaseApp(gl_error_INVALIDATE_FRAMEBUFFER_ATTACHMENT, GL_INVALID_ENUM, "An INVALID_ENUM error is generated if a framebuffer object is affected, and any element of of attachments is not one of the values COLOR_ATTACHMENTi, DEPTH_ATTACHMENT, STENCIL_ATTACHMENT, or DEPTH_STENCIL_ATTACHMENT.");
+    MakeCaseApp(gl_error_INVALIDATE_FRAMEBUFFER_ATTACHMENT_DEFAULT, GL_INVALID_ENUM, "An INVALID_ENUM error is generated if the default framebuffer is affected, and any element of attachments is not one of the values COLOR, DEPTH, or STENCIL.");
+    MakeCaseApp(gl_error_DRAW_INSTANCE_COUNT_NEGATIVE, GL_INVALID_VALUE, "An INVALID_VALUE error is generated if instancecount is negative.");
+    MakeCaseApp(gl_error_DRAW_ELEMENTS_TYPE, GL_INVALID_ENUM, "An INVALID_ENUM error is generated if type is not UNSIGNED_BYTE, UNSIGNED_SHORT, or UNSIGNED_INT.");
+    MakeCaseApp(gl_error_DRAW_RANGE_ELEMENTS_RANGE, GL_INVALID_VALUE, "An INVALID_VALUE error is generated if end < start.");
+    MakeCaseApp(gl_error_DRAW_BUFFER_MAPPED, GL_INVALID_OPERATION, "An INVALID_OPERATION error is generated if a non-zero buffer object name is bound to an enabled array or to the ELEMENT_ARRAY_BUFFER binding and the buffer object's data store is currently mapped, unless it was mapped with MAP_PERSISTENT_BIT.");
+    MakeCaseApp(gl_error_VERTEX_ARRAY_ELEMENT_BUFFER_VAO, GL_INVALID_OPERATION, "An INVALID_OPERATION error is generated by VertexArrayElementBuffer if vaobj is not the name of an existing vertex array object.");
+    MakeCaseApp(gl_error_VERTEX_ARRAY_ELEMENT_BUFFER_BUFFER, GL_INVALID_OPERATION, "An INVALID_OPERATION error is generated if buffer is not zero or the name of an existing buffer object.");
+    MakeCaseApp(gl_error_DRAW_INDIRECT_NO_BUFFER, GL_INVALID_OPERATION, "An INVALID_OPERATION error is generated if zero is bound to DRAW_INDIRECT_BUFFER.");
+    MakeCaseApp(gl_error_DRAW_INDIRECT_ALIGNMENT, GL_INVALID_VALUE, "An INVALID_VALUE error is generated if indirect is not a multiple of the size, in basic machine units, of uint.");
+    MakeCaseApp(gl_error_DRAW_INDIRECT_RANGE, GL_INVALID_OPERATION, "An INVALID_OPERATION error is generated if the command would source data beyond the end of the buffer object.");
+    MakeCaseApp(gl_error_MULTI_DRAW_DRAW_COUNT_NEGATIVE, GL_INVALID_VALUE, "An INVALID_VALUE error is generated if drawcount is negative.");
+    MakeCaseApp(gl_error_MULTI_DRAW_INDIRECT_MAX_DRAW_COUNT_NEGATIVE, GL_INVALID_VALUE, "An INVALID_VALUE error is generated if maxdrawcount is negative.");
+    MakeCaseApp(gl_error_MULTI_DRAW_INDIRECT_STRIDE, GL_INVALID_VALUE, "An INVALID_VALUE error is generated if stride is neither zero nor a multiple of four.");
+    MakeCaseApp(gl_error_MULTI_DRAW_INDIRECT_COUNT_NO_BUFFER, GL_INVALID_OPERATION, "An INVALID_OPERATION error is generated if no buffer is bound to the PARAMETER_BUFFER binding point.");
+    MakeCaseApp(gl_error_MULTI_DRAW_INDIRECT_COUNT_ALIGNMENT, GL_INVALID_VALUE, "An INVALID_VALUE error is generated if drawcount is not a multiple of four.");
+    MakeCaseApp(gl_error_MULTI_DRAW_INDIRECT_COUNT_RANGE, GL_INVALID_OPERATION, "An INVALID_OPERATION error is generated if reading a sizei typed value from the buffer bound to the PARAMETER_BUFFER target at the offset specified by drawcount would result in an out-of-bounds access.");
+    MakeCaseApp(gl_error_BIND_BUFFER_INDEXED_TARGET, GL_INVALID_ENUM, "An INVALID_ENUM error is generated if target is not one of the targets in table 6.5.");
+    MakeCaseApp(gl_error_BIND_BUFFER_INDEXED_INDEX, GL_INVALID_VALUE, "An INVALID_VALUE error is generated if index is greater than or equal to the number of target-specific indexed binding points, as described in section 6.7.1.");
+    MakeCaseApp(gl_error_BIND_BUFFER_INDEXED_BUFFER, GL_INVALID_OPERATION, "An INVALID_OPERATION error is generated if buffer is not zero or a name returned from a previous call to GenBuffers, or if such a name has since been deleted with DeleteBuffers.");
+    MakeCaseApp(gl_error_BIND_BUFFER_RANGE_SIZE, GL_INVALID_VALUE, "An INVALID_VALUE error is generated by BindBufferRange if buffer is non-zero and size is less than or equal to zero.");
+    MakeCaseApp(gl_error_BIND_BUFFER_RANGE_OFFSET, GL_INVALID_VALUE, "An INVALID_VALUE error is generated by BindBufferRange if buffer is non-zero and offset or size do not respectively satisfy the constraints described for those parameters for the specified target, as described in section 6.7.1.");
+    MakeCaseApp(gl_error_SHADER_STORAGE_BUFFER_MAPPED, GL_INVALID_OPERATION, "An INVALID_OPERATION error is generated if a buffer object bound to a shader storage block binding is mapped, unless it was mapped with MAP_PERSISTENT_BIT set in the MapBufferRange access flags.");
+    MakeCaseApp(gl_error_SHADER_STORAGE_BLOCK_BINDING_VALUE, GL_INVALID_VALUE, "An INVALID_VALUE error is generated if storageBlockIndex is not an active shader storage block index in program, or if storageBlockBinding is greater than or equal to the value of MAX_SHADER_STORAGE_BUFFER_BINDINGS.");
+    MakeCaseApp(gl_error_DISPATCH_NO_PROGRAM, GL_INVALID_OPERATION, "An INVALID_OPERATION error is generated if there is no active program for the compute shader stage.");
+    MakeCaseApp(gl_error_DISPATCH_GROUP_COUNT, GL_INVALID_VALUE, "An INVALID_VALUE error is generated if any of num_groups_x, num_groups_y and num_groups_z are greater than the value of MAX_COMPUTE_WORK_GROUP_COUNT for the corresponding dimension.");
+    MakeCaseApp(gl_error_DISPATCH_INDIRECT_NO_BUFFER, GL_INVALID_OPERATION, "An INVALID_OPERATION error is generated if zero is bound to DISPATCH_INDIRECT_BUFFER.");
+    MakeCaseApp(gl_error_DISPATCH_INDIRECT_OFFSET, GL_INVALID_VALUE, "An INVALID_VALUE error is generated if indirect is negative or is not a multiple of the size, in basic machine units, of uint.");
+    MakeCaseApp(gl_error_DISPATCH_INDIRECT_RANGE, GL_INVALID_OPERATION, "An INVALID_OPERATION error is generated if the command would source data beyond the end of the buffer object.");
+    MakeCaseApp(gl_error_DISPATCH_INDIRECT_MAPPED, GL_INVALID_OPERATION, "An INVALID_OPERATION error is generated if the buffer bound to DISPATCH_INDIRECT_BUFFER is mapped, unless it was mapped with MAP_PERSISTENT_BIT set in the MapBufferRange access flags.");
+    MakeCaseApp(gl_error_MEMORY_BARRIER_BITS, GL_INVALID_VALUE, "An INVALID_VALUE error is generated if barriers is not the special value ALL_BARRIER_BITS, and has any bits set other than those described above.");
+    MakeCaseApp(gl_error_BIND_IMAGE_TEXTURE_UNIT, GL_INVALID_VALUE, "An INVALID_VALUE error is generated if unit is greater than or equal to the value of MAX_IMAGE_UNITS.");
+    MakeCaseApp(gl_error_BIND_IMAGE_TEXTURE_TEXTURE, GL_INVALID_VALUE, "An INVALID_VALUE error is generated if texture is not the name of an existing texture object.");
+    MakeCaseApp(gl_error_BIND_IMAGE_TEXTURE_LEVEL_LAYER, GL_INVALID_VALUE, "An INVALID_VALUE error is generated if level or layer is negative.");
+    MakeCaseApp(gl_error_BIND_IMAGE_TEXTURE_ACCESS, GL_INVALID_ENUM, "An INVALID_ENUM error is generated if access is not one of READ_ONLY, WRITE_ONLY or READ_WRITE.");
+    MakeCaseApp(gl_error_BIND_IMAGE_TEXTURE_FORMAT, GL_INVALID_VALUE, "An INVALID_VALUE error is generated if format is not one of the formats listed in table 8.27.");
+    MakeCaseApp(gl_error_INVALIDATE_FRAMEBUFFER_COLOR_INDEX, GL_INVALID_OPERATION, "An INVALID_OPERATION error is generated if element of attachments is COLOR_ATTACHMENTm where m is greater than or equal to the value of MAX_COLOR_ATTACHMENTS.");
+
     default: Assert(0); break;
 #undef MakeCaseApi
 #undef MakeCaseApp
@@ -259,6 +351,21 @@ int PushCommand(context *C, command Command) {
     return 0;
 }
 
+VkDescriptorBufferInfo MakeBufferRange(VkBuffer Buffer, u64 Offset, u64 Range) {
+    VkDescriptorBufferInfo Result = {
+        .buffer = Buffer,
+        .offset = Offset,
+        .range = Range,
+    };
+    return Result;
+}
+
+int IsBufferRangeAliased(VkDescriptorBufferInfo A, VkDescriptorBufferInfo B) {
+    u64 EndA = A.range == VK_WHOLE_SIZE ? UINT64_MAX : A.offset + A.range;
+    u64 EndB = B.range == VK_WHOLE_SIZE ? UINT64_MAX : B.offset + B.range;
+    return A.buffer == B.buffer && A.offset < EndB && B.offset < EndA;
+}
+
 void GenObject(context *C, GLuint *OutHandle, object **OutObject) {
     Assert(C->Objects.Count < C->Objects.Capacity);
 
@@ -365,6 +472,18 @@ void DeleteObjects(context *Context, u64 Count, const GLuint *Handles, object_ty
             GenerateErrorMsg(Context, GL_INVALID_VALUE, GL_DEBUG_SOURCE_APPLICATION, "");
         }
 
+        if(Objects[Index].Type == object_BUFFER) {
+            ReleaseBufferMemory(Context, Objects + Index);
+            GLuint Expanded = Objects[Index].Buffer.ExpandedIndexBuffer;
+            if(Expanded) {
+                ReleaseBufferMemory(Context, Objects + Expanded);
+                DeleteObject(Context, Objects + Expanded);
+            }
+        }
+        if(Objects[Index].Type == object_FRAMEBUFFER) {
+            ReleaseRenderPass(Context, Objects[Index].Framebuffer.RenderPass);
+            ReleaseRenderPass(Context, Objects[Index].Framebuffer.ResumeRenderPass);
+        }
         DeleteObject(Context, Objects + Index);
     }
 }
@@ -397,7 +516,13 @@ void DeleteProgram(context *C, object *Object) {
         }
     }
 
+    vkDestroyPipeline(C->Device, Object->Program.ComputePipeline, 0);
+    vkDestroyPipelineLayout(C->Device, Object->Program.ComputeLayout, 0);
+    vkDestroyDescriptorSetLayout(C->Device, Object->Program.StorageDescriptorSetLayout, 0);
+    free(Object->Program.StorageBufferInfos.Data);
+
     GlslangProgramDelete(&Object->Program.GlslangProgram);
+    free(Object->Program.UniformSnapshotTable.Data);
     DeleteObject(C, Object);
 }
 
@@ -449,6 +574,26 @@ int HandledCheckShaderGet(context *C, GLuint H, object **OutObject, const char *
     return 0;
 }
 
+int HandledCheckBufferTargetGet(context *C, GLenum Target, object **OutObject, const char *Name) {
+    buffer_target_info TargetInfo = {0};
+    CheckGL(GetBufferTargetInfo(Target, &TargetInfo), gl_error_BUFFER_TARGET, 1);
+    GLuint H = C->BoundBuffers[TargetInfo.Index];
+    CheckGL(H == 0, gl_error_BUFFER_TARGET_ZERO_BOUND, 1);
+    CheckGL(CheckObjectTypeGet(C, H, object_BUFFER, OutObject), gl_error_BUFFER_TARGET_ZERO_BOUND, 1);
+    return 0;
+}
+
+int HandledCheckBufferGet(context *C, GLuint H, object **OutObject, const char *Name) {
+    CheckGL(H == 0 || CheckObjectTypeGet(C, H, object_BUFFER, OutObject), gl_error_BUFFER_NAME_INVALID, 1);
+    return 0;
+}
+
+int HandledCheckSyncGet(context *C, GLsync Sync, object **OutObject, const char *Name) {
+    GLuint H = (GLuint)(uintptr_t)Sync;
+    CheckGL(H == 0 || CheckObjectTypeGet(C, H, object_SYNC, OutObject), gl_error_SYNC_INVALID, 1);
+    return 0;
+}
+
 // NOTE(blackedout): MARK: Helper function
 
 void SetVertexInputAttributeFormat(context *C, object *Object, int IsCurrent, u32 Index, GLint Size, GLenum Type, GLuint RelativeOffset, u32 IntegerHandlingBits, const char *Name) {
@@ -481,7 +626,9 @@ void SetVertexInputBinding(context *C, object *Object, int IsCurrent, u32 Index,
     object *ObjectB = 0;
     CheckGL(Vbo != 0 && CheckObjectTypeGet(C, Vbo, object_BUFFER, &ObjectB), gl_error_VERTEX_ARRAY_VERTEX_BUFFER_VBO_INVALID);
 
+    // NOTE(blackedout): The divisor is separate binding state
     vertex_array_binding NewBinding = {0};
+    NewBinding.Divisor = Object->VertexArray.InputBindings[Index].Divisor;
     if(Vbo != 0) {
         NewBinding.Vbo = Vbo;
         NewBinding.Offset = Offset;
@@ -508,6 +655,30 @@ void SetVertexInputAttributeBinding(context *C, object *Object, int IsCurrent, u
     }
 }
 
+void SetVertexInputBindingDivisor(context *C, object *Object, int IsCurrent, u32 Index, GLuint Divisor, const char *Name) {
+    CheckGL(Index >= C->PipelineStateInfos[pipeline_state_VERTEX_INPUT_BINDINGS].InstanceCount, gl_error_VERTEX_BINDING_DIVISOR_INDEX);
+    if(Divisor > C->DeviceInfo.MaxVertexAttribDivisor) {
+        GenerateOther(C, GL_DEBUG_SOURCE_API, "VertexBindingDivisor: divisor is not supported by the device, attributes advance every instance instead");
+    }
+
+    Object->VertexArray.InputBindings[Index].Divisor = Divisor;
+    if(IsCurrent) {
+        pipeline_state_vertex_input_binding *State = GetCurrentPipelineState(C, pipeline_state_VERTEX_INPUT_BINDINGS);
+        State[Index].Divisor = Divisor;
+    }
+}
+
+// NOTE(blackedout): Pipelines only depend on the layout of the bindings, buffers and offsets are bound by commands
+void SetCurrentVertexInputBindings(context *C, object *Object) {
+    pipeline_state_vertex_input_binding *State = GetCurrentPipelineState(C, pipeline_state_VERTEX_INPUT_BINDINGS);
+    for(u32 I = 0; I < C->PipelineStateInfos[pipeline_state_VERTEX_INPUT_BINDINGS].InstanceCount; ++I) {
+        vertex_array_binding *Binding = Object->VertexArray.InputBindings + I;
+        State[I].IsEnabled = Binding->Vbo != 0;
+        State[I].Stride = Binding->Stride;
+        State[I].Divisor = Binding->Divisor;
+    }
+}
+
 void SetVertexInputAttributePointer(context *C, object *Object, u32 Index, GLint Size, GLenum Type, GLsizei Stride, const void *Pointer, u32 IntegerHandlingBits, const char *Name) {
     SetVertexInputAttributeFormat(C, Object, 1, Index, Size, Type, 0, IntegerHandlingBits, Name);
     SetVertexInputAttributeBinding(C, Object, 1, Index, Index, Name);
@@ -578,13 +749,34 @@ GLboolean NoContextIsObjectType(GLuint H, object_type Type, const char *Name) {
     context *C = 0;
     GLboolean Result = GL_FALSE;
     CheckGL(AcquireContext(&C, Name), gl_error_ACQUIRE_CONTEXT, Result);
-    int IsWrongType = CheckObjectType(C, H, object_BUFFER);
+    int IsWrongType = CheckObjectType(C, H, Type);
     ReleaseContext(C, Name);
     Result = IsWrongType ? GL_FALSE : GL_TRUE;
     return Result;
 }
 
-void NoContextSetUniformData(GLint Location, const void *Bytes, u32 Num, GLsizei Count, GLenum Type, const char *Name) {
+// NOTE(blackedout): The GL type of the scalars in `Type`, GL_BOOL for bools
+static GLenum GetGlslScalarType(glsl_type Type) {
+    GLenum ScalarTypes[] = { GL_DOUBLE, GL_FLOAT, GL_INT, GL_UNSIGNED_INT };
+    if(glsl_type_DOUBLE <= Type && Type <= glsl_type_UINT) {
+        return ScalarTypes[Type - glsl_type_DOUBLE];
+    }
+    if(glsl_type_DVEC2 <= Type && Type <= glsl_type_UVEC4) {
+        return ScalarTypes[(Type - glsl_type_DVEC2) % ArrayCount(ScalarTypes)];
+    }
+    if(glsl_type_BOOL <= Type && Type <= glsl_type_BVEC4) {
+        return GL_BOOL;
+    }
+    if(glsl_type_MAT2 <= Type && Type <= glsl_type_MAT4x4) {
+        return GL_FLOAT;
+    }
+    if(glsl_type_DMAT2 <= Type && Type <= glsl_type_DMAT4x4) {
+        return GL_DOUBLE;
+    }
+    return GL_NONE;
+}
+
+static void SetUniformData(GLint Location, const void *Bytes, u32 ColumnCount, u32 RowCount, GLsizei Count, GLboolean Transpose, GLenum Type, const char *Name) {
     context *C = 0;
     CheckGL(AcquireContext(&C, Name), gl_error_ACQUIRE_CONTEXT);
 
@@ -606,6 +798,24 @@ void NoContextSetUniformData(GLint Location, const void *Bytes, u32 Num, GLsizei
         }
     }
     CheckGL(Uniform == 0, gl_error_UNIFORM_INVALID_LOCATION);
+
+    u32 ScalarByteCount = 0;
+    switch(Type) {
+    case GL_DOUBLE: ScalarByteCount = sizeof(GLdouble); break;
+    case GL_FLOAT: ScalarByteCount = sizeof(GLfloat); break;
+    case GL_INT: ScalarByteCount = sizeof(GLint); break;
+    case GL_UNSIGNED_INT: ScalarByteCount = sizeof(GLuint); break;
+    default: Assert(0); return;
+    }
+    CheckGL(Uniform->ColumnCount != ColumnCount || Uniform->RowCount != RowCount || Uniform->ScalarByteCount != ScalarByteCount, gl_error_UNIFORM_SIZE_MISMATCH);
+    GLenum UniformScalarType = GetGlslScalarType(Uniform->Type);
+    int IsBool = UniformScalarType == GL_BOOL && Type != GL_DOUBLE;
+    CheckGL(UniformScalarType != Type && IsBool == 0, gl_error_UNIFORM_TYPE_MISMATCH);
+    CheckGL(Count > 1 && Uniform->ArrayIndexCount == 0, gl_error_UNIFORM_COUNT_NOT_ARRAY);
+
+    // NOTE(blackedout): Elements past the end of the uniform array are ignored
+    u32 ElementIndex = Location - Uniform->Location;
+    u32 ElementCount = Min((u32)Count, Uniform->LocationCount - ElementIndex);
     
     // TODO(blackedout): Also create a used flag
     if(Object->Program.LatestUniformsUsed) {
@@ -617,21 +827,44 @@ void NoContextSetUniformData(GLint Location, const void *Bytes, u32 Num, GLsizei
         Object->Program.LatestUniformsUsed = 0;
     }
 
-    u64 ByteCount = Num*Count;
-    switch(Type) {
-    case GL_DOUBLE: ByteCount *= sizeof(GLdouble); break;
-    case GL_FLOAT: ByteCount *= sizeof(GLfloat); break;
-    case GL_INT: ByteCount *= sizeof(GLint); break;
-    case GL_UNSIGNED_INT: ByteCount *= sizeof(GLuint); break;
-    default: Assert(0); return;
-    }
-
+    uniform_pack_info PackInfo = {
+        .ColumnCount = Uniform->ColumnCount,
+        .RowCount = Uniform->RowCount,
+        .ScalarByteCount = Uniform->ScalarByteCount,
+        .MatrixStride = Uniform->MatrixStride,
+        .ArrayStride = Uniform->ArrayStride,
+    };
     u8 *CurrentUniformData = ArrayData(u8, Object->Program.UniformBuffer) + (Object->Program.UniformBuffer.Count - 1)*Object->Program.AlignedUniformByteCount;
-    memcpy(CurrentUniformData + Uniform->ByteOffset, Bytes, ByteCount);
+    u8 *Dst = CurrentUniformData + Uniform->ByteOffset + ElementIndex*Uniform->ArrayStride;
+    if(IsBool && Type == GL_FLOAT) {
+        // NOTE(blackedout): Bools are uints in the block, so 0.0f and -0.0f must become 0 and everything else 1. Integers
+        // are true if they are nonzero either way.
+        u32 Converted[16*4];
+        u32 ChunkElementCount = ArrayCount(Converted)/RowCount;
+        for(u32 I = 0; I < ElementCount; I += ChunkElementCount) {
+            u32 LocalCount = Min(ChunkElementCount, ElementCount - I);
+            const GLfloat *Src = (const GLfloat *)Bytes + I*RowCount;
+            for(u32 J = 0; J < LocalCount*RowCount; ++J) {
+                Converted[J] = Src[J] != 0.0f;
+            }
+            PackUniformElements(Dst + I*Uniform->ArrayStride, Converted, LocalCount, 0, &PackInfo);
+        }
+    } else {
+        PackUniformElements(Dst, Bytes, ElementCount, Transpose == GL_TRUE, &PackInfo);
+    }
+    Object->Program.LatestUniformsResolved = 0;
 
     ReleaseContext(C, Name);
 }
 
+void NoContextSetUniformData(GLint Location, const void *Bytes, u32 Num, GLsizei Count, GLenum Type, const char *Name) {
+    SetUniformData(Location, Bytes, 1, Num, Count, GL_FALSE, Type, Name);
+}
+
+void NoContextSetUniformMatrixData(GLint Location, const void *Bytes, u32 ColumnCount, u32 RowCount, GLsizei Count, GLboolean Transpose, GLenum Type, const char *Name) {
+    SetUniformData(Location, Bytes, ColumnCount, RowCount, Count, Transpose, Type, Name);
+}
+
 void HandledCheckCapSet(context *C, GLenum Cap, int Enabled) {
     switch(Cap) {
     case GL_BLEND: {} break;
@@ -676,481 +909,3103 @@ int VulkanCheck(context *C, VkResult Result, const char *Call) {
     return 0;
 }
 
-int CheckFramebuffer(context *C, GLuint Fbo) {
-    object *Object = 0;
-    Assert(0 == CheckObjectTypeGet(C, Fbo, object_FRAMEBUFFER, &Object));
+// NOTE(blackedout): MARK: Transfer batch
+// Host to device copies of a frame are recorded into one command buffer that is submitted once by `cuglSwapBuffers`,
+// right before the graphics work that waits on its semaphore. Staging buffers are kept alive until the batch's fence signaled.
+// The batch runs on the transfer family, so with a dedicated transfer queue the copies run on the copy engine while the
+// graphics queue is busy with other work.
 
-    if(Object->Framebuffer.RenderPass != VK_NULL_HANDLE) {
-        // NOTE(blackedout): Render pass and so saved subpass state does exist, compare to current to evaluate if renderpass recreation is necessary
-        if(Object->Framebuffer.StoredSubpasses.Count != Object->Framebuffer.Subpasses.Count) {
-            goto label_NoMatch;
-        }
-        if(memcmp(Object->Framebuffer.StoredSubpasses.Data, Object->Framebuffer.Subpasses.Data, sizeof(render_pass_state_subpass)*Object->Framebuffer.Subpasses.Count) != 0) {
-            goto label_NoMatch;
-        }
-        if(Object->Framebuffer.StoredSubpassAttachments.Count != Object->Framebuffer.SubpassAttachments.Count) {
-            goto label_NoMatch;
-        }
-        if(memcmp(Object->Framebuffer.StoredSubpassAttachments.Data, Object->Framebuffer.SubpassAttachments.Data, sizeof(VkAttachmentReference)*Object->Framebuffer.SubpassAttachments.Count) != 0) {
-            goto label_NoMatch;
+int RecycleTransferBatch(context *C, int DoWait) {
+    if(C->IsTransferBatchInFlight == 0) {
+        return 0;
+    }
+
+    VkResult Status = VK_SUCCESS;
+    if(DoWait) {
+        Status = vkWaitForFences(C->Device, 1, C->Fences + fence_TRANSFER, VK_TRUE, UINT64_MAX);
+    } else {
+        Status = vkGetFenceStatus(C->Device, C->Fences[fence_TRANSFER]);
+        if(Status == VK_NOT_READY) {
+            return 0;
         }
+    }
+    VulkanCheckGoto(Status, label_Error);
+    VulkanCheckGoto(vkResetFences(C->Device, 1, C->Fences + fence_TRANSFER), label_Error);
 
-        // NOTE(blackedout): Match, reset current, keep old one and return
-        ArrayClear(&Object->Framebuffer.Subpasses, sizeof(render_pass_state_subpass));
-        ArrayClear(&Object->Framebuffer.SubpassAttachments, sizeof(VkAttachmentReference));
+    for(u64 I = 0; I < C->InFlightStagingBuffers.Count; ++I) {
+        staging_buffer *Staging = ArrayData(staging_buffer, C->InFlightStagingBuffers) + I;
+        vmaDestroyBuffer(C->Allocator, Staging->Buffer, Staging->Allocation);
+    }
+    C->InFlightStagingBuffers.Count = 0;
+    C->StagingRing.Tail = C->StagingRing.InFlightHead;
+    if(C->StagingRing.HasStreamRanges) {
+        C->StagingRing.Tail = Min(C->StagingRing.Tail, C->StagingRing.StreamTail);
+    }
+    C->IsTransferBatchInFlight = 0;
+    return 0;
 
-        return 0;
+label_Error:
+    return 1;
+}
 
-label_NoMatch:;
-        // NOTE(blackedout): Delete previous render pass and framebuffer. But since these might still be used there is a layer of buffering
-        if(Object->Framebuffer.OldFramebuffer != VK_NULL_HANDLE) {
-            vkDestroyFramebuffer(C->Device, Object->Framebuffer.OldFramebuffer, 0);
-            
+int BeginTransferBatch(context *C, VkCommandBuffer *OutCommandBuffer) {
+    VkCommandBuffer TransferCommandBuffer = C->CommandBuffers[command_buffer_TRANSFER];
+    if(C->IsTransferBatchRecording == 0) {
+        // NOTE(blackedout): The command buffer can only be recorded again once the previous batch is done
+        if(RecycleTransferBatch(C, 1)) {
+            return 1;
         }
-        Object->Framebuffer.OldFramebuffer = Object->Framebuffer.Framebuffer;
-        Object->Framebuffer.Framebuffer = VK_NULL_HANDLE;
 
-        if(Object->Framebuffer.OldRenderPass != VK_NULL_HANDLE) {
-            vkDestroyRenderPass(C->Device, Object->Framebuffer.OldRenderPass, 0);
-        }
-        Object->Framebuffer.OldRenderPass = Object->Framebuffer.RenderPass;
-        Object->Framebuffer.RenderPass = VK_NULL_HANDLE;
+        VkCommandBufferBeginInfo BeginInfo = {
+            .sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO,
+            .pNext = 0,
+            .flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT,
+            .pInheritanceInfo = 0,
+        };
+        VulkanCheckGoto(vkResetCommandBuffer(TransferCommandBuffer, 0), label_Error);
+        VulkanCheckGoto(vkBeginCommandBuffer(TransferCommandBuffer, &BeginInfo), label_Error);
+        C->IsTransferBatchRecording = 1;
     }
 
-    Assert(Object->Framebuffer.RenderPass == VK_NULL_HANDLE);
-    Assert(Object->Framebuffer.Framebuffer == VK_NULL_HANDLE);
+    *OutCommandBuffer = TransferCommandBuffer;
+    return 0;
 
-    VkAttachmentDescription *AttachmentDescriptions = 0;
-    VkImageView *ContiguousImageViews = 0;
-    u32 AttachmentCount = 0;
+label_Error:
+    return 1;
+}
 
-    for(u32 I = 0; I < Object->Framebuffer.ColorAttachmentCapacity; ++I) {
-        if(Object->Framebuffer.ColorAttachments[I].Rbo == 0) {
-            AttachmentCount = I;
-            break;
-        }
+int PushStagingBuffer(context *C, VkBuffer Buffer, VmaAllocation Allocation) {
+    if(ArrayRequireRoom(&C->RecordingStagingBuffers, 1, sizeof(staging_buffer), INITIAL_STAGING_BUFFER_CAPACITY)) {
+        return 1;
     }
-    for(u32 I = AttachmentCount; I < Object->Framebuffer.ColorAttachmentCapacity; ++I) {
-        // NOTE(blackedout): Bindings to GL_COLOR_ATTACHMENTi must be dense, skipping a binding entirely is currently not allowed
-        Assert(Object->Framebuffer.ColorAttachments[I].Rbo == 0);
+    staging_buffer Staging = {
+        .Buffer = Buffer,
+        .Allocation = Allocation,
+    };
+    ArrayData(staging_buffer, C->RecordingStagingBuffers)[C->RecordingStagingBuffers.Count++] = Staging;
+    return 0;
+}
+
+// NOTE(blackedout): Hands the written range over to the graphics family. Only needed if uploads run on a dedicated
+// transfer family, since buffers are created with exclusive sharing unless there is async compute (see `SetBufferSharing`).
+// Whole buffer uploads discard the old contents, so the transfer family doesn't have to acquire them first.
+int ReleaseUploadedBuffer(context *C, VkCommandBuffer TransferCommandBuffer, VkBuffer Buffer, u64 Offset, u64 ByteCount) {
+    u32 TransferFamilyIndex = C->DeviceInfo.QueueFamilyIndices[queue_TRANSFER];
+    u32 GraphicsFamilyIndex = C->DeviceInfo.QueueFamilyIndices[queue_GRAPHICS];
+    if(TransferFamilyIndex == GraphicsFamilyIndex || C->DeviceInfo.HasAsyncCompute) {
+        return 0;
+    }
+    if(ArrayRequireRoom(&C->PendingAcquireBarriers, 1, sizeof(VkBufferMemoryBarrier), INITIAL_ACQUIRE_BARRIER_CAPACITY)) {
+        return 1;
     }
 
-    VkAttachmentDescription DefaultAttachmentDescription = {
-        .flags = 0,
-        .format = C->DeviceInfo.InitialSurfaceFormat.format,
-        .samples = 1,
-        .loadOp = VK_ATTACHMENT_LOAD_OP_CLEAR,
-        .storeOp = VK_ATTACHMENT_STORE_OP_STORE,
-        .stencilLoadOp = VK_ATTACHMENT_LOAD_OP_DONT_CARE,
-        .stencilStoreOp = VK_ATTACHMENT_STORE_OP_DONT_CARE,
-        .initialLayout = VK_IMAGE_LAYOUT_UNDEFINED,
-        .finalLayout = VK_IMAGE_LAYOUT_PRESENT_SRC_KHR,
+    VkBufferMemoryBarrier Barrier = {
+        .sType = VK_STRUCTURE_TYPE_BUFFER_MEMORY_BARRIER,
+        .pNext = 0,
+        .srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT,
+        .dstAccessMask = 0,
+        .srcQueueFamilyIndex = TransferFamilyIndex,
+        .dstQueueFamilyIndex = GraphicsFamilyIndex,
+        .buffer = Buffer,
+        .offset = Offset,
+        .size = ByteCount,
     };
+    vkCmdPipelineBarrier(TransferCommandBuffer, VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT, 0, 0, 0, 1, &Barrier, 0, 0);
 
-    AttachmentDescriptions = calloc(AttachmentCount, sizeof(VkAttachmentDescription));
-    if(AttachmentDescriptions == 0) {
-        goto label_Error;
+    // NOTE(blackedout): The matching acquire has the same ownership transfer parameters, only the access masks differ
+    Barrier.srcAccessMask = 0;
+    Barrier.dstAccessMask = TRANSFER_BATCH_CONSUMER_ACCESS;
+    ArrayData(VkBufferMemoryBarrier, C->PendingAcquireBarriers)[C->PendingAcquireBarriers.Count++] = Barrier;
+    return 0;
+}
+
+// NOTE(blackedout): Must be recorded outside of a render pass into a graphics command buffer that is submitted after
+// (and, unless the batch was flushed, waits on the semaphore of) every batch that released the pending buffers.
+void AcquireUploadedBuffers(context *C, VkCommandBuffer GraphicsCommandBuffer) {
+    if(C->PendingAcquireBarriers.Count == 0) {
+        return;
     }
-    for(u32 I = 0; I < AttachmentCount; ++I) {
-        AttachmentDescriptions[I] = DefaultAttachmentDescription;
+    // NOTE(blackedout): The source stages match the semaphore wait stages, which chains the acquire to the release
+    vkCmdPipelineBarrier(GraphicsCommandBuffer, TRANSFER_BATCH_CONSUMER_STAGES, TRANSFER_BATCH_CONSUMER_STAGES, 0, 0, 0, (u32)C->PendingAcquireBarriers.Count, ArrayData(VkBufferMemoryBarrier, C->PendingAcquireBarriers), 0, 0);
+    C->PendingAcquireBarriers.Count = 0;
+}
+
+static int SubmitRecordingTransferBatch(context *C, VkQueue Queue, VkSemaphore SignalSemaphore) {
+    VkCommandBuffer TransferCommandBuffer = C->CommandBuffers[command_buffer_TRANSFER];
+    C->IsTransferBatchRecording = 0;
+    VulkanCheckGoto(vkEndCommandBuffer(TransferCommandBuffer), label_Error);
+
+    // NOTE(blackedout): With async compute, the batch also signals the timeline that dispatches wait on
+    VkSemaphore SignalSemaphores[2];
+    u64 SignalValues[2] = {0};
+    u32 SignalSemaphoreCount = 0;
+    if(SignalSemaphore != VK_NULL_HANDLE) {
+        SignalSemaphores[SignalSemaphoreCount++] = SignalSemaphore;
     }
-    
-    ArrayRequireRoom(&C->TmpSubpasses, Object->Framebuffer.Subpasses.Count, sizeof(VkSubpassDescription), 1);
-    for(u32 I = 0; I < Object->Framebuffer.Subpasses.Count; ++I) {
-        render_pass_state_subpass *SrcSubpass = ArrayData(render_pass_state_subpass, Object->Framebuffer.Subpasses) + I;
-        VkSubpassDescription *DstSubpass = ArrayData(VkSubpassDescription, C->TmpSubpasses) + I;
-        VkSubpassDescription SubpassDescription = {
-            .flags = 0,
-            .pipelineBindPoint = VK_PIPELINE_BIND_POINT_GRAPHICS,
-            .inputAttachmentCount = 0,
-            .pInputAttachments = 0,
-            .colorAttachmentCount = SrcSubpass->ColorAttachmentCount,
-            .pColorAttachments = ArrayData(VkAttachmentReference, Object->Framebuffer.SubpassAttachments) + SrcSubpass->BaseIndex,
-            .pResolveAttachments = 0,
-            .pDepthStencilAttachment = 0,
-            .preserveAttachmentCount = 0,
-            .pPreserveAttachments = 0,
-        };
-        *DstSubpass = SubpassDescription;
+    if(C->DeviceInfo.HasAsyncCompute) {
+        C->TransferTimelineValue = ++C->ComputeTimelineValue;
+        SignalValues[SignalSemaphoreCount] = C->TransferTimelineValue;
+        SignalSemaphores[SignalSemaphoreCount++] = C->ComputeTimeline;
     }
-
-    VkRenderPassCreateInfo RenderPassCreateInfo = {
-        .sType = VK_STRUCTURE_TYPE_RENDER_PASS_CREATE_INFO,
+    VkTimelineSemaphoreSubmitInfoKHR TimelineSubmitInfo = {
+        .sType = VK_STRUCTURE_TYPE_TIMELINE_SEMAPHORE_SUBMIT_INFO_KHR,
         .pNext = 0,
-        .flags = 0,
-        .attachmentCount = AttachmentCount,
-        .pAttachments = AttachmentDescriptions,
-        .subpassCount = Object->Framebuffer.Subpasses.Count,
-        .pSubpasses = ArrayData(VkSubpassDescription, C->TmpSubpasses),
-        .dependencyCount = 0,
-        .pDependencies = 0,
+        .waitSemaphoreValueCount = 0,
+        .pWaitSemaphoreValues = 0,
+        .signalSemaphoreValueCount = SignalSemaphoreCount,
+        .pSignalSemaphoreValues = SignalValues,
     };
+    VkSubmitInfo SubmitInfo = {
+        .sType = VK_STRUCTURE_TYPE_SUBMIT_INFO,
+        .pNext = C->DeviceInfo.HasAsyncCompute ? &TimelineSubmitInfo : 0,
+        .waitSemaphoreCount = 0,
+        .pWaitSemaphores = 0,
+        .pWaitDstStageMask = 0,
+        .commandBufferCount = 1,
+        .pCommandBuffers = &TransferCommandBuffer,
+        .signalSemaphoreCount = SignalSemaphoreCount,
+        .pSignalSemaphores = SignalSemaphores,
+    };
+    VulkanCheckGoto(vkQueueSubmit(Queue, 1, &SubmitInfo, C->Fences[fence_TRANSFER]), label_Error);
+
+    // NOTE(blackedout): The in flight list is empty here, since recording the batch recycled the previous one
+    Assert(C->IsTransferBatchInFlight == 0 && C->InFlightStagingBuffers.Count == 0);
+    array Tmp = C->InFlightStagingBuffers;
+    C->InFlightStagingBuffers = C->RecordingStagingBuffers;
+    C->RecordingStagingBuffers = Tmp;
+    C->StagingRing.InFlightHead = C->StagingRing.Head;
+    C->IsTransferBatchInFlight = 1;
+    return 0;
 
-    VulkanCheckGoto(vkCreateRenderPass(C->Device, &RenderPassCreateInfo, 0, &Object->Framebuffer.RenderPass), label_Error);
+label_Error:
+    return 1;
+}
 
-    u32 FramebufferCount = 0;
-    VkImageView *ImageViews = 0;
-    VkFramebuffer *Framebuffers = 0;
-    VkExtent2D Extent = { .width = C->DeviceInfo.Properties.limits.maxFramebufferWidth, .height = C->DeviceInfo.Properties.limits.maxFramebufferWidth };
-    if(Fbo == 0) {
-        ImageViews = C->SwapchainImageViews;
-        Framebuffers = C->SwapchainFramebuffers;
-        FramebufferCount = C->SwapchainImageCount;
-        Extent = C->DeviceInfo.SurfaceCapabilities.currentExtent;
-    } else {
-        FramebufferCount = 1;
-        Framebuffers = &Object->Framebuffer.Framebuffer;
-        ContiguousImageViews = calloc(Object->Framebuffer.ColorAttachmentCapacity, sizeof(VkImageView));
-        for(u32 I = 0; I < Object->Framebuffer.ColorAttachmentCapacity; ++I) {
-            object *ObjectR = 0;
-            Assert(0 == CheckObjectTypeGet(C, Object->Framebuffer.ColorAttachments[I].Rbo, object_RENDERBUFFER, &ObjectR));
-            ContiguousImageViews[I] = ObjectR->Renderbuffer.ImageView;
-            Extent.width = Min(Extent.width, ObjectR->Renderbuffer.Extent.width);
-            Extent.height = Min(Extent.height, ObjectR->Renderbuffer.Extent.height);
-        }
-        ImageViews = ContiguousImageViews;
+// NOTE(blackedout): `OutSignalSemaphore` is set to the semaphore graphics work has to wait on, or VK_NULL_HANDLE if nothing was recorded
+int SubmitTransferBatch(context *C, VkQueue Queue, VkSemaphore *OutSignalSemaphore) {
+    *OutSignalSemaphore = VK_NULL_HANDLE;
+    if(C->IsTransferBatchRecording == 0) {
+        return 0;
     }
-    Object->Framebuffer.Extent = Extent;
 
-    for(u32 I = 0; I < FramebufferCount; ++I) {
-        VkFramebufferCreateInfo FramebufferCreateInfo = {
-            .sType = VK_STRUCTURE_TYPE_FRAMEBUFFER_CREATE_INFO,
-            .pNext = 0,
-            .flags = 0,
-            .renderPass = Object->Framebuffer.RenderPass,
-            .attachmentCount = 1,
-            .pAttachments = C->SwapchainImageViews + I,
-            .width = Extent.width,
-            .height = Extent.height,
-            .layers = 1,
-        };
+    VkSemaphore SignalSemaphore = C->Semaphores[semaphore_TRANSFER_COMPLETE];
+    if(SubmitRecordingTransferBatch(C, Queue, SignalSemaphore)) {
+        return 1;
+    }
+    *OutSignalSemaphore = SignalSemaphore;
+    return 0;
+}
 
-        VulkanCheckGoto(vkCreateFramebuffer(C->Device, &FramebufferCreateInfo, 0, Framebuffers + I), label_Error);
+// NOTE(blackedout): Records a copy of `Data` into `Buffer` (owned by the graphics queue) into the current transfer batch
+int RecordBufferUpload(context *C, VkBuffer Buffer, u64 Offset, const void *Data, u64 ByteCount) {
+    staging_allocation Staging = {0};
+    VkCommandBuffer TransferCommandBuffer = VK_NULL_HANDLE;
+    if(AllocateStaging(C, ByteCount, 4, 0, &Staging) || BeginTransferBatch(C, &TransferCommandBuffer)) {
+        return 1;
     }
+    memcpy(Staging.Mapped, Data, ByteCount);
 
-    printf("Created RenderPass and Framebuffer\n");
+    VkBufferCopy Copy = {
+        .srcOffset = Staging.Offset,
+        .dstOffset = Offset,
+        .size = ByteCount,
+    };
+    vkCmdCopyBuffer(TransferCommandBuffer, Staging.Buffer, Buffer, 1, &Copy);
+    return ReleaseUploadedBuffer(C, TransferCommandBuffer, Buffer, Offset, ByteCount);
+}
 
-    ArrayRequireRoom(&Object->Framebuffer.StoredSubpasses, Object->Framebuffer.Subpasses.Count, sizeof(render_pass_state_subpass), 2);
-    ArrayRequireRoom(&Object->Framebuffer.StoredSubpassAttachments, Object->Framebuffer.SubpassAttachments.Count, sizeof(VkAttachmentReference), 2);
-    Object->Framebuffer.StoredSubpasses.Count = Object->Framebuffer.Subpasses.Count;
-    Object->Framebuffer.StoredSubpassAttachments.Count = Object->Framebuffer.SubpassAttachments.Count;
-    memcpy(Object->Framebuffer.StoredSubpasses.Data, Object->Framebuffer.Subpasses.Data, sizeof(render_pass_state_subpass)*Object->Framebuffer.Subpasses.Count);
-    memcpy(Object->Framebuffer.StoredSubpassAttachments.Data, Object->Framebuffer.SubpassAttachments.Data, sizeof(VkAttachmentReference)*Object->Framebuffer.SubpassAttachments.Count);
-    ArrayClear(&Object->Framebuffer.Subpasses, sizeof(render_pass_state_subpass));
-    ArrayClear(&Object->Framebuffer.SubpassAttachments, sizeof(VkAttachmentReference));
+// NOTE(blackedout): Last resort if the recording batch alone fills the staging ring at its maximum size.
+// The batch is executed right away, nothing has to wait on it afterwards.
+static int FlushTransferBatch(context *C) {
+    if(C->IsTransferBatchRecording == 0) {
+        return 0;
+    }
+    VkQueue Queue = VK_NULL_HANDLE;
+    vkGetDeviceQueue(C->Device, C->DeviceInfo.QueueFamilyIndices[queue_TRANSFER], 0, &Queue);
+    if(SubmitRecordingTransferBatch(C, Queue, VK_NULL_HANDLE)) {
+        return 1;
+    }
+    return RecycleTransferBatch(C, 1);
+}
+
+static int CreateStagingBuffer(context *C, u64 ByteCount, VkBuffer *OutBuffer, VmaAllocation *OutAllocation, void **OutMapped) {
+    VkBufferCreateInfo BufferCreateInfo = {
+        .sType = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO,
+        .pNext = 0,
+        .flags = 0,
+        .size = ByteCount,
+        .usage = VK_BUFFER_USAGE_TRANSFER_SRC_BIT,
+        .sharingMode = VK_SHARING_MODE_EXCLUSIVE,
+        .queueFamilyIndexCount = 1,
+        .pQueueFamilyIndices = &C->DeviceInfo.QueueFamilyIndices[queue_TRANSFER],
+    };
+    VmaAllocationCreateInfo AllocationCreateInfo = {
+        .flags = VMA_ALLOCATION_CREATE_HOST_ACCESS_SEQUENTIAL_WRITE_BIT | VMA_ALLOCATION_CREATE_MAPPED_BIT,
+        .usage = VMA_MEMORY_USAGE_AUTO,
+        .requiredFlags = VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT,
+        .preferredFlags = 0,
+        .memoryTypeBits = 0,
+        .pool = 0,
+        .pUserData = 0,
+        .priority = 0,
+    };
+    VmaAllocationInfo AllocationInfo = {0};
+    VulkanCheckGoto(vmaCreateBuffer(C->Allocator, &BufferCreateInfo, &AllocationCreateInfo, OutBuffer, OutAllocation, &AllocationInfo), label_Error);
+    *OutMapped = AllocationInfo.pMappedData;
+    return 0;
 
-    int Result = 0;
-    goto label_Exit;
 label_Error:
-    Result = 1;
-label_Exit:
-    free(ContiguousImageViews);
-    free(AttachmentDescriptions);
-    return Result;
+    return 1;
 }
 
-int PotentiallySaveSubpass(context *C, u32 *OutSubpassIndex) {
-    object *Object = 0;
-    Assert(0 == CheckObjectTypeGet(C, C->BoundDrawFbo, object_FRAMEBUFFER, &Object));
-
-    if(Object->Framebuffer.Subpasses.Count) {
-        // NOTE(blackedout): Compare previous subpass to current
-        u32 PrevIndex = Object->Framebuffer.Subpasses.Count - 1;
-        render_pass_state_subpass *PrevSubpass = ArrayData(render_pass_state_subpass, Object->Framebuffer.Subpasses) + PrevIndex;
-        if(PrevSubpass->ColorAttachmentCount != Object->Framebuffer.ColorAttachmentRange) {
-            goto label_NoMatch;
-        }
+// NOTE(blackedout): Replaces the ring with a bigger one. The old one stays alive until the recording batch that might still
+// reference it is done. Must only be called while nothing is in flight.
+static int GrowStagingRing(context *C, u64 MinByteCount) {
+    staging_ring *Ring = &C->StagingRing;
+    u64 MaxByteCount = C->MaxStagingByteCount ? C->MaxStagingByteCount : DEFAULT_MAX_STAGING_RING_BYTE_COUNT;
+    u64 NewByteCount = Ring->ByteCount ? 2*Ring->ByteCount : INITIAL_STAGING_RING_BYTE_COUNT;
+    while(NewByteCount < MinByteCount) {
+        NewByteCount *= 2;
+    }
+    NewByteCount = Min(NewByteCount, MaxByteCount);
 
-        VkAttachmentReference *ColorRefs = ArrayData(VkAttachmentReference, Object->Framebuffer.SubpassAttachments) + (u32)PrevSubpass->ColorAttachmentCount;
-        for(u32 I = 0; I < Object->Framebuffer.ColorAttachmentRange; ++I) {
-            framebuffer_attachment *Attachment = Object->Framebuffer.ColorAttachments + I;
-            if(Attachment->IsDrawBuffer) {
-                if(ColorRefs[I].attachment != I) {
-                    goto label_NoMatch;
-                }
-            } else {
-                if(ColorRefs[I].attachment != VK_ATTACHMENT_UNUSED) {
-                    goto label_NoMatch;
-                }
+    staging_ring NewRing = {0};
+    void *Mapped = 0;
+    if(CreateStagingBuffer(C, NewByteCount, &NewRing.Buffer, &NewRing.Allocation, &Mapped)) {
+        return 1;
+    }
+    NewRing.Mapped = Mapped;
+    NewRing.ByteCount = NewByteCount;
+
+    if(Ring->Buffer != VK_NULL_HANDLE) {
+        if(Ring->Head != Ring->Tail) {
+            if(PushStagingBuffer(C, Ring->Buffer, Ring->Allocation)) {
+                vmaDestroyBuffer(C->Allocator, NewRing.Buffer, NewRing.Allocation);
+                return 1;
             }
+        } else {
+            vmaDestroyBuffer(C->Allocator, Ring->Buffer, Ring->Allocation);
         }
+    }
+    *Ring = NewRing;
+    return 0;
+}
 
-        // NOTE(blackedout): Match, do nothing
-        *OutSubpassIndex = PrevIndex;
-        return 0;
+static int AllocateDedicatedStaging(context *C, u64 ByteCount, int IsStreamed, staging_allocation *OutAllocation) {
+    staging_allocation Allocation = {0};
+    VmaAllocation VmaAllocation = VK_NULL_HANDLE;
+    if(CreateStagingBuffer(C, ByteCount, &Allocation.Buffer, &VmaAllocation, &Allocation.Mapped)) {
+        return 1;
     }
-label_NoMatch:;
+    int IsPushFailed = IsStreamed ? RetireBufferMemory(C, Allocation.Buffer, VmaAllocation) : PushStagingBuffer(C, Allocation.Buffer, VmaAllocation);
+    if(IsPushFailed) {
+        vmaDestroyBuffer(C->Allocator, Allocation.Buffer, VmaAllocation);
+        return 1;
+    }
+    *OutAllocation = Allocation;
+    return 0;
+}
 
-    // NOTE(blackedout): Must save
-    u32 AttachmentStartIndex = Object->Framebuffer.SubpassAttachments.Count;
-    ArrayRequireRoom(&Object->Framebuffer.SubpassAttachments, Object->Framebuffer.ColorAttachmentRange, sizeof(VkAttachmentReference), 2);
+// NOTE(blackedout): Returns persistently mapped memory the caller writes to and copies from (in the current transfer batch).
+// If the ring is full, the oldest batch in flight is waited on, then the ring grows up to its maximum size. Uploads that
+// don't even fit into the maximum size get a dedicated staging buffer.
+// Streamed allocations are copied from by the command stream of the frame instead, the ring keeps them until the frame is done
+// (see `ReleaseStreamStaging`). It can't grow or start over until then, so if it is full, a dedicated buffer is used as well.
+int AllocateStaging(context *C, u64 ByteCount, u64 Alignment, int IsStreamed, staging_allocation *OutAllocation) {
+    staging_ring *Ring = &C->StagingRing;
+    u64 MaxByteCount = C->MaxStagingByteCount ? C->MaxStagingByteCount : DEFAULT_MAX_STAGING_RING_BYTE_COUNT;
+    if(ByteCount > MaxByteCount) {
+        return AllocateDedicatedStaging(C, ByteCount, IsStreamed, OutAllocation);
+    }
 
-    VkAttachmentReference *References = ArrayData(VkAttachmentReference, Object->Framebuffer.SubpassAttachments) + AttachmentStartIndex;
-    for(u32 I = 0; I < Object->Framebuffer.ColorAttachmentRange; ++I) {
-        framebuffer_attachment *Attachment = Object->Framebuffer.ColorAttachments + I;
-        if(Attachment->IsDrawBuffer) {
-            References[I].attachment = I;
-            References[I].layout = VK_IMAGE_LAYOUT_GENERAL;
+    while(1) {
+        if(Ring->ByteCount >= ByteCount) {
+            u64 Head = Alignment*((Ring->Head + Alignment - 1)/Alignment);
+            u64 Offset = Head % Ring->ByteCount;
+            if(Offset + ByteCount > Ring->ByteCount) {
+                // NOTE(blackedout): Doesn't fit before the end, skip to the start
+                Head += Ring->ByteCount - Offset;
+                Offset = 0;
+            }
+            if(Head + ByteCount - Ring->Tail <= Ring->ByteCount) {
+                if(IsStreamed && Ring->HasStreamRanges == 0) {
+                    Ring->StreamTail = Head;
+                    Ring->HasStreamRanges = 1;
+                }
+                Ring->Head = Head + ByteCount;
+                OutAllocation->Buffer = Ring->Buffer;
+                OutAllocation->Offset = Offset;
+                OutAllocation->Mapped = Ring->Mapped + Offset;
+                return 0;
+            }
+        }
+
+        if(C->IsTransferBatchInFlight) {
+            if(RecycleTransferBatch(C, 1)) {
+                return 1;
+            }
+        } else if(Ring->ByteCount < MaxByteCount && Ring->HasStreamRanges == 0) {
+            if(GrowStagingRing(C, ByteCount)) {
+                return 1;
+            }
+        } else if(C->IsTransferBatchRecording) {
+            if(FlushTransferBatch(C)) {
+                return 1;
+            }
+        } else if(Ring->HasStreamRanges) {
+            return AllocateDedicatedStaging(C, ByteCount, IsStreamed, OutAllocation);
         } else {
-            References[I].attachment = VK_ATTACHMENT_UNUSED;
+            // NOTE(blackedout): Nothing references the ring anymore, start over at the beginning
+            Ring->Head = 0;
+            Ring->Tail = 0;
         }
     }
-    Object->Framebuffer.SubpassAttachments.Count += Object->Framebuffer.ColorAttachmentRange;
+}
 
-    ArrayRequireRoom(&Object->Framebuffer.Subpasses, 1, sizeof(VkSubpassDescription), 1);
-    render_pass_state_subpass *SubpassDescriptions = ArrayData(render_pass_state_subpass, Object->Framebuffer.Subpasses);
-    u32 NewSubpassIndex = Object->Framebuffer.Subpasses.Count++;
-    SubpassDescriptions[NewSubpassIndex].ColorAttachmentCount = Object->Framebuffer.ColorAttachmentRange;
-    SubpassDescriptions[NewSubpassIndex].BaseIndex = AttachmentStartIndex;
+// NOTE(blackedout): Must be called once the graphics work of the frame is done. Streamed ranges past the last submitted batch
+// are then referenced by nothing, so the next batch done frees them.
+void ReleaseStreamStaging(context *C) {
+    staging_ring *Ring = &C->StagingRing;
+    if(Ring->HasStreamRanges == 0) {
+        return;
+    }
+    Ring->HasStreamRanges = 0;
+    if(C->IsTransferBatchRecording == 0) {
+        Ring->InFlightHead = Ring->Head;
+    }
+    if(C->IsTransferBatchInFlight == 0) {
+        Ring->Tail = Ring->InFlightHead;
+    }
+}
 
-    *OutSubpassIndex = NewSubpassIndex;
-    if(NewSubpassIndex == 0) {
-        command Command = {
-            .Type = command_BEGIN_RENDER_PASS,
-            .BeginRenderPass = {
-                .Fbo = C->BoundDrawFbo
-            },
-        };
-        PushCommand(C, Command);
+// NOTE(blackedout): MARK: Immediate commands
+// For the rare cases that need the device to do work before a GL call can return. The commands are recorded into
+// `command_buffer_GRAPHICS2` and executed on the graphics queue right away. Pending uploads are submitted first,
+// so the commands see their results.
+
+int BeginImmediateCommands(context *C, VkCommandBuffer *OutCommandBuffer) {
+    VkCommandBuffer CommandBuffer = C->CommandBuffers[command_buffer_GRAPHICS2];
+    VkCommandBufferBeginInfo BeginInfo = {
+        .sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO,
+        .pNext = 0,
+        .flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT,
+        .pInheritanceInfo = 0,
+    };
+    VulkanCheckGoto(vkBeginCommandBuffer(CommandBuffer, &BeginInfo), label_Error);
+    // NOTE(blackedout): Every release recorded so far is submitted before this command buffer
+    AcquireUploadedBuffers(C, CommandBuffer);
+
+    *OutCommandBuffer = CommandBuffer;
+    return 0;
+
+label_Error:
+    return 1;
+}
+
+int SubmitImmediateCommands(context *C) {
+    VkCommandBuffer CommandBuffer = C->CommandBuffers[command_buffer_GRAPHICS2];
+    VulkanCheckGoto(vkEndCommandBuffer(CommandBuffer), label_Error);
+
+    VkQueue GraphicsQueue, TransferQueue;
+    vkGetDeviceQueue(C->Device, C->DeviceInfo.QueueFamilyIndices[queue_GRAPHICS], 0, &GraphicsQueue);
+    vkGetDeviceQueue(C->Device, C->DeviceInfo.QueueFamilyIndices[queue_TRANSFER], 0, &TransferQueue);
+
+    VkSemaphore TransferSemaphore = VK_NULL_HANDLE;
+    if(SubmitTransferBatch(C, TransferQueue, &TransferSemaphore)) {
+        goto label_Error;
+    }
+
+    VkPipelineStageFlags WaitStage = TRANSFER_BATCH_CONSUMER_STAGES;
+    VkSubmitInfo SubmitInfo = {
+        .sType = VK_STRUCTURE_TYPE_SUBMIT_INFO,
+        .pNext = 0,
+        .waitSemaphoreCount = TransferSemaphore == VK_NULL_HANDLE ? 0 : 1,
+        .pWaitSemaphores = &TransferSemaphore,
+        .pWaitDstStageMask = &WaitStage,
+        .commandBufferCount = 1,
+        .pCommandBuffers = &CommandBuffer,
+        .signalSemaphoreCount = 0,
+        .pSignalSemaphores = 0,
+    };
+    // NOTE(blackedout): Only these commands are waited on, the queue may still run other work
+    VulkanCheckGoto(vkQueueSubmit(GraphicsQueue, 1, &SubmitInfo, C->Fences[fence_IMMEDIATE]), label_Error);
+    VulkanCheckGoto(vkWaitForFences(C->Device, 1, C->Fences + fence_IMMEDIATE, VK_TRUE, UINT64_MAX), label_Error);
+    VulkanCheckGoto(vkResetFences(C->Device, 1, C->Fences + fence_IMMEDIATE), label_Error);
+    if(RecycleTransferBatch(C, 1)) {
+        goto label_Error;
+    }
+    VulkanCheckGoto(vkResetCommandBuffer(CommandBuffer, 0), label_Error);
+    return 0;
+
+label_Error:
+    return 1;
+}
+
+// NOTE(blackedout): MARK: Buffer memory
+// Buffers start out in device local memory that is written through the transfer batch or, for partial updates, by transfer
+// commands at their position in the command stream. Mapping moves a buffer into persistently mapped host visible memory,
+// which is written in place from then on. Memory that commands of the current frame may still read is never overwritten
+// (unless unsynchronized), it is renamed instead: the buffer gets fresh memory from its pool of copies and the old memory
+// rejoins the pool once the frame is done.
+
+// NOTE(blackedout): With async compute, dispatches on the compute family access the same buffers as the graphics family.
+// Concurrent sharing avoids ownership transfers between them, which would otherwise be needed in both directions every frame.
+static void SetBufferSharing(context *C, VkBufferCreateInfo *CreateInfo) {
+    if(C->DeviceInfo.HasAsyncCompute) {
+        CreateInfo->sharingMode = VK_SHARING_MODE_CONCURRENT;
+        CreateInfo->queueFamilyIndexCount = C->DeviceInfo.SharedQueueFamilyIndexCount;
+        CreateInfo->pQueueFamilyIndices = C->DeviceInfo.SharedQueueFamilyIndices;
+    }
+}
+
+static int IsBufferInUse(context *C, object *Object) {
+    return Object->Buffer.LastUseFrame == C->SwapCounter + 1;
+}
+
+// NOTE(blackedout): Writes recorded in the stream go into memory that no command of the frame reads without renaming it,
+// later writes into the same range are ordered after them anyway
+static int IsBufferRead(context *C, object *Object) {
+    return Object->Buffer.LastReadFrame == C->SwapCounter + 1;
+}
+
+static void MarkBufferRead(context *C, object *Object) {
+    Object->Buffer.LastUseFrame = C->SwapCounter + 1;
+    Object->Buffer.LastReadFrame = C->SwapCounter + 1;
+}
+
+static void DestroyBufferCopy(context *C, buffer_copy *Copy) {
+    if(Copy->VirtualAllocation != VK_NULL_HANDLE) {
+        buffer_pool *Pool = ArrayData(buffer_pool, C->BufferPools) + Copy->PoolIndex;
+        vmaVirtualFree(Pool->Block, Copy->VirtualAllocation);
     } else {
-        command Command = {
-            .Type = command_NEXT_SUBPASS,
-            .NextSubpass = {
-                .SubpassIndex = NewSubpassIndex
-            },
-        };
-        PushCommand(C, Command);
+        vmaDestroyBuffer(C->Allocator, Copy->Buffer, Copy->Allocation);
     }
+}
 
+static int RetireBufferCopy(context *C, buffer_copy Copy) {
+    if(ArrayRequireRoom(&C->RetiredBuffers, 1, sizeof(buffer_copy), INITIAL_RETIRED_BUFFER_CAPACITY)) {
+        return 1;
+    }
+    ArrayData(buffer_copy, C->RetiredBuffers)[C->RetiredBuffers.Count++] = Copy;
     return 0;
 }
 
-// NOTE(blackedout): See https://docs.vulkan.org/spec/latest/chapters/limits.html (2025-11-13)
-static pipeline_state_info_params PipelineStateInfoParams[] = {
-#define MakeStaticEntry(EnumType, StateType) [(EnumType)] = { sizeof(StateType), ~((u32)0) }
-#define MakeDynamicEntry(EnumType, StateType, LimitsByteOffset) [(EnumType)] = { sizeof(StateType), (u32)(LimitsByteOffset) }
+int RetireBufferMemory(context *C, VkBuffer Buffer, VmaAllocation Allocation) {
+    buffer_copy Retired = {
+        .Buffer = Buffer,
+        .Allocation = Allocation,
+    };
+    return RetireBufferCopy(C, Retired);
+}
 
-    MakeStaticEntry(pipeline_state_HEADER, pipeline_state_header),
-    MakeStaticEntry(pipeline_state_CLEAR_COLOR, pipeline_state_clear_color),
-    MakeStaticEntry(pipeline_state_CLEAR_DEPTH, pipeline_state_clear_depth),
-    MakeStaticEntry(pipeline_state_CLEAR_STENCIL, pipeline_state_clear_stencil),
-    MakeDynamicEntry(pipeline_state_VIEWPORT, pipeline_state_viewport, offsetof(VkPhysicalDeviceLimits,  maxViewports)),
-    MakeDynamicEntry(pipeline_state_SCISSOR, pipeline_state_scissor, offsetof(VkPhysicalDeviceLimits,  maxViewports)),
-    MakeStaticEntry(pipeline_state_FRAMEBUFFER, pipeline_state_framebuffer),
-    MakeDynamicEntry(pipeline_state_DRAW_BUFFERS, pipeline_state_draw_buffer, offsetof(VkPhysicalDeviceLimits, maxColorAttachments)),
-    //MakeStaticEntry(pipeline_state_VERTEX_ARRAY, pipeline_state_vertex_array),
-    MakeDynamicEntry(pipeline_state_VERTEX_INPUT_ATTRIBUTES, pipeline_state_vertex_input_attribute, offsetof(VkPhysicalDeviceLimits, maxVertexInputAttributes)),
-    MakeDynamicEntry(pipeline_state_VERTEX_INPUT_BINDINGS, pipeline_state_vertex_input_binding, offsetof(VkPhysicalDeviceLimits, maxVertexInputBindings)),
-    MakeStaticEntry(pipeline_state_PROGRAM, pipeline_state_program),
-    MakeStaticEntry(pipeline_state_PRIMITIVE_TYPE, pipeline_state_primitive_type),
-    MakeDynamicEntry(pipeline_state_FLAGS, pipeline_state_flags, pipeline_state_COUNT),
+// NOTE(blackedout): Must only be called once the device is done with the frame
+void DestroyRetiredBuffers(context *C) {
+    for(u64 I = 0; I < C->RetiredBuffers.Count; ++I) {
+        DestroyBufferCopy(C, ArrayData(buffer_copy, C->RetiredBuffers) + I);
+    }
+    C->RetiredBuffers.Count = 0;
+}
 
-#undef MakeDynamicEntry
-#undef MakeStaticEntry
-};
-StaticAssert(ArrayCount(PipelineStateInfoParams) == pipeline_state_COUNT);
+// NOTE(blackedout): Small device local buffers share big pool buffers, one kind per usage. Their ranges are managed by
+// virtual blocks (two-level segregated fit), so a buffer costs neither a device allocation nor a VkBuffer of its own.
+static u64 GetBufferPoolAlignment(context *C, VkBufferUsageFlags Usage) {
+    VkPhysicalDeviceLimits *Limits = &C->DeviceInfo.Properties.limits;
+    u64 Alignment = MIN_BUFFER_POOL_ALIGNMENT;
+    if(Usage & VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT) {
+        Alignment = Max(Alignment, Limits->minUniformBufferOffsetAlignment);
+    }
+    if(Usage & VK_BUFFER_USAGE_STORAGE_BUFFER_BIT) {
+        Alignment = Max(Alignment, Limits->minStorageBufferOffsetAlignment);
+    }
+    if(Usage & (VK_BUFFER_USAGE_UNIFORM_TEXEL_BUFFER_BIT | VK_BUFFER_USAGE_STORAGE_TEXEL_BUFFER_BIT)) {
+        Alignment = Max(Alignment, Limits->minTexelBufferOffsetAlignment);
+    }
+    return Alignment;
+}
 
-static void SetPipelineStateInfos(pipeline_state_info *Infos, const VkPhysicalDeviceLimits *Limits, u32 *OutByteCount) {
-    u32 ByteOffset = 0;
-    for(u32 I = 0; I < ArrayCount(PipelineStateInfoParams); ++I) {
-        pipeline_state_info_params Params = PipelineStateInfoParams[I];
-        u32 InstanceCount = 1;
-        if(Params.LimitsByteOffset != (~((u32)0))) {
-            InstanceCount = *(uint32_t *)(((const u8 *)Limits) + Params.LimitsByteOffset);
-        }
+static int CreateBufferPool(context *C, VkBufferUsageFlags Usage, u32 *OutPoolIndex) {
+    if(ArrayRequireRoom(&C->BufferPools, 1, sizeof(buffer_pool), INITIAL_BUFFER_POOL_CAPACITY)) {
+        return 1;
+    }
+    VkBufferCreateInfo BufferCreateInfo = {
+        .sType = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO,
+        .pNext = 0,
+        .flags = 0,
+        .size = BUFFER_POOL_BYTE_COUNT,
+        .usage = VK_BUFFER_USAGE_TRANSFER_SRC_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT | Usage,
+        .sharingMode = VK_SHARING_MODE_EXCLUSIVE,
+        .queueFamilyIndexCount = 1,
+        .pQueueFamilyIndices = &C->DeviceInfo.QueueFamilyIndices[queue_GRAPHICS],
+    };
+    SetBufferSharing(C, &BufferCreateInfo);
+    VmaAllocationCreateInfo AllocationCreateInfo = {
+        .flags = 0,
+        .usage = VMA_MEMORY_USAGE_AUTO,
+        .requiredFlags = VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT,
+        .preferredFlags = 0,
+        .memoryTypeBits = 0,
+        .pool = 0,
+        .pUserData = 0,
+        .priority = 0,
+    };
+    VmaVirtualBlockCreateInfo BlockCreateInfo = {
+        .size = BUFFER_POOL_BYTE_COUNT,
+        .flags = 0,
+        .pAllocationCallbacks = 0,
+    };
+    buffer_pool Pool = {
+        .Usage = Usage,
+        .Alignment = GetBufferPoolAlignment(C, Usage),
+    };
+    VulkanCheckGoto(vmaCreateBuffer(C->Allocator, &BufferCreateInfo, &AllocationCreateInfo, &Pool.Buffer, &Pool.Allocation, 0), label_Error);
+    VulkanCheckGoto(vmaCreateVirtualBlock(&BlockCreateInfo, &Pool.Block), label_Buffer);
 
-        pipeline_state_info Info = {
-            .ByteOffset = ByteOffset,
-            .InstaceByteCount = Params.InstanceByteCount,
-            .InstanceCount = InstanceCount,
+    *OutPoolIndex = (u32)C->BufferPools.Count;
+    ArrayData(buffer_pool, C->BufferPools)[C->BufferPools.Count++] = Pool;
+    return 0;
+
+label_Buffer:
+    vmaDestroyBuffer(C->Allocator, Pool.Buffer, Pool.Allocation);
+label_Error:
+    return 1;
+}
+
+static int AllocatePooledBuffer(context *C, u64 ByteCount, VkBufferUsageFlags Usage, buffer_copy *OutCopy) {
+    for(u32 PoolIndex = 0; PoolIndex < C->BufferPools.Count; ++PoolIndex) {
+        buffer_pool *Pool = ArrayData(buffer_pool, C->BufferPools) + PoolIndex;
+        if(Pool->Usage != Usage) {
+            continue;
+        }
+        VmaVirtualAllocationCreateInfo AllocationCreateInfo = {
+            .size = ByteCount,
+            .alignment = Pool->Alignment,
+            .flags = 0,
+            .pUserData = 0,
         };
-        Infos[I] = Info;
-        ByteOffset += Info.InstaceByteCount*Info.InstanceCount;
+        VmaVirtualAllocation VirtualAllocation = VK_NULL_HANDLE;
+        VkDeviceSize Offset = 0;
+        // NOTE(blackedout): Fails if the pool is full, then the next one is tried
+        if(vmaVirtualAllocate(Pool->Block, &AllocationCreateInfo, &VirtualAllocation, &Offset) == VK_SUCCESS) {
+            buffer_copy Copy = {
+                .Buffer = Pool->Buffer,
+                .Offset = Offset,
+                .VirtualAllocation = VirtualAllocation,
+                .PoolIndex = PoolIndex,
+                .MemoryFlags = buffer_memory_DEVICE_LOCAL,
+            };
+            *OutCopy = Copy;
+            return 0;
+        }
     }
-    *OutByteCount = ByteOffset;
+    u32 PoolIndex = 0;
+    if(CreateBufferPool(C, Usage, &PoolIndex)) {
+        return 1;
+    }
+    // NOTE(blackedout): A fresh pool always has room, since pooled buffers are much smaller than pools
+    return AllocatePooledBuffer(C, ByteCount, Usage, OutCopy);
 }
 
-int CreatePipelineStates(context *C, const VkPhysicalDeviceLimits *Limits) {
-    SetPipelineStateInfos(C->PipelineStateInfos, Limits, &C->PipelineStateByteCount);
-    C->VertexInputBindingDescriptions = calloc(C->PipelineStateInfos[pipeline_state_VERTEX_INPUT_BINDINGS].InstanceCount, sizeof(VkVertexInputBindingDescription));
-    C->VertexInputAttributeDescriptions = calloc(C->PipelineStateInfos[pipeline_state_VERTEX_INPUT_ATTRIBUTES].InstanceCount, sizeof(VkVertexInputAttributeDescription));
+// NOTE(blackedout): `MemoryFlags` without `buffer_memory_HOST_VISIBLE` select device local memory, otherwise the memory is
+// persistently mapped
+static int CreateBufferCopy(context *C, u64 ByteCount, VkBufferUsageFlags Usage, u32 MemoryFlags, buffer_copy *OutCopy) {
+    if((MemoryFlags & buffer_memory_HOST_VISIBLE) == 0 && ByteCount <= MAX_POOLED_BUFFER_BYTE_COUNT) {
+        return AllocatePooledBuffer(C, ByteCount, Usage, OutCopy);
+    }
+    VkBufferCreateInfo BufferCreateInfo = {
+        .sType = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO,
+        .pNext = 0,
+        .flags = 0,
+        .size = ByteCount,
+        .usage = VK_BUFFER_USAGE_TRANSFER_SRC_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT | Usage,
+        .sharingMode = VK_SHARING_MODE_EXCLUSIVE,
+        .queueFamilyIndexCount = 1,
+        .pQueueFamilyIndices = &C->DeviceInfo.QueueFamilyIndices[queue_GRAPHICS],
+    };
+    SetBufferSharing(C, &BufferCreateInfo);
+    VmaAllocationCreateInfo AllocationCreateInfo = {
+        .flags = 0,
+        .usage = VMA_MEMORY_USAGE_AUTO,
+        .requiredFlags = VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT,
+        .preferredFlags = 0,
+        .memoryTypeBits = 0,
+        .pool = 0,
+        .pUserData = 0,
+        .priority = 0,
+    };
+    if(MemoryFlags & buffer_memory_HOST_VISIBLE) {
+        VmaAllocationCreateFlags HostAccessFlag = (MemoryFlags & buffer_memory_HOST_READ) ? VMA_ALLOCATION_CREATE_HOST_ACCESS_RANDOM_BIT : VMA_ALLOCATION_CREATE_HOST_ACCESS_SEQUENTIAL_WRITE_BIT;
+        AllocationCreateInfo.flags = HostAccessFlag | VMA_ALLOCATION_CREATE_MAPPED_BIT;
+        AllocationCreateInfo.requiredFlags = VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | ((MemoryFlags & buffer_memory_HOST_COHERENT) ? VK_MEMORY_PROPERTY_HOST_COHERENT_BIT : 0);
+        AllocationCreateInfo.preferredFlags = (MemoryFlags & buffer_memory_HOST_READ) ? VK_MEMORY_PROPERTY_HOST_CACHED_BIT : 0;
+        if(MemoryFlags & buffer_memory_DEVICE_LOCAL) {
+            AllocationCreateInfo.preferredFlags |= VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT;
+        }
+    }
+    buffer_copy Copy = {0};
+    VmaAllocationInfo AllocationInfo = {0};
+    VulkanCheckGoto(vmaCreateBuffer(C->Allocator, &BufferCreateInfo, &AllocationCreateInfo, &Copy.Buffer, &Copy.Allocation, &AllocationInfo), label_Error);
+
+    // NOTE(blackedout): The allocator may pick coherent or device local memory even if it wasn't asked for
+    VkMemoryPropertyFlags PropertyFlags = 0;
+    vmaGetAllocationMemoryProperties(C->Allocator, Copy.Allocation, &PropertyFlags);
+    if(PropertyFlags & VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT) {
+        Copy.MemoryFlags |= buffer_memory_DEVICE_LOCAL;
+    }
+    if(MemoryFlags & buffer_memory_HOST_VISIBLE) {
+        Copy.MemoryFlags |= buffer_memory_HOST_VISIBLE | (MemoryFlags & buffer_memory_HOST_READ);
+        if(PropertyFlags & VK_MEMORY_PROPERTY_HOST_COHERENT_BIT) {
+            Copy.MemoryFlags |= buffer_memory_HOST_COHERENT;
+        }
+        Copy.Mapped = AllocationInfo.pMappedData;
+    }
+    *OutCopy = Copy;
+    return 0;
 
-    if(ArrayRequireRoom(&C->PipelineStates, 2, C->PipelineStateByteCount, INITIAL_PIPELINE_STATE_CAPACITY)) {
+label_Error:
+    return 1;
+}
+
+static void SetBufferMemory(object *Object, buffer_copy Copy) {
+    Object->Buffer.Buffer = Copy.Buffer;
+    Object->Buffer.Allocation = Copy.Allocation;
+    Object->Buffer.Offset = Copy.Offset;
+    Object->Buffer.VirtualAllocation = Copy.VirtualAllocation;
+    Object->Buffer.PoolIndex = Copy.PoolIndex;
+    Object->Buffer.Mapped = Copy.Mapped;
+    Object->Buffer.MemoryFlags = Copy.MemoryFlags;
+}
+
+static int PushBufferCopy(array *Copies, buffer_copy Copy) {
+    if(ArrayRequireRoom(Copies, 1, sizeof(buffer_copy), INITIAL_BUFFER_COPY_CAPACITY)) {
         return 1;
     }
-    C->PipelineStates.Count = 1;
-    SetDefaultPipelineState(C, 0);
+    ArrayData(buffer_copy, *Copies)[Copies->Count++] = Copy;
     return 0;
 }
 
-void *GetPipelineState(context *C, u64 StateIndex, pipeline_state_type Type) {
-    Assert(StateIndex < C->PipelineStates.Count);
-    Assert(Type < pipeline_state_COUNT);
-    u8 *Base = ArrayData(u8, C->PipelineStates) + StateIndex*C->PipelineStateByteCount;
-    return Base + C->PipelineStateInfos[Type].ByteOffset;
+// NOTE(blackedout): Takes a copy with at least the requested memory flags from the buffer's pool or creates a new one
+static int TakeBufferCopy(context *C, object *Object, u32 MemoryFlags, buffer_copy *OutCopy) {
+    u32 RequiredFlags = MemoryFlags & (buffer_memory_HOST_VISIBLE | buffer_memory_HOST_COHERENT);
+    buffer_copy *FreeCopies = ArrayData(buffer_copy, Object->Buffer.FreeCopies);
+    for(u64 I = 0; I < Object->Buffer.FreeCopies.Count; ++I) {
+        u32 CopyFlags = FreeCopies[I].MemoryFlags & (buffer_memory_HOST_VISIBLE | buffer_memory_HOST_COHERENT);
+        // NOTE(blackedout): Device local requests only take device local copies, host visible ones may take coherent copies
+        int IsMatch = RequiredFlags ? (CopyFlags & RequiredFlags) == RequiredFlags : CopyFlags == 0;
+        if(IsMatch) {
+            *OutCopy = FreeCopies[I];
+            FreeCopies[I] = FreeCopies[--Object->Buffer.FreeCopies.Count];
+            return 0;
+        }
+    }
+    return CreateBufferCopy(C, Object->Buffer.ByteCount, Object->Buffer.VulkanUsage, MemoryFlags, OutCopy);
 }
 
-void ClearPipelineState(context *C, u64 StateIndex, pipeline_state_type Type) {
-    pipeline_state_info Info = C->PipelineStateInfos[Type];
-    void *State = GetPipelineState(C, StateIndex, Type);
-    memset(State, 0, Info.InstanceCount*Info.InstaceByteCount);
+// NOTE(blackedout): Hands the current memory to the pool, it is only reused after the frame if commands may still reference it
+static int RetireCurrentBufferMemory(context *C, object *Object) {
+    if(Object->Buffer.Buffer == VK_NULL_HANDLE) {
+        return 0;
+    }
+    buffer_copy Current = {
+        .Buffer = Object->Buffer.Buffer,
+        .Allocation = Object->Buffer.Allocation,
+        .Offset = Object->Buffer.Offset,
+        .VirtualAllocation = Object->Buffer.VirtualAllocation,
+        .PoolIndex = Object->Buffer.PoolIndex,
+        .Mapped = Object->Buffer.Mapped,
+        .MemoryFlags = Object->Buffer.MemoryFlags,
+    };
+    array *Copies = IsBufferInUse(C, Object) ? &Object->Buffer.InUseCopies : &Object->Buffer.FreeCopies;
+    if(PushBufferCopy(Copies, Current)) {
+        return 1;
+    }
+    SetBufferMemory(Object, (buffer_copy){0});
+    return 0;
 }
 
-void CopyPipelineStateToPtr(context *C, void *DstState, u64 SrcStateIndex, pipeline_state_type Type) {
-    pipeline_state_info Info = C->PipelineStateInfos[Type];
-    void *SrcState = GetPipelineState(C, SrcStateIndex, Type);
-    memcpy(DstState, SrcState, Info.InstanceCount*Info.InstaceByteCount);
+// NOTE(blackedout): Called for every buffer once the device is done with the frame
+void RecycleBufferCopies(context *C, object *Object) {
+    for(u64 I = 0; I < Object->Buffer.InUseCopies.Count; ++I) {
+        buffer_copy Copy = ArrayData(buffer_copy, Object->Buffer.InUseCopies)[I];
+        if(Object->Buffer.FreeCopies.Count >= MAX_FREE_BUFFER_COPY_COUNT || PushBufferCopy(&Object->Buffer.FreeCopies, Copy)) {
+            DestroyBufferCopy(C, &Copy);
+        }
+    }
+    Object->Buffer.InUseCopies.Count = 0;
 }
 
-void CopyPipelineStateFromPtr(context *C, u64 DstStateIndex, void *SrcState, pipeline_state_type Type) {
-    pipeline_state_info Info = C->PipelineStateInfos[Type];
-    void *DstState = GetPipelineState(C, DstStateIndex, Type);
-    memcpy(DstState, SrcState, Info.InstanceCount*Info.InstaceByteCount);
+// NOTE(blackedout): Gets rid of the current memory and all copies, memory that might still be referenced is retired
+int ReleaseBufferMemory(context *C, object *Object) {
+    if(RetireCurrentBufferMemory(C, Object)) {
+        return 1;
+    }
+    int Result = 0;
+    for(u64 I = 0; I < Object->Buffer.InUseCopies.Count; ++I) {
+        buffer_copy *Copy = ArrayData(buffer_copy, Object->Buffer.InUseCopies) + I;
+        if(RetireBufferCopy(C, *Copy)) {
+            // NOTE(blackedout): Better to leak than to destroy memory that is still in use
+            Result = 1;
+        }
+    }
+    for(u64 I = 0; I < Object->Buffer.FreeCopies.Count; ++I) {
+        DestroyBufferCopy(C, ArrayData(buffer_copy, Object->Buffer.FreeCopies) + I);
+    }
+    free(Object->Buffer.InUseCopies.Data);
+    free(Object->Buffer.FreeCopies.Data);
+    Object->Buffer.InUseCopies = (array){0};
+    Object->Buffer.FreeCopies = (array){0};
+    return Result;
 }
 
-void CopyPipelineState(context *C, u64 DstStateIndex, u64 SrcStateIndex, pipeline_state_type Type) {
-    pipeline_state_info Info = C->PipelineStateInfos[Type];
-    void *DstState = GetPipelineState(C, DstStateIndex, Type);
-    void *SrcState = GetPipelineState(C, SrcStateIndex, Type);
-    memcpy(DstState, SrcState, Info.InstanceCount*Info.InstaceByteCount);
+// NOTE(blackedout): For commands that must see the draws recorded before them, they are pushed behind them and end the render
+// pass there during replay. The next draw resumes it (see `PotentiallySaveSubpass`) and commands outside of render passes are
+// pushed in order until then.
+static int PushRenderPassEndingCommand(context *C, command Command) {
+    if(PushCommand(C, Command)) {
+        return 1;
+    }
+    C->IsRenderPassRecorded = 0;
+    return 0;
+}
+
+// NOTE(blackedout): Inserts a transfer command at the current position of the command stream. Transfers can't be recorded
+// inside a render pass, so once one was begun they go in front of it. That is invisible to the draws in the pass, since
+// buffers they reference are always renamed before they are written.
+static int PushOutsideRenderPassCommand(context *C, command Command) {
+    if(C->IsRenderPassRecorded == 0) {
+        return PushCommand(C, Command);
+    }
+    if(RequireRoomForNewCommands(C, 1)) {
+        return 1;
+    }
+    command *Commands = ArrayData(command, C->Commands);
+    u32 Index = C->RenderPassCommandIndex;
+    memmove(Commands + Index + 1, Commands + Index, (C->Commands.Count - Index)*sizeof(command));
+    Commands[Index] = Command;
+    ++C->Commands.Count;
+    ++C->RenderPassCommandIndex;
+    return 0;
+}
+
+// NOTE(blackedout): The buffer ranges `Command` may write, at most `SHADER_STORAGE_BINDING_COUNT`. Storage buffers bound for
+// draws all count as written, their commands don't tell which of them are.
+static u32 GetCommandWrittenRanges(context *C, const command *Command, VkDescriptorBufferInfo *Ranges) {
+    u32 Count = 0;
+    const VkDescriptorBufferInfo *BufferInfos = 0;
+    switch(Command->Type) {
+    case command_UPDATE_BUFFER: {
+        Ranges[Count++] = MakeBufferRange(Command->UpdateBuffer.Buffer, Command->UpdateBuffer.Offset, Command->UpdateBuffer.ByteCount);
+    } break;
+    case command_COPY_BUFFER: {
+        Ranges[Count++] = MakeBufferRange(Command->CopyBuffer.DstBuffer, Command->CopyBuffer.DstOffset, Command->CopyBuffer.ByteCount);
+    } break;
+    case command_READ_PIXELS: {
+        Ranges[Count++] = MakeBufferRange(Command->ReadPixels.Buffer, Command->ReadPixels.Offset, VK_WHOLE_SIZE);
+    } break;
+    case command_BIND_STORAGE_BUFFERS: {
+        BufferInfos = (const VkDescriptorBufferInfo *)(ArrayData(u8, C->CommandData) + Command->BindStorageBuffers.BufferInfoDataOffset);
+        for(u32 I = 0; I < Command->BindStorageBuffers.BufferInfoCount; ++I) {
+            Ranges[Count++] = BufferInfos[I];
+        }
+    } break;
+    case command_DISPATCH:
+    case command_DISPATCH_INDIRECT: {
+        BufferInfos = (const VkDescriptorBufferInfo *)(ArrayData(u8, C->CommandData) + Command->Dispatch.BufferInfoDataOffset);
+        for(u32 I = 0; I < Command->Dispatch.BufferInfoCount; ++I) {
+            if(Command->Dispatch.WrittenBufferInfoMask & (1u << I)) {
+                Ranges[Count++] = BufferInfos[I];
+            }
+        }
+    } break;
+    default: {
+
+    } break;
+    }
+    return Count;
+}
+
+// NOTE(blackedout): Whether commands of the stream that haven't run yet may write into the range
+static int HasPendingBufferWrites(context *C, VkBuffer Buffer, u64 Offset, u64 ByteCount) {
+    VkDescriptorBufferInfo Range = MakeBufferRange(Buffer, Offset, ByteCount);
+    command *Commands = ArrayData(command, C->Commands);
+    for(u32 I = 0; I < C->Commands.Count; ++I) {
+        VkDescriptorBufferInfo Written[SHADER_STORAGE_BINDING_COUNT];
+        u32 WrittenCount = GetCommandWrittenRanges(C, Commands + I, Written);
+        for(u32 J = 0; J < WrittenCount; ++J) {
+            if(IsBufferRangeAliased(Written[J], Range)) {
+                return 1;
+            }
+        }
+    }
+    return 0;
 }
 
-int UseCurrentPipelineState(context *C, u32 TypeCount, pipeline_state_type *Types) {
-    // TODO(blackedout): Validate if pipeline can be used
-    {
-        
+// NOTE(blackedout): Records the transfers of the stream into the immediate command buffer, so their writes are done once it
+// was submitted, and takes them out of the stream. They only depend on each other and on writes of shaders and pixel reads,
+// since buffers are renamed before they are written (see `PushOutsideRenderPassCommand`). The first transfer that touches
+// such a write stays in the stream with every transfer after it.
+static void FlushPendingTransfers(context *C, VkCommandBuffer CommandBuffer) {
+    VkDescriptorBufferInfo BlockingWrites[MAX_FLUSH_BLOCKING_WRITE_COUNT];
+    u32 BlockingWriteCount = 0;
+    int IsBlockingWriteOverflow = 0;
+    u32 FlushedCount = 0;
+    command *Commands = ArrayData(command, C->Commands);
+    for(u32 I = 0; I < C->Commands.Count; ++I) {
+        command *Command = Commands + I;
+        int IsTransfer = Command->Type == command_UPDATE_BUFFER || Command->Type == command_COPY_BUFFER;
+        VkDescriptorBufferInfo Written[SHADER_STORAGE_BINDING_COUNT];
+        u32 WrittenCount = GetCommandWrittenRanges(C, Command, Written);
+        if(IsTransfer == 0) {
+            for(u32 J = 0; J < WrittenCount; ++J) {
+                if(BlockingWriteCount == MAX_FLUSH_BLOCKING_WRITE_COUNT) {
+                    IsBlockingWriteOverflow = 1;
+                    break;
+                }
+                BlockingWrites[BlockingWriteCount++] = Written[J];
+            }
+            continue;
+        }
+
+        int IsBlocked = IsBlockingWriteOverflow;
+        for(u32 J = 0; J < BlockingWriteCount && IsBlocked == 0; ++J) {
+            IsBlocked = IsBufferRangeAliased(BlockingWrites[J], Written[0]);
+            if(Command->Type == command_COPY_BUFFER) {
+                IsBlocked |= IsBufferRangeAliased(BlockingWrites[J], MakeBufferRange(Command->CopyBuffer.SrcBuffer, Command->CopyBuffer.SrcOffset, Command->CopyBuffer.ByteCount));
+            }
+        }
+        if(IsBlocked) {
+            break;
+        }
+
+        // NOTE(blackedout): The first barrier orders after everything submitted before, the others order the transfers
+        VkMemoryBarrier Barrier = {
+            .sType = VK_STRUCTURE_TYPE_MEMORY_BARRIER,
+            .pNext = 0,
+            .srcAccessMask = FlushedCount ? VK_ACCESS_TRANSFER_WRITE_BIT : VK_ACCESS_MEMORY_WRITE_BIT,
+            .dstAccessMask = VK_ACCESS_TRANSFER_READ_BIT | VK_ACCESS_TRANSFER_WRITE_BIT,
+        };
+        VkPipelineStageFlags SrcStages = FlushedCount ? VK_PIPELINE_STAGE_TRANSFER_BIT : VK_PIPELINE_STAGE_ALL_COMMANDS_BIT;
+        vkCmdPipelineBarrier(CommandBuffer, SrcStages, VK_PIPELINE_STAGE_TRANSFER_BIT, 0, 1, &Barrier, 0, 0, 0, 0);
+        if(Command->Type == command_UPDATE_BUFFER) {
+            u8 *Data = ArrayData(u8, C->CommandData) + Command->UpdateBuffer.DataOffset;
+            vkCmdUpdateBuffer(CommandBuffer, Command->UpdateBuffer.Buffer, Command->UpdateBuffer.Offset, Command->UpdateBuffer.ByteCount, Data);
+        } else {
+            VkBufferCopy Region = {
+                .srcOffset = Command->CopyBuffer.SrcOffset,
+                .dstOffset = Command->CopyBuffer.DstOffset,
+                .size = Command->CopyBuffer.ByteCount,
+            };
+            vkCmdCopyBuffer(CommandBuffer, Command->CopyBuffer.SrcBuffer, Command->CopyBuffer.DstBuffer, 1, &Region);
+        }
+        Command->Type = command_NONE;
+        ++FlushedCount;
+    }
+
+    if(FlushedCount) {
+        // NOTE(blackedout): Covers the host and every later submission, the frame's commands included
+        VkMemoryBarrier Barrier = {
+            .sType = VK_STRUCTURE_TYPE_MEMORY_BARRIER,
+            .pNext = 0,
+            .srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT,
+            .dstAccessMask = VK_ACCESS_MEMORY_READ_BIT | VK_ACCESS_MEMORY_WRITE_BIT | VK_ACCESS_HOST_READ_BIT | VK_ACCESS_HOST_WRITE_BIT,
+        };
+        vkCmdPipelineBarrier(CommandBuffer, VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_ALL_COMMANDS_BIT | VK_PIPELINE_STAGE_HOST_BIT, 0, 1, &Barrier, 0, 0, 0, 0);
+    }
+}
+
+// NOTE(blackedout): Runs the pending transfers of the stream right away, see `FlushPendingTransfers`
+static int RunPendingTransfers(context *C) {
+    VkCommandBuffer CommandBuffer = VK_NULL_HANDLE;
+    if(BeginImmediateCommands(C, &CommandBuffer)) {
+        return 1;
+    }
+    FlushPendingTransfers(C, CommandBuffer);
+    return SubmitImmediateCommands(C);
+}
+
+// NOTE(blackedout): Reads device local memory through a temporary host visible copy, the buffer keeps its memory
+static int ReadDeviceLocalBuffer(context *C, object *Object, u64 Offset, u64 ByteCount, void *Data) {
+    buffer_copy Readback = {0};
+    if(CreateBufferCopy(C, ByteCount, 0, buffer_memory_HOST_VISIBLE | buffer_memory_HOST_READ, &Readback)) {
+        return 1;
+    }
+    VkCommandBuffer CommandBuffer = VK_NULL_HANDLE;
+    if(BeginImmediateCommands(C, &CommandBuffer)) {
+        goto label_Readback;
+    }
+    VkBufferCopy Region = {
+        .srcOffset = Object->Buffer.Offset + Offset,
+        .dstOffset = 0,
+        .size = ByteCount,
+    };
+    vkCmdCopyBuffer(CommandBuffer, Object->Buffer.Buffer, Readback.Buffer, 1, &Region);
+    VkMemoryBarrier Barrier = {
+        .sType = VK_STRUCTURE_TYPE_MEMORY_BARRIER,
+        .pNext = 0,
+        .srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT,
+        .dstAccessMask = VK_ACCESS_HOST_READ_BIT,
+    };
+    vkCmdPipelineBarrier(CommandBuffer, VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_HOST_BIT, 0, 1, &Barrier, 0, 0, 0, 0);
+    if(SubmitImmediateCommands(C)) {
+        goto label_Readback;
+    }
+    VulkanCheckGoto(vmaInvalidateAllocation(C->Allocator, Readback.Allocation, 0, VK_WHOLE_SIZE), label_Readback);
+    memcpy(Data, Readback.Mapped, ByteCount);
+    DestroyBufferCopy(C, &Readback);
+    return 0;
+
+label_Readback:
+    DestroyBufferCopy(C, &Readback);
+    return 1;
+}
+
+// NOTE(blackedout): Writes `Data` into the buffer at its position in the command stream. Small updates are stored with the
+// commands, larger ones are copied from staging memory that lives until the frame is done.
+static int PushBufferUpdate(context *C, object *Object, u64 Offset, const void *Data, u64 ByteCount) {
+    command Command = {0};
+    if(IsInlineBufferUpdate(Offset, ByteCount)) {
+        if(ArrayRequireRoom(&C->CommandData, ByteCount, 1, INITIAL_COMMAND_DATA_CAPACITY)) {
+            return 1;
+        }
+        Command.Type = command_UPDATE_BUFFER;
+        Command.UpdateBuffer.Buffer = Object->Buffer.Buffer;
+        Command.UpdateBuffer.Offset = Object->Buffer.Offset + Offset;
+        Command.UpdateBuffer.ByteCount = ByteCount;
+        Command.UpdateBuffer.DataOffset = C->CommandData.Count;
+        memcpy(ArrayData(u8, C->CommandData) + C->CommandData.Count, Data, ByteCount);
+        C->CommandData.Count += ByteCount;
+    } else {
+        staging_allocation Staging = {0};
+        if(AllocateStaging(C, ByteCount, 4, 1, &Staging)) {
+            return 1;
+        }
+        memcpy(Staging.Mapped, Data, ByteCount);
+        Command.Type = command_COPY_BUFFER;
+        Command.CopyBuffer.SrcBuffer = Staging.Buffer;
+        Command.CopyBuffer.DstBuffer = Object->Buffer.Buffer;
+        Command.CopyBuffer.SrcOffset = Staging.Offset;
+        Command.CopyBuffer.DstOffset = Object->Buffer.Offset + Offset;
+        Command.CopyBuffer.ByteCount = ByteCount;
+    }
+    if(PushOutsideRenderPassCommand(C, Command)) {
+        return 1;
+    }
+    Object->Buffer.LastUseFrame = C->SwapCounter + 1;
+    return 0;
+}
+
+// NOTE(blackedout): Gives the buffer fresh memory from its pool. If `PreserveContents` is set, the old contents are copied over:
+// by a transfer command in the stream into device local memory and right away into host visible memory (the caller is about to
+// access it), by the host from host visible memory, otherwise by the device. Pending transfers of the stream run first then,
+// so the copy sees them. Pending writes of shaders and pixel reads can't run before, they are lost and reported.
+int RenameBufferMemory(context *C, object *Object, u32 MemoryFlags, int PreserveContents) {
+    buffer_copy Copy = {0};
+    if(TakeBufferCopy(C, Object, MemoryFlags, &Copy)) {
+        return 1;
+    }
+
+    if(PreserveContents && Object->Buffer.Buffer != VK_NULL_HANDLE && Object->Buffer.ByteCount > 0) {
+        int IsOldHostVisible = (Object->Buffer.MemoryFlags & buffer_memory_HOST_VISIBLE) != 0;
+        int IsNewHostVisible = (Copy.MemoryFlags & buffer_memory_HOST_VISIBLE) != 0;
+        if(IsNewHostVisible == 0) {
+            command Command = {
+                .Type = command_COPY_BUFFER,
+                .CopyBuffer = {
+                    .SrcBuffer = Object->Buffer.Buffer,
+                    .DstBuffer = Copy.Buffer,
+                    .SrcOffset = Object->Buffer.Offset,
+                    .DstOffset = Copy.Offset,
+                    .ByteCount = Object->Buffer.ByteCount,
+                },
+            };
+            if(PushOutsideRenderPassCommand(C, Command)) {
+                goto label_Error;
+            }
+            // NOTE(blackedout): Both are referenced by the copy, the old memory goes to the in use copies below
+            Object->Buffer.LastUseFrame = C->SwapCounter + 1;
+        } else {
+            int IsPending = IsBufferInUse(C, Object) && HasPendingBufferWrites(C, Object->Buffer.Buffer, Object->Buffer.Offset, Object->Buffer.ByteCount);
+            if(IsOldHostVisible == 0 || IsPending) {
+                VkCommandBuffer CommandBuffer = VK_NULL_HANDLE;
+                if(BeginImmediateCommands(C, &CommandBuffer)) {
+                    goto label_Error;
+                }
+                FlushPendingTransfers(C, CommandBuffer);
+                if(IsOldHostVisible == 0) {
+                    VkBufferCopy Region = {
+                        .srcOffset = Object->Buffer.Offset,
+                        .dstOffset = Copy.Offset,
+                        .size = Object->Buffer.ByteCount,
+                    };
+                    vkCmdCopyBuffer(CommandBuffer, Object->Buffer.Buffer, Copy.Buffer, 1, &Region);
+                    VkMemoryBarrier Barrier = {
+                        .sType = VK_STRUCTURE_TYPE_MEMORY_BARRIER,
+                        .pNext = 0,
+                        .srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT,
+                        .dstAccessMask = VK_ACCESS_HOST_READ_BIT | VK_ACCESS_HOST_WRITE_BIT,
+                    };
+                    vkCmdPipelineBarrier(CommandBuffer, VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_HOST_BIT, 0, 1, &Barrier, 0, 0, 0, 0);
+                }
+                if(SubmitImmediateCommands(C)) {
+                    goto label_Error;
+                }
+                if(IsPending && HasPendingBufferWrites(C, Object->Buffer.Buffer, Object->Buffer.Offset, Object->Buffer.ByteCount)) {
+                    GenerateOther(C, GL_DEBUG_SOURCE_API, "Shader writes or pixel reads of the current frame into a buffer that the host accesses now have not run yet, they are lost");
+                }
+            }
+            if(IsOldHostVisible) {
+                VulkanCheckGoto(vmaInvalidateAllocation(C->Allocator, Object->Buffer.Allocation, 0, VK_WHOLE_SIZE), label_Error);
+                memcpy(Copy.Mapped, Object->Buffer.Mapped, Object->Buffer.ByteCount);
+                VulkanCheckGoto(vmaFlushAllocation(C->Allocator, Copy.Allocation, 0, VK_WHOLE_SIZE), label_Error);
+            } else {
+                VulkanCheckGoto(vmaInvalidateAllocation(C->Allocator, Copy.Allocation, 0, VK_WHOLE_SIZE), label_Error);
+            }
+        }
+    }
+
+    int IsCopyInUse = IsBufferInUse(C, Object);
+    if(RetireCurrentBufferMemory(C, Object)) {
+        goto label_Error;
+    }
+    SetBufferMemory(Object, Copy);
+    // NOTE(blackedout): Fresh memory is only referenced by this frame if the contents were copied by the stream
+    Object->Buffer.LastReadFrame = 0;
+    Object->Buffer.LastUseFrame = (IsCopyInUse && PreserveContents && (Copy.MemoryFlags & buffer_memory_HOST_VISIBLE) == 0) ? C->SwapCounter + 1 : 0;
+    return 0;
+
+label_Error:
+    DestroyBufferCopy(C, &Copy);
+    return 1;
+}
+
+void *MapBufferRange(context *C, object *Object, GLintptr Offset, GLsizeiptr Length, GLbitfield Access, const char *Name) {
+    const GLbitfield ValidAccess = GL_MAP_READ_BIT | GL_MAP_WRITE_BIT | GL_MAP_INVALIDATE_RANGE_BIT | GL_MAP_INVALIDATE_BUFFER_BIT |
+        GL_MAP_FLUSH_EXPLICIT_BIT | GL_MAP_UNSYNCHRONIZED_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT;
+    CheckGL(Offset < 0 || Length < 0 || (u64)Offset + (u64)Length > Object->Buffer.ByteCount || (Access & ~ValidAccess), gl_error_MAP_BUFFER_RANGE_VALUE, 0);
+    CheckGL(Length == 0, gl_error_MAP_BUFFER_RANGE_LENGTH_ZERO, 0);
+    CheckGL(Object->Buffer.IsMapped, gl_error_MAP_BUFFER_RANGE_MAPPED, 0);
+    CheckGL((Access & (GL_MAP_READ_BIT | GL_MAP_WRITE_BIT)) == 0, gl_error_MAP_BUFFER_RANGE_NO_READ_WRITE, 0);
+    CheckGL((Access & GL_MAP_READ_BIT) && (Access & (GL_MAP_INVALIDATE_RANGE_BIT | GL_MAP_INVALIDATE_BUFFER_BIT | GL_MAP_UNSYNCHRONIZED_BIT)), gl_error_MAP_BUFFER_RANGE_READ_INVALIDATE, 0);
+    CheckGL((Access & GL_MAP_FLUSH_EXPLICIT_BIT) && (Access & GL_MAP_WRITE_BIT) == 0, gl_error_MAP_BUFFER_RANGE_FLUSH_NO_WRITE, 0);
+    const GLbitfield StorageAccess = GL_MAP_READ_BIT | GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT;
+    CheckGL((Access & StorageAccess & ~Object->Buffer.StorageFlags) != 0, gl_error_MAP_BUFFER_RANGE_STORAGE_FLAGS, 0);
+
+    u32 RequiredMemoryFlags = buffer_memory_HOST_VISIBLE;
+    if(Access & GL_MAP_COHERENT_BIT) {
+        RequiredMemoryFlags |= buffer_memory_HOST_COHERENT;
+    }
+    int IsUnsynchronized = (Access & GL_MAP_UNSYNCHRONIZED_BIT) != 0;
+    int IsInUse = IsBufferInUse(C, Object);
+    int IsInvalidate = (Access & GL_MAP_INVALIDATE_BUFFER_BIT) || ((Access & GL_MAP_INVALIDATE_RANGE_BIT) && Offset == 0 && (u64)Length == Object->Buffer.ByteCount);
+    int IsMemoryUsable = (Object->Buffer.MemoryFlags & RequiredMemoryFlags) == RequiredMemoryFlags;
+
+    // NOTE(blackedout): Invalidation renames only if the memory is busy, writing idle memory in place is equivalent.
+    // Unsynchronized maps write in place even if commands of this frame read the buffer, as specified.
+    int IsWriteHazard = (Access & GL_MAP_WRITE_BIT) && IsInUse && IsUnsynchronized == 0;
+    if(IsMemoryUsable == 0 || IsWriteHazard) {
+        u32 MemoryFlags = RequiredMemoryFlags | ((Access & GL_MAP_READ_BIT) ? buffer_memory_HOST_READ : 0) | (Object->Buffer.PlacementFlags & buffer_memory_DEVICE_LOCAL);
+        if(RenameBufferMemory(C, Object, MemoryFlags, IsInvalidate == 0)) {
+            GenerateErrorMsg(C, GL_OUT_OF_MEMORY, GL_DEBUG_SOURCE_API, "MapBufferRange: failed to allocate host visible memory");
+            return 0;
+        }
+    } else if((Access & GL_MAP_READ_BIT) && (Object->Buffer.MemoryFlags & buffer_memory_HOST_COHERENT) == 0) {
+        if(VulkanCheck(C, vmaInvalidateAllocation(C->Allocator, Object->Buffer.Allocation, Offset, Length), "vmaInvalidateAllocation")) {
+            return 0;
+        }
+    }
+
+    if(Access & GL_MAP_WRITE_BIT) {
+        Object->Buffer.IsExpandedIndexBufferStale = 1;
+    }
+    Object->Buffer.IsMapped = 1;
+    Object->Buffer.MapAccess = Access;
+    Object->Buffer.MapOffset = Offset;
+    Object->Buffer.MapLength = Length;
+    return Object->Buffer.Mapped + Offset;
+}
+
+GLboolean UnmapBuffer(context *C, object *Object, const char *Name) {
+    CheckGL(Object->Buffer.IsMapped == 0, gl_error_UNMAP_BUFFER_NOT_MAPPED, GL_FALSE);
+
+    // NOTE(blackedout): Without explicit flushes the whole mapped range is flushed (a no-op for coherent memory)
+    GLbitfield Access = Object->Buffer.MapAccess;
+    if((Access & GL_MAP_WRITE_BIT) && (Access & GL_MAP_FLUSH_EXPLICIT_BIT) == 0) {
+        VulkanCheck(C, vmaFlushAllocation(C->Allocator, Object->Buffer.Allocation, Object->Buffer.MapOffset, Object->Buffer.MapLength), "vmaFlushAllocation");
+    }
+    Object->Buffer.IsMapped = 0;
+    Object->Buffer.MapAccess = 0;
+    Object->Buffer.MapOffset = 0;
+    Object->Buffer.MapLength = 0;
+    return GL_TRUE;
+}
+
+void FlushMappedBufferRange(context *C, object *Object, GLintptr Offset, GLsizeiptr Length, const char *Name) {
+    CheckGL(Object->Buffer.IsMapped == 0 || (Object->Buffer.MapAccess & GL_MAP_FLUSH_EXPLICIT_BIT) == 0, gl_error_FLUSH_MAPPED_BUFFER_RANGE_NOT_MAPPED);
+    CheckGL(Offset < 0 || Length < 0 || (u64)Offset + (u64)Length > Object->Buffer.MapLength, gl_error_FLUSH_MAPPED_BUFFER_RANGE_VALUE);
+    VulkanCheck(C, vmaFlushAllocation(C->Allocator, Object->Buffer.Allocation, Object->Buffer.MapOffset + Offset, Length), "vmaFlushAllocation");
+}
+
+// NOTE(blackedout): `Size` is ignored unless `IsRange` is set (BindBufferBase), zero then means the whole buffer
+void BindBufferRange(context *C, GLenum Target, GLuint Index, GLuint Buffer, GLintptr Offset, GLsizeiptr Size, int IsRange, const char *Name) {
+    int IsIndexedTarget = Target == GL_ATOMIC_COUNTER_BUFFER || Target == GL_SHADER_STORAGE_BUFFER || Target == GL_TRANSFORM_FEEDBACK_BUFFER || Target == GL_UNIFORM_BUFFER;
+    CheckGL(IsIndexedTarget == 0, gl_error_BIND_BUFFER_INDEXED_TARGET);
+    if(Target != GL_SHADER_STORAGE_BUFFER) {
+        // TODO(blackedout): Uniform blocks are packed into the default uniform buffer of the program
+        GenerateOther(C, GL_DEBUG_SOURCE_API, "BindBufferRange: only SHADER_STORAGE_BUFFER has indexed binding points");
+        return;
+    }
+    CheckGL(Index >= SHADER_STORAGE_BINDING_COUNT, gl_error_BIND_BUFFER_INDEXED_INDEX);
+    // NOTE(blackedout): Named object creation not supported
+    CheckGL(Buffer != 0 && CheckObjectCreated(C, Buffer), gl_error_BIND_BUFFER_INDEXED_BUFFER);
+    if(IsRange == 0) {
+        Offset = 0;
+        Size = 0;
+    } else if(Buffer != 0) {
+        CheckGL(Size <= 0, gl_error_BIND_BUFFER_RANGE_SIZE);
+        u64 Alignment = C->DeviceInfo.Properties.limits.minStorageBufferOffsetAlignment;
+        CheckGL(Offset < 0 || (u64)Offset % Alignment != 0, gl_error_BIND_BUFFER_RANGE_OFFSET);
+    }
+
+    buffer_target_info TargetInfo = {0};
+    Assert(0 == GetBufferTargetInfo(Target, &TargetInfo));
+    C->BoundBuffers[TargetInfo.Index] = Buffer;
+    indexed_buffer_binding Binding = {
+        .Buffer = Buffer,
+        .Offset = Offset,
+        .Size = Size,
+    };
+    C->ShaderStorageBindings[Index] = Binding;
+}
+
+static void SpecifyBufferStore(context *C, object *Object, GLsizeiptr Size, const void *Data, VkBufferUsageFlags VulkanUsage, u32 MemoryFlags, const char *Name);
+
+static void ExpandByteIndices(u16 *Dst, const u8 *Src, u64 Count) {
+    for(u64 I = 0; I < Count; ++I) {
+        Dst[I] = Src[I];
+    }
+}
+
+// NOTE(blackedout): Repeats an upload into the store (or a respecification of it) for the expanded index buffer,
+// so it only has to be rebuilt from the contents when the device or a mapping wrote them
+static void UploadExpandedIndices(context *C, object *Object, u64 Offset, const void *Data, u64 Size, int IsRespecify, const char *Name) {
+    if(Object->Buffer.ExpandedIndexBuffer == 0 || (Object->Buffer.IsExpandedIndexBufferStale && IsRespecify == 0)) {
+        return;
+    }
+    object *Expanded = 0;
+    GetObject(C, Object->Buffer.ExpandedIndexBuffer, &Expanded);
+    u16 *Indices = 0;
+    if(Data && Size > 0) {
+        Indices = malloc(Size*sizeof(u16));
+        if(Indices == 0) {
+            Object->Buffer.IsExpandedIndexBufferStale = 1;
+            return;
+        }
+        ExpandByteIndices(Indices, Data, Size);
+    }
+    if(IsRespecify) {
+        SpecifyBufferStore(C, Expanded, Size*sizeof(u16), Indices, VK_BUFFER_USAGE_INDEX_BUFFER_BIT, 0, Name);
+        Object->Buffer.IsExpandedIndexBufferStale = 0;
+    } else if(Indices) {
+        BufferSubData(C, Expanded, Offset*sizeof(u16), Size*sizeof(u16), Indices, Name);
+    }
+    free(Indices);
+}
+
+// NOTE(blackedout): Respecifies the data store in memory chosen by `MemoryFlags`. Memory of the same size, usage and
+// placement is reused (renamed if still in use). Host visible memory is written in place, device local memory through
+// the transfer batch, since nothing of this frame can reference the new contents yet.
+static void SpecifyBufferStore(context *C, object *Object, GLsizeiptr Size, const void *Data, VkBufferUsageFlags VulkanUsage, u32 MemoryFlags, const char *Name) {
+    // NOTE(blackedout): Respecifying the data store unmaps it
+    if(Object->Buffer.IsMapped) {
+        UnmapBuffer(C, Object, Name);
+    }
+
+    u32 RequiredMemoryFlags = MemoryFlags & (buffer_memory_HOST_VISIBLE | buffer_memory_HOST_COHERENT);
+    int IsReusable = Object->Buffer.Buffer != VK_NULL_HANDLE && Object->Buffer.ByteCount == (u64)Size &&
+        Object->Buffer.VulkanUsage == VulkanUsage && Object->Buffer.PlacementFlags == MemoryFlags &&
+        (Object->Buffer.MemoryFlags & (buffer_memory_HOST_VISIBLE | buffer_memory_HOST_COHERENT)) == RequiredMemoryFlags;
+    if(IsReusable) {
+        if(IsBufferInUse(C, Object) && RenameBufferMemory(C, Object, MemoryFlags, 0)) {
+            goto label_OutOfMemory;
+        }
+    } else {
+        if(ReleaseBufferMemory(C, Object)) {
+            goto label_OutOfMemory;
+        }
+        Object->Buffer.ByteCount = Size;
+        Object->Buffer.VulkanUsage = VulkanUsage;
+        Object->Buffer.PlacementFlags = MemoryFlags;
+        Object->Buffer.LastUseFrame = 0;
+        Object->Buffer.LastReadFrame = 0;
+        if(Size > 0) {
+            buffer_copy Copy = {0};
+            if(CreateBufferCopy(C, Size, VulkanUsage, MemoryFlags, &Copy)) {
+                Object->Buffer.ByteCount = 0;
+                goto label_OutOfMemory;
+            }
+            SetBufferMemory(Object, Copy);
+        }
+    }
+
+    if(Data && Size > 0) {
+        if(Object->Buffer.MemoryFlags & buffer_memory_HOST_VISIBLE) {
+            memcpy(Object->Buffer.Mapped, Data, Size);
+            VulkanCheck(C, vmaFlushAllocation(C->Allocator, Object->Buffer.Allocation, 0, VK_WHOLE_SIZE), "vmaFlushAllocation");
+        } else if(RecordBufferUpload(C, Object->Buffer.Buffer, Object->Buffer.Offset, Data, Size)) {
+            goto label_OutOfMemory;
+        }
+    }
+    UploadExpandedIndices(C, Object, 0, Data, Size, 1, Name);
+    return;
+
+label_OutOfMemory:
+    GenerateErrorMsg(C, GL_OUT_OF_MEMORY, GL_DEBUG_SOURCE_API, "SpecifyBufferStore: failed to allocate or upload buffer memory");
+}
+
+void BufferData(context *C, object *Object, GLsizeiptr Size, const void *Data, GLenum Usage, VkBufferUsageFlags VulkanUsage, const char *Name) {
+    CheckGL(Size < 0, gl_error_BUFFER_DATA_SIZE);
+    u32 MemoryFlags = 0;
+    CheckGL(GetBufferUsageMemoryFlags(Usage, &MemoryFlags), gl_error_BUFFER_DATA_USAGE);
+    CheckGL(Object->Buffer.IsImmutable, gl_error_BUFFER_DATA_IMMUTABLE);
+
+    SpecifyBufferStore(C, Object, Size, Data, VulkanUsage, MemoryFlags, Name);
+    Object->Buffer.StorageFlags = GL_MAP_READ_BIT | GL_MAP_WRITE_BIT | GL_DYNAMIC_STORAGE_BIT;
+    Object->Buffer.IsReadBack = Usage == GL_STATIC_READ || Usage == GL_DYNAMIC_READ || Usage == GL_STREAM_READ;
+}
+
+// NOTE(blackedout): Mappable storage lives in persistently mapped host visible memory from the start, so maps never move it.
+// Client storage asks for memory on the host side, everything else prefers device local memory.
+static u32 GetBufferStorageMemoryFlags(GLbitfield Flags) {
+    u32 MemoryFlags = 0;
+    if(Flags & (GL_MAP_READ_BIT | GL_MAP_WRITE_BIT | GL_CLIENT_STORAGE_BIT)) {
+        MemoryFlags |= buffer_memory_HOST_VISIBLE;
+    }
+    if((Flags & GL_CLIENT_STORAGE_BIT) == 0) {
+        MemoryFlags |= buffer_memory_DEVICE_LOCAL;
+    }
+    if(Flags & GL_MAP_READ_BIT) {
+        MemoryFlags |= buffer_memory_HOST_READ;
+    }
+    if(Flags & GL_MAP_COHERENT_BIT) {
+        MemoryFlags |= buffer_memory_HOST_COHERENT;
+    }
+    return MemoryFlags;
+}
+
+void BufferStorage(context *C, object *Object, GLsizeiptr Size, const void *Data, GLbitfield Flags, VkBufferUsageFlags VulkanUsage, const char *Name) {
+    const GLbitfield ValidFlags = GL_DYNAMIC_STORAGE_BIT | GL_MAP_READ_BIT | GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT | GL_CLIENT_STORAGE_BIT;
+    CheckGL(Size <= 0, gl_error_BUFFER_STORAGE_SIZE);
+    CheckGL(Flags & ~ValidFlags, gl_error_BUFFER_STORAGE_FLAGS);
+    CheckGL((Flags & GL_MAP_PERSISTENT_BIT) && (Flags & (GL_MAP_READ_BIT | GL_MAP_WRITE_BIT)) == 0, gl_error_BUFFER_STORAGE_PERSISTENT);
+    CheckGL((Flags & GL_MAP_COHERENT_BIT) && (Flags & GL_MAP_PERSISTENT_BIT) == 0, gl_error_BUFFER_STORAGE_COHERENT);
+    CheckGL(Object->Buffer.IsImmutable, gl_error_BUFFER_STORAGE_IMMUTABLE);
+
+    SpecifyBufferStore(C, Object, Size, Data, VulkanUsage, GetBufferStorageMemoryFlags(Flags), Name);
+    if(Object->Buffer.Buffer != VK_NULL_HANDLE) {
+        Object->Buffer.IsImmutable = 1;
+        Object->Buffer.StorageFlags = Flags;
+        Object->Buffer.IsReadBack = (Flags & GL_MAP_READ_BIT) != 0;
+    }
+}
+
+// NOTE(blackedout): Host visible memory is written in place, device local memory by a transfer in the command stream.
+// Whole buffer updates of memory that isn't in use go through the transfer batch instead.
+void BufferSubData(context *C, object *Object, GLintptr Offset, GLsizeiptr Size, const void *Data, const char *Name) {
+    CheckGL(Offset < 0 || Size < 0 || (u64)Offset + (u64)Size > Object->Buffer.ByteCount, gl_error_BUFFER_SUB_DATA_VALUE);
+    int IsMappedRange = Object->Buffer.IsMapped && (u64)Offset < Object->Buffer.MapOffset + Object->Buffer.MapLength && Object->Buffer.MapOffset < (u64)(Offset + Size);
+    CheckGL(IsMappedRange && (Object->Buffer.MapAccess & GL_MAP_PERSISTENT_BIT) == 0, gl_error_BUFFER_SUB_DATA_MAPPED);
+    CheckGL(Object->Buffer.IsImmutable && (Object->Buffer.StorageFlags & GL_DYNAMIC_STORAGE_BIT) == 0, gl_error_BUFFER_SUB_DATA_IMMUTABLE);
+    if(Size == 0 || Data == 0) {
+        return;
+    }
+
+    int IsWhole = Offset == 0 && (u64)Size == Object->Buffer.ByteCount;
+    int IsInUse = IsBufferInUse(C, Object);
+    int IsHostVisible = (Object->Buffer.MemoryFlags & buffer_memory_HOST_VISIBLE) != 0;
+    if(IsHostVisible && Object->Buffer.IsMapped == 0) {
+        if(IsInUse && RenameBufferMemory(C, Object, Object->Buffer.MemoryFlags, IsWhole == 0)) {
+            goto label_OutOfMemory;
+        }
+        memcpy(Object->Buffer.Mapped + Offset, Data, Size);
+        if(VulkanCheck(C, vmaFlushAllocation(C->Allocator, Object->Buffer.Allocation, Offset, Size), "vmaFlushAllocation")) {
+            return;
+        }
+    } else if(IsWhole && IsInUse == 0 && IsHostVisible == 0) {
+        if(RecordBufferUpload(C, Object->Buffer.Buffer, Object->Buffer.Offset, Data, Size)) {
+            goto label_OutOfMemory;
+        }
+    } else {
+        // NOTE(blackedout): Persistently mapped buffers keep their memory, the client may hold the pointer
+        if(IsBufferRead(C, Object) && Object->Buffer.IsMapped == 0 && RenameBufferMemory(C, Object, 0, IsWhole == 0)) {
+            goto label_OutOfMemory;
+        }
+        if(PushBufferUpdate(C, Object, Offset, Data, Size)) {
+            goto label_OutOfMemory;
+        }
+    }
+    UploadExpandedIndices(C, Object, Offset, Data, Size, 0, Name);
+    return;
+
+label_OutOfMemory:
+    GenerateErrorMsg(C, GL_OUT_OF_MEMORY, GL_DEBUG_SOURCE_API, "BufferSubData: failed to allocate or upload buffer memory");
+}
+
+// NOTE(blackedout): Recorded as a transfer at its position in the command stream, so it sees every earlier update.
+// Like any buffer write, a destination that commands of this frame read is renamed first.
+void CopyBufferSubData(context *C, object *Read, object *Write, GLintptr ReadOffset, GLintptr WriteOffset, GLsizeiptr Size, const char *Name) {
+    CheckGL(ReadOffset < 0 || WriteOffset < 0 || Size < 0, gl_error_COPY_BUFFER_SUB_DATA_NEGATIVE);
+    CheckGL((u64)ReadOffset + (u64)Size > Read->Buffer.ByteCount || (u64)WriteOffset + (u64)Size > Write->Buffer.ByteCount, gl_error_COPY_BUFFER_SUB_DATA_RANGE);
+    CheckGL(Read == Write && ReadOffset < WriteOffset + Size && WriteOffset < ReadOffset + Size, gl_error_COPY_BUFFER_SUB_DATA_OVERLAP);
+    int IsReadMapped = Read->Buffer.IsMapped && (Read->Buffer.MapAccess & GL_MAP_PERSISTENT_BIT) == 0;
+    int IsWriteMapped = Write->Buffer.IsMapped && (Write->Buffer.MapAccess & GL_MAP_PERSISTENT_BIT) == 0;
+    CheckGL(IsReadMapped || IsWriteMapped, gl_error_COPY_BUFFER_SUB_DATA_MAPPED);
+    if(Size == 0) {
+        return;
+    }
+
+    int IsWhole = WriteOffset == 0 && (u64)Size == Write->Buffer.ByteCount;
+    if(IsBufferRead(C, Write) && Write->Buffer.IsMapped == 0) {
+        if(RenameBufferMemory(C, Write, Write->Buffer.MemoryFlags, IsWhole == 0)) {
+            GenerateErrorMsg(C, GL_OUT_OF_MEMORY, GL_DEBUG_SOURCE_API, "CopyBufferSubData: failed to allocate buffer memory");
+            return;
+        }
+    }
+
+    // NOTE(blackedout): Read after renaming, the source may be the destination
+    command Command = {
+        .Type = command_COPY_BUFFER,
+        .CopyBuffer = {
+            .SrcBuffer = Read->Buffer.Buffer,
+            .DstBuffer = Write->Buffer.Buffer,
+            .SrcOffset = Read->Buffer.Offset + ReadOffset,
+            .DstOffset = Write->Buffer.Offset + WriteOffset,
+            .ByteCount = Size,
+        },
+    };
+    if(PushOutsideRenderPassCommand(C, Command)) {
+        GenerateErrorMsg(C, GL_OUT_OF_MEMORY, GL_DEBUG_SOURCE_API, "CopyBufferSubData: failed to record copy");
+        return;
+    }
+    MarkBufferRead(C, Read);
+    Write->Buffer.LastUseFrame = C->SwapCounter + 1;
+    Write->Buffer.IsExpandedIndexBufferStale = 1;
+}
+
+// NOTE(blackedout): Host visible memory is read in place. Device local memory of buffers meant to be read back (see `IsReadBack`)
+// is moved into host cached memory first, so later reads are plain memory copies. Other buffers keep their memory, since the
+// device keeps writing them (e.g. a counter of a culling dispatch), they are read through a temporary host cached copy.
+// Pending transfers of the current frame into the range run before the read. If shaders or pixel reads of the frame are still
+// to write it, moving the buffer would lose their writes, so it is read through a temporary copy and the read is reported.
+void GetBufferSubData(context *C, object *Object, GLintptr Offset, GLsizeiptr Size, void *Data, const char *Name) {
+    CheckGL(Offset < 0 || Size < 0 || (u64)Offset + (u64)Size > Object->Buffer.ByteCount, gl_error_GET_BUFFER_SUB_DATA_VALUE);
+    CheckGL(Object->Buffer.IsMapped && (Object->Buffer.MapAccess & GL_MAP_PERSISTENT_BIT) == 0, gl_error_GET_BUFFER_SUB_DATA_MAPPED);
+    if(Size == 0 || Data == 0) {
+        return;
+    }
+
+    int IsPending = IsBufferInUse(C, Object) && HasPendingBufferWrites(C, Object->Buffer.Buffer, Object->Buffer.Offset + Offset, Size);
+    if(IsPending) {
+        if(RunPendingTransfers(C)) {
+            GenerateErrorMsg(C, GL_OUT_OF_MEMORY, GL_DEBUG_SOURCE_API, "GetBufferSubData: failed to run the pending transfers of the frame");
+            return;
+        }
+        IsPending = HasPendingBufferWrites(C, Object->Buffer.Buffer, Object->Buffer.Offset + Offset, Size);
+        if(IsPending) {
+            GenerateOther(C, GL_DEBUG_SOURCE_API, "GetBufferSubData: shader writes or pixel reads of the current frame into the range have not run yet, read it once a fence of the frame is signaled");
+        }
+    }
+    if((Object->Buffer.MemoryFlags & buffer_memory_HOST_VISIBLE) == 0) {
+        if(IsPending || Object->Buffer.IsReadBack == 0) {
+            if(ReadDeviceLocalBuffer(C, Object, Offset, Size, Data)) {
+                GenerateErrorMsg(C, GL_OUT_OF_MEMORY, GL_DEBUG_SOURCE_API, "GetBufferSubData: failed to read device local memory");
+            }
+            return;
+        }
+        if(RenameBufferMemory(C, Object, buffer_memory_HOST_VISIBLE | buffer_memory_HOST_READ, 1)) {
+            GenerateErrorMsg(C, GL_OUT_OF_MEMORY, GL_DEBUG_SOURCE_API, "GetBufferSubData: failed to allocate host visible memory");
+            return;
+        }
+    } else if((Object->Buffer.MemoryFlags & buffer_memory_HOST_COHERENT) == 0) {
+        if(VulkanCheck(C, vmaInvalidateAllocation(C->Allocator, Object->Buffer.Allocation, Offset, Size), "vmaInvalidateAllocation")) {
+            return;
+        }
+    }
+    memcpy(Data, Object->Buffer.Mapped + Offset, Size);
+}
+
+// NOTE(blackedout): Invalidating the whole data store of a buffer that commands of this frame use renames it, so later writes
+// don't have to preserve the old contents. Idle memory and partial invalidation are left as they are.
+void InvalidateBufferSubData(context *C, object *Object, GLintptr Offset, GLsizeiptr Length, const char *Name) {
+    CheckGL(Offset < 0 || Length < 0 || (u64)Offset + (u64)Length > Object->Buffer.ByteCount, gl_error_INVALIDATE_BUFFER_SUB_DATA_VALUE);
+    int IsMappedRange = Object->Buffer.IsMapped && (u64)Offset < Object->Buffer.MapOffset + Object->Buffer.MapLength && Object->Buffer.MapOffset < (u64)(Offset + Length);
+    CheckGL(IsMappedRange && (Object->Buffer.MapAccess & GL_MAP_PERSISTENT_BIT) == 0, gl_error_INVALIDATE_BUFFER_MAPPED);
+
+    int IsWhole = Offset == 0 && (u64)Length == Object->Buffer.ByteCount;
+    // NOTE(blackedout): Persistently mapped buffers keep their memory, the client may hold the pointer
+    if(IsWhole && Length > 0 && IsBufferInUse(C, Object) && Object->Buffer.IsMapped == 0) {
+        if(RenameBufferMemory(C, Object, Object->Buffer.MemoryFlags, 0)) {
+            GenerateErrorMsg(C, GL_OUT_OF_MEMORY, GL_DEBUG_SOURCE_API, "InvalidateBufferSubData: failed to allocate buffer memory");
+        }
+    }
+}
+
+// NOTE(blackedout): Reads of the default framebuffer into a pixel pack buffer are recorded as a copy out of the swapchain image
+// at their position in the command stream, which ends the render pass there, so the copy sees the draws before the call. The
+// copy goes into the memory the buffer already has, host cached memory for the *_READ usages, so the pixels can be read after a
+// fence of the frame without waiting on the device. The buffer is written in place even if commands of this frame use it, those
+// before the call run before the copy and those after it see the pixels.
+// TODO(blackedout): Reads into client memory, other framebuffers, format conversion and the pixel pack state
+void ReadPixels(context *C, GLint X, GLint Y, GLsizei Width, GLsizei Height, GLenum Format, GLenum Type, void *Pixels, const char *Name) {
+    CheckGL(Width < 0 || Height < 0, gl_error_READ_PIXELS_SIZE_NEGATIVE);
+
+    buffer_target_info TargetInfo = {0};
+    Assert(0 == GetBufferTargetInfo(GL_PIXEL_PACK_BUFFER, &TargetInfo));
+    object *Object = 0;
+    GLuint Pbo = C->BoundBuffers[TargetInfo.Index];
+    if(Pbo == 0 || CheckObjectTypeGet(C, Pbo, object_BUFFER, &Object)) {
+        GenerateOther(C, GL_DEBUG_SOURCE_API, "ReadPixels: reads into client memory are not supported, bind a pixel pack buffer");
+        return;
+    }
+    CheckGL(Object->Buffer.IsMapped && (Object->Buffer.MapAccess & GL_MAP_PERSISTENT_BIT) == 0, gl_error_READ_PIXELS_PACK_MAPPED);
+
+    GLenum SurfaceFormat = GL_NONE;
+    switch(C->DeviceInfo.InitialSurfaceFormat.format) {
+    case VK_FORMAT_R8G8B8A8_UNORM:
+    case VK_FORMAT_R8G8B8A8_SRGB: SurfaceFormat = GL_RGBA; break;
+    case VK_FORMAT_B8G8R8A8_UNORM:
+    case VK_FORMAT_B8G8R8A8_SRGB: SurfaceFormat = GL_BGRA; break;
+    default: break;
+    }
+    u64 Offset = (u64)(uintptr_t)Pixels;
+    if(C->BoundReadFbo != 0 || Format != SurfaceFormat || Type != GL_UNSIGNED_BYTE || Offset % 4 != 0) {
+        GenerateOther(C, GL_DEBUG_SOURCE_API, "ReadPixels: only reads of the default framebuffer in its own channel order as UNSIGNED_BYTE to a multiple of 4 bytes are supported");
+        return;
+    }
+    CheckGL(Offset + 4*(u64)Width*(u64)Height > Object->Buffer.ByteCount, gl_error_READ_PIXELS_PACK_RANGE);
+
+    // NOTE(blackedout): Pixels outside of the framebuffer are undefined, they are not written
+    VkExtent2D Extent = C->DeviceInfo.SurfaceCapabilities.currentExtent;
+    int64_t X0 = Max(X, 0);
+    int64_t Y0 = Max(Y, 0);
+    int64_t X1 = Min((int64_t)X + Width, (int64_t)Extent.width);
+    int64_t Y1 = Min((int64_t)Y + Height, (int64_t)Extent.height);
+    if(X1 <= X0 || Y1 <= Y0) {
+        return;
+    }
+
+    command Command = {
+        .Type = command_READ_PIXELS,
+        .ReadPixels = {
+            .Buffer = Object->Buffer.Buffer,
+            .Offset = Object->Buffer.Offset + Offset + 4*((u64)(Y0 - Y)*Width + (u64)(X0 - X)),
+            .ImageOffset = { .x = (int32_t)X0, .y = (int32_t)Y0 },
+            .ImageExtent = { .width = (u32)(X1 - X0), .height = (u32)(Y1 - Y0) },
+            .RowLength = Width,
+        },
+    };
+    if(PushRenderPassEndingCommand(C, Command)) {
+        GenerateErrorMsg(C, GL_OUT_OF_MEMORY, GL_DEBUG_SOURCE_API, "ReadPixels: failed to record copy");
+        return;
+    }
+    // NOTE(blackedout): Counts as a read, so later updates rename the buffer instead of relying on the order of the copies
+    MarkBufferRead(C, Object);
+    Object->Buffer.IsReadBack = 1;
+    Object->Buffer.IsExpandedIndexBufferStale = 1;
+}
+
+// NOTE(blackedout): MARK: Render pass cache
+
+static int AppendRenderPassKey(context *C, const void *Bytes, u32 ByteCount) {
+    if(ArrayRequireRoom(&C->TmpRenderPassKey, ByteCount, 1, 256)) {
+        return 1;
+    }
+    memcpy(ArrayData(u8, C->TmpRenderPassKey) + C->TmpRenderPassKey.Count, Bytes, ByteCount);
+    C->TmpRenderPassKey.Count += ByteCount;
+    return 0;
+}
+
+// NOTE(blackedout): Serializes everything that makes two render passes different (attachment formats, sample counts,
+// load/store ops, layouts and the subpass layout) and returns the cached render pass with the same key or creates it.
+// Render passes with equal keys are compatible, so a pipeline built against one works with every framebuffer sharing it.
+static int AcquireRenderPass(context *C, const VkRenderPassCreateInfo *CreateInfo, VkRenderPass *OutRenderPass) {
+    C->TmpRenderPassKey.Count = 0;
+    int IsOutOfMemory = AppendRenderPassKey(C, &CreateInfo->attachmentCount, sizeof(u32));
+    IsOutOfMemory |= AppendRenderPassKey(C, CreateInfo->pAttachments, CreateInfo->attachmentCount*sizeof(VkAttachmentDescription));
+    IsOutOfMemory |= AppendRenderPassKey(C, &CreateInfo->subpassCount, sizeof(u32));
+    for(u32 I = 0; I < CreateInfo->subpassCount; ++I) {
+        const VkSubpassDescription *Subpass = CreateInfo->pSubpasses + I;
+        IsOutOfMemory |= AppendRenderPassKey(C, &Subpass->colorAttachmentCount, sizeof(u32));
+        for(u32 J = 0; J < Subpass->colorAttachmentCount; ++J) {
+            // NOTE(blackedout): The layout of unused references is never written, so it must not be part of the key
+            VkAttachmentReference Reference = Subpass->pColorAttachments[J];
+            if(Reference.attachment == VK_ATTACHMENT_UNUSED) {
+                Reference.layout = VK_IMAGE_LAYOUT_UNDEFINED;
+            }
+            IsOutOfMemory |= AppendRenderPassKey(C, &Reference, sizeof(VkAttachmentReference));
+        }
+    }
+    if(IsOutOfMemory) {
+        return 1;
+    }
+
+    const u8 *Key = ArrayData(u8, C->TmpRenderPassKey);
+    u32 KeyByteCount = (u32)C->TmpRenderPassKey.Count;
+    u64 Hash = HashBytes(Key, KeyByteCount);
+    render_pass_cache_entry *Entries = ArrayData(render_pass_cache_entry, C->RenderPasses);
+    for(u64 I = 0; I < C->RenderPasses.Count; ++I) {
+        render_pass_cache_entry *Entry = Entries + I;
+        if(Entry->Hash == Hash && Entry->KeyByteCount == KeyByteCount && memcmp(Entry->Key, Key, KeyByteCount) == 0) {
+            ++Entry->ReferenceCount;
+            Entry->LastUseSwapCounter = C->SwapCounter;
+            *OutRenderPass = Entry->RenderPass;
+            return 0;
+        }
+    }
+
+    if(ArrayRequireRoom(&C->RenderPasses, 1, sizeof(render_pass_cache_entry), INITIAL_RENDER_PASS_CACHE_CAPACITY)) {
+        return 1;
+    }
+    render_pass_cache_entry Entry = {
+        .Hash = Hash,
+        .Key = malloc(KeyByteCount),
+        .KeyByteCount = KeyByteCount,
+        .ReferenceCount = 1,
+        .LastUseSwapCounter = C->SwapCounter,
+        .RenderPass = VK_NULL_HANDLE,
+    };
+    if(Entry.Key == 0) {
+        return 1;
+    }
+    memcpy(Entry.Key, Key, KeyByteCount);
+    if(VulkanCheck(C, vkCreateRenderPass(C->Device, CreateInfo, 0, &Entry.RenderPass), "vkCreateRenderPass")) {
+        free(Entry.Key);
+        return 1;
+    }
+    ArrayData(render_pass_cache_entry, C->RenderPasses)[C->RenderPasses.Count++] = Entry;
+    ++C->FrameStats.CreatedRenderPassCount;
+
+    *OutRenderPass = Entry.RenderPass;
+    return 0;
+}
+
+void ReleaseRenderPass(context *C, VkRenderPass RenderPass) {
+    if(RenderPass == VK_NULL_HANDLE) {
+        return;
+    }
+    render_pass_cache_entry *Entries = ArrayData(render_pass_cache_entry, C->RenderPasses);
+    for(u64 I = 0; I < C->RenderPasses.Count; ++I) {
+        if(Entries[I].RenderPass == RenderPass) {
+            Assert(Entries[I].ReferenceCount > 0);
+            --Entries[I].ReferenceCount;
+            Entries[I].LastUseSwapCounter = C->SwapCounter;
+            return;
+        }
+    }
+    Assert(0);
+}
+
+// NOTE(blackedout): Deletes the render passes no framebuffer has used for a while. Keeping them around for some frames
+// serves as the deferred deletion for command buffers still in flight and avoids recreation when a signature comes back.
+void EvictRenderPasses(context *C) {
+    render_pass_cache_entry *Entries = ArrayData(render_pass_cache_entry, C->RenderPasses);
+    u64 KeepCount = 0;
+    for(u64 I = 0; I < C->RenderPasses.Count; ++I) {
+        u64 UnusedSwapCount = C->SwapCounter - Entries[I].LastUseSwapCounter;
+        if(Entries[I].ReferenceCount == 0 && UnusedSwapCount > RENDER_PASS_UNUSED_SWAP_COUNTER_DELETE) {
+            vkDestroyRenderPass(C->Device, Entries[I].RenderPass, 0);
+            free(Entries[I].Key);
+        } else {
+            Entries[KeepCount++] = Entries[I];
+        }
+    }
+    C->RenderPasses.Count = KeepCount;
+}
+
+// NOTE(blackedout): Attachments that are neither cleared nor invalidated keep their contents. The swapchain image's
+// contents are undefined after a swap (as they are in GL), there is nothing to load.
+VkAttachmentLoadOp GetAttachmentLoadOp(GLuint Fbo, u32 ClearLoadMask, u32 DiscardLoadMask, u32 Index) {
+    u32 Bit = Index < 32 ? (1u << Index) : 0;
+    if(ClearLoadMask & Bit) {
+        return VK_ATTACHMENT_LOAD_OP_CLEAR;
+    }
+    if((DiscardLoadMask & Bit) || Fbo == 0) {
+        return VK_ATTACHMENT_LOAD_OP_DONT_CARE;
+    }
+    return VK_ATTACHMENT_LOAD_OP_LOAD;
+}
+
+VkAttachmentStoreOp GetAttachmentStoreOp(u32 DiscardStoreMask, u32 Index) {
+    u32 Bit = Index < 32 ? (1u << Index) : 0;
+    return (DiscardStoreMask & Bit) ? VK_ATTACHMENT_STORE_OP_DONT_CARE : VK_ATTACHMENT_STORE_OP_STORE;
+}
+
+static u32 GetFramebufferAttachmentCount(object *Object) {
+    u32 AttachmentCount = Object->Framebuffer.ColorAttachmentCapacity;
+    for(u32 I = 0; I < Object->Framebuffer.ColorAttachmentCapacity; ++I) {
+        if(Object->Framebuffer.ColorAttachments[I].Rbo == 0) {
+            AttachmentCount = I;
+            break;
+        }
+    }
+    for(u32 I = AttachmentCount; I < Object->Framebuffer.ColorAttachmentCapacity; ++I) {
+        // NOTE(blackedout): Bindings to GL_COLOR_ATTACHMENTi must be dense, skipping a binding entirely is currently not allowed
+        Assert(Object->Framebuffer.ColorAttachments[I].Rbo == 0);
+    }
+    return AttachmentCount;
+}
+
+static VkExtent2D GetFramebufferExtent(context *C, GLuint Fbo, object *Object, u32 AttachmentCount) {
+    if(Fbo == 0) {
+        return C->DeviceInfo.SurfaceCapabilities.currentExtent;
+    }
+    VkExtent2D Extent = { .width = C->DeviceInfo.Properties.limits.maxFramebufferWidth, .height = C->DeviceInfo.Properties.limits.maxFramebufferHeight };
+    for(u32 I = 0; I < AttachmentCount; ++I) {
+        object *ObjectR = 0;
+        Assert(0 == CheckObjectTypeGet(C, Object->Framebuffer.ColorAttachments[I].Rbo, object_RENDERBUFFER, &ObjectR));
+        Extent.width = Min(Extent.width, ObjectR->Renderbuffer.Extent.width);
+        Extent.height = Min(Extent.height, ObjectR->Renderbuffer.Extent.height);
+    }
+    return Extent;
+}
+
+// NOTE(blackedout): Moves the subpass state recorded this frame to the stored state the replay uses and resets it
+static void StoreFramebufferFrameState(object *Object) {
+    ArrayRequireRoom(&Object->Framebuffer.StoredSubpasses, Object->Framebuffer.Subpasses.Count, sizeof(render_pass_state_subpass), 2);
+    ArrayRequireRoom(&Object->Framebuffer.StoredSubpassAttachments, Object->Framebuffer.SubpassAttachments.Count, sizeof(VkAttachmentReference), 2);
+    Object->Framebuffer.StoredSubpasses.Count = Object->Framebuffer.Subpasses.Count;
+    Object->Framebuffer.StoredSubpassAttachments.Count = Object->Framebuffer.SubpassAttachments.Count;
+    memcpy(Object->Framebuffer.StoredSubpasses.Data, Object->Framebuffer.Subpasses.Data, sizeof(render_pass_state_subpass)*Object->Framebuffer.Subpasses.Count);
+    memcpy(Object->Framebuffer.StoredSubpassAttachments.Data, Object->Framebuffer.SubpassAttachments.Data, sizeof(VkAttachmentReference)*Object->Framebuffer.SubpassAttachments.Count);
+    ArrayClear(&Object->Framebuffer.Subpasses, sizeof(render_pass_state_subpass));
+    ArrayClear(&Object->Framebuffer.SubpassAttachments, sizeof(VkAttachmentReference));
+    Object->Framebuffer.StoredDiscardLoadMask = Object->Framebuffer.DiscardLoadMask;
+    Object->Framebuffer.StoredDiscardStoreMask = Object->Framebuffer.DiscardStoreMask;
+    Object->Framebuffer.StoredClearLoadMask = Object->Framebuffer.ClearLoadMask;
+    Object->Framebuffer.DiscardLoadMask = 0;
+    Object->Framebuffer.DiscardStoreMask = 0;
+    Object->Framebuffer.ClearLoadMask = 0;
+    Object->Framebuffer.IsResumed = 0;
+}
+
+int CheckFramebuffer(context *C, GLuint Fbo) {
+    object *Object = 0;
+    Assert(0 == CheckObjectTypeGet(C, Fbo, object_FRAMEBUFFER, &Object));
+
+    if(C->DeviceInfo.HasDynamicRendering) {
+        // NOTE(blackedout): There is nothing to create, the replay begins rendering from the attachment views and the stored
+        // state, see `BeginRendering`. A change of draw buffers is just another begin.
+        if(Object->Framebuffer.Subpasses.Count) {
+            Object->Framebuffer.AttachmentCount = GetFramebufferAttachmentCount(Object);
+            Object->Framebuffer.Extent = GetFramebufferExtent(C, Fbo, Object, Object->Framebuffer.AttachmentCount);
+            StoreFramebufferFrameState(Object);
+        }
+        return 0;
+    }
+
+    if(Object->Framebuffer.RenderPass != VK_NULL_HANDLE) {
+        // NOTE(blackedout): Nothing was drawn into this framebuffer since it was last checked (it is checked once per pipeline
+        // state that uses it), keep what it has
+        if(Object->Framebuffer.Subpasses.Count == 0) {
+            return 0;
+        }
+        // NOTE(blackedout): Render pass and so saved subpass state does exist, compare to current to evaluate if renderpass recreation is necessary
+        if(Object->Framebuffer.StoredSubpasses.Count != Object->Framebuffer.Subpasses.Count) {
+            goto label_NoMatch;
+        }
+        if(memcmp(Object->Framebuffer.StoredSubpasses.Data, Object->Framebuffer.Subpasses.Data, sizeof(render_pass_state_subpass)*Object->Framebuffer.Subpasses.Count) != 0) {
+            goto label_NoMatch;
+        }
+        if(Object->Framebuffer.StoredSubpassAttachments.Count != Object->Framebuffer.SubpassAttachments.Count) {
+            goto label_NoMatch;
+        }
+        if(memcmp(Object->Framebuffer.StoredSubpassAttachments.Data, Object->Framebuffer.SubpassAttachments.Data, sizeof(VkAttachmentReference)*Object->Framebuffer.SubpassAttachments.Count) != 0) {
+            goto label_NoMatch;
+        }
+        if(Object->Framebuffer.StoredDiscardLoadMask != Object->Framebuffer.DiscardLoadMask || Object->Framebuffer.StoredDiscardStoreMask != Object->Framebuffer.DiscardStoreMask) {
+            goto label_NoMatch;
+        }
+        if(Object->Framebuffer.StoredClearLoadMask != Object->Framebuffer.ClearLoadMask) {
+            goto label_NoMatch;
+        }
+        if(Object->Framebuffer.IsResumed && Object->Framebuffer.ResumeRenderPass == VK_NULL_HANDLE) {
+            goto label_NoMatch;
+        }
+
+        // NOTE(blackedout): Match, reset current, keep old one and return
+        ArrayClear(&Object->Framebuffer.Subpasses, sizeof(render_pass_state_subpass));
+        ArrayClear(&Object->Framebuffer.SubpassAttachments, sizeof(VkAttachmentReference));
+        Object->Framebuffer.DiscardLoadMask = 0;
+        Object->Framebuffer.DiscardStoreMask = 0;
+        Object->Framebuffer.ClearLoadMask = 0;
+        Object->Framebuffer.IsResumed = 0;
+
+        return 0;
+
+label_NoMatch:;
+        // NOTE(blackedout): Delete previous render pass and framebuffer. But since these might still be used there is a layer of buffering
+        if(Object->Framebuffer.OldFramebuffer != VK_NULL_HANDLE) {
+            vkDestroyFramebuffer(C->Device, Object->Framebuffer.OldFramebuffer, 0);
+            
+        }
+        Object->Framebuffer.OldFramebuffer = Object->Framebuffer.Framebuffer;
+        Object->Framebuffer.Framebuffer = VK_NULL_HANDLE;
+
+        // NOTE(blackedout): The render pass stays cached for other framebuffers and in flight commands, see `EvictRenderPasses`
+        ReleaseRenderPass(C, Object->Framebuffer.RenderPass);
+        ReleaseRenderPass(C, Object->Framebuffer.ResumeRenderPass);
+        Object->Framebuffer.RenderPass = VK_NULL_HANDLE;
+        Object->Framebuffer.ResumeRenderPass = VK_NULL_HANDLE;
+    }
+
+    Assert(Object->Framebuffer.RenderPass == VK_NULL_HANDLE);
+    Assert(Object->Framebuffer.Framebuffer == VK_NULL_HANDLE);
+
+    VkAttachmentDescription *AttachmentDescriptions = 0;
+    VkImageView *ContiguousImageViews = 0;
+    u32 AttachmentCount = GetFramebufferAttachmentCount(Object);
+
+    AttachmentDescriptions = calloc(AttachmentCount, sizeof(VkAttachmentDescription));
+    if(AttachmentDescriptions == 0) {
+        goto label_Error;
+    }
+    for(u32 I = 0; I < AttachmentCount; ++I) {
+        // TODO(blackedout): Renderbuffer images must be transitioned to the final layout once they have storage, for the load
+        VkAttachmentLoadOp LoadOp = GetAttachmentLoadOp(Fbo, Object->Framebuffer.ClearLoadMask, Object->Framebuffer.DiscardLoadMask, I);
+        VkAttachmentDescription AttachmentDescription = {
+            .flags = 0,
+            .format = C->DeviceInfo.InitialSurfaceFormat.format,
+            .samples = 1,
+            .loadOp = LoadOp,
+            .storeOp = GetAttachmentStoreOp(Object->Framebuffer.DiscardStoreMask, I),
+            .stencilLoadOp = VK_ATTACHMENT_LOAD_OP_DONT_CARE,
+            .stencilStoreOp = VK_ATTACHMENT_STORE_OP_DONT_CARE,
+            .initialLayout = LoadOp == VK_ATTACHMENT_LOAD_OP_LOAD ? VK_IMAGE_LAYOUT_PRESENT_SRC_KHR : VK_IMAGE_LAYOUT_UNDEFINED,
+            .finalLayout = VK_IMAGE_LAYOUT_PRESENT_SRC_KHR,
+        };
+        AttachmentDescriptions[I] = AttachmentDescription;
+    }
+    
+    ArrayRequireRoom(&C->TmpSubpasses, Object->Framebuffer.Subpasses.Count, sizeof(VkSubpassDescription), 1);
+    for(u32 I = 0; I < Object->Framebuffer.Subpasses.Count; ++I) {
+        render_pass_state_subpass *SrcSubpass = ArrayData(render_pass_state_subpass, Object->Framebuffer.Subpasses) + I;
+        VkSubpassDescription *DstSubpass = ArrayData(VkSubpassDescription, C->TmpSubpasses) + I;
+        VkSubpassDescription SubpassDescription = {
+            .flags = 0,
+            .pipelineBindPoint = VK_PIPELINE_BIND_POINT_GRAPHICS,
+            .inputAttachmentCount = 0,
+            .pInputAttachments = 0,
+            .colorAttachmentCount = SrcSubpass->ColorAttachmentCount,
+            .pColorAttachments = ArrayData(VkAttachmentReference, Object->Framebuffer.SubpassAttachments) + SrcSubpass->BaseIndex,
+            .pResolveAttachments = 0,
+            .pDepthStencilAttachment = 0,
+            .preserveAttachmentCount = 0,
+            .pPreserveAttachments = 0,
+        };
+        *DstSubpass = SubpassDescription;
+    }
+
+    VkRenderPassCreateInfo RenderPassCreateInfo = {
+        .sType = VK_STRUCTURE_TYPE_RENDER_PASS_CREATE_INFO,
+        .pNext = 0,
+        .flags = 0,
+        .attachmentCount = AttachmentCount,
+        .pAttachments = AttachmentDescriptions,
+        .subpassCount = Object->Framebuffer.Subpasses.Count,
+        .pSubpasses = ArrayData(VkSubpassDescription, C->TmpSubpasses),
+        .dependencyCount = 0,
+        .pDependencies = 0,
+    };
+
+    if(AcquireRenderPass(C, &RenderPassCreateInfo, &Object->Framebuffer.RenderPass)) {
+        goto label_Error;
+    }
+    if(Object->Framebuffer.IsResumed) {
+        // NOTE(blackedout): Compatible with the framebuffers below, it only differs in loading whatever was drawn before
+        for(u32 I = 0; I < AttachmentCount; ++I) {
+            AttachmentDescriptions[I].loadOp = VK_ATTACHMENT_LOAD_OP_LOAD;
+            AttachmentDescriptions[I].initialLayout = VK_IMAGE_LAYOUT_PRESENT_SRC_KHR;
+        }
+        if(AcquireRenderPass(C, &RenderPassCreateInfo, &Object->Framebuffer.ResumeRenderPass)) {
+            goto label_Error;
+        }
+    }
+
+    u32 FramebufferCount = 0;
+    VkImageView *ImageViews = 0;
+    VkFramebuffer *Framebuffers = 0;
+    VkExtent2D Extent = GetFramebufferExtent(C, Fbo, Object, AttachmentCount);
+    if(Fbo == 0) {
+        ImageViews = C->SwapchainImageViews;
+        Framebuffers = C->SwapchainFramebuffers;
+        FramebufferCount = C->SwapchainImageCount;
+    } else {
+        FramebufferCount = 1;
+        Framebuffers = &Object->Framebuffer.Framebuffer;
+        ContiguousImageViews = calloc(Object->Framebuffer.ColorAttachmentCapacity, sizeof(VkImageView));
+        for(u32 I = 0; I < AttachmentCount; ++I) {
+            object *ObjectR = 0;
+            Assert(0 == CheckObjectTypeGet(C, Object->Framebuffer.ColorAttachments[I].Rbo, object_RENDERBUFFER, &ObjectR));
+            ContiguousImageViews[I] = ObjectR->Renderbuffer.ImageView;
+        }
+        ImageViews = ContiguousImageViews;
+    }
+    Object->Framebuffer.Extent = Extent;
+    Object->Framebuffer.AttachmentCount = AttachmentCount;
+
+    for(u32 I = 0; I < FramebufferCount; ++I) {
+        VkFramebufferCreateInfo FramebufferCreateInfo = {
+            .sType = VK_STRUCTURE_TYPE_FRAMEBUFFER_CREATE_INFO,
+            .pNext = 0,
+            .flags = 0,
+            .renderPass = Object->Framebuffer.RenderPass,
+            .attachmentCount = 1,
+            .pAttachments = C->SwapchainImageViews + I,
+            .width = Extent.width,
+            .height = Extent.height,
+            .layers = 1,
+        };
+
+        VulkanCheckGoto(vkCreateFramebuffer(C->Device, &FramebufferCreateInfo, 0, Framebuffers + I), label_Error);
+    }
+
+    printf("Created Framebuffer\n");
+    StoreFramebufferFrameState(Object);
+
+    int Result = 0;
+    goto label_Exit;
+label_Error:
+    Result = 1;
+label_Exit:
+    free(ContiguousImageViews);
+    free(AttachmentDescriptions);
+    return Result;
+}
+
+static int PushBeginRenderPass(context *C, int IsResume, u32 SubpassIndex) {
+    // NOTE(blackedout): Buffer transfers recorded from now on are inserted before this command
+    C->RenderPassCommandIndex = (u32)C->Commands.Count;
+    C->IsRenderPassRecorded = 1;
+    C->RenderPassFbo = C->BoundDrawFbo;
+    // NOTE(blackedout): Resumed passes may be moved behind other passes (see `MergeRenderPasses`), so each binds its own pipeline
+    C->IsPipelineSet = 0;
+    command Command = {
+        .Type = command_BEGIN_RENDER_PASS,
+        .BeginRenderPass = {
+            .Fbo = C->BoundDrawFbo,
+            .IsResume = IsResume,
+            .SubpassIndex = SubpassIndex,
+        },
+    };
+    return PushCommand(C, Command);
+}
+
+int PotentiallySaveSubpass(context *C, u32 *OutSubpassIndex) {
+    object *Object = 0;
+    Assert(0 == CheckObjectTypeGet(C, C->BoundDrawFbo, object_FRAMEBUFFER, &Object));
+    // NOTE(blackedout): Drawing defines invalidated contents again
+    Object->Framebuffer.DiscardStoreMask = 0;
+
+    if(Object->Framebuffer.Subpasses.Count) {
+        // NOTE(blackedout): Compare previous subpass to current
+        u32 PrevIndex = Object->Framebuffer.Subpasses.Count - 1;
+        render_pass_state_subpass *PrevSubpass = ArrayData(render_pass_state_subpass, Object->Framebuffer.Subpasses) + PrevIndex;
+        if(PrevSubpass->ColorAttachmentCount != Object->Framebuffer.ColorAttachmentRange) {
+            goto label_NoMatch;
+        }
+
+        VkAttachmentReference *ColorRefs = ArrayData(VkAttachmentReference, Object->Framebuffer.SubpassAttachments) + (u32)PrevSubpass->ColorAttachmentCount;
+        for(u32 I = 0; I < Object->Framebuffer.ColorAttachmentRange; ++I) {
+            framebuffer_attachment *Attachment = Object->Framebuffer.ColorAttachments + I;
+            if(Attachment->IsDrawBuffer) {
+                if(ColorRefs[I].attachment != I) {
+                    goto label_NoMatch;
+                }
+            } else {
+                if(ColorRefs[I].attachment != VK_ATTACHMENT_UNUSED) {
+                    goto label_NoMatch;
+                }
+            }
+        }
+
+        // NOTE(blackedout): Match, only a different framebuffer drawn to or a render pass ending command in between has to be left again
+        *OutSubpassIndex = PrevIndex;
+        if(C->IsRenderPassRecorded == 0 || C->RenderPassFbo != C->BoundDrawFbo) {
+            return PushBeginRenderPass(C, 1, PrevIndex);
+        }
+        return 0;
+    }
+label_NoMatch:;
+
+    // NOTE(blackedout): Must save
+    u32 AttachmentStartIndex = Object->Framebuffer.SubpassAttachments.Count;
+    ArrayRequireRoom(&Object->Framebuffer.SubpassAttachments, Object->Framebuffer.ColorAttachmentRange, sizeof(VkAttachmentReference), 2);
+
+    VkAttachmentReference *References = ArrayData(VkAttachmentReference, Object->Framebuffer.SubpassAttachments) + AttachmentStartIndex;
+    for(u32 I = 0; I < Object->Framebuffer.ColorAttachmentRange; ++I) {
+        framebuffer_attachment *Attachment = Object->Framebuffer.ColorAttachments + I;
+        if(Attachment->IsDrawBuffer) {
+            References[I].attachment = I;
+            References[I].layout = VK_IMAGE_LAYOUT_GENERAL;
+        } else {
+            References[I].attachment = VK_ATTACHMENT_UNUSED;
+        }
+    }
+    Object->Framebuffer.SubpassAttachments.Count += Object->Framebuffer.ColorAttachmentRange;
+
+    ArrayRequireRoom(&Object->Framebuffer.Subpasses, 1, sizeof(VkSubpassDescription), 1);
+    render_pass_state_subpass *SubpassDescriptions = ArrayData(render_pass_state_subpass, Object->Framebuffer.Subpasses);
+    u32 NewSubpassIndex = Object->Framebuffer.Subpasses.Count++;
+    SubpassDescriptions[NewSubpassIndex].ColorAttachmentCount = Object->Framebuffer.ColorAttachmentRange;
+    SubpassDescriptions[NewSubpassIndex].BaseIndex = AttachmentStartIndex;
+
+    *OutSubpassIndex = NewSubpassIndex;
+    if(NewSubpassIndex == 0 || C->IsRenderPassRecorded == 0 || C->RenderPassFbo != C->BoundDrawFbo) {
+        PushBeginRenderPass(C, NewSubpassIndex != 0, NewSubpassIndex);
+    } else {
+        command Command = {
+            .Type = command_NEXT_SUBPASS,
+            .NextSubpass = {
+                .SubpassIndex = NewSubpassIndex
+            },
+        };
+        PushCommand(C, Command);
+    }
+
+    return 0;
+}
+
+// NOTE(blackedout): Whether the rectangle covers the whole framebuffer, which may not have its extent yet
+static int IsWholeFramebuffer(context *C, GLuint Fbo, object *Object, GLint X, GLint Y, GLsizei Width, GLsizei Height) {
+    VkExtent2D Extent = Fbo == 0 ? C->DeviceInfo.SurfaceCapabilities.currentExtent : Object->Framebuffer.Extent;
+    if(Extent.width == 0 || Extent.height == 0) {
+        // NOTE(blackedout): The framebuffer wasn't used yet, only rectangles covering the maximum size cover it for sure
+        Extent.width = C->DeviceInfo.Properties.limits.maxFramebufferWidth;
+        Extent.height = C->DeviceInfo.Properties.limits.maxFramebufferHeight;
+    }
+    return X <= 0 && Y <= 0 && (int64_t)X + Width >= (int64_t)Extent.width && (int64_t)Y + Height >= (int64_t)Extent.height;
+}
+
+// NOTE(blackedout): Invalidation before the first draw of the frame into the framebuffer means the attachments need not be loaded,
+// after a draw that they need not be stored (unless drawn again). Both become DONT_CARE ops of the render pass that
+// `CheckFramebuffer` builds at the end of the frame. Only invalidation of whole attachments is used, a part is ignored.
+// TODO(blackedout): Depth and stencil, once framebuffers have those attachments
+void InvalidateFramebuffer(context *C, GLuint Fbo, GLsizei Count, const GLenum *Attachments, GLint X, GLint Y, GLsizei Width, GLsizei Height, const char *Name) {
+    CheckGL(Count < 0 || Width < 0 || Height < 0, gl_error_INVALIDATE_FRAMEBUFFER_NEGATIVE);
+    object *Object = 0;
+    Assert(0 == CheckObjectTypeGet(C, Fbo, object_FRAMEBUFFER, &Object));
+
+    u32 Mask = 0;
+    for(GLsizei I = 0; I < Count; ++I) {
+        GLenum Attachment = Attachments[I];
+        if(Fbo == 0) {
+            CheckGL(Attachment != GL_COLOR && Attachment != GL_DEPTH && Attachment != GL_STENCIL, gl_error_INVALIDATE_FRAMEBUFFER_ATTACHMENT_DEFAULT);
+            if(Attachment == GL_COLOR) {
+                Mask |= 1;
+            }
+        } else if(Attachment >= GL_COLOR_ATTACHMENT0 && Attachment <= GL_COLOR_ATTACHMENT31) {
+            u32 Index = Attachment - GL_COLOR_ATTACHMENT0;
+            CheckGL(Index >= Object->Framebuffer.ColorAttachmentCapacity, gl_error_INVALIDATE_FRAMEBUFFER_COLOR_INDEX);
+            Mask |= 1u << Index;
+        } else {
+            int IsDepthStencil = Attachment == GL_DEPTH_ATTACHMENT || Attachment == GL_STENCIL_ATTACHMENT || Attachment == GL_DEPTH_STENCIL_ATTACHMENT;
+            CheckGL(IsDepthStencil == 0, gl_error_INVALIDATE_FRAMEBUFFER_ATTACHMENT);
+        }
+    }
+
+    if(IsWholeFramebuffer(C, Fbo, Object, X, Y, Width, Height) == 0) {
+        return;
+    }
+    if(Object->Framebuffer.Subpasses.Count == 0) {
+        Object->Framebuffer.DiscardLoadMask |= Mask;
+    } else {
+        Object->Framebuffer.DiscardStoreMask |= Mask;
+    }
+}
+
+// NOTE(blackedout): A clear of whole color attachments before the first draw into the framebuffer this frame becomes the
+// CLEAR load op of the render pass `CheckFramebuffer` builds, with the clear color passed to the render pass begin. Any
+// other clear is recorded as a clear command inside the render pass.
+// TODO(blackedout): Depth and stencil, once framebuffers have those attachments
+void Clear(context *C, GLbitfield Mask, const char *Name) {
+    object *Object = 0;
+    if(CheckObjectTypeGet(C, C->BoundDrawFbo, object_FRAMEBUFFER, &Object)) {
+        GenerateErrorMsg(C, GL_INVALID_OPERATION, GL_DEBUG_SOURCE_APPLICATION, "glClear: TODO invalid framebuffer");
+        return;
+    }
+
+    pipeline_state_scissor *Scissor = GetCurrentPipelineState(C, pipeline_state_SCISSOR);
+    int IsScissored = C->Config.ScissorEnabled;
+    if(IsScissored && IsWholeFramebuffer(C, C->BoundDrawFbo, Object, Scissor->offset.x, Scissor->offset.y, (GLsizei)Scissor->extent.width, (GLsizei)Scissor->extent.height)) {
+        IsScissored = 0;
+    }
+    u32 ClearLoadMask = 0;
+    if((Mask & GL_COLOR_BUFFER_BIT) && IsScissored == 0 && Object->Framebuffer.Subpasses.Count == 0) {
+        for(u32 I = 0; I < Object->Framebuffer.ColorAttachmentRange && I < 32; ++I) {
+            if(Object->Framebuffer.ColorAttachments[I].IsDrawBuffer) {
+                ClearLoadMask |= 1u << I;
+            }
+        }
+    }
+
+    u32 SubpassIndex = 0;
+    CheckGL(PotentiallySaveSubpass(C, &SubpassIndex), gl_error_OUT_OF_MEMORY);
+    // TODO(blackedout): Make pipeline have a is fixed bit for each state type, such that a draw which doesn't use a program
+    // can leave the program state as unset, such that a following draw command is able to edit the program state
+    pipeline_state_type Types[] = {
+        pipeline_state_CLEAR_COLOR,
+        pipeline_state_VIEWPORT,
+        pipeline_state_SCISSOR,
+        pipeline_state_FRAMEBUFFER,
+        pipeline_state_DRAW_BUFFERS,
+    };
+    CheckGL(UseCurrentPipelineState(C, ArrayCount(Types), Types), gl_error_OUT_OF_MEMORY);
+
+    if(ClearLoadMask) {
+        // NOTE(blackedout): The first subpass was just saved, which began the render pass
+        pipeline_state_clear_color *ClearColor = GetCurrentPipelineState(C, pipeline_state_CLEAR_COLOR);
+        command *BeginCommand = ArrayData(command, C->Commands) + C->RenderPassCommandIndex;
+        Assert(BeginCommand->Type == command_BEGIN_RENDER_PASS);
+        VkClearColorValue Color = { .float32 = { ClearColor->R, ClearColor->G, ClearColor->B, ClearColor->A } };
+        BeginCommand->BeginRenderPass.ClearColor = Color;
+        Object->Framebuffer.ClearLoadMask |= ClearLoadMask;
+        Mask &= ~GL_COLOR_BUFFER_BIT;
+        if(Mask == 0) {
+            return;
+        }
+    }
+
+    command Command = {0};
+    Command.Type = command_CLEAR;
+    Command.Clear.SubpassIndex = SubpassIndex;
+    Command.Clear.Mask = Mask;
+    Command.Clear.IsScissored = IsScissored;
+    Command.Clear.Scissor = *Scissor;
+    CheckGL(PushCommand(C, Command), gl_error_OUT_OF_MEMORY);
+}
+
+// NOTE(blackedout): See https://docs.vulkan.org/spec/latest/chapters/limits.html (2025-11-13)
+static pipeline_state_info_params PipelineStateInfoParams[] = {
+#define MakeStaticEntry(EnumType, StateType) [(EnumType)] = { sizeof(StateType), ~((u32)0) }
+#define MakeDynamicEntry(EnumType, StateType, LimitsByteOffset) [(EnumType)] = { sizeof(StateType), (u32)(LimitsByteOffset) }
+
+    MakeStaticEntry(pipeline_state_HEADER, pipeline_state_header),
+    MakeStaticEntry(pipeline_state_CLEAR_COLOR, pipeline_state_clear_color),
+    MakeStaticEntry(pipeline_state_CLEAR_DEPTH, pipeline_state_clear_depth),
+    MakeStaticEntry(pipeline_state_CLEAR_STENCIL, pipeline_state_clear_stencil),
+    MakeDynamicEntry(pipeline_state_VIEWPORT, pipeline_state_viewport, offsetof(VkPhysicalDeviceLimits,  maxViewports)),
+    MakeDynamicEntry(pipeline_state_SCISSOR, pipeline_state_scissor, offsetof(VkPhysicalDeviceLimits,  maxViewports)),
+    MakeStaticEntry(pipeline_state_FRAMEBUFFER, pipeline_state_framebuffer),
+    MakeDynamicEntry(pipeline_state_DRAW_BUFFERS, pipeline_state_draw_buffer, offsetof(VkPhysicalDeviceLimits, maxColorAttachments)),
+    //MakeStaticEntry(pipeline_state_VERTEX_ARRAY, pipeline_state_vertex_array),
+    MakeDynamicEntry(pipeline_state_VERTEX_INPUT_ATTRIBUTES, pipeline_state_vertex_input_attribute, offsetof(VkPhysicalDeviceLimits, maxVertexInputAttributes)),
+    MakeDynamicEntry(pipeline_state_VERTEX_INPUT_BINDINGS, pipeline_state_vertex_input_binding, offsetof(VkPhysicalDeviceLimits, maxVertexInputBindings)),
+    MakeStaticEntry(pipeline_state_PROGRAM, pipeline_state_program),
+    MakeStaticEntry(pipeline_state_PRIMITIVE_TYPE, pipeline_state_primitive_type),
+    MakeDynamicEntry(pipeline_state_FLAGS, pipeline_state_flags, pipeline_state_COUNT),
+
+#undef MakeDynamicEntry
+#undef MakeStaticEntry
+};
+StaticAssert(ArrayCount(PipelineStateInfoParams) == pipeline_state_COUNT);
+
+static void SetPipelineStateInfos(pipeline_state_info *Infos, const VkPhysicalDeviceLimits *Limits, u32 *OutByteCount) {
+    u32 ByteOffset = 0;
+    for(u32 I = 0; I < ArrayCount(PipelineStateInfoParams); ++I) {
+        pipeline_state_info_params Params = PipelineStateInfoParams[I];
+        u32 InstanceCount = 1;
+        if(Params.LimitsByteOffset != (~((u32)0))) {
+            InstanceCount = *(uint32_t *)(((const u8 *)Limits) + Params.LimitsByteOffset);
+        }
+
+        pipeline_state_info Info = {
+            .ByteOffset = ByteOffset,
+            .InstaceByteCount = Params.InstanceByteCount,
+            .InstanceCount = InstanceCount,
+        };
+        Infos[I] = Info;
+        ByteOffset += Info.InstaceByteCount*Info.InstanceCount;
+    }
+    *OutByteCount = ByteOffset;
+}
+
+int CreatePipelineStates(context *C, const VkPhysicalDeviceLimits *Limits) {
+    SetPipelineStateInfos(C->PipelineStateInfos, Limits, &C->PipelineStateByteCount);
+    C->VertexInputBindingDescriptions = calloc(C->PipelineStateInfos[pipeline_state_VERTEX_INPUT_BINDINGS].InstanceCount, sizeof(VkVertexInputBindingDescription));
+    C->VertexInputAttributeDescriptions = calloc(C->PipelineStateInfos[pipeline_state_VERTEX_INPUT_ATTRIBUTES].InstanceCount, sizeof(VkVertexInputAttributeDescription));
+    C->VertexInputBindingDivisorDescriptions = calloc(C->PipelineStateInfos[pipeline_state_VERTEX_INPUT_BINDINGS].InstanceCount, sizeof(VkVertexInputBindingDivisorDescriptionEXT));
+
+    if(ArrayRequireRoom(&C->PipelineStates, 2, C->PipelineStateByteCount, INITIAL_PIPELINE_STATE_CAPACITY)) {
+        return 1;
+    }
+    C->PipelineStates.Count = 1;
+    SetDefaultPipelineState(C, 0);
+    return 0;
+}
+
+void *GetPipelineState(context *C, u64 StateIndex, pipeline_state_type Type) {
+    Assert(StateIndex < C->PipelineStates.Count);
+    Assert(Type < pipeline_state_COUNT);
+    u8 *Base = ArrayData(u8, C->PipelineStates) + StateIndex*C->PipelineStateByteCount;
+    return Base + C->PipelineStateInfos[Type].ByteOffset;
+}
+
+void ClearPipelineState(context *C, u64 StateIndex, pipeline_state_type Type) {
+    pipeline_state_info Info = C->PipelineStateInfos[Type];
+    void *State = GetPipelineState(C, StateIndex, Type);
+    memset(State, 0, Info.InstanceCount*Info.InstaceByteCount);
+}
+
+void CopyPipelineStateToPtr(context *C, void *DstState, u64 SrcStateIndex, pipeline_state_type Type) {
+    pipeline_state_info Info = C->PipelineStateInfos[Type];
+    void *SrcState = GetPipelineState(C, SrcStateIndex, Type);
+    memcpy(DstState, SrcState, Info.InstanceCount*Info.InstaceByteCount);
+}
+
+void CopyPipelineStateFromPtr(context *C, u64 DstStateIndex, void *SrcState, pipeline_state_type Type) {
+    pipeline_state_info Info = C->PipelineStateInfos[Type];
+    void *DstState = GetPipelineState(C, DstStateIndex, Type);
+    memcpy(DstState, SrcState, Info.InstanceCount*Info.InstaceByteCount);
+}
+
+void CopyPipelineState(context *C, u64 DstStateIndex, u64 SrcStateIndex, pipeline_state_type Type) {
+    pipeline_state_info Info = C->PipelineStateInfos[Type];
+    void *DstState = GetPipelineState(C, DstStateIndex, Type);
+    void *SrcState = GetPipelineState(C, SrcStateIndex, Type);
+    memcpy(DstState, SrcState, Info.InstanceCount*Info.InstaceByteCount);
+}
+
+// NOTE(blackedout): Called when a draw uses the latest uniform values of a program. If the same values were already used this frame,
+// the draw shares their slot (and dynamic offset) and the latest slot stays writable. Otherwise the latest slot is frozen
+// and the next uniform update copies it into a new slot (see `SetUniformData`).
+static int ResolveUniformSnapshot(context *C, object *Object) {
+    if(Object->Program.LatestUniformsUsed || Object->Program.LatestUniformsResolved) {
+        return 0;
+    }
+
+    u32 SlotIndex = Object->Program.UniformBuffer.Count - 1;
+    u32 ByteCount = Object->Program.AlignedUniformByteCount;
+    u8 *UniformData = ArrayData(u8, Object->Program.UniformBuffer);
+    u8 *SlotData = UniformData + SlotIndex*ByteCount;
+    u64 Hash = HashBytes(SlotData, ByteCount);
+
+    array *Table = &Object->Program.UniformSnapshotTable;
+    if(2*(Table->Count + 1) > Table->Capacity) {
+        u64 NewCapacity = Max(2*Table->Capacity, INITIAL_UNIFORM_SNAPSHOT_TABLE_CAPACITY);
+        uniform_snapshot_entry *NewEntries = calloc(NewCapacity, sizeof(uniform_snapshot_entry));
+        if(NewEntries == 0) {
+            return 1;
+        }
+        for(u64 I = 0; I < Table->Capacity; ++I) {
+            uniform_snapshot_entry Entry = ArrayData(uniform_snapshot_entry, *Table)[I];
+            if(Entry.Slot == 0) {
+                continue;
+            }
+            u64 J = Entry.Hash & (NewCapacity - 1);
+            while(NewEntries[J].Slot) {
+                J = (J + 1) & (NewCapacity - 1);
+            }
+            NewEntries[J] = Entry;
+        }
+        free(Table->Data);
+        Table->Data = NewEntries;
+        Table->Capacity = NewCapacity;
+    }
+
+    ++C->FrameStats.UniformSnapshotCount;
+    uniform_snapshot_entry *Entries = ArrayData(uniform_snapshot_entry, *Table);
+    u64 Mask = Table->Capacity - 1;
+    for(u64 I = Hash & Mask;; I = (I + 1) & Mask) {
+        uniform_snapshot_entry *Entry = Entries + I;
+        if(Entry->Slot == 0) {
+            Entry->Hash = Hash;
+            Entry->Slot = SlotIndex + 1;
+            ++Table->Count;
+            ++C->FrameStats.UniqueUniformSnapshotCount;
+
+            Object->Program.LatestUniformsUsed = 1;
+            Object->Program.LatestUsedUniformsIndex = SlotIndex;
+            break;
+        }
+        if(Entry->Hash == Hash && memcmp(UniformData + (Entry->Slot - 1)*ByteCount, SlotData, ByteCount) == 0) {
+            Object->Program.LatestUsedUniformsIndex = Entry->Slot - 1;
+            break;
+        }
+    }
+    Object->Program.LatestUniformsResolved = 1;
+    return 0;
+}
+
+int UseCurrentPipelineState(context *C, u32 TypeCount, pipeline_state_type *Types) {
+    // TODO(blackedout): Validate if pipeline can be used
+    {
+        
+    }
+    object *ObjectP = 0;
+    for(u32 I = 0; I < TypeCount; ++I) {
+        if(Types[I] == pipeline_state_VERTEX_INPUT_BINDINGS) {
+            // TODO(blackedout): Since comamnds are only pushed, make the command buffer like a stack
+            // That would allow variable sized commands (would make it unnecessary to push a bind for each command)
+
+            // TODO(blackedout): Unbind this also
+
+            // NOTE(blackedout): Bindings are used, push bind commands of currently bound vao
+            object *Object = 0;
+            // TODO(blackedout): This should be a validation, don't Assert
+            Assert(0 == CheckObjectTypeGet(C, C->BoundVao, object_VERTEX_ARRAY, &Object));
+            
+            for(u32 J = 0; J < C->PipelineStateInfos[pipeline_state_VERTEX_INPUT_BINDINGS].InstanceCount; ++J) {
+                object *ObjectB = 0;
+                if(Object->VertexArray.InputBindings[J].Vbo == 0) {
+                    // NOTE(blackedout): Binding unused, ignore it
+                    continue;
+                }
+                Assert(0 == CheckObjectTypeGet(C, Object->VertexArray.InputBindings[J].Vbo, object_BUFFER, &ObjectB));
+                MarkBufferRead(C, ObjectB);
+                
+                command Command = {
+                    .Type = command_BIND_VERTEX_BUFFER,
+                    .BindVertexBuffer = {
+                        .BindingIndex = J,
+                        .Buffer = ObjectB->Buffer.Buffer,
+                        .Offset = ObjectB->Buffer.Offset + Object->VertexArray.InputBindings[J].Offset
+                    }
+                };
+                // TODO(blackedout): Error handling
+                PushCommand(C, Command);
+            }
+        } else if(Types[I] == pipeline_state_PROGRAM) {
+            pipeline_state_program *State = GetCurrentPipelineState(C, pipeline_state_PROGRAM);
+            if(CheckObjectTypeGet(C, State->Program, object_PROGRAM, &ObjectP)) {
+                // TODO(blackedout): How to handle this case? Report error or do nothing?
+                Assert(0);
+            }
+            if(ResolveUniformSnapshot(C, ObjectP)) {
+                return 1;
+            }
+        }
+    }
+
+    // NOTE(blackedout): Go through each saved pipeline state and check if there exists a match for the current one (index 0).
+    // Match means that all states this usage requests must be equal IF this compared state has been marked as fixed.
+    // If it hasn't been marked as fixed, the pevious usage didn't care about its value, so it can be overwritten by this usage.
+    int FoundMatchingPipeline = 0;
+    u32 MatchingPipelineIndex = 0;
+    for(u32 I = 1; I < C->PipelineStates.Count; ++I) {
+        int DidMatchAll = 1;
+        for(u32 J = 0; J < TypeCount; ++J) {
+            pipeline_state_type Type = Types[J];            
+            pipeline_state_flags *Flags = GetPipelineState(C, I, pipeline_state_FLAGS);
+            if(Flags[Type] & pipeline_state_flag_FIXED) {
+                void *State = GetPipelineState(C, I, Type);
+                void *CurrState = GetCurrentPipelineState(C, Type);
+                
+                pipeline_state_info Info = C->PipelineStateInfos[Type];
+                if(memcmp(State, CurrState, Info.InstanceCount*Info.InstaceByteCount) != 0) {
+                    DidMatchAll = 0;
+                    break;
+                }
+            }
+        }
+        if(DidMatchAll) {
+            FoundMatchingPipeline = 1;
+            MatchingPipelineIndex = I;
+            break;
+        }
+    }
+    
+    if(FoundMatchingPipeline == 0) {
+        // NOTE(blackedout): If no match existed, create a new one, copy all usage state and set fixed flags
+        if(ArrayRequireRoom(&C->PipelineStates, 1, C->PipelineStateByteCount, INITIAL_PIPELINE_STATE_CAPACITY)) {
+            return 1;
+        }
+        MatchingPipelineIndex = C->PipelineStates.Count++;
+        SetDefaultPipelineState(C, MatchingPipelineIndex);
+        FoundMatchingPipeline = 1;
+
+        for(u32 J = 0; J < TypeCount; ++J) {
+            pipeline_state_type Type = Types[J];
+            pipeline_state_info Info = C->PipelineStateInfos[Type];
+            void *State = GetPipelineState(C, MatchingPipelineIndex, Type);
+            void *CurrState = GetCurrentPipelineState(C, Type);
+            memcpy(State, CurrState, Info.InstanceCount*Info.InstaceByteCount);
+
+            pipeline_state_flags *Flags = GetPipelineState(C, MatchingPipelineIndex, pipeline_state_FLAGS);
+            Flags[Type] |= pipeline_state_flag_FIXED;
+        }
+    } else {
+        // NOTE(blackedout): If a match existed, just copy the parts that were not marked as fixed in the matched state
+        for(u32 I = 0; I < TypeCount; ++I) {
+            pipeline_state_type Type = Types[I];
+            pipeline_state_flags *Flags = GetPipelineState(C, MatchingPipelineIndex, pipeline_state_FLAGS);
+            if((Flags[Type] & pipeline_state_flag_FIXED) == 0) {
+                void *State = GetPipelineState(C, MatchingPipelineIndex, Type);
+                void *CurrState = GetCurrentPipelineState(C, Type);
+                
+                pipeline_state_info Info = C->PipelineStateInfos[Type];
+                memcpy(State, CurrState, Info.InstanceCount*Info.InstaceByteCount);
+                Flags[Type] |= pipeline_state_flag_FIXED;
+            }
+        }
+    }
+
+    if(C->IsPipelineSet == 0 || C->LastPipelineIndex != MatchingPipelineIndex) {
+        command Command = {
+            .Type = command_BIND_PIPELINE,
+            .BindPipeline.PipelineIndex = MatchingPipelineIndex
+        };
+        C->IsPipelineSet = 1;
+        C->LastPipelineIndex = MatchingPipelineIndex;
+
+        if(PushCommand(C, Command)) {
+            return 1;
+        }
+    }
+
+    if(ObjectP) {
+        command Command = {
+            .Type = command_BIND_UNIFORMS,
+            .BindUniforms.Index = ObjectP->Program.LatestUsedUniformsIndex,
+        };
+
+        if(PushCommand(C, Command)) {
+            return 1;
+        }
+    }
+
+    return 0;
+}
+
+// NOTE(blackedout): MARK: Shader storage
+
+// NOTE(blackedout): Storage descriptor sets only live for one frame, so they come from shared pools that are reset at its end
+static int AllocateStorageDescriptorSet(context *C, VkDescriptorSetLayout Layout, VkDescriptorSet *OutSet, const char *Name) {
+    VkDescriptorSetAllocateInfo DescriptorSetAllocateInfo = {
+        .sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO,
+        .pNext = 0,
+        .descriptorPool = VK_NULL_HANDLE,
+        .descriptorSetCount = 1,
+        .pSetLayouts = &Layout,
+    };
+    for(; C->StorageDescriptorPoolIndex < C->StorageDescriptorPools.Count; ++C->StorageDescriptorPoolIndex) {
+        DescriptorSetAllocateInfo.descriptorPool = ArrayData(VkDescriptorPool, C->StorageDescriptorPools)[C->StorageDescriptorPoolIndex];
+        VkResult Result = vkAllocateDescriptorSets(C->Device, &DescriptorSetAllocateInfo, OutSet);
+        if(Result == VK_SUCCESS) {
+            return 0;
+        }
+        if(Result != VK_ERROR_OUT_OF_POOL_MEMORY && Result != VK_ERROR_FRAGMENTED_POOL) {
+            return VulkanCheck(C, Result, "vkAllocateDescriptorSets");
+        }
+    }
+
+    // NOTE(blackedout): All pools are full, add another one
+    CheckGL(ArrayRequireRoom(&C->StorageDescriptorPools, 1, sizeof(VkDescriptorPool), INITIAL_STORAGE_DESCRIPTOR_POOL_CAPACITY), gl_error_OUT_OF_MEMORY, 1);
+    VkDescriptorPoolSize DescriptorPoolSizes[] = {
+        {
+            .type = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER,
+            .descriptorCount = STORAGE_DESCRIPTOR_POOL_DESCRIPTOR_COUNT,
+        }
+    };
+    VkDescriptorPoolCreateInfo DescriptorPoolCreateInfo = {
+        .sType = VK_STRUCTURE_TYPE_DESCRIPTOR_POOL_CREATE_INFO,
+        .pNext = 0,
+        .flags = 0,
+        .maxSets = STORAGE_DESCRIPTOR_POOL_SET_COUNT,
+        .poolSizeCount = ArrayCount(DescriptorPoolSizes),
+        .pPoolSizes = DescriptorPoolSizes,
+    };
+    VkDescriptorPool Pool = VK_NULL_HANDLE;
+    if(VulkanCheck(C, vkCreateDescriptorPool(C->Device, &DescriptorPoolCreateInfo, 0, &Pool), "vkCreateDescriptorPool")) {
+        return 1;
+    }
+    ArrayData(VkDescriptorPool, C->StorageDescriptorPools)[C->StorageDescriptorPools.Count++] = Pool;
+    DescriptorSetAllocateInfo.descriptorPool = Pool;
+    return VulkanCheck(C, vkAllocateDescriptorSets(C->Device, &DescriptorSetAllocateInfo, OutSet), "vkAllocateDescriptorSets");
+}
+
+void ResetStorageDescriptorPools(context *C) {
+    for(u32 I = 0; I < C->StorageDescriptorPools.Count; ++I) {
+        VulkanCheck(C, vkResetDescriptorPool(C->Device, ArrayData(VkDescriptorPool, C->StorageDescriptorPools)[I], 0), "vkResetDescriptorPool");
+    }
+    C->StorageDescriptorPoolIndex = 0;
+}
+
+// NOTE(blackedout): Resolves the GL binding points of the storage blocks of the program to the buffers currently bound there.
+// The descriptor set of the last draw or dispatch of the program this frame is reused if it refers to the same ranges.
+// TODO(blackedout): Renaming a buffer the device writes doesn't preserve what it writes later in the frame
+static int HandledGetStorageDescriptorSet(context *C, object *Program, VkDescriptorSet *OutSet, const char *Name) {
+    glslang_program *GlslangProgram = &Program->Program.GlslangProgram;
+    u32 BlockCount = GlslangProgram->StorageBlockCount;
+    Assert(BlockCount <= SHADER_STORAGE_BINDING_COUNT);
+    VkDescriptorBufferInfo BufferInfos[SHADER_STORAGE_BINDING_COUNT];
+    for(u32 I = 0; I < BlockCount; ++I) {
+        indexed_buffer_binding Binding = C->ShaderStorageBindings[GlslangProgram->StorageBlocks[I].Binding];
+        object *Object = 0;
+        if(Binding.Buffer == 0 || CheckObjectTypeGet(C, Binding.Buffer, object_BUFFER, &Object) || Object->Buffer.Buffer == VK_NULL_HANDLE) {
+            GenerateOther(C, GL_DEBUG_SOURCE_API, "ShaderStorage: no buffer with a data store is bound to a shader storage block binding of the program");
+            return 1;
+        }
+        CheckGL(Object->Buffer.IsMapped && (Object->Buffer.MapAccess & GL_MAP_PERSISTENT_BIT) == 0, gl_error_SHADER_STORAGE_BUFFER_MAPPED, 1);
+        u64 Offset = Min((u64)Binding.Offset, Object->Buffer.ByteCount);
+        u64 Range = Object->Buffer.ByteCount - Offset;
+        if(Binding.Size) {
+            Range = Min(Range, (u64)Binding.Size);
+        }
+        if(Range == 0) {
+            GenerateOther(C, GL_DEBUG_SOURCE_API, "ShaderStorage: a bound range lies outside of the data store of its buffer");
+            return 1;
+        }
+        VkDescriptorBufferInfo BufferInfo = {
+            .buffer = Object->Buffer.Buffer,
+            .offset = Object->Buffer.Offset + Offset,
+            .range = Range,
+        };
+        BufferInfos[I] = BufferInfo;
+        MarkBufferRead(C, Object);
+        // NOTE(blackedout): The device may write it
+        Object->Buffer.IsExpandedIndexBufferStale = 1;
+    }
+
+    array *LastBufferInfos = &Program->Program.StorageBufferInfos;
+    if(Program->Program.StorageDescriptorSetFrame == C->SwapCounter + 1 && memcmp(LastBufferInfos->Data, BufferInfos, BlockCount*sizeof(VkDescriptorBufferInfo)) == 0) {
+        *OutSet = Program->Program.StorageDescriptorSet;
+        return 0;
+    }
+    if(LastBufferInfos->Count == 0) {
+        CheckGL(ArrayRequireRoom(LastBufferInfos, BlockCount, sizeof(VkDescriptorBufferInfo), BlockCount), gl_error_OUT_OF_MEMORY, 1);
+        LastBufferInfos->Count = BlockCount;
+    }
+
+    VkDescriptorSet Set = VK_NULL_HANDLE;
+    if(AllocateStorageDescriptorSet(C, Program->Program.StorageDescriptorSetLayout, &Set, Name)) {
+        return 1;
+    }
+    // NOTE(blackedout): The bindings are consecutive and of the same type, so one write covers all of them
+    VkWriteDescriptorSet WriteDescriptorSet = {
+        .sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET,
+        .pNext = 0,
+        .dstSet = Set,
+        .dstBinding = 0,
+        .dstArrayElement = 0,
+        .descriptorCount = BlockCount,
+        .descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER,
+        .pImageInfo = 0,
+        .pBufferInfo = BufferInfos,
+        .pTexelBufferView = 0,
+    };
+    vkUpdateDescriptorSets(C->Device, 1, &WriteDescriptorSet, 0, 0);
+
+    memcpy(LastBufferInfos->Data, BufferInfos, BlockCount*sizeof(VkDescriptorBufferInfo));
+    Program->Program.StorageDescriptorSet = Set;
+    Program->Program.StorageDescriptorSetFrame = C->SwapCounter + 1;
+    *OutSet = Set;
+    return 0;
+}
+
+// NOTE(blackedout): Copies the buffer infos of the last storage set of the program to `CommandData`, replay checks them for aliasing
+static int PushStorageBufferInfos(context *C, object *Program, u64 *OutDataOffset) {
+    u64 ByteCount = Program->Program.GlslangProgram.StorageBlockCount*sizeof(VkDescriptorBufferInfo);
+    if(ArrayRequireRoom(&C->CommandData, ByteCount, 1, INITIAL_COMMAND_DATA_CAPACITY)) {
+        return 1;
+    }
+    *OutDataOffset = C->CommandData.Count;
+    memcpy(ArrayData(u8, C->CommandData) + C->CommandData.Count, Program->Program.StorageBufferInfos.Data, ByteCount);
+    C->CommandData.Count += ByteCount;
+    return 0;
+}
+
+// NOTE(blackedout): Records the pipeline state every draw depends on, in the current subpass
+int RecordDrawState(context *C, GLenum Mode) {
+    pipeline_state_primitive_type *State = GetCurrentPipelineState(C, pipeline_state_PRIMITIVE_TYPE);
+    State->Type = Mode;
+
+    u32 SubpassIndex = 0;
+    if(PotentiallySaveSubpass(C, &SubpassIndex)) {
+        return 1;
+    }
+    pipeline_state_type Types[] = {
+        pipeline_state_VIEWPORT,
+        pipeline_state_SCISSOR,
+        pipeline_state_FRAMEBUFFER,
+        pipeline_state_DRAW_BUFFERS,
+        pipeline_state_VERTEX_INPUT_ATTRIBUTES,
+        pipeline_state_VERTEX_INPUT_BINDINGS,
+        pipeline_state_PROGRAM,
+        pipeline_state_PRIMITIVE_TYPE,
+    };
+    return UseCurrentPipelineState(C, ArrayCount(Types), Types);
+}
+
+// NOTE(blackedout): Like `RecordDrawState`, plus the storage buffers of the program. Returns 1 if the draw must be dropped.
+static int HandledRecordDrawState(context *C, GLenum Mode, const char *Name) {
+    object *Program = 0;
+    VkDescriptorSet StorageSet = VK_NULL_HANDLE;
+    if(0 == CheckObjectTypeGet(C, C->ActiveProgram, object_PROGRAM, &Program) && Program->Program.StorageDescriptorSetLayout != VK_NULL_HANDLE) {
+        if(HandledGetStorageDescriptorSet(C, Program, &StorageSet, Name)) {
+            return 1;
+        }
+    }
+
+    CheckGL(RecordDrawState(C, Mode), gl_error_OUT_OF_MEMORY, 1);
+    if(StorageSet != VK_NULL_HANDLE) {
+        command Command = {
+            .Type = command_BIND_STORAGE_BUFFERS,
+            .BindStorageBuffers.Set = StorageSet,
+            .BindStorageBuffers.BufferInfoCount = Program->Program.GlslangProgram.StorageBlockCount,
+        };
+        CheckGL(PushStorageBufferInfos(C, Program, &Command.BindStorageBuffers.BufferInfoDataOffset), gl_error_OUT_OF_MEMORY, 1);
+        CheckGL(PushCommand(C, Command), gl_error_OUT_OF_MEMORY, 1);
+    }
+    return 0;
+}
+
+static void DrawEmulatedArrays(context *C, GLenum Mode, GLint First, GLsizei Count, GLsizei InstanceCount, GLuint BaseInstance, u32 DrawId, const char *Name);
+
+void DrawArrays(context *C, GLenum Mode, GLint First, GLsizei Count, GLsizei InstanceCount, GLuint BaseInstance, const char *Name) {
+    CheckGL(First < 0, gl_error_DRAW_FIRST_NEGATIVE);
+    CheckGL(Count < 0, gl_error_DRAW_COUNT_NEGATIVE);
+    CheckGL(InstanceCount < 0, gl_error_DRAW_INSTANCE_COUNT_NEGATIVE);
+
+    primitive_info PrimitiveInfo = {0};
+    CheckGL(GetPrimitiveInfo(Mode, &PrimitiveInfo), gl_error_DRAW_MODE);
+
+    if(Count == 0 || InstanceCount == 0) {
+        return;
+    }
+    if(IsEmulatedPrimitive(C, Mode)) {
+        DrawEmulatedArrays(C, Mode, First, Count, InstanceCount, BaseInstance, 0, Name);
+        return;
+    }
+
+    if(HandledRecordDrawState(C, Mode, Name)) {
+        return;
+    }
+
+    command Command = {
+        .Type = command_DRAW,
+        .Draw = {
+            .VertexCount = Count,
+            .VertexOffset = First,
+            .InstanceCount = InstanceCount,
+            .InstanceOffset = BaseInstance,
+        },
+    };
+    CheckGL(PushCommand(C, Command), gl_error_OUT_OF_MEMORY);
+}
+
+// NOTE(blackedout): Vulkan has no 8 bit indices (without VK_EXT_index_type_uint8), so byte indices are drawn from a hidden
+// 16 bit copy of the element buffer. Uploads keep it current (see `UploadExpandedIndices`), writes by the device or through
+// a mapping mark it stale and it is rebuilt from the buffer contents on the next draw. The contents are read where they are,
+// after the pending transfers of the frame ran. If shaders or pixel reads of the frame are still to write them, the draw is
+// dropped and reported, the copy can only be rebuilt once the frame is done. Returns 1 if the draw is dropped.
+// TODO(blackedout): The fixed primitive restart index 0xFF would have to become 0xFFFF
+static int HandledGetExpandedIndexBuffer(context *C, GLuint Ebo, object **OutExpanded, const char *Name) {
+    object *Object = 0;
+    GetObject(C, Ebo, &Object);
+    if(Object->Buffer.ExpandedIndexBuffer == 0) {
+        CheckGL(ArrayRequireRoom(&C->Objects, 1, sizeof(object), INITIAL_OBJECT_CAPACITY), gl_error_OUT_OF_MEMORY, 1);
+        GLuint Handle = 0;
+        object *Expanded = 0;
+        GenObject(C, &Handle, &Expanded);
+        Expanded->Type = object_BUFFER;
+        CreateObject(C, Expanded);
+
+        // NOTE(blackedout): Generating may have moved the objects
+        GetObject(C, Ebo, &Object);
+        Object->Buffer.ExpandedIndexBuffer = Handle;
+        Object->Buffer.IsExpandedIndexBufferStale = 1;
+    }
+
+    object *Expanded = 0;
+    GetObject(C, Object->Buffer.ExpandedIndexBuffer, &Expanded);
+    int IsMappedForWrite = Object->Buffer.IsMapped && (Object->Buffer.MapAccess & GL_MAP_WRITE_BIT);
+    if(Object->Buffer.IsExpandedIndexBufferStale || IsMappedForWrite) {
+        u64 Count = Object->Buffer.ByteCount;
+        if(Count > 0 && IsBufferInUse(C, Object) && HasPendingBufferWrites(C, Object->Buffer.Buffer, Object->Buffer.Offset, Count)) {
+            CheckGL(RunPendingTransfers(C), gl_error_OUT_OF_MEMORY, 1);
+            if(HasPendingBufferWrites(C, Object->Buffer.Buffer, Object->Buffer.Offset, Count)) {
+                GenerateOther(C, GL_DEBUG_SOURCE_API, "DrawElements: shader writes or pixel reads of the current frame into the UNSIGNED_BYTE element buffer have not run yet, the draw is dropped");
+                return 1;
+            }
+        }
+        u16 *Indices = 0;
+        if(Count > 0) {
+            // NOTE(blackedout): The bytes are read behind the space of the indices they expand to
+            Indices = malloc(Count*(sizeof(u16) + 1));
+            CheckGL(Indices == 0, gl_error_OUT_OF_MEMORY, 1);
+            u8 *Bytes = (u8 *)(Indices + Count);
+            int IsReadFailed = 0;
+            if(Object->Buffer.MemoryFlags & buffer_memory_HOST_VISIBLE) {
+                if((Object->Buffer.MemoryFlags & buffer_memory_HOST_COHERENT) == 0) {
+                    IsReadFailed = VulkanCheck(C, vmaInvalidateAllocation(C->Allocator, Object->Buffer.Allocation, 0, Count), "vmaInvalidateAllocation");
+                }
+                if(IsReadFailed == 0) {
+                    memcpy(Bytes, Object->Buffer.Mapped, Count);
+                }
+            } else {
+                IsReadFailed = ReadDeviceLocalBuffer(C, Object, 0, Count, Bytes);
+            }
+            if(IsReadFailed) {
+                free(Indices);
+            }
+            CheckGL(IsReadFailed, gl_error_OUT_OF_MEMORY, 1);
+            ExpandByteIndices(Indices, Bytes, Count);
+        }
+        SpecifyBufferStore(C, Expanded, Count*sizeof(u16), Indices, VK_BUFFER_USAGE_INDEX_BUFFER_BIT, 0, Name);
+        free(Indices);
+        // NOTE(blackedout): While mapped for writing, the client may change the contents before every draw
+        Object->Buffer.IsExpandedIndexBufferStale = IsMappedForWrite;
+    }
+
+    *OutExpanded = Expanded;
+    return 0;
+}
+
+// NOTE(blackedout): Finds the element buffer of the bound vertex array (or its expanded copy for byte indices) and generates
+// the errors of using it. Returns 1 if the draw is dropped.
+// TODO(blackedout): Indices in client memory
+static int HandledGetDrawIndexBuffer(context *C, index_type_info TypeInfo, object **OutIndexBuffer, const char *Name) {
+    object *Vao = 0;
+    CheckGL(CheckObjectTypeGet(C, C->BoundVao, object_VERTEX_ARRAY, &Vao), gl_error_DRAW_NO_VAO_BOUND, 1);
+    GLuint EboHandle = Vao->VertexArray.ElementBuffer;
+    object *Ebo = 0;
+    if(EboHandle == 0 || CheckObjectTypeGet(C, EboHandle, object_BUFFER, &Ebo)) {
+        GenerateOther(C, GL_DEBUG_SOURCE_API, "DrawElements: indices in client memory are not supported, bind an element array buffer");
+        return 1;
+    }
+    CheckGL(Ebo->Buffer.IsMapped && (Ebo->Buffer.MapAccess & GL_MAP_PERSISTENT_BIT) == 0, gl_error_DRAW_BUFFER_MAPPED, 1);
+
+    object *IndexBuffer = Ebo;
+    if(TypeInfo.ByteCount != TypeInfo.VulkanByteCount) {
+        if(HandledGetExpandedIndexBuffer(C, EboHandle, &IndexBuffer, Name)) {
+            return 1;
+        }
+    }
+    *OutIndexBuffer = IndexBuffer;
+    return IndexBuffer->Buffer.Buffer == VK_NULL_HANDLE;
+}
+
+static int PushIndexBufferBind(context *C, object *IndexBuffer, VkIndexType IndexType) {
+    MarkBufferRead(C, IndexBuffer);
+    command Command = {
+        .Type = command_BIND_INDEX_BUFFER,
+        .BindIndexBuffer = {
+            .Buffer = IndexBuffer->Buffer.Buffer,
+            .Offset = IndexBuffer->Buffer.Offset,
+            .IndexType = IndexType,
+        },
+    };
+    return PushCommand(C, Command);
+}
+
+// NOTE(blackedout): MARK: Emulated primitives
+// Vulkan has no line loops and portability implementations may lack triangle fans. Array draws of them are drawn indexed,
+// as line strips closed by repeating the first vertex and as triangle lists. The generated index buffers are cached per mode
+// and vertex count. The first vertex is passed as vertex offset, so one buffer serves every range of the same length.
+// Element and indirect draws of them would need their indices or commands rewritten, they are dropped and reported.
+// TODO(blackedout): Rewrite element ranges into cached index buffers
+
+int IsEmulatedPrimitive(context *C, GLenum Mode) {
+    return Mode == GL_LINE_LOOP || (Mode == GL_TRIANGLE_FAN && C->DeviceInfo.HasTriangleFans == 0);
+}
+
+static u32 GetEmulatedPrimitiveIndexCount(GLenum Mode, u32 VertexCount) {
+    if(Mode == GL_LINE_LOOP) {
+        return VertexCount < 2 ? 0 : VertexCount + 1;
+    }
+    return VertexCount < 3 ? 0 : 3*(VertexCount - 2);
+}
+
+static int HandledGetPrimitiveIndexBuffer(context *C, GLenum Mode, u32 VertexCount, object **OutIndexBuffer, const char *Name) {
+    primitive_index_buffer *Entries = ArrayData(primitive_index_buffer, C->PrimitiveIndexBuffers);
+    for(u64 I = 0; I < C->PrimitiveIndexBuffers.Count; ++I) {
+        if(Entries[I].Mode == Mode && Entries[I].VertexCount == VertexCount) {
+            GetObject(C, Entries[I].Buffer, OutIndexBuffer);
+            return 0;
+        }
+    }
+
+    CheckGL(ArrayRequireRoom(&C->PrimitiveIndexBuffers, 1, sizeof(primitive_index_buffer), INITIAL_PRIMITIVE_INDEX_BUFFER_CAPACITY), gl_error_OUT_OF_MEMORY, 1);
+    CheckGL(ArrayRequireRoom(&C->Objects, 1, sizeof(object), INITIAL_OBJECT_CAPACITY), gl_error_OUT_OF_MEMORY, 1);
+    u32 IndexCount = GetEmulatedPrimitiveIndexCount(Mode, VertexCount);
+    int IsShort = VertexCount <= 0xFFFF;
+    u64 ByteCount = (u64)IndexCount*(IsShort ? sizeof(u16) : sizeof(u32));
+    void *Indices = malloc(ByteCount);
+    CheckGL(Indices == 0, gl_error_OUT_OF_MEMORY, 1);
+    for(u32 I = 0; I < IndexCount; ++I) {
+        u32 Index = 0;
+        if(Mode == GL_LINE_LOOP) {
+            Index = I % VertexCount;
+        } else {
+            // NOTE(blackedout): Triangle i of a fan is (0, i + 1, i + 2) and GL provokes with its last vertex, Vulkan with the
+            // first one. Rotating keeps the winding.
+            u32 Triangle = I/3;
+            u32 Corners[] = { Triangle + 2, 0, Triangle + 1 };
+            Index = Corners[I % 3];
+        }
+        if(IsShort) {
+            ((u16 *)Indices)[I] = (u16)Index;
+        } else {
+            ((u32 *)Indices)[I] = Index;
+        }
+    }
+
+    GLuint Handle = 0;
+    object *Object = 0;
+    GenObject(C, &Handle, &Object);
+    Object->Type = object_BUFFER;
+    CreateObject(C, Object);
+    SpecifyBufferStore(C, Object, ByteCount, Indices, VK_BUFFER_USAGE_INDEX_BUFFER_BIT, 0, Name);
+    free(Indices);
+    if(Object->Buffer.Buffer == VK_NULL_HANDLE) {
+        // NOTE(blackedout): The error was generated by `SpecifyBufferStore`
+        DeleteObject(C, Object);
+        return 1;
+    }
+
+    primitive_index_buffer Entry = {
+        .Mode = Mode,
+        .VertexCount = VertexCount,
+        .Buffer = Handle,
+    };
+    ArrayData(primitive_index_buffer, C->PrimitiveIndexBuffers)[C->PrimitiveIndexBuffers.Count++] = Entry;
+    *OutIndexBuffer = Object;
+    return 0;
+}
+
+static void DrawEmulatedArrays(context *C, GLenum Mode, GLint First, GLsizei Count, GLsizei InstanceCount, GLuint BaseInstance, u32 DrawId, const char *Name) {
+    u32 IndexCount = GetEmulatedPrimitiveIndexCount(Mode, Count);
+    if(IndexCount == 0) {
+        return;
+    }
+    object *IndexBuffer = 0;
+    if(HandledGetPrimitiveIndexBuffer(C, Mode, Count, &IndexBuffer, Name)) {
+        return;
+    }
+
+    if(HandledRecordDrawState(C, Mode == GL_LINE_LOOP ? GL_LINE_STRIP : GL_TRIANGLES, Name)) {
+        return;
+    }
+    VkIndexType IndexType = Count <= 0xFFFF ? VK_INDEX_TYPE_UINT16 : VK_INDEX_TYPE_UINT32;
+    CheckGL(PushIndexBufferBind(C, IndexBuffer, IndexType), gl_error_OUT_OF_MEMORY);
+
+    command Command = {
+        .Type = command_DRAW_INDEXED,
+        .DrawIndexed = {
+            .IndexCount = IndexCount,
+            .FirstIndex = 0,
+            .VertexOffset = First,
+            .InstanceCount = InstanceCount,
+            .InstanceOffset = BaseInstance,
+            .DrawId = DrawId,
+        },
+    };
+    CheckGL(PushCommand(C, Command), gl_error_OUT_OF_MEMORY);
+}
+
+// NOTE(blackedout): Deletes the generated index buffers that weren't drawn with for a while
+void EvictPrimitiveIndexBuffers(context *C) {
+    primitive_index_buffer *Entries = ArrayData(primitive_index_buffer, C->PrimitiveIndexBuffers);
+    u64 KeepCount = 0;
+    for(u64 I = 0; I < C->PrimitiveIndexBuffers.Count; ++I) {
+        object *Object = 0;
+        GetObject(C, Entries[I].Buffer, &Object);
+        u64 UnusedSwapCount = C->SwapCounter + 1 - Object->Buffer.LastUseFrame;
+        if(UnusedSwapCount > PRIMITIVE_INDEX_BUFFER_UNUSED_SWAP_COUNTER_DELETE) {
+            ReleaseBufferMemory(C, Object);
+            DeleteObject(C, Object);
+        } else {
+            Entries[KeepCount++] = Entries[I];
+        }
+    }
+    C->PrimitiveIndexBuffers.Count = KeepCount;
+}
+
+void DrawElements(context *C, GLenum Mode, GLsizei Count, GLenum Type, const void *Indices, GLsizei InstanceCount, GLint BaseVertex, GLuint BaseInstance, const char *Name) {
+    primitive_info PrimitiveInfo = {0};
+    CheckGL(GetPrimitiveInfo(Mode, &PrimitiveInfo), gl_error_DRAW_MODE);
+    CheckGL(Count < 0, gl_error_DRAW_COUNT_NEGATIVE);
+    CheckGL(InstanceCount < 0, gl_error_DRAW_INSTANCE_COUNT_NEGATIVE);
+    index_type_info TypeInfo = {0};
+    CheckGL(GetIndexTypeInfo(Type, &TypeInfo), gl_error_DRAW_ELEMENTS_TYPE);
+
+    object *IndexBuffer = 0;
+    if(HandledGetDrawIndexBuffer(C, TypeInfo, &IndexBuffer, Name)) {
+        return;
+    }
+    if(Count == 0 || InstanceCount == 0) {
+        return;
+    }
+    if(IsEmulatedPrimitive(C, Mode)) {
+        GenerateOther(C, GL_DEBUG_SOURCE_API, "DrawElements: LINE_LOOP (and TRIANGLE_FAN without device support) is only supported by array draws, the draw is dropped");
+        return;
+    }
+
+    // NOTE(blackedout): With an element buffer bound, indices is a byte offset into it
+    u64 Offset = (u64)(uintptr_t)Indices/TypeInfo.ByteCount*TypeInfo.VulkanByteCount;
+
+    if(HandledRecordDrawState(C, Mode, Name)) {
+        return;
+    }
+    CheckGL(PushIndexBufferBind(C, IndexBuffer, TypeInfo.VulkanIndexType), gl_error_OUT_OF_MEMORY);
+
+    command Command = {
+        .Type = command_DRAW_INDEXED,
+        .DrawIndexed = {
+            .IndexCount = Count,
+            .FirstIndex = Offset/TypeInfo.VulkanByteCount,
+            .VertexOffset = BaseVertex,
+            .InstanceCount = InstanceCount,
+            .InstanceOffset = BaseInstance,
+        },
+    };
+    CheckGL(PushCommand(C, Command), gl_error_OUT_OF_MEMORY);
+}
+
+// NOTE(blackedout): The GL indirect command structures have the layout of VkDrawIndirectCommand and VkDrawIndexedIndirectCommand,
+// so the buffers are consumed as they are. Byte indices are drawn from the expanded copy, which keeps the index positions.
+// `Type` is NONE for array draws.
+// TODO(blackedout): Without drawIndirectFirstInstance, base instances in the buffer must be 0
+void DrawIndirect(context *C, GLenum Mode, GLenum Type, const void *Indirect, GLsizei DrawCount, int HasCountBuffer, GLintptr CountOffset, GLsizei Stride, const char *Name) {
+    primitive_info PrimitiveInfo = {0};
+    CheckGL(GetPrimitiveInfo(Mode, &PrimitiveInfo), gl_error_DRAW_MODE);
+    int IsIndexed = Type != GL_NONE;
+    index_type_info TypeInfo = {0};
+    CheckGL(IsIndexed && GetIndexTypeInfo(Type, &TypeInfo), gl_error_DRAW_ELEMENTS_TYPE);
+    CheckGL(DrawCount < 0, HasCountBuffer ? gl_error_MULTI_DRAW_INDIRECT_MAX_DRAW_COUNT_NEGATIVE : gl_error_MULTI_DRAW_DRAW_COUNT_NEGATIVE);
+    CheckGL(Stride < 0 || Stride % 4 != 0, gl_error_MULTI_DRAW_INDIRECT_STRIDE);
+    u64 Offset = (u64)(uintptr_t)Indirect;
+    CheckGL(Offset % sizeof(GLuint) != 0, gl_error_DRAW_INDIRECT_ALIGNMENT);
+
+    buffer_target_info TargetInfo = {0};
+    Assert(0 == GetBufferTargetInfo(GL_DRAW_INDIRECT_BUFFER, &TargetInfo));
+    GLuint Handle = C->BoundBuffers[TargetInfo.Index];
+    object *Object = 0;
+    CheckGL(Handle == 0 || CheckObjectTypeGet(C, Handle, object_BUFFER, &Object), gl_error_DRAW_INDIRECT_NO_BUFFER);
+    u32 CommandByteCount = IsIndexed ? sizeof(VkDrawIndexedIndirectCommand) : sizeof(VkDrawIndirectCommand);
+    u32 ActualStride = Stride ? (u32)Stride : CommandByteCount;
+    CheckGL(DrawCount > 0 && Offset + (u64)(DrawCount - 1)*ActualStride + CommandByteCount > Object->Buffer.ByteCount, gl_error_DRAW_INDIRECT_RANGE);
+    CheckGL(Object->Buffer.IsMapped && (Object->Buffer.MapAccess & GL_MAP_PERSISTENT_BIT) == 0, gl_error_DRAW_BUFFER_MAPPED);
+
+    GLuint CountHandle = 0;
+    if(HasCountBuffer) {
+        Assert(0 == GetBufferTargetInfo(GL_PARAMETER_BUFFER, &TargetInfo));
+        CountHandle = C->BoundBuffers[TargetInfo.Index];
+        object *CountObject = 0;
+        CheckGL(CountHandle == 0 || CheckObjectTypeGet(C, CountHandle, object_BUFFER, &CountObject), gl_error_MULTI_DRAW_INDIRECT_COUNT_NO_BUFFER);
+        CheckGL(CountOffset < 0 || CountOffset % 4 != 0, gl_error_MULTI_DRAW_INDIRECT_COUNT_ALIGNMENT);
+        CheckGL((u64)CountOffset + sizeof(GLsizei) > CountObject->Buffer.ByteCount, gl_error_MULTI_DRAW_INDIRECT_COUNT_RANGE);
+        CheckGL(CountObject->Buffer.IsMapped && (CountObject->Buffer.MapAccess & GL_MAP_PERSISTENT_BIT) == 0, gl_error_DRAW_BUFFER_MAPPED);
+    }
+
+    object *IndexBuffer = 0;
+    if(IsIndexed && HandledGetDrawIndexBuffer(C, TypeInfo, &IndexBuffer, Name)) {
+        return;
+    }
+    if(DrawCount == 0) {
+        return;
+    }
+    if(IsEmulatedPrimitive(C, Mode)) {
+        GenerateOther(C, GL_DEBUG_SOURCE_API, "DrawIndirect: LINE_LOOP (and TRIANGLE_FAN without device support) is only supported by direct array draws, the draw is dropped");
+        return;
+    }
+
+    // NOTE(blackedout): Expanding indices may have moved the objects
+    GetObject(C, Handle, &Object);
+    object *CountObject = 0;
+    if(HasCountBuffer) {
+        GetObject(C, CountHandle, &CountObject);
+    }
+    if(HasCountBuffer && C->DeviceInfo.HasDrawIndirectCount == 0) {
+        GenerateOther(C, GL_DEBUG_SOURCE_API, "DrawIndirect: draw counts from a buffer are not supported by the device (VK_KHR_draw_indirect_count)");
+        return;
     }
-    object *ObjectP = 0;
-    for(u32 I = 0; I < TypeCount; ++I) {
-        if(Types[I] == pipeline_state_VERTEX_INPUT_BINDINGS) {
-            // TODO(blackedout): Since comamnds are only pushed, make the command buffer like a stack
-            // That would allow variable sized commands (would make it unnecessary to push a bind for each command)
 
-            // TODO(blackedout): Unbind this also
+    if(HandledRecordDrawState(C, Mode, Name)) {
+        return;
+    }
+    if(IsIndexed) {
+        CheckGL(PushIndexBufferBind(C, IndexBuffer, TypeInfo.VulkanIndexType), gl_error_OUT_OF_MEMORY);
+    }
 
-            // NOTE(blackedout): Bindings are used, push bind commands of currently bound vao
-            object *Object = 0;
-            // TODO(blackedout): This should be a validation, don't Assert
-            Assert(0 == CheckObjectTypeGet(C, C->BoundVao, object_VERTEX_ARRAY, &Object));
-            
-            for(u32 J = 0; J < C->PipelineStateInfos[pipeline_state_VERTEX_INPUT_BINDINGS].InstanceCount; ++J) {
-                object *ObjectB = 0;
-                if(Object->VertexArray.InputBindings[J].Vbo == 0) {
-                    // NOTE(blackedout): Binding unused, ignore it
-                    continue;
-                }
-                Assert(0 == CheckObjectTypeGet(C, Object->VertexArray.InputBindings[J].Vbo, object_BUFFER, &ObjectB));
-                
-                command Command = {
-                    .Type = command_BIND_VERTEX_BUFFER,
-                    .BindVertexBuffer = {
-                        .BindingIndex = J,
-                        .Buffer = ObjectB->Buffer.Buffer,
-                        .Offset = Object->VertexArray.InputBindings[J].Offset
-                    }
-                };
-                // TODO(blackedout): Error handling
-                PushCommand(C, Command);
-            }
-        } else if(Types[I] == pipeline_state_PROGRAM) {
-            pipeline_state_program *State = GetCurrentPipelineState(C, pipeline_state_PROGRAM);
-            if(CheckObjectTypeGet(C, State->Program, object_PROGRAM, &ObjectP)) {
-                // TODO(blackedout): How to handle this case? Report error or do nothing?
-                Assert(0);
-            }
-            ObjectP->Program.LatestUniformsUsed = 1;
-            ObjectP->Program.LatestUsedUniformsIndex = ObjectP->Program.UniformBuffer.Count - 1;
-        }
+    MarkBufferRead(C, Object);
+    command Command = {
+        .Type = IsIndexed ? command_DRAW_INDEXED_INDIRECT : command_DRAW_INDIRECT,
+        .DrawIndirect = {
+            .Buffer = Object->Buffer.Buffer,
+            .Offset = Object->Buffer.Offset + Offset,
+            .CountBuffer = VK_NULL_HANDLE,
+            .CountOffset = 0,
+            .DrawCount = DrawCount,
+            .Stride = ActualStride,
+        },
+    };
+    if(CountObject) {
+        MarkBufferRead(C, CountObject);
+        Command.DrawIndirect.CountBuffer = CountObject->Buffer.Buffer;
+        Command.DrawIndirect.CountOffset = CountObject->Buffer.Offset + CountOffset;
     }
+    CheckGL(PushCommand(C, Command), gl_error_OUT_OF_MEMORY);
+}
 
-    // NOTE(blackedout): Go through each saved pipeline state and check if there exists a match for the current one (index 0).
-    // Match means that all states this usage requests must be equal IF this compared state has been marked as fixed.
-    // If it hasn't been marked as fixed, the pevious usage didn't care about its value, so it can be overwritten by this usage.
-    int FoundMatchingPipeline = 0;
-    u32 MatchingPipelineIndex = 0;
-    for(u32 I = 1; I < C->PipelineStates.Count; ++I) {
-        int DidMatchAll = 1;
-        for(u32 J = 0; J < TypeCount; ++J) {
-            pipeline_state_type Type = Types[J];            
-            pipeline_state_flags *Flags = GetPipelineState(C, I, pipeline_state_FLAGS);
-            if(Flags[Type] & pipeline_state_flag_FIXED) {
-                void *State = GetPipelineState(C, I, Type);
-                void *CurrState = GetCurrentPipelineState(C, Type);
-                
-                pipeline_state_info Info = C->PipelineStateInfos[Type];
-                if(memcmp(State, CurrState, Info.InstanceCount*Info.InstaceByteCount) != 0) {
-                    DidMatchAll = 0;
-                    break;
-                }
-            }
+// NOTE(blackedout): The ranges of a multi draw share one state resolution and one command. They are stored in
+// `C->MultiDrawData` in the layout `vkCmdDrawMulti*EXT` reads if VK_EXT_multi_draw is enabled, otherwise as indirect commands
+// that are drawn from `C->MultiDrawBuffer` (see `UploadMultiDrawData`). Empty ranges are dropped.
+// `Type` is NONE for array draws, then `Firsts` is used instead of `Indices` and `BaseVertices`, which may be null.
+void MultiDraw(context *C, GLenum Mode, GLenum Type, const GLint *Firsts, const GLsizei *Counts, const void *const *Indices, const GLint *BaseVertices, GLsizei DrawCount, const char *Name) {
+    primitive_info PrimitiveInfo = {0};
+    CheckGL(GetPrimitiveInfo(Mode, &PrimitiveInfo), gl_error_DRAW_MODE);
+    int IsIndexed = Type != GL_NONE;
+    index_type_info TypeInfo = {0};
+    CheckGL(IsIndexed && GetIndexTypeInfo(Type, &TypeInfo), gl_error_DRAW_ELEMENTS_TYPE);
+    CheckGL(DrawCount < 0, gl_error_MULTI_DRAW_DRAW_COUNT_NEGATIVE);
+    u32 RangeCount = 0;
+    for(GLsizei I = 0; I < DrawCount; ++I) {
+        CheckGL(IsIndexed == 0 && Firsts[I] < 0, gl_error_DRAW_FIRST_NEGATIVE);
+        CheckGL(Counts[I] < 0, gl_error_DRAW_COUNT_NEGATIVE);
+        RangeCount += Counts[I] > 0;
+    }
+
+    object *IndexBuffer = 0;
+    if(IsIndexed && HandledGetDrawIndexBuffer(C, TypeInfo, &IndexBuffer, Name)) {
+        return;
+    }
+    if(RangeCount == 0) {
+        return;
+    }
+    if(IsEmulatedPrimitive(C, Mode)) {
+        if(IsIndexed) {
+            GenerateOther(C, GL_DEBUG_SOURCE_API, "MultiDrawElements: LINE_LOOP (and TRIANGLE_FAN without device support) is only supported by array draws, the draw is dropped");
+            return;
         }
-        if(DidMatchAll) {
-            FoundMatchingPipeline = 1;
-            MatchingPipelineIndex = I;
-            break;
+        // NOTE(blackedout): Every range length needs its own generated index buffer
+        for(GLsizei I = 0; I < DrawCount; ++I) {
+            DrawEmulatedArrays(C, Mode, Firsts[I], Counts[I], 1, 0, (u32)I, Name);
         }
+        return;
     }
-    
-    if(FoundMatchingPipeline == 0) {
-        // NOTE(blackedout): If no match existed, create a new one, copy all usage state and set fixed flags
-        if(ArrayRequireRoom(&C->PipelineStates, 1, C->PipelineStateByteCount, INITIAL_PIPELINE_STATE_CAPACITY)) {
-            return 1;
-        }
-        MatchingPipelineIndex = C->PipelineStates.Count++;
-        SetDefaultPipelineState(C, MatchingPipelineIndex);
-        FoundMatchingPipeline = 1;
 
-        for(u32 J = 0; J < TypeCount; ++J) {
-            pipeline_state_type Type = Types[J];
-            pipeline_state_info Info = C->PipelineStateInfos[Type];
-            void *State = GetPipelineState(C, MatchingPipelineIndex, Type);
-            void *CurrState = GetCurrentPipelineState(C, Type);
-            memcpy(State, CurrState, Info.InstanceCount*Info.InstaceByteCount);
-
-            pipeline_state_flags *Flags = GetPipelineState(C, MatchingPipelineIndex, pipeline_state_FLAGS);
-            Flags[Type] |= pipeline_state_flag_FIXED;
+    int IsNative = C->DeviceInfo.MaxMultiDrawCount > 0;
+    u32 RecordByteCount = GetMultiDrawRecordByteCount(C, IsIndexed);
+    CheckGL(ArrayRequireRoom(&C->MultiDrawData, (u64)RangeCount*RecordByteCount, 1, INITIAL_MULTI_DRAW_DATA_CAPACITY), gl_error_OUT_OF_MEMORY);
+    u8 *Data = ArrayData(u8, C->MultiDrawData) + C->MultiDrawData.Count;
+    for(GLsizei I = 0; I < DrawCount; ++I) {
+        if(Counts[I] == 0) {
+            continue;
         }
-    } else {
-        // NOTE(blackedout): If a match existed, just copy the parts that were not marked as fixed in the matched state
-        for(u32 I = 0; I < TypeCount; ++I) {
-            pipeline_state_type Type = Types[I];
-            pipeline_state_flags *Flags = GetPipelineState(C, MatchingPipelineIndex, pipeline_state_FLAGS);
-            if((Flags[Type] & pipeline_state_flag_FIXED) == 0) {
-                void *State = GetPipelineState(C, MatchingPipelineIndex, Type);
-                void *CurrState = GetCurrentPipelineState(C, Type);
-                
-                pipeline_state_info Info = C->PipelineStateInfos[Type];
-                memcpy(State, CurrState, Info.InstanceCount*Info.InstaceByteCount);
-                Flags[Type] |= pipeline_state_flag_FIXED;
+        if(IsIndexed) {
+            // NOTE(blackedout): With an element buffer bound, the indices are byte offsets into it
+            u32 FirstIndex = (u32)((uintptr_t)Indices[I]/TypeInfo.ByteCount);
+            int32_t VertexOffset = BaseVertices ? BaseVertices[I] : 0;
+            if(IsNative) {
+                VkMultiDrawIndexedInfoEXT Info = {
+                    .firstIndex = FirstIndex,
+                    .indexCount = Counts[I],
+                    .vertexOffset = VertexOffset,
+                };
+                memcpy(Data, &Info, sizeof(Info));
+            } else {
+                VkDrawIndexedIndirectCommand IndirectCommand = {
+                    .indexCount = Counts[I],
+                    .instanceCount = 1,
+                    .firstIndex = FirstIndex,
+                    .vertexOffset = VertexOffset,
+                    .firstInstance = 0,
+                };
+                memcpy(Data, &IndirectCommand, sizeof(IndirectCommand));
             }
+        } else if(IsNative) {
+            VkMultiDrawInfoEXT Info = {
+                .firstVertex = Firsts[I],
+                .vertexCount = Counts[I],
+            };
+            memcpy(Data, &Info, sizeof(Info));
+        } else {
+            VkDrawIndirectCommand IndirectCommand = {
+                .vertexCount = Counts[I],
+                .instanceCount = 1,
+                .firstVertex = Firsts[I],
+                .firstInstance = 0,
+            };
+            memcpy(Data, &IndirectCommand, sizeof(IndirectCommand));
         }
+        Data += RecordByteCount;
     }
 
-    if(C->IsPipelineSet == 0 || C->LastPipelineIndex != MatchingPipelineIndex) {
-        command Command = {
-            .Type = command_BIND_PIPELINE,
-            .BindPipeline.PipelineIndex = MatchingPipelineIndex
-        };
-        C->IsPipelineSet = 1;
-        C->LastPipelineIndex = MatchingPipelineIndex;
+    if(HandledRecordDrawState(C, Mode, Name)) {
+        return;
+    }
+    if(IsIndexed) {
+        CheckGL(PushIndexBufferBind(C, IndexBuffer, TypeInfo.VulkanIndexType), gl_error_OUT_OF_MEMORY);
+    }
 
-        if(PushCommand(C, Command)) {
-            return 1;
-        }
+    command Command = {
+        .Type = IsIndexed ? command_MULTI_DRAW_INDEXED : command_MULTI_DRAW,
+        .MultiDraw = {
+            .DataOffset = C->MultiDrawData.Count,
+            .DrawCount = RangeCount,
+        },
+    };
+    CheckGL(PushCommand(C, Command), gl_error_OUT_OF_MEMORY);
+    C->MultiDrawData.Count += (u64)RangeCount*RecordByteCount;
+}
+
+u32 GetMultiDrawRecordByteCount(context *C, int IsIndexed) {
+    if(C->DeviceInfo.MaxMultiDrawCount) {
+        return IsIndexed ? sizeof(VkMultiDrawIndexedInfoEXT) : sizeof(VkMultiDrawInfoEXT);
     }
+    return IsIndexed ? sizeof(VkDrawIndexedIndirectCommand) : sizeof(VkDrawIndirectCommand);
+}
 
-    if(ObjectP) {
-        command Command = {
-            .Type = command_BIND_UNIFORMS,
-            .BindUniforms.Index = ObjectP->Program.LatestUsedUniformsIndex,
-        };
+// NOTE(blackedout): Copies the indirect commands of the frame's multi draws into the buffer they are drawn from. Each swap
+// finishes its frame, so the buffer can be rewritten by the next one.
+int UploadMultiDrawData(context *C) {
+    u64 ByteCount = C->MultiDrawData.Count;
+    if(C->DeviceInfo.MaxMultiDrawCount || ByteCount == 0) {
+        return 0;
+    }
 
-        if(PushCommand(C, Command)) {
-            return 1;
+    if(C->MultiDrawBufferByteCount < ByteCount) {
+        if(C->MultiDrawBuffer != VK_NULL_HANDLE) {
+            vmaDestroyBuffer(C->Allocator, C->MultiDrawBuffer, C->MultiDrawAllocation);
+            C->MultiDrawBuffer = VK_NULL_HANDLE;
+            C->MultiDrawAllocation = VK_NULL_HANDLE;
         }
+        u64 NewByteCount = C->MultiDrawBufferByteCount ? 2*C->MultiDrawBufferByteCount : INITIAL_MULTI_DRAW_DATA_CAPACITY;
+        while(NewByteCount < ByteCount) {
+            NewByteCount *= 2;
+        }
+        C->MultiDrawBufferByteCount = 0;
+
+        VkBufferCreateInfo BufferCreateInfo = {
+            .sType = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO,
+            .pNext = 0,
+            .flags = 0,
+            .size = NewByteCount,
+            .usage = VK_BUFFER_USAGE_INDIRECT_BUFFER_BIT,
+            .sharingMode = VK_SHARING_MODE_EXCLUSIVE,
+            .queueFamilyIndexCount = 1,
+            .pQueueFamilyIndices = &C->DeviceInfo.QueueFamilyIndices[queue_GRAPHICS],
+        };
+        VmaAllocationCreateInfo AllocationCreateInfo = {
+            .flags = VMA_ALLOCATION_CREATE_HOST_ACCESS_SEQUENTIAL_WRITE_BIT | VMA_ALLOCATION_CREATE_MAPPED_BIT,
+            .usage = VMA_MEMORY_USAGE_AUTO,
+            .requiredFlags = VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT,
+            .preferredFlags = 0,
+            .memoryTypeBits = 0,
+            .pool = 0,
+            .pUserData = 0,
+            .priority = 0,
+        };
+        VmaAllocationInfo AllocationInfo = {0};
+        VulkanCheckGoto(vmaCreateBuffer(C->Allocator, &BufferCreateInfo, &AllocationCreateInfo, &C->MultiDrawBuffer, &C->MultiDrawAllocation, &AllocationInfo), label_Error);
+        C->MultiDrawMapped = AllocationInfo.pMappedData;
+        C->MultiDrawBufferByteCount = NewByteCount;
     }
 
+    memcpy(C->MultiDrawMapped, ArrayData(u8, C->MultiDrawData), ByteCount);
     return 0;
+
+label_Error:
+    return 1;
 }
 
 void SetDefaultPipelineState(context *C, u32 PipelineIndex) {
@@ -1200,8 +4055,10 @@ static void ConvertPipelineVertexInputAttributes(context *C, u32 PipelineIndex,
     *OutCount = Count;
 }
 
-static void ConvertPipelineVertexInputBindings(context *C, u32 PipelineIndex, VkVertexInputBindingDescription *BindingDescriptions, u32 *OutCount) {
+// NOTE(blackedout): Instance rate bindings advance every instance, other divisors need VK_EXT_vertex_attribute_divisor
+static void ConvertPipelineVertexInputBindings(context *C, u32 PipelineIndex, VkVertexInputBindingDescription *BindingDescriptions, u32 *OutCount, VkVertexInputBindingDivisorDescriptionEXT *DivisorDescriptions, u32 *OutDivisorCount) {
     u32 Count = 0;
+    u32 DivisorCount = 0;
     pipeline_state_vertex_input_binding *State = GetPipelineState(C, PipelineIndex, pipeline_state_VERTEX_INPUT_BINDINGS);
     pipeline_state_info Info = C->PipelineStateInfos[pipeline_state_VERTEX_INPUT_BINDINGS];
     for(u32 I = 0; I < Info.InstanceCount; ++I) {
@@ -1209,12 +4066,21 @@ static void ConvertPipelineVertexInputBindings(context *C, u32 PipelineIndex, Vk
             VkVertexInputBindingDescription Desc = {
                 .binding = I,
                 .stride = State[I].Stride,
-                .inputRate = VK_VERTEX_INPUT_RATE_VERTEX, // TODO(blackedout)
+                .inputRate = State[I].Divisor == 0 ? VK_VERTEX_INPUT_RATE_VERTEX : VK_VERTEX_INPUT_RATE_INSTANCE,
             };
             BindingDescriptions[Count++] = Desc;
+
+            if(State[I].Divisor > 1 && State[I].Divisor <= C->DeviceInfo.MaxVertexAttribDivisor) {
+                VkVertexInputBindingDivisorDescriptionEXT DivisorDesc = {
+                    .binding = I,
+                    .divisor = State[I].Divisor,
+                };
+                DivisorDescriptions[DivisorCount++] = DivisorDesc;
+            }
         }
     }
     *OutCount = Count;
+    *OutDivisorCount = DivisorCount;
 }
 
 static void ConvertProgramShaderStages(context *C, u32 PipelineIndex, VkPipelineShaderStageCreateInfo *ShaderStageCreateInfos, u32 *OutCount) {
@@ -1244,6 +4110,86 @@ static void ConvertProgramShaderStages(context *C, u32 PipelineIndex, VkPipeline
     *OutCount = ShaderStageCount;
 }
 
+// NOTE(blackedout): Copies all uniform snapshots of this frame into the uniform buffer of the program, once per frame
+int UploadProgramUniforms(context *C, GLuint Program) {
+    object *Object = 0;
+    Assert(0 == CheckObjectTypeGet(C, Program, object_PROGRAM, &Object));
+    if(Object->Program.LastUniformUploadFrame == C->SwapCounter + 1) {
+        return 0;
+    }
+
+    int Result = 1;
+    u64 UniformBufferByteCount = Object->Program.UniformBuffer.Count*Object->Program.AlignedUniformByteCount;
+    if(Object->Program.LastUniformCount != Object->Program.UniformBuffer.Count) {
+        printf("Recreating uniform buffer of program %u. Last count was %llu, now %llu\n", Program, Object->Program.LastUniformCount, Object->Program.UniformBuffer.Count);
+        Object->Program.LastUniformCount = Object->Program.UniformBuffer.Count;
+
+        if(Object->Program.VulkanUniformBuffer != VK_NULL_HANDLE) {
+            vmaDestroyBuffer(C->Allocator, Object->Program.VulkanUniformBuffer, Object->Program.UniformBufferAllocation);
+        }
+        
+        VkBufferCreateInfo BufferCreateInfo = {
+            .sType = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO,
+            .pNext = 0,
+            .flags = 0,
+            .size = UniformBufferByteCount,
+            .usage = VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT,
+            .sharingMode = VK_SHARING_MODE_EXCLUSIVE,
+            .queueFamilyIndexCount = 1,
+            .pQueueFamilyIndices = &C->DeviceInfo.QueueFamilyIndices[queue_GRAPHICS],
+        };
+        SetBufferSharing(C, &BufferCreateInfo);
+        VmaAllocationCreateInfo AllocationCreateInfo = {
+            .flags = VMA_ALLOCATION_CREATE_HOST_ACCESS_SEQUENTIAL_WRITE_BIT,
+            .usage = VMA_MEMORY_USAGE_AUTO,
+            .requiredFlags = VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT,
+            .preferredFlags = 0,
+            .memoryTypeBits = 0,
+            .pool = 0,
+            .pUserData = 0,
+            .priority = 0,
+        };
+        VkBuffer Buffer = VK_NULL_HANDLE;
+        VmaAllocation Allocation = VK_NULL_HANDLE;
+        VmaAllocationInfo BufferInfo = {0};
+        VulkanCheckGoto(vmaCreateBuffer(C->Allocator, &BufferCreateInfo, &AllocationCreateInfo, &Buffer, &Allocation, &BufferInfo), label_Exit);
+        Object->Program.VulkanUniformBuffer = Buffer;
+        Object->Program.UniformBufferAllocation = Allocation;
+        Object->Program.UniformMemory = BufferInfo.deviceMemory;
+
+        VkDescriptorBufferInfo DescriptorBufferInfo = {
+            .buffer = Buffer,
+            .offset = 0,
+            .range = Object->Program.AlignedUniformByteCount,
+        };
+
+        VkWriteDescriptorSet WriteDescriptorSet = {
+            .sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET,
+            .pNext = 0,
+            .dstSet = Object->Program.UniformDescriptorSet,
+            .dstBinding = 0,
+            .dstArrayElement = 0,
+            .descriptorCount = 1,
+            .descriptorType = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC,
+            .pImageInfo = 0,
+            .pBufferInfo = &DescriptorBufferInfo,
+            .pTexelBufferView = 0,
+        };
+
+        vkUpdateDescriptorSets(C->Device, 1, &WriteDescriptorSet, 0, 0);
+    }
+
+    void *MappedBuffer = 0;
+    VulkanCheckGoto(vkMapMemory(C->Device, Object->Program.UniformMemory, 0, UniformBufferByteCount, 0, &MappedBuffer), label_Exit);
+    memcpy(MappedBuffer, Object->Program.UniformBuffer.Data, UniformBufferByteCount);
+    vkUnmapMemory(C->Device, Object->Program.UniformMemory);
+
+    Object->Program.LastUniformUploadFrame = C->SwapCounter + 1;
+    Result = 0;
+label_Exit:
+    return Result;
+}
+
 int CheckPipeline(context *C, u32 PipelineIndex) {
     pipeline_state_header *Header = GetPipelineState(C, PipelineIndex, pipeline_state_HEADER);
     object *ObjectF = 0;
@@ -1259,70 +4205,9 @@ int CheckPipeline(context *C, u32 PipelineIndex) {
     {
         pipeline_state_program *State = GetPipelineState(C, PipelineIndex, pipeline_state_PROGRAM);
         Assert(0 == CheckObjectTypeGet(C, State->Program, object_PROGRAM, &ObjectP));
-
-        u64 UniformBufferByteCount = ObjectP->Program.UniformBuffer.Count*ObjectP->Program.AlignedUniformByteCount;
-        if(ObjectP->Program.LastUniformCount != ObjectP->Program.UniformBuffer.Count) {
-            printf("Recreating uniform buffer of program %u. Last count was %llu, now %llu\n", State->Program, ObjectP->Program.LastUniformCount, ObjectP->Program.UniformBuffer.Count);
-            ObjectP->Program.LastUniformCount = ObjectP->Program.UniformBuffer.Count;
-
-            if(ObjectP->Program.VulkanUniformBuffer != VK_NULL_HANDLE) {
-                vmaDestroyBuffer(C->Allocator, ObjectP->Program.VulkanUniformBuffer, ObjectP->Program.UniformBufferAllocation);
-            }
-            
-            VkBufferCreateInfo BufferCreateInfo = {
-                .sType = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO,
-                .pNext = 0,
-                .flags = 0,
-                .size = UniformBufferByteCount,
-                .usage = VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT,
-                .sharingMode = VK_SHARING_MODE_EXCLUSIVE,
-                .queueFamilyIndexCount = 1,
-                .pQueueFamilyIndices = &C->DeviceInfo.QueueFamilyIndices[queue_GRAPHICS],
-            };
-            VmaAllocationCreateInfo AllocationCreateInfo = {
-                .flags = VMA_ALLOCATION_CREATE_HOST_ACCESS_SEQUENTIAL_WRITE_BIT,
-                .usage = VMA_MEMORY_USAGE_AUTO,
-                .requiredFlags = VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT,
-                .preferredFlags = 0,
-                .memoryTypeBits = 0,
-                .pool = 0,
-                .pUserData = 0,
-                .priority = 0,
-            };
-            VkBuffer Buffer = VK_NULL_HANDLE;
-            VmaAllocation Allocation = VK_NULL_HANDLE;
-            VmaAllocationInfo BufferInfo = {0};
-            VulkanCheckGoto(vmaCreateBuffer(C->Allocator, &BufferCreateInfo, &AllocationCreateInfo, &Buffer, &Allocation, &BufferInfo), label_Error);
-            ObjectP->Program.VulkanUniformBuffer = Buffer;
-            ObjectP->Program.UniformBufferAllocation = Allocation;
-            ObjectP->Program.UniformMemory = BufferInfo.deviceMemory;
-
-            VkDescriptorBufferInfo DescriptorBufferInfo = {
-                .buffer = Buffer,
-                .offset = 0,
-                .range = ObjectP->Program.AlignedUniformByteCount,
-            };
-
-            VkWriteDescriptorSet WriteDescriptorSet = {
-                .sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET,
-                .pNext = 0,
-                .dstSet = ObjectP->Program.UniformDescriptorSet,
-                .dstBinding = 0,
-                .dstArrayElement = 0,
-                .descriptorCount = 1,
-                .descriptorType = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC,
-                .pImageInfo = 0,
-                .pBufferInfo = &DescriptorBufferInfo,
-                .pTexelBufferView = 0,
-            };
-
-            vkUpdateDescriptorSets(C->Device, 1, &WriteDescriptorSet, 0, 0);
+        if(UploadProgramUniforms(C, State->Program)) {
+            return 1;
         }
-
-        void *MappedBuffer = 0;
-        VulkanCheckGoto(vkMapMemory(C->Device, ObjectP->Program.UniformMemory, 0, UniformBufferByteCount, 0, &MappedBuffer), label_Error);
-        memcpy(MappedBuffer, ObjectP->Program.UniformBuffer.Data, UniformBufferByteCount);
-        vkUnmapMemory(C->Device, ObjectP->Program.UniformMemory);
     }
 
     if(Header->IsCreated) {
@@ -1413,14 +4298,22 @@ int CheckPipeline(context *C, u32 PipelineIndex) {
         .blendConstants = {0.0f, 0.0f, 0.0f, 0.0f}
     };
 
+    // NOTE(blackedout): Set 0 holds the default uniform block, set 1 the storage blocks (if there are any). Every graphics layout
+    // has the same push constant range, the gl_DrawID base of split draws, so the value stays valid across pipelines.
+    VkDescriptorSetLayout SetLayouts[] = { ObjectP->Program.DescriptorSetLayout, ObjectP->Program.StorageDescriptorSetLayout };
+    VkPushConstantRange DrawIdBaseRange = {
+        .stageFlags = VK_SHADER_STAGE_VERTEX_BIT,
+        .offset = 0,
+        .size = sizeof(u32),
+    };
     VkPipelineLayoutCreateInfo PipelineLayoutCreateInfo = {
         .sType = VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO,
         .pNext = 0,
         .flags = 0,
-        .setLayoutCount = 1,
-        .pSetLayouts = &ObjectP->Program.DescriptorSetLayout,
-        .pushConstantRangeCount = 0,
-        .pPushConstantRanges = 0,
+        .setLayoutCount = ObjectP->Program.StorageDescriptorSetLayout == VK_NULL_HANDLE ? 1 : 2,
+        .pSetLayouts = SetLayouts,
+        .pushConstantRangeCount = 1,
+        .pPushConstantRanges = &DrawIdBaseRange,
     };
     VulkanCheckGoto(vkCreatePipelineLayout(C->Device, &PipelineLayoutCreateInfo, 0, &Header->Layout), label_Error);
 
@@ -1433,13 +4326,36 @@ int CheckPipeline(context *C, u32 PipelineIndex) {
         .vertexAttributeDescriptionCount = 0,
         .pVertexAttributeDescriptions = C->VertexInputAttributeDescriptions,
     };
-    ConvertPipelineVertexInputBindings(C, PipelineIndex, C->VertexInputBindingDescriptions, &PipelineVertexInputStateCreateInfo.vertexBindingDescriptionCount);
+    VkPipelineVertexInputDivisorStateCreateInfoEXT PipelineVertexInputDivisorStateCreateInfo = {
+        .sType = VK_STRUCTURE_TYPE_PIPELINE_VERTEX_INPUT_DIVISOR_STATE_CREATE_INFO_EXT,
+        .pNext = 0,
+        .vertexBindingDivisorCount = 0,
+        .pVertexBindingDivisors = C->VertexInputBindingDivisorDescriptions,
+    };
+    ConvertPipelineVertexInputBindings(C, PipelineIndex, C->VertexInputBindingDescriptions, &PipelineVertexInputStateCreateInfo.vertexBindingDescriptionCount,
+                                       C->VertexInputBindingDivisorDescriptions, &PipelineVertexInputDivisorStateCreateInfo.vertexBindingDivisorCount);
+    if(PipelineVertexInputDivisorStateCreateInfo.vertexBindingDivisorCount > 0) {
+        PipelineVertexInputStateCreateInfo.pNext = &PipelineVertexInputDivisorStateCreateInfo;
+    }
     ConvertPipelineVertexInputAttributes(C, PipelineIndex, C->VertexInputAttributeDescriptions, &PipelineVertexInputStateCreateInfo.vertexAttributeDescriptionCount);
 
+    // NOTE(blackedout): With dynamic rendering the pipeline only names the attachment formats instead of a render pass
+    // TODO(blackedout): One color attachment like the blend state, multiple draw buffers need a blend attachment each
+    VkFormat ColorAttachmentFormat = C->DeviceInfo.InitialSurfaceFormat.format;
+    VkPipelineRenderingCreateInfoKHR PipelineRenderingCreateInfo = {
+        .sType = VK_STRUCTURE_TYPE_PIPELINE_RENDERING_CREATE_INFO_KHR,
+        .pNext = 0,
+        .viewMask = 0,
+        .colorAttachmentCount = 1,
+        .pColorAttachmentFormats = &ColorAttachmentFormat,
+        .depthAttachmentFormat = VK_FORMAT_UNDEFINED,
+        .stencilAttachmentFormat = VK_FORMAT_UNDEFINED,
+    };
+
     VkPipelineShaderStageCreateInfo ShaderStageCreateInfos[PROGRAM_SHADER_CAPACITY] = {0};
     VkGraphicsPipelineCreateInfo GraphicsPipelineCreateInfo = {
         .sType = VK_STRUCTURE_TYPE_GRAPHICS_PIPELINE_CREATE_INFO,
-        .pNext = 0,
+        .pNext = C->DeviceInfo.HasDynamicRendering ? &PipelineRenderingCreateInfo : 0,
         .flags = 0,
         .stageCount = 0,
         .pStages = ShaderStageCreateInfos,
@@ -1453,7 +4369,7 @@ int CheckPipeline(context *C, u32 PipelineIndex) {
         .pColorBlendState = &PipelineColorBlendStateCreateInfo,
         //.pDynamicState = &PipelineDynamicStateCreateInfo,
         .layout = Header->Layout,
-        .renderPass = ObjectF->Framebuffer.RenderPass,
+        .renderPass = C->DeviceInfo.HasDynamicRendering ? VK_NULL_HANDLE : ObjectF->Framebuffer.RenderPass,
         .subpass = 0,
         .basePipelineHandle = VK_NULL_HANDLE,
         .basePipelineIndex = -1
@@ -1472,4 +4388,163 @@ label_Error:
     vkDestroyPipeline(C->Device, Header->Pipeline, 0);
 label_Exit:
     return Result;
-}
\ No newline at end of file
+}
+// NOTE(blackedout): MARK: Compute
+
+// NOTE(blackedout): Unlike graphics pipelines, compute pipelines depend on nothing but the program, so they are created when it is linked
+int CreateComputePipeline(context *C, object *Object, VkShaderModule Module) {
+    VkDescriptorSetLayout SetLayouts[] = { Object->Program.DescriptorSetLayout, Object->Program.StorageDescriptorSetLayout };
+    VkPipelineLayoutCreateInfo PipelineLayoutCreateInfo = {
+        .sType = VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO,
+        .pNext = 0,
+        .flags = 0,
+        .setLayoutCount = Object->Program.StorageDescriptorSetLayout == VK_NULL_HANDLE ? 1 : 2,
+        .pSetLayouts = SetLayouts,
+        .pushConstantRangeCount = 0,
+        .pPushConstantRanges = 0,
+    };
+    if(VulkanCheck(C, vkCreatePipelineLayout(C->Device, &PipelineLayoutCreateInfo, 0, &Object->Program.ComputeLayout), "vkCreatePipelineLayout")) {
+        return 1;
+    }
+
+    VkComputePipelineCreateInfo ComputePipelineCreateInfo = {
+        .sType = VK_STRUCTURE_TYPE_COMPUTE_PIPELINE_CREATE_INFO,
+        .pNext = 0,
+        .flags = 0,
+        .stage = {
+            .sType = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO,
+            .pNext = 0,
+            .flags = 0,
+            .stage = VK_SHADER_STAGE_COMPUTE_BIT,
+            .module = Module,
+            .pName = "main",
+            .pSpecializationInfo = 0
+        },
+        .layout = Object->Program.ComputeLayout,
+        .basePipelineHandle = VK_NULL_HANDLE,
+        .basePipelineIndex = -1
+    };
+    if(VulkanCheck(C, vkCreateComputePipelines(C->Device, VK_NULL_HANDLE, 1, &ComputePipelineCreateInfo, 0, &Object->Program.ComputePipeline), "vkCreateComputePipelines")) {
+        vkDestroyPipelineLayout(C->Device, Object->Program.ComputeLayout, 0);
+        Object->Program.ComputeLayout = VK_NULL_HANDLE;
+        return 1;
+    }
+    return 0;
+}
+
+// NOTE(blackedout): Dispatches can't be recorded inside a render pass, they end it where they were issued and the next draw
+// resumes it (see `PushRenderPassEndingCommand`).
+void DispatchCompute(context *C, GLuint GroupCountX, GLuint GroupCountY, GLuint GroupCountZ, int IsIndirect, GLintptr Indirect, const char *Name) {
+    object *Program = 0;
+    CheckGL(C->ActiveProgram == 0 || CheckObjectTypeGet(C, C->ActiveProgram, object_PROGRAM, &Program) || Program->Program.ComputePipeline == VK_NULL_HANDLE, gl_error_DISPATCH_NO_PROGRAM);
+
+    command Command = {
+        .Type = IsIndirect ? command_DISPATCH_INDIRECT : command_DISPATCH,
+        .Dispatch.Program = C->ActiveProgram,
+    };
+    object *Object = 0;
+    if(IsIndirect) {
+        CheckGL(Indirect < 0 || (u64)Indirect % sizeof(GLuint) != 0, gl_error_DISPATCH_INDIRECT_OFFSET);
+        buffer_target_info TargetInfo = {0};
+        Assert(0 == GetBufferTargetInfo(GL_DISPATCH_INDIRECT_BUFFER, &TargetInfo));
+        GLuint Handle = C->BoundBuffers[TargetInfo.Index];
+        CheckGL(Handle == 0 || CheckObjectTypeGet(C, Handle, object_BUFFER, &Object), gl_error_DISPATCH_INDIRECT_NO_BUFFER);
+        CheckGL((u64)Indirect + sizeof(VkDispatchIndirectCommand) > Object->Buffer.ByteCount, gl_error_DISPATCH_INDIRECT_RANGE);
+        CheckGL(Object->Buffer.IsMapped && (Object->Buffer.MapAccess & GL_MAP_PERSISTENT_BIT) == 0, gl_error_DISPATCH_INDIRECT_MAPPED);
+        Command.Dispatch.Buffer = Object->Buffer.Buffer;
+        Command.Dispatch.Offset = Object->Buffer.Offset + (u64)Indirect;
+    } else {
+        const uint32_t *MaxGroupCounts = C->DeviceInfo.Properties.limits.maxComputeWorkGroupCount;
+        CheckGL(GroupCountX > MaxGroupCounts[0] || GroupCountY > MaxGroupCounts[1] || GroupCountZ > MaxGroupCounts[2], gl_error_DISPATCH_GROUP_COUNT);
+        if(GroupCountX == 0 || GroupCountY == 0 || GroupCountZ == 0) {
+            return;
+        }
+        Command.Dispatch.GroupCountX = GroupCountX;
+        Command.Dispatch.GroupCountY = GroupCountY;
+        Command.Dispatch.GroupCountZ = GroupCountZ;
+    }
+
+    if(Program->Program.StorageDescriptorSetLayout != VK_NULL_HANDLE) {
+        if(HandledGetStorageDescriptorSet(C, Program, &Command.Dispatch.StorageSet, Name)) {
+            return;
+        }
+        // NOTE(blackedout): Replay tracks what dispatches write to tell which memory barriers they depend on
+        glslang_program *GlslangProgram = &Program->Program.GlslangProgram;
+        CheckGL(PushStorageBufferInfos(C, Program, &Command.Dispatch.BufferInfoDataOffset), gl_error_OUT_OF_MEMORY);
+        Command.Dispatch.BufferInfoCount = GlslangProgram->StorageBlockCount;
+        for(u32 I = 0; I < GlslangProgram->StorageBlockCount; ++I) {
+            Command.Dispatch.WrittenBufferInfoMask |= (GlslangProgram->StorageBlocks[I].IsWritten ? 1u : 0u) << I;
+        }
+    }
+    CheckGL(ResolveUniformSnapshot(C, Program), gl_error_OUT_OF_MEMORY);
+    Command.Dispatch.UniformIndex = Program->Program.LatestUsedUniformsIndex;
+    // NOTE(blackedout): Programs only used by dispatches have no pipeline state that would upload their uniforms
+    Program->Program.LastDispatchFrame = C->SwapCounter + 1;
+    if(Object) {
+        MarkBufferRead(C, Object);
+    }
+    CheckGL(PushRenderPassEndingCommand(C, Command), gl_error_OUT_OF_MEMORY);
+}
+
+// NOTE(blackedout): MARK: Memory barriers
+
+// NOTE(blackedout): Render passes have no self dependencies, so barriers end them where they were issued like dispatches and
+// the next draw resumes it. During replay they are deferred to the next command that may consume the storage buffer writes of
+// dispatches and draws before them and merged on the way (see `cuglSwapBuffers`). Barriers by region have nothing to be local
+// to outside of a render pass, they only allow fewer bits.
+void PushMemoryBarrier(context *C, GLbitfield Barriers, int IsByRegion, const char *Name) {
+    const GLbitfield ByRegionBarriers = GL_ATOMIC_COUNTER_BARRIER_BIT | GL_FRAMEBUFFER_BARRIER_BIT | GL_SHADER_IMAGE_ACCESS_BARRIER_BIT |
+                                        GL_SHADER_STORAGE_BARRIER_BIT | GL_TEXTURE_FETCH_BARRIER_BIT | GL_UNIFORM_BARRIER_BIT;
+    int IsAll = Barriers == GL_ALL_BARRIER_BITS;
+    if(IsAll && IsByRegion) {
+        Barriers = ByRegionBarriers;
+    }
+    CheckGL(IsAll == 0 && IsByRegion && (Barriers & ~ByRegionBarriers), gl_error_MEMORY_BARRIER_BITS);
+
+    command Command = {
+        .Type = command_MEMORY_BARRIER,
+    };
+    for(u32 I = 0; I < 32; ++I) {
+        GLbitfield Bit = (GLbitfield)1 << I;
+        if((Barriers & Bit) == 0) {
+            continue;
+        }
+        memory_barrier_info Info = {0};
+        if(GetMemoryBarrierInfo(Bit, &Info)) {
+            CheckGL(IsAll == 0, gl_error_MEMORY_BARRIER_BITS);
+            continue;
+        }
+        Command.Barrier.DstStages |= Info.VulkanStages;
+        Command.Barrier.DstAccess |= Info.VulkanAccess;
+    }
+
+    ++C->FrameStats.RequestedMemoryBarrierCount;
+    if(Command.Barrier.DstStages == 0) {
+        return;
+    }
+    CheckGL(PushRenderPassEndingCommand(C, Command), gl_error_OUT_OF_MEMORY);
+}
+
+// NOTE(blackedout): Textures have no storage yet, so image units only hold their state and shaders don't see bound images
+// TODO(blackedout): Storage image descriptors of the bound levels and layers once they do
+void BindImageTexture(context *C, GLuint Unit, GLuint Texture, GLint Level, GLboolean Layered, GLint Layer, GLenum Access, GLenum Format, const char *Name) {
+    CheckGL(Unit >= IMAGE_UNIT_COUNT, gl_error_BIND_IMAGE_TEXTURE_UNIT);
+    CheckGL(Texture != 0 && CheckObjectType(C, Texture, object_TEXTURE), gl_error_BIND_IMAGE_TEXTURE_TEXTURE);
+    CheckGL(Level < 0 || Layer < 0, gl_error_BIND_IMAGE_TEXTURE_LEVEL_LAYER);
+    CheckGL(Access != GL_READ_ONLY && Access != GL_WRITE_ONLY && Access != GL_READ_WRITE, gl_error_BIND_IMAGE_TEXTURE_ACCESS);
+    VkFormat VulkanFormat = VK_FORMAT_UNDEFINED;
+    CheckGL(GetImageUnitFormat(Format, &VulkanFormat), gl_error_BIND_IMAGE_TEXTURE_FORMAT);
+
+    image_unit_binding Binding = {
+        .Texture = Texture,
+        .Level = Level,
+        .Layered = Layered,
+        .Layer = Layer,
+        .Access = Access,
+        .VulkanFormat = VulkanFormat,
+    };
+    C->ImageUnits[Unit] = Binding;
+    if(Texture != 0) {
+        GenerateOther(C, GL_DEBUG_SOURCE_API, "BindImageTexture: image units have no storage image descriptors yet, shaders don't see the bound image");
+    }
+}
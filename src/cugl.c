@@ -5,14 +5,445 @@
 
 #include <stdio.h>
 
+static void RecordDispatch(context *C, VkCommandBuffer CommandBuffer, const command *Command) {
+    object *ObjectP = 0;
+    Assert(0 == CheckObjectTypeGet(C, Command->Dispatch.Program, object_PROGRAM, &ObjectP));
+    vkCmdBindPipeline(CommandBuffer, VK_PIPELINE_BIND_POINT_COMPUTE, ObjectP->Program.ComputePipeline);
+
+    uint32_t Offset = ObjectP->Program.AlignedUniformByteCount*Command->Dispatch.UniformIndex;
+    VkDescriptorSet Sets[] = { ObjectP->Program.UniformDescriptorSet, Command->Dispatch.StorageSet };
+    u32 SetCount = Command->Dispatch.StorageSet == VK_NULL_HANDLE ? 1 : 2;
+    vkCmdBindDescriptorSets(CommandBuffer, VK_PIPELINE_BIND_POINT_COMPUTE, ObjectP->Program.ComputeLayout, 0, SetCount, Sets, 1, &Offset);
+    if(Command->Type == command_DISPATCH_INDIRECT) {
+        vkCmdDispatchIndirect(CommandBuffer, Command->Dispatch.Buffer, Command->Dispatch.Offset);
+    } else {
+        vkCmdDispatch(CommandBuffer, Command->Dispatch.GroupCountX, Command->Dispatch.GroupCountY, Command->Dispatch.GroupCountZ);
+    }
+}
+
+// NOTE(blackedout): MARK: Async compute
+// A dispatch runs on the async compute queue if none of the buffer ranges it accesses alias a range the graphics queue
+// accesses in the same frame. Such dispatches only depend on the uploads of the frame and on each other, so they overlap
+// all of its graphics work. Ranges of size VK_WHOLE_SIZE extend to the end of their buffer.
+
+// NOTE(blackedout): Appends the buffer ranges `Command` accesses, returns 1 if they don't fit
+static int PushCommandBufferRanges(context *C, const command *Command, VkDescriptorBufferInfo *Ranges, u32 *Count, u32 Capacity) {
+    VkDescriptorBufferInfo CommandRanges[SHADER_STORAGE_BINDING_COUNT + 2];
+    u32 CommandRangeCount = 0;
+    const VkDescriptorBufferInfo *BufferInfos = 0;
+    u32 BufferInfoCount = 0;
+    switch(Command->Type) {
+    case command_BIND_VERTEX_BUFFER: {
+        CommandRanges[CommandRangeCount++] = MakeBufferRange(Command->BindVertexBuffer.Buffer, Command->BindVertexBuffer.Offset, VK_WHOLE_SIZE);
+    } break;
+    case command_BIND_INDEX_BUFFER: {
+        CommandRanges[CommandRangeCount++] = MakeBufferRange(Command->BindIndexBuffer.Buffer, Command->BindIndexBuffer.Offset, VK_WHOLE_SIZE);
+    } break;
+    case command_DRAW_INDIRECT:
+    case command_DRAW_INDEXED_INDIRECT: {
+        CommandRanges[CommandRangeCount++] = MakeBufferRange(Command->DrawIndirect.Buffer, Command->DrawIndirect.Offset, VK_WHOLE_SIZE);
+        if(Command->DrawIndirect.CountBuffer != VK_NULL_HANDLE) {
+            CommandRanges[CommandRangeCount++] = MakeBufferRange(Command->DrawIndirect.CountBuffer, Command->DrawIndirect.CountOffset, sizeof(u32));
+        }
+    } break;
+    case command_UPDATE_BUFFER: {
+        CommandRanges[CommandRangeCount++] = MakeBufferRange(Command->UpdateBuffer.Buffer, Command->UpdateBuffer.Offset, Command->UpdateBuffer.ByteCount);
+    } break;
+    case command_COPY_BUFFER: {
+        CommandRanges[CommandRangeCount++] = MakeBufferRange(Command->CopyBuffer.SrcBuffer, Command->CopyBuffer.SrcOffset, Command->CopyBuffer.ByteCount);
+        CommandRanges[CommandRangeCount++] = MakeBufferRange(Command->CopyBuffer.DstBuffer, Command->CopyBuffer.DstOffset, Command->CopyBuffer.ByteCount);
+    } break;
+    case command_READ_PIXELS: {
+        CommandRanges[CommandRangeCount++] = MakeBufferRange(Command->ReadPixels.Buffer, Command->ReadPixels.Offset, VK_WHOLE_SIZE);
+    } break;
+    case command_BIND_STORAGE_BUFFERS: {
+        BufferInfos = (const VkDescriptorBufferInfo *)(ArrayData(u8, C->CommandData) + Command->BindStorageBuffers.BufferInfoDataOffset);
+        BufferInfoCount = Command->BindStorageBuffers.BufferInfoCount;
+    } break;
+    case command_DISPATCH:
+    case command_DISPATCH_INDIRECT: {
+        BufferInfos = (const VkDescriptorBufferInfo *)(ArrayData(u8, C->CommandData) + Command->Dispatch.BufferInfoDataOffset);
+        BufferInfoCount = Command->Dispatch.BufferInfoCount;
+        if(Command->Type == command_DISPATCH_INDIRECT) {
+            CommandRanges[CommandRangeCount++] = MakeBufferRange(Command->Dispatch.Buffer, Command->Dispatch.Offset, sizeof(VkDispatchIndirectCommand));
+        }
+    } break;
+    default: {
+
+    } break;
+    }
+    for(u32 I = 0; I < BufferInfoCount; ++I) {
+        CommandRanges[CommandRangeCount++] = BufferInfos[I];
+    }
+
+    if(*Count + CommandRangeCount > Capacity) {
+        return 1;
+    }
+    memcpy(Ranges + *Count, CommandRanges, CommandRangeCount*sizeof(VkDescriptorBufferInfo));
+    *Count += CommandRangeCount;
+    return 0;
+}
+
+// NOTE(blackedout): Sets `IsAsync` of the dispatches that run on the async compute queue and returns how many there are
+static u32 MarkAsyncDispatches(context *C) {
+    if(C->DeviceInfo.HasAsyncCompute == 0) {
+        return 0;
+    }
+    command *Commands = ArrayData(command, C->Commands);
+    u32 AsyncDispatchCount = 0;
+    for(u32 I = 0; I < C->Commands.Count; ++I) {
+        if(Commands[I].Type == command_DISPATCH || Commands[I].Type == command_DISPATCH_INDIRECT) {
+            Commands[I].Dispatch.IsAsync = 1;
+            ++AsyncDispatchCount;
+        }
+    }
+
+    // NOTE(blackedout): A dispatch that stays on the graphics queue adds its ranges to those of the graphics queue,
+    // which may keep more dispatches there, so this repeats until nothing changes
+    VkDescriptorBufferInfo GraphicsRanges[MAX_ASYNC_COMPUTE_RANGE_COUNT];
+    int IsChanged = 1;
+    while(IsChanged && AsyncDispatchCount) {
+        IsChanged = 0;
+        u32 GraphicsRangeCount = 0;
+        int IsOverflow = 0;
+        for(u32 I = 0; I < C->Commands.Count && IsOverflow == 0; ++I) {
+            int IsDispatch = Commands[I].Type == command_DISPATCH || Commands[I].Type == command_DISPATCH_INDIRECT;
+            if(IsDispatch == 0 || Commands[I].Dispatch.IsAsync == 0) {
+                IsOverflow = PushCommandBufferRanges(C, Commands + I, GraphicsRanges, &GraphicsRangeCount, ArrayCount(GraphicsRanges));
+            }
+        }
+
+        for(u32 I = 0; I < C->Commands.Count; ++I) {
+            int IsDispatch = Commands[I].Type == command_DISPATCH || Commands[I].Type == command_DISPATCH_INDIRECT;
+            if(IsDispatch == 0 || Commands[I].Dispatch.IsAsync == 0) {
+                continue;
+            }
+            VkDescriptorBufferInfo DispatchRanges[SHADER_STORAGE_BINDING_COUNT + 2];
+            u32 DispatchRangeCount = 0;
+            Assert(0 == PushCommandBufferRanges(C, Commands + I, DispatchRanges, &DispatchRangeCount, ArrayCount(DispatchRanges)));
+            int IsAliased = IsOverflow;
+            for(u32 J = 0; J < DispatchRangeCount && IsAliased == 0; ++J) {
+                for(u32 K = 0; K < GraphicsRangeCount && IsAliased == 0; ++K) {
+                    IsAliased = IsBufferRangeAliased(DispatchRanges[J], GraphicsRanges[K]);
+                }
+            }
+            if(IsAliased) {
+                Commands[I].Dispatch.IsAsync = 0;
+                --AsyncDispatchCount;
+                IsChanged = 1;
+            }
+        }
+    }
+    return AsyncDispatchCount;
+}
+
+// NOTE(blackedout): MARK: Dynamic rendering
+// Without render pass objects the replay transitions the attachment images itself: into COLOR_ATTACHMENT_OPTIMAL before the
+// framebuffer's first rendering of the frame and back to PRESENT_SRC (the final layout of the render pass path) after its
+// last one. Every stored subpass is a rendering of its own, only the first loads and only the last may discard. A resumed
+// render pass (see `MergeRenderPasses`) loads everything the framebuffer's earlier rendering stored.
+
+static void GetAttachmentImage(context *C, GLuint Fbo, object *ObjectF, u32 Index, u32 AcquiredImageIndex, VkImage *OutImage, VkImageView *OutImageView) {
+    if(Fbo == 0) {
+        *OutImage = C->SwapchainImages[AcquiredImageIndex];
+        *OutImageView = C->SwapchainImageViews[AcquiredImageIndex];
+        return;
+    }
+    object *ObjectR = 0;
+    Assert(0 == CheckObjectTypeGet(C, ObjectF->Framebuffer.ColorAttachments[Index].Rbo, object_RENDERBUFFER, &ObjectR));
+    *OutImage = ObjectR->Renderbuffer.Image;
+    *OutImageView = ObjectR->Renderbuffer.ImageView;
+}
+
+static void TransitionRenderingImages(context *C, VkCommandBuffer CommandBuffer, GLuint Fbo, object *ObjectF, u32 AcquiredImageIndex, int IsBegin, int IsResume) {
+    for(u32 I = 0; I < ObjectF->Framebuffer.AttachmentCount; ++I) {
+        VkImage Image = VK_NULL_HANDLE;
+        VkImageView ImageView = VK_NULL_HANDLE;
+        GetAttachmentImage(C, Fbo, ObjectF, I, AcquiredImageIndex, &Image, &ImageView);
+        VkImageMemoryBarrier Barrier = {
+            .sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER,
+            .pNext = 0,
+            .srcAccessMask = VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT,
+            .dstAccessMask = 0,
+            .oldLayout = VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL,
+            .newLayout = VK_IMAGE_LAYOUT_PRESENT_SRC_KHR,
+            .srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED,
+            .dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED,
+            .image = Image,
+            .subresourceRange = {
+                .aspectMask = VK_IMAGE_ASPECT_COLOR_BIT,
+                .baseMipLevel = 0,
+                .levelCount = 1,
+                .baseArrayLayer = 0,
+                .layerCount = 1,
+            },
+        };
+        VkPipelineStageFlags DstStages = VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT;
+        if(IsBegin) {
+            VkAttachmentLoadOp LoadOp = GetAttachmentLoadOp(Fbo, ObjectF->Framebuffer.StoredClearLoadMask, ObjectF->Framebuffer.StoredDiscardLoadMask, I);
+            Barrier.srcAccessMask = 0;
+            Barrier.dstAccessMask = VK_ACCESS_COLOR_ATTACHMENT_READ_BIT | VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT;
+            Barrier.oldLayout = IsResume || LoadOp == VK_ATTACHMENT_LOAD_OP_LOAD ? VK_IMAGE_LAYOUT_PRESENT_SRC_KHR : VK_IMAGE_LAYOUT_UNDEFINED;
+            Barrier.newLayout = VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL;
+            DstStages = VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT;
+        }
+        vkCmdPipelineBarrier(CommandBuffer, VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT, DstStages, 0, 0, 0, 0, 0, 1, &Barrier);
+    }
+}
+
+// TODO(blackedout): Pipelines have a single color attachment, see `CheckPipeline`
+static int BeginRendering(context *C, VkCommandBuffer CommandBuffer, GLuint Fbo, object *ObjectF, u32 SubpassIndex, int IsResume, u32 AcquiredImageIndex, VkClearColorValue ClearColor) {
+    render_pass_state_subpass *Subpass = ArrayData(render_pass_state_subpass, ObjectF->Framebuffer.StoredSubpasses) + SubpassIndex;
+    VkAttachmentReference *References = ArrayData(VkAttachmentReference, ObjectF->Framebuffer.StoredSubpassAttachments) + Subpass->BaseIndex;
+    int IsFirst = SubpassIndex == 0 && IsResume == 0;
+    int IsLast = SubpassIndex + 1 == ObjectF->Framebuffer.StoredSubpasses.Count;
+    if(ArrayRequireRoom(&C->TmpRenderingAttachments, Subpass->ColorAttachmentCount, sizeof(VkRenderingAttachmentInfoKHR), 8)) {
+        return 1;
+    }
+    VkRenderingAttachmentInfoKHR *Attachments = ArrayData(VkRenderingAttachmentInfoKHR, C->TmpRenderingAttachments);
+    for(u32 I = 0; I < Subpass->ColorAttachmentCount; ++I) {
+        VkRenderingAttachmentInfoKHR Attachment = {
+            .sType = VK_STRUCTURE_TYPE_RENDERING_ATTACHMENT_INFO_KHR,
+            .pNext = 0,
+            .imageView = VK_NULL_HANDLE,
+            .imageLayout = VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL,
+            .resolveMode = VK_RESOLVE_MODE_NONE,
+            .resolveImageView = VK_NULL_HANDLE,
+            .resolveImageLayout = VK_IMAGE_LAYOUT_UNDEFINED,
+            .loadOp = VK_ATTACHMENT_LOAD_OP_LOAD,
+            .storeOp = VK_ATTACHMENT_STORE_OP_STORE,
+            .clearValue.color = ClearColor,
+        };
+        u32 Index = References[I].attachment;
+        if(Index != VK_ATTACHMENT_UNUSED) {
+            VkImage Image = VK_NULL_HANDLE;
+            GetAttachmentImage(C, Fbo, ObjectF, Index, AcquiredImageIndex, &Image, &Attachment.imageView);
+            if(IsFirst) {
+                Attachment.loadOp = GetAttachmentLoadOp(Fbo, ObjectF->Framebuffer.StoredClearLoadMask, ObjectF->Framebuffer.StoredDiscardLoadMask, Index);
+            }
+            if(IsLast) {
+                Attachment.storeOp = GetAttachmentStoreOp(ObjectF->Framebuffer.StoredDiscardStoreMask, Index);
+            }
+        }
+        Attachments[I] = Attachment;
+    }
+
+    VkRenderingInfoKHR RenderingInfo = {
+        .sType = VK_STRUCTURE_TYPE_RENDERING_INFO_KHR,
+        .pNext = 0,
+        .flags = 0,
+        .renderArea = {
+            .offset = { .x = 0, .y = 0 },
+            .extent = ObjectF->Framebuffer.Extent,
+        },
+        .layerCount = 1,
+        .viewMask = 0,
+        .colorAttachmentCount = Subpass->ColorAttachmentCount,
+        .pColorAttachments = Attachments,
+        .pDepthAttachment = 0,
+        .pStencilAttachment = 0,
+    };
+    C->CmdBeginRendering(CommandBuffer, &RenderingInfo);
+    return 0;
+}
+
+// NOTE(blackedout): MARK: Render pass merging
+// Binding framebuffer A, then B and A again records a resume of A's render pass after B's, see `PotentiallySaveSubpass`.
+// If nothing from A's pass up to the resume has to run outside of a render pass, the resumed commands move up behind A's
+// pass and continue it, so A is stored and loaded once. The skipped draws can't read A's attachments (there are no texture
+// attachments), they only depend on the moved ones through storage buffers, so those keep their order.
+
+static int IsOutsideRenderPassCommand(command_type Type) {
+    return Type == command_UPDATE_BUFFER || Type == command_COPY_BUFFER || Type == command_DISPATCH || Type == command_DISPATCH_INDIRECT || Type == command_MEMORY_BARRIER || Type == command_READ_PIXELS;
+}
+
+static void MergeRenderPasses(context *C) {
+    command *Commands = ArrayData(command, C->Commands);
+    u32 CommandCount = (u32)C->Commands.Count;
+    u32 RecordedCount = 0;
+    u32 MergedCount = 0;
+    for(u32 J = 0; J < CommandCount; ++J) {
+        if(Commands[J].Type != command_BEGIN_RENDER_PASS) {
+            continue;
+        }
+        ++RecordedCount;
+        ++MergedCount;
+        if(Commands[J].BeginRenderPass.IsResume == 0) {
+            continue;
+        }
+
+        // NOTE(blackedout): The resumed commands end at the next pass or the transfers and dispatches in front of it
+        GLuint Fbo = Commands[J].BeginRenderPass.Fbo;
+        u32 End = J + 1;
+        int IsMovedStorage = 0;
+        while(End < CommandCount && Commands[End].Type != command_BEGIN_RENDER_PASS && IsOutsideRenderPassCommand(Commands[End].Type) == 0) {
+            IsMovedStorage |= Commands[End].Type == command_BIND_STORAGE_BUFFERS;
+            ++End;
+        }
+
+        // NOTE(blackedout): They are inserted where the pass after the framebuffer's previous one begins
+        u32 Insert = J;
+        u32 Previous = J;
+        int IsMergeable = 0;
+        while(Previous > 0) {
+            command *Other = Commands + --Previous;
+            if(IsOutsideRenderPassCommand(Other->Type)) {
+                break;
+            }
+            if(Other->Type == command_BEGIN_RENDER_PASS) {
+                if(Other->BeginRenderPass.Fbo == Fbo) {
+                    IsMergeable = 1;
+                    break;
+                }
+                Insert = Previous;
+            }
+        }
+        for(u32 K = Insert; K < J && IsMergeable && IsMovedStorage; ++K) {
+            IsMergeable = Commands[K].Type != command_BIND_STORAGE_BUFFERS;
+        }
+        u32 MovedCount = End - J;
+        C->TmpCommands.Count = 0;
+        if(IsMergeable && ArrayRequireRoom(&C->TmpCommands, MovedCount, sizeof(command), 64)) {
+            IsMergeable = 0;
+        }
+        if(IsMergeable == 0) {
+            object *Object = 0;
+            Assert(0 == CheckObjectTypeGet(C, Fbo, object_FRAMEBUFFER, &Object));
+            Object->Framebuffer.IsResumed = 1;
+            // NOTE(blackedout): The earlier pass must store what the resumed one loads
+            Object->Framebuffer.DiscardStoreMask = 0;
+            continue;
+        }
+
+        u32 LastSubpassIndex = Commands[Previous].BeginRenderPass.SubpassIndex;
+        for(u32 K = Previous + 1; K < Insert; ++K) {
+            if(Commands[K].Type == command_NEXT_SUBPASS) {
+                LastSubpassIndex = Commands[K].NextSubpass.SubpassIndex;
+            }
+        }
+        command *Moved = ArrayData(command, C->TmpCommands);
+        memcpy(Moved, Commands + J, MovedCount*sizeof(command));
+        memmove(Commands + Insert + MovedCount, Commands + Insert, (J - Insert)*sizeof(command));
+        memcpy(Commands + Insert, Moved, MovedCount*sizeof(command));
+
+        // NOTE(blackedout): The resume is now just the subpass change it stands for, if any
+        command *Begin = Commands + Insert;
+        u32 SubpassIndex = Begin->BeginRenderPass.SubpassIndex;
+        if(SubpassIndex == LastSubpassIndex) {
+            Begin->Type = command_NONE;
+        } else {
+            command Command = {
+                .Type = command_NEXT_SUBPASS,
+                .NextSubpass = {
+                    .SubpassIndex = SubpassIndex
+                },
+            };
+            *Begin = Command;
+        }
+        --MergedCount;
+        J = End - 1;
+    }
+    C->FrameStats.RecordedRenderPassCount = RecordedCount;
+    C->FrameStats.MergedRenderPassCount = MergedCount;
+}
+
+// NOTE(blackedout): Draws split into several calls pass the index of their first draw, ranges of emulated multi draws their own
+// index. Vertex shaders add it to gl_DrawID (see `MakeVulkanCompatible`). It is only pushed when it changes, `*InOutPushed` is
+// negative while the value is unknown.
+static void SetDrawIdBase(context *C, VkCommandBuffer CommandBuffer, u32 PipelineIndex, u32 DrawIdBase, int64_t *InOutPushed) {
+    if(*InOutPushed == (int64_t)DrawIdBase) {
+        return;
+    }
+    pipeline_state_header *Header = GetPipelineState(C, PipelineIndex, pipeline_state_HEADER);
+    vkCmdPushConstants(CommandBuffer, Header->Layout, VK_SHADER_STAGE_VERTEX_BIT, 0, sizeof(u32), &DrawIdBase);
+    *InOutPushed = DrawIdBase;
+}
+
+// NOTE(blackedout): Copies the swapchain image into the pack buffer of a pixel read, between the render passes before and after
+// it. The image is in the present layout outside of render passes, it is undefined until the first pass of the frame into it.
+static void RecordReadPixels(context *C, VkCommandBuffer CommandBuffer, const command *Command, u32 AcquiredImageIndex, int IsImageDrawn) {
+    VkImageSubresourceRange ColorRange = {
+        .aspectMask = VK_IMAGE_ASPECT_COLOR_BIT,
+        .baseMipLevel = 0,
+        .levelCount = 1,
+        .baseArrayLayer = 0,
+        .layerCount = 1,
+    };
+    // NOTE(blackedout): Earlier commands of the frame may access the buffer, including earlier reads into it
+    VkMemoryBarrier BufferBarrier = {
+        .sType = VK_STRUCTURE_TYPE_MEMORY_BARRIER,
+        .pNext = 0,
+        .srcAccessMask = VK_ACCESS_MEMORY_WRITE_BIT,
+        .dstAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT,
+    };
+    VkImageMemoryBarrier ImageBarrier = {
+        .sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER,
+        .pNext = 0,
+        .srcAccessMask = VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT,
+        .dstAccessMask = VK_ACCESS_TRANSFER_READ_BIT,
+        .oldLayout = IsImageDrawn ? VK_IMAGE_LAYOUT_PRESENT_SRC_KHR : VK_IMAGE_LAYOUT_UNDEFINED,
+        .newLayout = VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL,
+        .srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED,
+        .dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED,
+        .image = C->SwapchainImages[AcquiredImageIndex],
+        .subresourceRange = ColorRange,
+    };
+    vkCmdPipelineBarrier(CommandBuffer, VK_PIPELINE_STAGE_ALL_COMMANDS_BIT, VK_PIPELINE_STAGE_TRANSFER_BIT, 0, 1, &BufferBarrier, 0, 0, 1, &ImageBarrier);
+
+    VkBufferImageCopy Region = {
+        .bufferOffset = Command->ReadPixels.Offset,
+        .bufferRowLength = Command->ReadPixels.RowLength,
+        .bufferImageHeight = 0,
+        .imageSubresource = {
+            .aspectMask = VK_IMAGE_ASPECT_COLOR_BIT,
+            .mipLevel = 0,
+            .baseArrayLayer = 0,
+            .layerCount = 1,
+        },
+        .imageOffset = { .x = Command->ReadPixels.ImageOffset.x, .y = Command->ReadPixels.ImageOffset.y, .z = 0 },
+        .imageExtent = { .width = Command->ReadPixels.ImageExtent.width, .height = Command->ReadPixels.ImageExtent.height, .depth = 1 },
+    };
+    vkCmdCopyImageToBuffer(CommandBuffer, C->SwapchainImages[AcquiredImageIndex], VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL, Command->ReadPixels.Buffer, 1, &Region);
+
+    // NOTE(blackedout): Later commands of the frame may use the pixels, the host may read them once the frame is done.
+    // The render pass resumed after the read draws into the image again.
+    BufferBarrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+    BufferBarrier.dstAccessMask = TRANSFER_BATCH_CONSUMER_ACCESS | VK_ACCESS_HOST_READ_BIT;
+    ImageBarrier.srcAccessMask = 0;
+    ImageBarrier.dstAccessMask = VK_ACCESS_COLOR_ATTACHMENT_READ_BIT | VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT;
+    ImageBarrier.oldLayout = VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL;
+    ImageBarrier.newLayout = VK_IMAGE_LAYOUT_PRESENT_SRC_KHR;
+    VkPipelineStageFlags DstStages = TRANSFER_BATCH_CONSUMER_STAGES | VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT | VK_PIPELINE_STAGE_HOST_BIT;
+    vkCmdPipelineBarrier(CommandBuffer, VK_PIPELINE_STAGE_TRANSFER_BIT, DstStages, 0, 1, &BufferBarrier, 0, 0, 1, &ImageBarrier);
+}
+
+// NOTE(blackedout): Ends the render pass or rendering begun for `ObjectF`
+static void EndRenderPass(context *C, VkCommandBuffer CommandBuffer, GLuint Fbo, object *ObjectF, u32 AcquiredImageIndex) {
+    if(C->DeviceInfo.HasDynamicRendering) {
+        C->CmdEndRendering(CommandBuffer);
+        TransitionRenderingImages(C, CommandBuffer, Fbo, ObjectF, AcquiredImageIndex, 0, 0);
+    } else {
+        vkCmdEndRenderPass(CommandBuffer);
+    }
+}
+
 void cuglSwapBuffers(void) {
     const char *Name = "cuglSwapBuffers";
     context *C = 0;
     CheckGL(AcquireContext(&C, Name), gl_error_ACQUIRE_CONTEXT);
     
+    // NOTE(blackedout): Decides which framebuffers are resumed, which `CheckFramebuffer` builds the render passes for
+    MergeRenderPasses(C);
     for(u32 I = 1; I < C->PipelineStates.Count; ++I) {
         CheckPipeline(C, I);
     }
+    for(u32 I = 1; I < C->Objects.Capacity; ++I) {
+        object *Object = 0;
+        if(0 == CheckObjectTypeGet(C, I, object_PROGRAM, &Object) && Object->Program.LastDispatchFrame == C->SwapCounter + 1) {
+            UploadProgramUniforms(C, I);
+        }
+    }
+    CheckGL(UploadMultiDrawData(C), gl_error_OUT_OF_MEMORY);
 
     uint32_t AcquiredImageIndex = 0;
     VulkanCheckReturn(vkAcquireNextImageKHR(C->Device, C->Swapchain, UINT64_MAX, C->Semaphores[semaphore_PREV_PRESENT_DONE], VK_NULL_HANDLE, &AcquiredImageIndex));
@@ -26,11 +457,198 @@ void cuglSwapBuffers(void) {
     VulkanCheckReturn(vkBeginCommandBuffer(C->CommandBuffers[command_buffer_GRAPHICS], &BeginInfo));
 
     VkCommandBuffer GraphicsCommandBuffer = C->CommandBuffers[command_buffer_GRAPHICS];
+    AcquireUploadedBuffers(C, GraphicsCommandBuffer);
+
+    u32 AsyncDispatchCount = MarkAsyncDispatches(C);
+    VkCommandBuffer ComputeCommandBuffer = C->CommandBuffers[command_buffer_COMPUTE];
+    if(AsyncDispatchCount) {
+        VulkanCheckReturn(vkBeginCommandBuffer(ComputeCommandBuffer, &BeginInfo));
+    }
+    // NOTE(blackedout): Async dispatches are ordered by their own aliasing, which covers every barrier between them that matters
+    VkDescriptorBufferInfo AsyncWrites[MAX_UNBARRIERED_WRITE_COUNT];
+    u32 AsyncWriteCount = 0;
+    int HasAsyncWrites = 0;
     object *ObjectF = 0;
     GLuint Fbo = 0;
+    VkClearColorValue RenderingClearColor = {0};
     u32 PipelineIndex = 0;
+    int IsSwapchainImageDrawn = 0;
+    int64_t PushedDrawIdBase = -1;
+    int IsInTransferRun = 0;
+    int IsDrawnSinceDispatch = 0;
+    // NOTE(blackedout): A requested memory barrier is pending until a command that may consume the writes before it. Dispatches
+    // only consume it if they access a buffer range written since the last emitted barrier. Barriers without such writes are dropped.
+    // Draws may write every storage buffer bound for them.
+    VkPipelineStageFlags PendingBarrierDstStages = 0;
+    VkAccessFlags PendingBarrierDstAccess = 0;
+    VkDescriptorBufferInfo UnbarrieredWrites[MAX_UNBARRIERED_WRITE_COUNT];
+    u32 UnbarrieredWriteCount = 0;
+    int HasUnbarrieredWrites = 0;
+    VkPipelineStageFlags UnbarrieredWriteStages = 0;
+    const VkDescriptorBufferInfo *DrawStorageBufferInfos = 0;
+    u32 DrawStorageBufferInfoCount = 0;
+    VkDescriptorBufferInfo RunWrittenRanges[MAX_TRANSFER_RUN_WRITTEN_RANGE_COUNT];
+    u32 RunWrittenRangeCount = 0;
+    VkBuffer BoundVertexBuffers[MAX_TRACKED_VERTEX_BINDING_COUNT] = {0};
+    VkDeviceSize BoundVertexOffsets[MAX_TRACKED_VERTEX_BINDING_COUNT] = {0};
+    VkBuffer BoundIndexBuffer = VK_NULL_HANDLE;
+    VkDeviceSize BoundIndexOffset = 0;
+    VkIndexType BoundIndexType = VK_INDEX_TYPE_UINT16;
     for(u32 I = 0; I < C->Commands.Count; ++I) {
         command *Command = ArrayData(command, C->Commands) + I;
+        int IsDispatch = Command->Type == command_DISPATCH || Command->Type == command_DISPATCH_INDIRECT;
+        const VkDescriptorBufferInfo *DispatchBufferInfos = 0;
+        if(IsDispatch) {
+            DispatchBufferInfos = (const VkDescriptorBufferInfo *)(ArrayData(u8, C->CommandData) + Command->Dispatch.BufferInfoDataOffset);
+        }
+        if(IsDispatch && Command->Dispatch.IsAsync) {
+            VkDescriptorBufferInfo DispatchRanges[SHADER_STORAGE_BINDING_COUNT + 2];
+            u32 DispatchRangeCount = 0;
+            Assert(0 == PushCommandBufferRanges(C, Command, DispatchRanges, &DispatchRangeCount, ArrayCount(DispatchRanges)));
+            int IsHazard = AsyncWriteCount == MAX_UNBARRIERED_WRITE_COUNT;
+            for(u32 J = 0; J < AsyncWriteCount && IsHazard == 0; ++J) {
+                for(u32 K = 0; K < DispatchRangeCount && IsHazard == 0; ++K) {
+                    IsHazard = IsBufferRangeAliased(AsyncWrites[J], DispatchRanges[K]);
+                }
+            }
+            if(IsHazard) {
+                VkMemoryBarrier Barrier = {
+                    .sType = VK_STRUCTURE_TYPE_MEMORY_BARRIER,
+                    .pNext = 0,
+                    .srcAccessMask = VK_ACCESS_SHADER_WRITE_BIT,
+                    .dstAccessMask = VK_ACCESS_SHADER_READ_BIT | VK_ACCESS_SHADER_WRITE_BIT | VK_ACCESS_INDIRECT_COMMAND_READ_BIT,
+                };
+                VkPipelineStageFlags DstStages = VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT | VK_PIPELINE_STAGE_DRAW_INDIRECT_BIT;
+                vkCmdPipelineBarrier(ComputeCommandBuffer, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, DstStages, 0, 1, &Barrier, 0, 0, 0, 0);
+                AsyncWriteCount = 0;
+            }
+            for(u32 K = 0; K < Command->Dispatch.BufferInfoCount && AsyncWriteCount < MAX_UNBARRIERED_WRITE_COUNT; ++K) {
+                if(Command->Dispatch.WrittenBufferInfoMask & (1u << K)) {
+                    AsyncWrites[AsyncWriteCount++] = DispatchBufferInfos[K];
+                    HasAsyncWrites = 1;
+                }
+            }
+            RecordDispatch(C, ComputeCommandBuffer, Command);
+            continue;
+        }
+        // NOTE(blackedout): Transfers, dispatches, barriers and pixel reads end the render pass before them
+        if(ObjectF && (IsDispatch || IsOutsideRenderPassCommand(Command->Type))) {
+            EndRenderPass(C, GraphicsCommandBuffer, Fbo, ObjectF, AcquiredImageIndex);
+            ObjectF = 0;
+        }
+        if(Command->Type == command_MEMORY_BARRIER) {
+            if(HasUnbarrieredWrites) {
+                PendingBarrierDstStages |= Command->Barrier.DstStages;
+                PendingBarrierDstAccess |= Command->Barrier.DstAccess;
+            }
+            continue;
+        }
+        if(PendingBarrierDstStages) {
+            int IsConsumer = IsDispatch == 0 || UnbarrieredWriteCount == MAX_UNBARRIERED_WRITE_COUNT;
+            for(u32 J = 0; J < UnbarrieredWriteCount && IsConsumer == 0; ++J) {
+                VkDescriptorBufferInfo Write = UnbarrieredWrites[J];
+                if(Command->Type == command_DISPATCH_INDIRECT && Write.buffer == Command->Dispatch.Buffer &&
+                   Write.offset < Command->Dispatch.Offset + sizeof(VkDispatchIndirectCommand) && Command->Dispatch.Offset < Write.offset + Write.range) {
+                    IsConsumer = 1;
+                }
+                for(u32 K = 0; K < Command->Dispatch.BufferInfoCount && IsConsumer == 0; ++K) {
+                    VkDescriptorBufferInfo Info = DispatchBufferInfos[K];
+                    IsConsumer = Write.buffer == Info.buffer && Write.offset < Info.offset + Info.range && Info.offset < Write.offset + Write.range;
+                }
+            }
+            if(IsConsumer) {
+                VkMemoryBarrier Barrier = {
+                    .sType = VK_STRUCTURE_TYPE_MEMORY_BARRIER,
+                    .pNext = 0,
+                    .srcAccessMask = VK_ACCESS_SHADER_WRITE_BIT,
+                    .dstAccessMask = PendingBarrierDstAccess,
+                };
+                vkCmdPipelineBarrier(GraphicsCommandBuffer, UnbarrieredWriteStages, PendingBarrierDstStages, 0, 1, &Barrier, 0, 0, 0, 0);
+                ++C->FrameStats.EmittedMemoryBarrierCount;
+                PendingBarrierDstStages = 0;
+                PendingBarrierDstAccess = 0;
+                UnbarrieredWriteCount = 0;
+                HasUnbarrieredWrites = 0;
+                UnbarrieredWriteStages = 0;
+            }
+        }
+        if(IsDispatch) {
+            HasUnbarrieredWrites = 1;
+            UnbarrieredWriteStages |= VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT;
+            for(u32 K = 0; K < Command->Dispatch.BufferInfoCount && UnbarrieredWriteCount < MAX_UNBARRIERED_WRITE_COUNT; ++K) {
+                if(Command->Dispatch.WrittenBufferInfoMask & (1u << K)) {
+                    UnbarrieredWrites[UnbarrieredWriteCount++] = DispatchBufferInfos[K];
+                }
+            }
+        }
+        if(Command->Type == command_BIND_STORAGE_BUFFERS) {
+            DrawStorageBufferInfos = (const VkDescriptorBufferInfo *)(ArrayData(u8, C->CommandData) + Command->BindStorageBuffers.BufferInfoDataOffset);
+            DrawStorageBufferInfoCount = Command->BindStorageBuffers.BufferInfoCount;
+        }
+        int IsDraw = Command->Type == command_DRAW || Command->Type == command_DRAW_INDEXED || Command->Type == command_DRAW_INDIRECT ||
+                     Command->Type == command_DRAW_INDEXED_INDIRECT || Command->Type == command_MULTI_DRAW || Command->Type == command_MULTI_DRAW_INDEXED;
+        if(IsDraw && DrawStorageBufferInfoCount) {
+            HasUnbarrieredWrites = 1;
+            UnbarrieredWriteStages |= VK_PIPELINE_STAGE_VERTEX_SHADER_BIT | VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT;
+            // NOTE(blackedout): Consecutive draws mostly keep their storage buffers, those are tracked once
+            for(u32 K = 0; K < DrawStorageBufferInfoCount && UnbarrieredWriteCount < MAX_UNBARRIERED_WRITE_COUNT; ++K) {
+                VkDescriptorBufferInfo Info = DrawStorageBufferInfos[K];
+                int IsTracked = 0;
+                for(u32 J = 0; J < UnbarrieredWriteCount && IsTracked == 0; ++J) {
+                    IsTracked = UnbarrieredWrites[J].buffer == Info.buffer && UnbarrieredWrites[J].offset == Info.offset && UnbarrieredWrites[J].range == Info.range;
+                }
+                if(IsTracked == 0) {
+                    UnbarrieredWrites[UnbarrieredWriteCount++] = Info;
+                }
+            }
+        }
+        // NOTE(blackedout): Consecutive buffer transfers share one barrier before and one after them
+        int IsTransfer = Command->Type == command_UPDATE_BUFFER || Command->Type == command_COPY_BUFFER;
+        if(IsTransfer && IsInTransferRun) {
+            // NOTE(blackedout): Within a run, only transfers touching a range written earlier in the run wait on each other.
+            // Pooled buffers share their pool's buffer, so comparing buffers alone would make them all wait.
+            VkDescriptorBufferInfo DstRange = {0}, SrcRange = {0};
+            if(Command->Type == command_UPDATE_BUFFER) {
+                DstRange = MakeBufferRange(Command->UpdateBuffer.Buffer, Command->UpdateBuffer.Offset, Command->UpdateBuffer.ByteCount);
+            } else {
+                DstRange = MakeBufferRange(Command->CopyBuffer.DstBuffer, Command->CopyBuffer.DstOffset, Command->CopyBuffer.ByteCount);
+                SrcRange = MakeBufferRange(Command->CopyBuffer.SrcBuffer, Command->CopyBuffer.SrcOffset, Command->CopyBuffer.ByteCount);
+            }
+            int IsHazard = RunWrittenRangeCount == MAX_TRANSFER_RUN_WRITTEN_RANGE_COUNT;
+            for(u32 J = 0; J < RunWrittenRangeCount && IsHazard == 0; ++J) {
+                IsHazard = IsBufferRangeAliased(RunWrittenRanges[J], DstRange) || (SrcRange.buffer != VK_NULL_HANDLE && IsBufferRangeAliased(RunWrittenRanges[J], SrcRange));
+            }
+            if(IsHazard) {
+                VkMemoryBarrier Barrier = {
+                    .sType = VK_STRUCTURE_TYPE_MEMORY_BARRIER,
+                    .pNext = 0,
+                    .srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT,
+                    .dstAccessMask = VK_ACCESS_TRANSFER_READ_BIT | VK_ACCESS_TRANSFER_WRITE_BIT,
+                };
+                vkCmdPipelineBarrier(GraphicsCommandBuffer, VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_TRANSFER_BIT, 0, 1, &Barrier, 0, 0, 0, 0);
+                RunWrittenRangeCount = 0;
+            }
+        }
+        if(IsTransfer != IsInTransferRun) {
+            VkMemoryBarrier Barrier = {
+                .sType = VK_STRUCTURE_TYPE_MEMORY_BARRIER,
+                .pNext = 0,
+                .srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT,
+                .dstAccessMask = IsTransfer ? (VK_ACCESS_TRANSFER_READ_BIT | VK_ACCESS_TRANSFER_WRITE_BIT) : TRANSFER_BATCH_CONSUMER_ACCESS,
+            };
+            VkPipelineStageFlags SrcStages = IsTransfer ? TRANSFER_BATCH_CONSUMER_STAGES : VK_PIPELINE_STAGE_TRANSFER_BIT;
+            VkPipelineStageFlags DstStages = IsTransfer ? VK_PIPELINE_STAGE_TRANSFER_BIT : TRANSFER_BATCH_CONSUMER_STAGES;
+            vkCmdPipelineBarrier(GraphicsCommandBuffer, SrcStages, DstStages, 0, 1, &Barrier, 0, 0, 0, 0);
+            IsInTransferRun = IsTransfer;
+            RunWrittenRangeCount = 0;
+        }
+        if(IsTransfer) {
+            if(Command->Type == command_UPDATE_BUFFER) {
+                RunWrittenRanges[RunWrittenRangeCount++] = MakeBufferRange(Command->UpdateBuffer.Buffer, Command->UpdateBuffer.Offset, Command->UpdateBuffer.ByteCount);
+            } else {
+                RunWrittenRanges[RunWrittenRangeCount++] = MakeBufferRange(Command->CopyBuffer.DstBuffer, Command->CopyBuffer.DstOffset, Command->CopyBuffer.ByteCount);
+            }
+        }
         switch(Command->Type) {
         case command_BIND_PIPELINE: {
             PipelineIndex = Command->BindPipeline.PipelineIndex;
@@ -47,39 +665,185 @@ void cuglSwapBuffers(void) {
             uint32_t Offset = ObjectP->Program.AlignedUniformByteCount*Command->BindUniforms.Index;
             vkCmdBindDescriptorSets(GraphicsCommandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, Header->Layout, 0, 1, &ObjectP->Program.UniformDescriptorSet, 1, &Offset);
         } break;
+        case command_BIND_STORAGE_BUFFERS: {
+            pipeline_state_header *Header = GetPipelineState(C, PipelineIndex, pipeline_state_HEADER);
+            vkCmdBindDescriptorSets(GraphicsCommandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, Header->Layout, 1, 1, &Command->BindStorageBuffers.Set, 0, 0);
+        } break;
+        case command_DISPATCH:
+        case command_DISPATCH_INDIRECT: {
+            if(IsDrawnSinceDispatch) {
+                // NOTE(blackedout): Dispatches are recorded where they were issued, they must not write what earlier draws still read
+                vkCmdPipelineBarrier(GraphicsCommandBuffer, VK_PIPELINE_STAGE_ALL_GRAPHICS_BIT, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, 0, 0, 0, 0, 0, 0, 0);
+                IsDrawnSinceDispatch = 0;
+            }
+            RecordDispatch(C, GraphicsCommandBuffer, Command);
+            // NOTE(blackedout): The compute layout has no push constants, the values are undefined afterwards
+            PushedDrawIdBase = -1;
+        } break;
+        case command_READ_PIXELS: {
+            RecordReadPixels(C, GraphicsCommandBuffer, Command, AcquiredImageIndex, IsSwapchainImageDrawn);
+        } break;
         case command_CLEAR: {
-            if(Fbo == 0) {
-                // TOOD(blackedout): Depth, stencil
-                pipeline_state_clear_color *State = GetPipelineState(C, PipelineIndex, pipeline_state_CLEAR_COLOR);
+            // TOOD(blackedout): Depth, stencil
+            if((Command->Clear.Mask & GL_COLOR_BUFFER_BIT) == 0) {
+                break;
+            }
+            int64_t X0 = 0, Y0 = 0;
+            int64_t X1 = ObjectF->Framebuffer.Extent.width, Y1 = ObjectF->Framebuffer.Extent.height;
+            if(Command->Clear.IsScissored) {
+                VkRect2D Scissor = Command->Clear.Scissor;
+                X0 = Max(X0, (int64_t)Scissor.offset.x);
+                Y0 = Max(Y0, (int64_t)Scissor.offset.y);
+                X1 = Min(X1, (int64_t)Scissor.offset.x + Scissor.extent.width);
+                Y1 = Min(Y1, (int64_t)Scissor.offset.y + Scissor.extent.height);
+            }
+            if(X1 <= X0 || Y1 <= Y0) {
+                break;
+            }
+            VkClearRect ClearRect = {
+                .rect = {
+                    .offset = { .x = (int32_t)X0, .y = (int32_t)Y0 },
+                    .extent = { .width = (u32)(X1 - X0), .height = (u32)(Y1 - Y0) },
+                },
+                .baseArrayLayer = 0,
+                .layerCount = 1,
+            };
+
+            // NOTE(blackedout): Clears the draw buffers of the subpass, `colorAttachment` indexes its color references
+            pipeline_state_clear_color *State = GetPipelineState(C, PipelineIndex, pipeline_state_CLEAR_COLOR);
+            render_pass_state_subpass *Subpass = ArrayData(render_pass_state_subpass, ObjectF->Framebuffer.StoredSubpasses) + Command->Clear.SubpassIndex;
+            VkAttachmentReference *References = ArrayData(VkAttachmentReference, ObjectF->Framebuffer.StoredSubpassAttachments) + Subpass->BaseIndex;
+            for(u32 I = 0; I < Subpass->ColorAttachmentCount; ++I) {
+                if(References[I].attachment == VK_ATTACHMENT_UNUSED) {
+                    continue;
+                }
                 VkClearAttachment ClearAttachment = {
                     .aspectMask = VK_IMAGE_ASPECT_COLOR_BIT,
-                    .colorAttachment = 0,
+                    .colorAttachment = I,
                     .clearValue.color.float32 = { State->R, State->G, State->B, State->A },
                 };
-                // TODO(blackedout): Clip with scissor
-                VkClearRect ClearRect = {
-                    .rect = {
-                        .offset = { .x = 0, .y = 0 },
-                        .extent = ObjectF->Framebuffer.Extent,
-                    },
-                    .baseArrayLayer = 0,
-                    .layerCount = 1,
-                };
                 vkCmdClearAttachments(GraphicsCommandBuffer, 1, &ClearAttachment, 1, &ClearRect);
-            } else {
-                // TODO(blackedout): Look up draw buffer in subpass state
             }
         } break;
         case command_BIND_VERTEX_BUFFER: {
-            vkCmdBindVertexBuffers(GraphicsCommandBuffer, Command->BindVertexBuffer.BindingIndex, 1, &Command->BindVertexBuffer.Buffer, &Command->BindVertexBuffer.Offset);
+            // NOTE(blackedout): Draws of buffers from the same pool range often bind the same buffer and offset again
+            u32 BindingIndex = Command->BindVertexBuffer.BindingIndex;
+            if(BindingIndex < MAX_TRACKED_VERTEX_BINDING_COUNT) {
+                if(BoundVertexBuffers[BindingIndex] == Command->BindVertexBuffer.Buffer && BoundVertexOffsets[BindingIndex] == Command->BindVertexBuffer.Offset) {
+                    ++C->FrameStats.SkippedVertexBufferBindCount;
+                    break;
+                }
+                BoundVertexBuffers[BindingIndex] = Command->BindVertexBuffer.Buffer;
+                BoundVertexOffsets[BindingIndex] = Command->BindVertexBuffer.Offset;
+            }
+            vkCmdBindVertexBuffers(GraphicsCommandBuffer, BindingIndex, 1, &Command->BindVertexBuffer.Buffer, &Command->BindVertexBuffer.Offset);
+        } break;
+        case command_UPDATE_BUFFER: {
+            u8 *Data = ArrayData(u8, C->CommandData) + Command->UpdateBuffer.DataOffset;
+            vkCmdUpdateBuffer(GraphicsCommandBuffer, Command->UpdateBuffer.Buffer, Command->UpdateBuffer.Offset, Command->UpdateBuffer.ByteCount, Data);
+        } break;
+        case command_COPY_BUFFER: {
+            VkBufferCopy Region = {
+                .srcOffset = Command->CopyBuffer.SrcOffset,
+                .dstOffset = Command->CopyBuffer.DstOffset,
+                .size = Command->CopyBuffer.ByteCount,
+            };
+            vkCmdCopyBuffer(GraphicsCommandBuffer, Command->CopyBuffer.SrcBuffer, Command->CopyBuffer.DstBuffer, 1, &Region);
         } break;
         case command_DRAW: {
+            SetDrawIdBase(C, GraphicsCommandBuffer, PipelineIndex, 0, &PushedDrawIdBase);
             vkCmdDraw(GraphicsCommandBuffer, Command->Draw.VertexCount, Command->Draw.InstanceCount, Command->Draw.VertexOffset, Command->Draw.InstanceOffset);
         } break;
+        case command_BIND_INDEX_BUFFER: {
+            // NOTE(blackedout): Consecutive indexed draws mostly use the same element buffer
+            if(Command->BindIndexBuffer.Buffer != BoundIndexBuffer || Command->BindIndexBuffer.Offset != BoundIndexOffset || Command->BindIndexBuffer.IndexType != BoundIndexType) {
+                BoundIndexBuffer = Command->BindIndexBuffer.Buffer;
+                BoundIndexOffset = Command->BindIndexBuffer.Offset;
+                BoundIndexType = Command->BindIndexBuffer.IndexType;
+                vkCmdBindIndexBuffer(GraphicsCommandBuffer, BoundIndexBuffer, BoundIndexOffset, BoundIndexType);
+            }
+        } break;
+        case command_DRAW_INDEXED: {
+            SetDrawIdBase(C, GraphicsCommandBuffer, PipelineIndex, Command->DrawIndexed.DrawId, &PushedDrawIdBase);
+            vkCmdDrawIndexed(GraphicsCommandBuffer, Command->DrawIndexed.IndexCount, Command->DrawIndexed.InstanceCount, Command->DrawIndexed.FirstIndex, Command->DrawIndexed.VertexOffset, Command->DrawIndexed.InstanceOffset);
+        } break;
+        case command_DRAW_INDIRECT:
+        case command_DRAW_INDEXED_INDIRECT: {
+            int IsIndexed = Command->Type == command_DRAW_INDEXED_INDIRECT;
+            if(Command->DrawIndirect.CountBuffer != VK_NULL_HANDLE) {
+                SetDrawIdBase(C, GraphicsCommandBuffer, PipelineIndex, 0, &PushedDrawIdBase);
+                PFN_vkCmdDrawIndirectCountKHR CmdDraw = IsIndexed ? C->CmdDrawIndexedIndirectCount : C->CmdDrawIndirectCount;
+                CmdDraw(GraphicsCommandBuffer, Command->DrawIndirect.Buffer, Command->DrawIndirect.Offset, Command->DrawIndirect.CountBuffer, Command->DrawIndirect.CountOffset, Command->DrawIndirect.DrawCount, Command->DrawIndirect.Stride);
+                break;
+            }
+            // NOTE(blackedout): Without multiDrawIndirect the draw count must be 0 or 1, so the draws are split, each call passing
+            // its first draw index on for gl_DrawID
+            u32 MaxDrawCount = C->DeviceInfo.Features.multiDrawIndirect ? C->DeviceInfo.Properties.limits.maxDrawIndirectCount : 1;
+            u64 Offset = Command->DrawIndirect.Offset;
+            for(u32 J = 0; J < Command->DrawIndirect.DrawCount; J += MaxDrawCount) {
+                u32 DrawCount = Min(MaxDrawCount, Command->DrawIndirect.DrawCount - J);
+                SetDrawIdBase(C, GraphicsCommandBuffer, PipelineIndex, J, &PushedDrawIdBase);
+                if(IsIndexed) {
+                    vkCmdDrawIndexedIndirect(GraphicsCommandBuffer, Command->DrawIndirect.Buffer, Offset, DrawCount, Command->DrawIndirect.Stride);
+                } else {
+                    vkCmdDrawIndirect(GraphicsCommandBuffer, Command->DrawIndirect.Buffer, Offset, DrawCount, Command->DrawIndirect.Stride);
+                }
+                Offset += (u64)DrawCount*Command->DrawIndirect.Stride;
+            }
+        } break;
+        case command_MULTI_DRAW:
+        case command_MULTI_DRAW_INDEXED: {
+            int IsIndexed = Command->Type == command_MULTI_DRAW_INDEXED;
+            u32 RecordByteCount = GetMultiDrawRecordByteCount(C, IsIndexed);
+            u32 MaxDrawCount = C->DeviceInfo.MaxMultiDrawCount;
+            if(MaxDrawCount == 0) {
+                MaxDrawCount = C->DeviceInfo.Features.multiDrawIndirect ? C->DeviceInfo.Properties.limits.maxDrawIndirectCount : 1;
+            }
+            u64 DataOffset = Command->MultiDraw.DataOffset;
+            for(u32 J = 0; J < Command->MultiDraw.DrawCount; J += MaxDrawCount) {
+                u32 DrawCount = Min(MaxDrawCount, Command->MultiDraw.DrawCount - J);
+                SetDrawIdBase(C, GraphicsCommandBuffer, PipelineIndex, J, &PushedDrawIdBase);
+                const void *Data = ArrayData(u8, C->MultiDrawData) + DataOffset;
+                if(C->DeviceInfo.MaxMultiDrawCount && IsIndexed) {
+                    C->CmdDrawMultiIndexed(GraphicsCommandBuffer, DrawCount, Data, 1, 0, RecordByteCount, 0);
+                } else if(C->DeviceInfo.MaxMultiDrawCount) {
+                    C->CmdDrawMulti(GraphicsCommandBuffer, DrawCount, Data, 1, 0, RecordByteCount);
+                } else if(IsIndexed) {
+                    vkCmdDrawIndexedIndirect(GraphicsCommandBuffer, C->MultiDrawBuffer, DataOffset, DrawCount, RecordByteCount);
+                } else {
+                    vkCmdDrawIndirect(GraphicsCommandBuffer, C->MultiDrawBuffer, DataOffset, DrawCount, RecordByteCount);
+                }
+                DataOffset += (u64)DrawCount*RecordByteCount;
+            }
+        } break;
         case command_BEGIN_RENDER_PASS: {
+            if(ObjectF) {
+                EndRenderPass(C, GraphicsCommandBuffer, Fbo, ObjectF, AcquiredImageIndex);
+            }
             ObjectF = 0;
             Fbo = Command->BeginRenderPass.Fbo;
-            Assert(0 == CheckObjectTypeGet(C, Command->BeginRenderPass.Fbo, object_FRAMEBUFFER, &ObjectF));
+            Assert(0 == CheckObjectTypeGet(C, Fbo, object_FRAMEBUFFER, &ObjectF));
+            IsSwapchainImageDrawn |= Fbo == 0;
+            IsDrawnSinceDispatch = 1;
+            int IsResume = Command->BeginRenderPass.IsResume;
+            if(C->DeviceInfo.HasDynamicRendering) {
+                RenderingClearColor = Command->BeginRenderPass.ClearColor;
+                TransitionRenderingImages(C, GraphicsCommandBuffer, Fbo, ObjectF, AcquiredImageIndex, 1, IsResume);
+                if(BeginRendering(C, GraphicsCommandBuffer, Fbo, ObjectF, Command->BeginRenderPass.SubpassIndex, IsResume, AcquiredImageIndex, RenderingClearColor)) {
+                    GenerateErrorMsg(C, GL_OUT_OF_MEMORY, GL_DEBUG_SOURCE_API, "cuglSwapBuffers: failed to begin rendering");
+                }
+                break;
+            }
+            if(IsResume) {
+                // NOTE(blackedout): The render pass has no external dependencies, the earlier pass's writes must be loaded
+                VkMemoryBarrier Barrier = {
+                    .sType = VK_STRUCTURE_TYPE_MEMORY_BARRIER,
+                    .pNext = 0,
+                    .srcAccessMask = VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT,
+                    .dstAccessMask = VK_ACCESS_COLOR_ATTACHMENT_READ_BIT | VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT,
+                };
+                vkCmdPipelineBarrier(GraphicsCommandBuffer, VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT, VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT, 0, 1, &Barrier, 0, 0, 0, 0);
+            }
             
             VkFramebuffer Framebuffer = VK_NULL_HANDLE;
             if(Command->BeginRenderPass.Fbo == 0) {
@@ -87,18 +851,19 @@ void cuglSwapBuffers(void) {
             } else {
                 Framebuffer = ObjectF->Framebuffer.Framebuffer;
             }
-            VkClearValue ClearValue = {
-                .color = {
-                    .float32[0] = 0.0f,
-                    .float32[1] = 0.5f,
-                    .float32[2] = 0.0f,
-                    .float32[3] = 0.0f
-                }
-            };
+            // NOTE(blackedout): Only attachments with the CLEAR load op read their value, see `Clear`
+            u32 ClearValueCount = ObjectF->Framebuffer.AttachmentCount;
+            if(ArrayRequireRoom(&C->TmpClearValues, ClearValueCount, sizeof(VkClearValue), 8)) {
+                ClearValueCount = 0;
+            }
+            VkClearValue *ClearValues = ArrayData(VkClearValue, C->TmpClearValues);
+            for(u32 I = 0; I < ClearValueCount; ++I) {
+                ClearValues[I].color = Command->BeginRenderPass.ClearColor;
+            }
             VkRenderPassBeginInfo RenderPassBeginInfo = {
                 .sType = VK_STRUCTURE_TYPE_RENDER_PASS_BEGIN_INFO,
                 .pNext = 0,
-                .renderPass = ObjectF->Framebuffer.RenderPass,
+                .renderPass = IsResume ? ObjectF->Framebuffer.ResumeRenderPass : ObjectF->Framebuffer.RenderPass,
                 .framebuffer = Framebuffer,
                 .renderArea = {
                     .offset.x = 0,
@@ -106,18 +871,47 @@ void cuglSwapBuffers(void) {
                     .extent.width = ObjectF->Framebuffer.Extent.width,
                     .extent.height = ObjectF->Framebuffer.Extent.height,
                 },
-                .clearValueCount = 1,
-                .pClearValues = &ClearValue,
+                .clearValueCount = ClearValueCount,
+                .pClearValues = ClearValues,
             };
             vkCmdBeginRenderPass(GraphicsCommandBuffer, &RenderPassBeginInfo, VK_SUBPASS_CONTENTS_INLINE);
         } break;
+        case command_NEXT_SUBPASS: {
+            if(C->DeviceInfo.HasDynamicRendering) {
+                // NOTE(blackedout): The next rendering loads what the previous one stored
+                C->CmdEndRendering(GraphicsCommandBuffer);
+                VkMemoryBarrier Barrier = {
+                    .sType = VK_STRUCTURE_TYPE_MEMORY_BARRIER,
+                    .pNext = 0,
+                    .srcAccessMask = VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT,
+                    .dstAccessMask = VK_ACCESS_COLOR_ATTACHMENT_READ_BIT | VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT,
+                };
+                vkCmdPipelineBarrier(GraphicsCommandBuffer, VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT, VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT, 0, 1, &Barrier, 0, 0, 0, 0);
+                if(BeginRendering(C, GraphicsCommandBuffer, Fbo, ObjectF, Command->NextSubpass.SubpassIndex, 0, AcquiredImageIndex, RenderingClearColor)) {
+                    GenerateErrorMsg(C, GL_OUT_OF_MEMORY, GL_DEBUG_SOURCE_API, "cuglSwapBuffers: failed to begin rendering");
+                }
+            }
+        } break;
         default: {
 
         } break;
         }
     }
 
-    vkCmdEndRenderPass(C->CommandBuffers[command_buffer_GRAPHICS]);
+    // NOTE(blackedout): A frame may consist of dispatches and transfers only
+    if(ObjectF) {
+        EndRenderPass(C, GraphicsCommandBuffer, Fbo, ObjectF, AcquiredImageIndex);
+    } else if(PendingBarrierDstStages & VK_PIPELINE_STAGE_HOST_BIT) {
+        // NOTE(blackedout): Nothing consumed the last barrier, but the host may once the frame is done
+        VkMemoryBarrier Barrier = {
+            .sType = VK_STRUCTURE_TYPE_MEMORY_BARRIER,
+            .pNext = 0,
+            .srcAccessMask = VK_ACCESS_SHADER_WRITE_BIT,
+            .dstAccessMask = VK_ACCESS_HOST_READ_BIT,
+        };
+        vkCmdPipelineBarrier(GraphicsCommandBuffer, UnbarrieredWriteStages, VK_PIPELINE_STAGE_HOST_BIT, 0, 1, &Barrier, 0, 0, 0, 0);
+        ++C->FrameStats.EmittedMemoryBarrierCount;
+    }
 
 #if 0
     VkImageMemoryBarrier FromPresentBarrier = {
@@ -164,19 +958,19 @@ void cuglSwapBuffers(void) {
 #endif
 
     VulkanCheckReturn(vkEndCommandBuffer(C->CommandBuffers[command_buffer_GRAPHICS]));
-
-    VkPipelineStageFlags WaitStage = VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT;
-    VkSubmitInfo SubmitInfo = {
-        .sType = VK_STRUCTURE_TYPE_SUBMIT_INFO,
-        .pNext = 0,
-        .waitSemaphoreCount = 1,
-        .pWaitSemaphores = &C->Semaphores[semaphore_PREV_PRESENT_DONE],
-        .pWaitDstStageMask = &WaitStage,
-        .commandBufferCount = 1,
-        .pCommandBuffers = &C->CommandBuffers[command_buffer_GRAPHICS],
-        .signalSemaphoreCount = 1,
-        .pSignalSemaphores = &C->Semaphores[semaphore_RENDER_COMPLETE],
-    };
+    if(AsyncDispatchCount) {
+        if(HasAsyncWrites) {
+            // NOTE(blackedout): The host may read what they wrote once the frame is done
+            VkMemoryBarrier Barrier = {
+                .sType = VK_STRUCTURE_TYPE_MEMORY_BARRIER,
+                .pNext = 0,
+                .srcAccessMask = VK_ACCESS_SHADER_WRITE_BIT,
+                .dstAccessMask = VK_ACCESS_HOST_READ_BIT,
+            };
+            vkCmdPipelineBarrier(ComputeCommandBuffer, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, VK_PIPELINE_STAGE_HOST_BIT, 0, 1, &Barrier, 0, 0, 0, 0);
+        }
+        VulkanCheckReturn(vkEndCommandBuffer(ComputeCommandBuffer));
+    }
 
     VkQueue GraphicsQueue, SurfaceQueue;
     vkGetDeviceQueue(C->Device, C->DeviceInfo.QueueFamilyIndices[queue_GRAPHICS], 0, &GraphicsQueue);
@@ -185,6 +979,80 @@ void cuglSwapBuffers(void) {
     } else {
         vkGetDeviceQueue(C->Device, C->DeviceInfo.QueueFamilyIndices[queue_SURFACE], 0, &SurfaceQueue);
     }
+
+    // NOTE(blackedout): Submit this frame's uploads first, the graphics work waits on them
+    VkQueue TransferQueue = GraphicsQueue;
+    if(C->DeviceInfo.QueueFamilyIndices[queue_TRANSFER] != C->DeviceInfo.QueueFamilyIndices[queue_GRAPHICS]) {
+        vkGetDeviceQueue(C->Device, C->DeviceInfo.QueueFamilyIndices[queue_TRANSFER], 0, &TransferQueue);
+    }
+    VkSemaphore TransferSemaphore = VK_NULL_HANDLE;
+    if(SubmitTransferBatch(C, TransferQueue, &TransferSemaphore)) {
+        return;
+    }
+
+    // NOTE(blackedout): Async dispatches only wait on the uploads. The graphics work of this frame doesn't wait on them, that
+    // of the next frame does (which is why the value of an earlier batch is fine to wait on if this frame has none).
+    u64 ComputeSignalValue = 0;
+    if(AsyncDispatchCount) {
+        VkQueue ComputeQueue;
+        vkGetDeviceQueue(C->Device, C->DeviceInfo.QueueFamilyIndices[queue_COMPUTE], 0, &ComputeQueue);
+        ComputeSignalValue = ++C->ComputeTimelineValue;
+        VkPipelineStageFlags ComputeWaitStage = VK_PIPELINE_STAGE_DRAW_INDIRECT_BIT | VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT;
+        VkTimelineSemaphoreSubmitInfoKHR ComputeTimelineSubmitInfo = {
+            .sType = VK_STRUCTURE_TYPE_TIMELINE_SEMAPHORE_SUBMIT_INFO_KHR,
+            .pNext = 0,
+            .waitSemaphoreValueCount = 1,
+            .pWaitSemaphoreValues = &C->TransferTimelineValue,
+            .signalSemaphoreValueCount = 1,
+            .pSignalSemaphoreValues = &ComputeSignalValue,
+        };
+        VkSubmitInfo ComputeSubmitInfo = {
+            .sType = VK_STRUCTURE_TYPE_SUBMIT_INFO,
+            .pNext = &ComputeTimelineSubmitInfo,
+            .waitSemaphoreCount = 1,
+            .pWaitSemaphores = &C->ComputeTimeline,
+            .pWaitDstStageMask = &ComputeWaitStage,
+            .commandBufferCount = 1,
+            .pCommandBuffers = &ComputeCommandBuffer,
+            .signalSemaphoreCount = 1,
+            .pSignalSemaphores = &C->ComputeTimeline,
+        };
+        VulkanCheckReturn(vkQueueSubmit(ComputeQueue, 1, &ComputeSubmitInfo, VK_NULL_HANDLE));
+    }
+
+    VkSemaphore WaitSemaphores[3] = { C->Semaphores[semaphore_PREV_PRESENT_DONE] };
+    VkPipelineStageFlags WaitStages[3] = { VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT };
+    u64 WaitValues[3] = {0};
+    u32 WaitSemaphoreCount = 1;
+    if(TransferSemaphore != VK_NULL_HANDLE) {
+        WaitSemaphores[WaitSemaphoreCount] = TransferSemaphore;
+        WaitStages[WaitSemaphoreCount++] = TRANSFER_BATCH_CONSUMER_STAGES;
+    }
+    if(C->UnwaitedComputeTimelineValue) {
+        WaitSemaphores[WaitSemaphoreCount] = C->ComputeTimeline;
+        WaitValues[WaitSemaphoreCount] = C->UnwaitedComputeTimelineValue;
+        WaitStages[WaitSemaphoreCount++] = ASYNC_COMPUTE_CONSUMER_STAGES;
+        C->UnwaitedComputeTimelineValue = 0;
+    }
+    VkTimelineSemaphoreSubmitInfoKHR TimelineSubmitInfo = {
+        .sType = VK_STRUCTURE_TYPE_TIMELINE_SEMAPHORE_SUBMIT_INFO_KHR,
+        .pNext = 0,
+        .waitSemaphoreValueCount = WaitSemaphoreCount,
+        .pWaitSemaphoreValues = WaitValues,
+        .signalSemaphoreValueCount = 0,
+        .pSignalSemaphoreValues = 0,
+    };
+    VkSubmitInfo SubmitInfo = {
+        .sType = VK_STRUCTURE_TYPE_SUBMIT_INFO,
+        .pNext = C->DeviceInfo.HasAsyncCompute ? &TimelineSubmitInfo : 0,
+        .waitSemaphoreCount = WaitSemaphoreCount,
+        .pWaitSemaphores = WaitSemaphores,
+        .pWaitDstStageMask = WaitStages,
+        .commandBufferCount = 1,
+        .pCommandBuffers = &C->CommandBuffers[command_buffer_GRAPHICS],
+        .signalSemaphoreCount = 1,
+        .pSignalSemaphores = &C->Semaphores[semaphore_RENDER_COMPLETE],
+    };
     VulkanCheckReturn(vkQueueSubmit(GraphicsQueue, 1, &SubmitInfo, VK_NULL_HANDLE));
 
     VkPresentInfoKHR PresentInfo = {
@@ -200,17 +1068,44 @@ void cuglSwapBuffers(void) {
     VulkanCheckReturn(vkQueuePresentKHR(SurfaceQueue, &PresentInfo));
 
     VulkanCheckReturn(vkQueueWaitIdle(SurfaceQueue));
+    if(AsyncDispatchCount) {
+        // NOTE(blackedout): Their descriptor sets and uniforms are recycled below
+        VkSemaphoreWaitInfoKHR WaitInfo = {
+            .sType = VK_STRUCTURE_TYPE_SEMAPHORE_WAIT_INFO_KHR,
+            .pNext = 0,
+            .flags = 0,
+            .semaphoreCount = 1,
+            .pSemaphores = &C->ComputeTimeline,
+            .pValues = &ComputeSignalValue,
+        };
+        VulkanCheckReturn(C->WaitSemaphores(C->Device, &WaitInfo, UINT64_MAX));
+        VulkanCheckReturn(vkResetCommandBuffer(ComputeCommandBuffer, 0));
+        C->UnwaitedComputeTimelineValue = ComputeSignalValue;
+        C->FrameStats.AsyncDispatchCount = AsyncDispatchCount;
+    }
+    ReleaseStreamStaging(C);
+    if(RecycleTransferBatch(C, 0)) {
+        return;
+    }
+    DestroyRetiredBuffers(C);
+    ResetStorageDescriptorPools(C);
 
     VulkanCheckReturn(vkResetCommandBuffer(C->CommandBuffers[command_buffer_GRAPHICS], 0));
 
     for(u32 I = 1; I < C->Objects.Capacity; ++I) {
         object *Object = 0;
-        if(0 == CheckObjectTypeGet(C, I, object_PROGRAM, &Object)) {
+        if(0 == CheckObjectTypeGet(C, I, object_BUFFER, &Object)) {
+            RecycleBufferCopies(C, Object);
+        } else if(0 == CheckObjectTypeGet(C, I, object_PROGRAM, &Object)) {
             u8 *LastUniformData = ArrayData(u8, Object->Program.UniformBuffer) + (Object->Program.UniformBuffer.Count - 1)*Object->Program.AlignedUniformByteCount;
             memcpy(Object->Program.UniformBuffer.Data, LastUniformData, Object->Program.AlignedUniformByteCount);
             Object->Program.UniformBuffer.Count = 1;
             Object->Program.LatestUsedUniformsIndex = 0;
             Object->Program.LatestUniformsUsed = 0;
+            Object->Program.LatestUniformsResolved = 0;
+            if(Object->Program.UniformSnapshotTable.Capacity) {
+                ArrayClear(&Object->Program.UniformSnapshotTable, sizeof(uniform_snapshot_entry));
+            }
         }
     }
 
@@ -231,11 +1126,52 @@ void cuglSwapBuffers(void) {
         }
     }
     C->PipelineStates.Count -= DeleteCount;
+    EvictPrimitiveIndexBuffers(C);
+    EvictRenderPasses(C);
 
     ArrayClear(&C->Commands, sizeof(command));
+    C->CommandData.Count = 0;
+    C->MultiDrawData.Count = 0;
+    C->IsRenderPassRecorded = 0;
+    C->RenderPassCommandIndex = 0;
     C->LastPipelineIndex = 0;
     C->IsPipelineSet = 0;
     ++C->SwapCounter;
+
+    C->LastFrameStats = C->FrameStats;
+    memset(&C->FrameStats, 0, sizeof(C->FrameStats));
+}
+
+void cuglGetFrameStats(frame_stats *OutStats) {
+    const char *Name = "cuglGetFrameStats";
+    context *C = 0;
+    CheckGL(AcquireContext(&C, Name), gl_error_ACQUIRE_CONTEXT);
+    *OutStats = C->LastFrameStats;
+    ReleaseContext(C, Name);
+}
+
+int cuglGetBufferMemoryInfo(uint32_t Buffer, buffer_memory_info *OutInfo) {
+    const char *Name = "cuglGetBufferMemoryInfo";
+    context *C = 0;
+    CheckGL(AcquireContext(&C, Name), gl_error_ACQUIRE_CONTEXT, 1);
+
+    object *Object = 0;
+    if(CheckObjectTypeGet(C, Buffer, object_BUFFER, &Object) || Object->Buffer.Buffer == VK_NULL_HANDLE) {
+        ReleaseContext(C, Name);
+        return 1;
+    }
+    VmaAllocation Allocation = Object->Buffer.Allocation;
+    if(Object->Buffer.VirtualAllocation != VK_NULL_HANDLE) {
+        Allocation = ArrayData(buffer_pool, C->BufferPools)[Object->Buffer.PoolIndex].Allocation;
+    }
+    VmaAllocationInfo AllocationInfo = {0};
+    vmaGetAllocationInfo(C->Allocator, Allocation, &AllocationInfo);
+    OutInfo->MemoryTypeIndex = AllocationInfo.memoryType;
+    vmaGetAllocationMemoryProperties(C->Allocator, Allocation, &OutInfo->MemoryPropertyFlags);
+    OutInfo->IsPooled = Object->Buffer.VirtualAllocation != VK_NULL_HANDLE;
+    OutInfo->ByteCount = Object->Buffer.ByteCount;
+    ReleaseContext(C, Name);
+    return 0;
 }
 
 int cuglCreateContext(const context_create_params *Params) {
@@ -249,6 +1185,9 @@ int cuglCreateContext(const context_create_params *Params) {
     C->Allocator = VK_NULL_HANDLE;
     C->Swapchain = VK_NULL_HANDLE;
     C->GraphicsCommandPool = VK_NULL_HANDLE;
+    C->TransferCommandPool = VK_NULL_HANDLE;
+    C->ComputeCommandPool = VK_NULL_HANDLE;
+    C->ComputeTimeline = VK_NULL_HANDLE;
     for(u32 I = 0; I < command_buffer_COUNT; ++I) {
         C->CommandBuffers[I] = VK_NULL_HANDLE;
     }
@@ -268,9 +1207,11 @@ int cuglCreateContext(const context_create_params *Params) {
 
     VulkanCheckGoto(Params->CreateSurface(C->Instance, 0, &C->Surface, Params->User), label_Error);
 
+    C->IsAsyncComputeRequested = Params->IsAsyncComputeEnabled;
     if(VulkanCreateDevice(C, C->Surface)) {
         goto label_Error;
     }
+    C->MaxStagingByteCount = Params->MaxStagingByteCount;
 
     {
         VkCommandPoolCreateInfo GraphicsCommandPoolCreateInfo = {
@@ -286,9 +1227,30 @@ int cuglCreateContext(const context_create_params *Params) {
             .pNext = 0,
             .commandPool = C->GraphicsCommandPool,
             .level = VK_COMMAND_BUFFER_LEVEL_PRIMARY,
-            .commandBufferCount = command_buffer_COUNT,
+            .commandBufferCount = command_buffer_TRANSFER,
         };
         VulkanCheckGoto(vkAllocateCommandBuffers(C->Device, &GraphicsCommandBufferAllocateInfo, C->CommandBuffers), label_Error);
+
+        // NOTE(blackedout): Uploads are recorded on the transfer family, which may be the graphics family
+        VkCommandPoolCreateInfo TransferCommandPoolCreateInfo = GraphicsCommandPoolCreateInfo;
+        TransferCommandPoolCreateInfo.queueFamilyIndex = C->DeviceInfo.QueueFamilyIndices[queue_TRANSFER];
+        VulkanCheckGoto(vkCreateCommandPool(C->Device, &TransferCommandPoolCreateInfo, 0, &C->TransferCommandPool), label_Error);
+
+        VkCommandBufferAllocateInfo TransferCommandBufferAllocateInfo = GraphicsCommandBufferAllocateInfo;
+        TransferCommandBufferAllocateInfo.commandPool = C->TransferCommandPool;
+        TransferCommandBufferAllocateInfo.commandBufferCount = command_buffer_COMPUTE - command_buffer_TRANSFER;
+        VulkanCheckGoto(vkAllocateCommandBuffers(C->Device, &TransferCommandBufferAllocateInfo, C->CommandBuffers + command_buffer_TRANSFER), label_Error);
+
+        if(C->DeviceInfo.HasAsyncCompute) {
+            VkCommandPoolCreateInfo ComputeCommandPoolCreateInfo = GraphicsCommandPoolCreateInfo;
+            ComputeCommandPoolCreateInfo.queueFamilyIndex = C->DeviceInfo.QueueFamilyIndices[queue_COMPUTE];
+            VulkanCheckGoto(vkCreateCommandPool(C->Device, &ComputeCommandPoolCreateInfo, 0, &C->ComputeCommandPool), label_Error);
+
+            VkCommandBufferAllocateInfo ComputeCommandBufferAllocateInfo = GraphicsCommandBufferAllocateInfo;
+            ComputeCommandBufferAllocateInfo.commandPool = C->ComputeCommandPool;
+            ComputeCommandBufferAllocateInfo.commandBufferCount = command_buffer_COUNT - command_buffer_COMPUTE;
+            VulkanCheckGoto(vkAllocateCommandBuffers(C->Device, &ComputeCommandBufferAllocateInfo, C->CommandBuffers + command_buffer_COMPUTE), label_Error);
+        }
     }
 
     {
@@ -304,6 +1266,8 @@ int cuglCreateContext(const context_create_params *Params) {
         }
     }
 
+    // NOTE(blackedout): Only graphics and surface queues ever access the swapchain images
+    uint32_t SwapchainQueueFamilyIndices[] = { C->DeviceInfo.QueueFamilyIndices[queue_GRAPHICS], C->DeviceInfo.QueueFamilyIndices[queue_SURFACE] };
     VkSwapchainCreateInfoKHR SwapchainCreateInfo = {
         .sType = VK_STRUCTURE_TYPE_SWAPCHAIN_CREATE_INFO_KHR,
         .pNext = 0,
@@ -314,10 +1278,10 @@ int cuglCreateContext(const context_create_params *Params) {
         .imageColorSpace = C->DeviceInfo.InitialSurfaceFormat.colorSpace,
         .imageExtent = C->DeviceInfo.SurfaceCapabilities.currentExtent,
         .imageArrayLayers = 1,
-        .imageUsage = VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT | VK_IMAGE_USAGE_TRANSFER_DST_BIT,
+        .imageUsage = VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT | VK_IMAGE_USAGE_TRANSFER_SRC_BIT | VK_IMAGE_USAGE_TRANSFER_DST_BIT,
         .imageSharingMode = VK_SHARING_MODE_CONCURRENT,
-        .queueFamilyIndexCount = queue_COUNT,
-        .pQueueFamilyIndices = C->DeviceInfo.QueueFamilyIndices,
+        .queueFamilyIndexCount = ArrayCount(SwapchainQueueFamilyIndices),
+        .pQueueFamilyIndices = SwapchainQueueFamilyIndices,
         .preTransform = C->DeviceInfo.SurfaceCapabilities.currentTransform,
         .compositeAlpha = VK_COMPOSITE_ALPHA_OPAQUE_BIT_KHR,
         .presentMode = C->DeviceInfo.BestPresentMode,
@@ -397,6 +1361,20 @@ int cuglCreateContext(const context_create_params *Params) {
             VulkanCheckGoto(vkCreateSemaphore(C->Device, &SemaphoreCreateInfo, 0, C->Semaphores + I), label_Error);
             ++CreatedSemaphoreCount;
         }
+
+        if(C->DeviceInfo.HasAsyncCompute) {
+            VkSemaphoreTypeCreateInfoKHR SemaphoreTypeCreateInfo = {
+                .sType = VK_STRUCTURE_TYPE_SEMAPHORE_TYPE_CREATE_INFO_KHR,
+                .pNext = 0,
+                .semaphoreType = VK_SEMAPHORE_TYPE_TIMELINE_KHR,
+                .initialValue = 0,
+            };
+            SemaphoreCreateInfo.pNext = &SemaphoreTypeCreateInfo;
+            VulkanCheckGoto(vkCreateSemaphore(C->Device, &SemaphoreCreateInfo, 0, &C->ComputeTimeline), label_Error);
+            C->ComputeTimelineValue = 0;
+            C->TransferTimelineValue = 0;
+            C->UnwaitedComputeTimelineValue = 0;
+        }
     }
 
     C->Config = GetDefaultConfig(C->DeviceInfo.SurfaceCapabilities.currentExtent.width, C->DeviceInfo.SurfaceCapabilities.currentExtent.height);
@@ -412,6 +1390,7 @@ label_Error:
     for(u32 I = 0; I < CreatedSemaphoreCount; ++I) {
         vkDestroySemaphore(C->Device, C->Semaphores[I], 0);
     }
+    vkDestroySemaphore(C->Device, C->ComputeTimeline, 0);
     for(u32 I = 0; I < CreatedImageViewCount; ++I) {
         vkDestroyImageView(C->Device, C->SwapchainImageViews[I], 0);
     }
@@ -420,7 +1399,13 @@ label_Error:
     for(u32 I = 0; I < CreatedFenceCount; ++I) {
         vkDestroyFence(C->Device, C->Fences[I], 0);
     }
-    vkFreeCommandBuffers(C->Device, C->GraphicsCommandPool, command_buffer_COUNT, C->CommandBuffers);
+    if(C->ComputeCommandPool != VK_NULL_HANDLE) {
+        vkFreeCommandBuffers(C->Device, C->ComputeCommandPool, command_buffer_COUNT - command_buffer_COMPUTE, C->CommandBuffers + command_buffer_COMPUTE);
+        vkDestroyCommandPool(C->Device, C->ComputeCommandPool, 0);
+    }
+    vkFreeCommandBuffers(C->Device, C->TransferCommandPool, command_buffer_COMPUTE - command_buffer_TRANSFER, C->CommandBuffers + command_buffer_TRANSFER);
+    vkDestroyCommandPool(C->Device, C->TransferCommandPool, 0);
+    vkFreeCommandBuffers(C->Device, C->GraphicsCommandPool, command_buffer_TRANSFER, C->CommandBuffers);
     vkDestroyCommandPool(C->Device, C->GraphicsCommandPool, 0);
     vmaDestroyAllocator(C->Allocator);
     vkDestroySwapchainKHR(C->Device, C->Swapchain, 0);
@@ -494,9 +1479,27 @@ void glBindBuffer(GLenum target, GLuint buffer) {
     }
 
     C->BoundBuffers[TargetInfo.Index] = buffer;
+
+    // NOTE(blackedout): The element array buffer binding is part of the vertex array state
+    object *Vao = 0;
+    if(target == GL_ELEMENT_ARRAY_BUFFER && CheckObjectTypeGet(C, C->BoundVao, object_VERTEX_ARRAY, &Vao) == 0) {
+        Vao->VertexArray.ElementBuffer = buffer;
+    }
+}
+void glBindBufferBase(GLenum target, GLuint index, GLuint buffer) {
+    const char *Name = "glBindBufferBase";
+    context *C = 0;
+    CheckGL(AcquireContext(&C, Name), gl_error_ACQUIRE_CONTEXT);
+
+    BindBufferRange(C, target, index, buffer, 0, 0, 0, Name);
+}
+void glBindBufferRange(GLenum target, GLuint index, GLuint buffer, GLintptr offset, GLsizeiptr size) {
+    const char *Name = "glBindBufferRange";
+    context *C = 0;
+    CheckGL(AcquireContext(&C, Name), gl_error_ACQUIRE_CONTEXT);
+
+    BindBufferRange(C, target, index, buffer, offset, size, 1, Name);
 }
-void glBindBufferBase(GLenum target, GLuint index, GLuint buffer) {}
-void glBindBufferRange(GLenum target, GLuint index, GLuint buffer, GLintptr offset, GLsizeiptr size) {}
 void glBindBuffersBase(GLenum target, GLuint first, GLsizei count, const GLuint * buffers) {}
 void glBindBuffersRange(GLenum target, GLuint first, GLsizei count, const GLuint * buffers, const GLintptr * offsets, const GLsizeiptr * sizes) {}
 void glBindFragDataLocation(GLuint program, GLuint color, const GLchar * name) {}
@@ -529,7 +1532,13 @@ void glBindFramebuffer(GLenum target, GLuint framebuffer) {
         GenerateErrorMsg(C, GL_INVALID_ENUM, GL_DEBUG_SOURCE_APPLICATION, Msg);
     }
 }
-void glBindImageTexture(GLuint unit, GLuint texture, GLint level, GLboolean layered, GLint layer, GLenum access, GLenum format) {}
+void glBindImageTexture(GLuint unit, GLuint texture, GLint level, GLboolean layered, GLint layer, GLenum access, GLenum format) {
+    const char *Name = "glBindImageTexture";
+    context *C = 0;
+    CheckGL(AcquireContext(&C, Name), gl_error_ACQUIRE_CONTEXT);
+
+    BindImageTexture(C, unit, texture, level, layered, layer, access, format, Name);
+}
 void glBindImageTextures(GLuint first, GLsizei count, const GLuint * textures) {}
 void glBindProgramPipeline(GLuint pipeline) {}
 void glBindRenderbuffer(GLenum target, GLuint renderbuffer) {}
@@ -584,6 +1593,10 @@ void glBindVertexArray(GLuint array) {
     
     C->BoundVao = array;
 
+    buffer_target_info ElementTargetInfo = {0};
+    Assert(0 == GetBufferTargetInfo(GL_ELEMENT_ARRAY_BUFFER, &ElementTargetInfo));
+    C->BoundBuffers[ElementTargetInfo.Index] = array == 0 ? 0 : Object->VertexArray.ElementBuffer;
+
     if(array == 0) {
         ClearCurrentPipelineState(C, pipeline_state_VERTEX_INPUT_ATTRIBUTES);
         ClearCurrentPipelineState(C, pipeline_state_VERTEX_INPUT_BINDINGS);
@@ -591,7 +1604,7 @@ void glBindVertexArray(GLuint array) {
     }
 
     pipeline_state_info AttributeInfo = C->PipelineStateInfos[pipeline_state_VERTEX_INPUT_ATTRIBUTES];
-    pipeline_state_info BindingInfo = C->PipelineStateInfos[pipeline_state_VERTEX_INPUT_ATTRIBUTES];
+    pipeline_state_info BindingInfo = C->PipelineStateInfos[pipeline_state_VERTEX_INPUT_BINDINGS];
     if(Object->VertexArray.InputAttributes == 0) {
         // NOTE(blackedout): Specs say to create the state here, not in glGen
         Object->VertexArray.InputAttributes = calloc(AttributeInfo.InstanceCount, sizeof(*Object->VertexArray.InputAttributes));
@@ -600,7 +1613,7 @@ void glBindVertexArray(GLuint array) {
     }
 
     CurrentPipelineStateFromPtr(C, Object->VertexArray.InputAttributes, pipeline_state_VERTEX_INPUT_ATTRIBUTES);
-    CurrentPipelineStateFromPtr(C, Object->VertexArray.InputBindings, pipeline_state_VERTEX_INPUT_BINDINGS);
+    SetCurrentVertexInputBindings(C, Object);
 }
 void glBindVertexBuffer(GLuint bindingindex, GLuint buffer, GLintptr offset, GLsizei stride) {
     const char *Name = "glBindVertexBuffer";
@@ -711,12 +1724,6 @@ void glBufferData(GLenum target, GLsizeiptr size, const void * data, GLenum usag
         return;
     }
 
-    if(size < 0) {
-        const char *Msg = "An INVALID_VALUE error is generated if size is negative.";
-        GenerateErrorMsg(C, GL_INVALID_VALUE, GL_DEBUG_SOURCE_APPLICATION, Msg);
-        return;
-    }
-
     GLuint H = C->BoundBuffers[TargetInfo.Index];
     if(H == 0) {
         const char *Msg = "An INVALID_OPERATION error is generated by BufferData if zero is bound to target.";
@@ -731,115 +1738,31 @@ void glBufferData(GLenum target, GLsizeiptr size, const void * data, GLenum usag
         return;
     }
 
-#if 0
-    switch(usage) {
-    case GL_STATIC_DRAW: {
-
-    } break;  
-    default:
-        break;
-    }
-#endif
+    // NOTE(blackedout): The buffer may be bound to any other target later, see `ALL_BUFFER_TARGET_VULKAN_USAGE`
+    BufferData(C, Object, size, data, usage, ALL_BUFFER_TARGET_VULKAN_USAGE, Name);
+}
+void glBufferStorage(GLenum target, GLsizeiptr size, const void * data, GLbitfield flags) {
+    const char *Name = "glBufferStorage";
+    context *C = 0;
+    CheckGL(AcquireContext(&C, Name), gl_error_ACQUIRE_CONTEXT);
 
-    { // NOTE(blackedout): Device buffer is always created here
-        VkBufferCreateInfo BufferCreateInfo = {
-            .sType = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO,
-            .pNext = 0,
-            .flags = 0,
-            .size = size,
-            .usage = VK_BUFFER_USAGE_TRANSFER_DST_BIT | TargetInfo.VulkanUsage,
-            .sharingMode = VK_SHARING_MODE_EXCLUSIVE,
-            .queueFamilyIndexCount = 1,
-            .pQueueFamilyIndices = &C->DeviceInfo.QueueFamilyIndices[queue_GRAPHICS],
-        };
-        VmaAllocationCreateInfo AllocationCreateInfo = {
-            .flags = 0,
-            .usage = VMA_MEMORY_USAGE_AUTO,
-            .requiredFlags = VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT,
-            .preferredFlags = 0,
-            .memoryTypeBits = 0,
-            .pool = 0,
-            .pUserData = 0,
-            .priority = 0,
-        };
-        VkBuffer Buffer = VK_NULL_HANDLE;
-        VmaAllocation Allocation = VK_NULL_HANDLE;
-        VulkanCheckReturn(vmaCreateBuffer(C->Allocator, &BufferCreateInfo, &AllocationCreateInfo, &Object->Buffer.Buffer, &Object->Buffer.Allocation, 0));
+    object *Object = 0;
+    if(HandledCheckBufferTargetGet(C, target, &Object, Name)) {
+        return;
     }
+    BufferStorage(C, Object, size, data, flags, ALL_BUFFER_TARGET_VULKAN_USAGE, Name);
+}
+void glBufferSubData(GLenum target, GLintptr offset, GLsizeiptr size, const void * data) {
+    const char *Name = "glBufferSubData";
+    context *C = 0;
+    CheckGL(AcquireContext(&C, Name), gl_error_ACQUIRE_CONTEXT);
 
-    // NOTE(blackedout): Copy data only if provided by using a temporary staging buffer
-    if(data) {
-        VkBufferCreateInfo StagingBufferCreateInfo = {
-            .sType = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO,
-            .pNext = 0,
-            .flags = 0,
-            .size = size,
-            .usage = VK_BUFFER_USAGE_TRANSFER_SRC_BIT,
-            .sharingMode = VK_SHARING_MODE_EXCLUSIVE,
-            .queueFamilyIndexCount = 1,
-            .pQueueFamilyIndices = &C->DeviceInfo.QueueFamilyIndices[queue_GRAPHICS],
-        };
-        VmaAllocationCreateInfo StagingAllocationCreateInfo = {
-            .flags = VMA_ALLOCATION_CREATE_HOST_ACCESS_SEQUENTIAL_WRITE_BIT,
-            .usage = VMA_MEMORY_USAGE_AUTO,
-            .requiredFlags = VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT,
-            .preferredFlags = 0,
-            .memoryTypeBits = 0,
-            .pool = 0,
-            .pUserData = 0,
-            .priority = 0,
-        };
-
-        VkBuffer StagingBuffer = VK_NULL_HANDLE;
-        VmaAllocation StagingAllocation = VK_NULL_HANDLE;
-        VmaAllocationInfo StagingInfo = {0};
-        VulkanCheckReturn(vmaCreateBuffer(C->Allocator, &StagingBufferCreateInfo, &StagingAllocationCreateInfo, &StagingBuffer, &StagingAllocation, &StagingInfo));
-        void *MappedData = 0;
-        VulkanCheckReturn(vmaMapMemory(C->Allocator, StagingAllocation, &MappedData));
-        memcpy(MappedData, data, size);
-        vmaUnmapMemory(C->Allocator, StagingAllocation);
-
-        VkCommandBufferBeginInfo BeginInfo = {
-            .sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO,
-            .pNext = 0,
-            .flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT,
-            .pInheritanceInfo = 0,
-        };
-
-        VkCommandBuffer TransferCommandBuffer = C->CommandBuffers[command_buffer_TRANSFER];
-        VulkanCheckReturn(vkBeginCommandBuffer(TransferCommandBuffer, &BeginInfo));
-        VkBufferCopy Copy = {
-            .srcOffset = 0,
-            .dstOffset = 0,
-            .size = size,
-        };
-        vkCmdCopyBuffer(TransferCommandBuffer, StagingBuffer, Object->Buffer.Buffer, 1, &Copy);
-        VulkanCheckReturn(vkEndCommandBuffer(TransferCommandBuffer));
-
-        // TODO(blackedout): Should probably use a separate queue here
-        VkQueue TransferQueue = VK_NULL_HANDLE;
-        vkGetDeviceQueue(C->Device, C->DeviceInfo.QueueFamilyIndices[queue_GRAPHICS], 0, &TransferQueue);
-        VkSubmitInfo SubmitInfo = {
-            .sType = VK_STRUCTURE_TYPE_SUBMIT_INFO,
-            .pNext = 0,
-            .waitSemaphoreCount = 0,
-            .pWaitSemaphores = 0,
-            .pWaitDstStageMask = 0,
-            .commandBufferCount = 1,
-            .pCommandBuffers = &TransferCommandBuffer,
-            .signalSemaphoreCount = 0,
-            .pSignalSemaphores = 0,
-        };
-        
-        VulkanCheckReturn(vkQueueSubmit(TransferQueue, 1, &SubmitInfo, C->Fences[fence_TRANSFER]));
-        vkWaitForFences(C->Device, 1, C->Fences + fence_TRANSFER, VK_TRUE, UINT64_MAX);
-        vkResetCommandBuffer(TransferCommandBuffer, 0);
-
-        vmaDestroyBuffer(C->Allocator, StagingBuffer, StagingAllocation);
+    object *Object = 0;
+    if(HandledCheckBufferTargetGet(C, target, &Object, Name)) {
+        return;
     }
+    BufferSubData(C, Object, offset, size, data, Name);
 }
-void glBufferStorage(GLenum target, GLsizeiptr size, const void * data, GLbitfield flags) {}
-void glBufferSubData(GLenum target, GLintptr offset, GLsizeiptr size, const void * data) {}
 GLenum glCheckFramebufferStatus(GLenum target) {return GL_FRAMEBUFFER_COMPLETE;}
 GLenum glCheckNamedFramebufferStatus(GLuint framebuffer, GLenum target) {return GL_FRAMEBUFFER_COMPLETE;}
 void glClampColor(GLenum target, GLenum clamp) {}
@@ -847,41 +1770,7 @@ void glClear(GLbitfield mask) {
     const char *Name = "glClear";
     context *C = 0;
     CheckGL(AcquireContext(&C, Name), gl_error_ACQUIRE_CONTEXT);
-
-    object *Object;
-    GLuint H = C->BoundFramebuffers[framebuffer_WRITE];
-    if(CheckObjectTypeGet(C, H, object_FRAMEBUFFER, &Object)) {
-        GenerateErrorMsg(C, GL_INVALID_OPERATION, GL_DEBUG_SOURCE_APPLICATION, "glClear: TODO invalid framebuffer");
-        return;
-    }
-
-    // TODO(blackedout): Depth (which buffer to choose?)
-#if 0
-    VkImageAspectFlags AspectMask = VK_IMAGE_ASPECT_NONE;
-    if(mask & GL_DEPTH_BUFFER_BIT) {
-        AspectMask |= VK_IMAGE_ASPECT_DEPTH_BIT;
-    }
-    if(mask & GL_STENCIL_BUFFER_BIT) {
-        AspectMask |= VK_IMAGE_ASPECT_STENCIL_BIT;
-    }
-#endif
-    u32 SubpassIndex = 0;
-    CheckGL(PotentiallySaveSubpass(C, &SubpassIndex), gl_error_OUT_OF_MEMORY);
-    // TODO(blackedout): Make pipeline have a is fixed bit for each state type, such that a draw which doesn't use a program
-    // can leave the program state as unset, such that a following draw command is able to edit the program state
-    pipeline_state_type Types[] = {
-        pipeline_state_CLEAR_COLOR,
-        pipeline_state_VIEWPORT,
-        pipeline_state_SCISSOR,
-        pipeline_state_FRAMEBUFFER,
-        pipeline_state_DRAW_BUFFERS,
-    };
-    CheckGL(UseCurrentPipelineState(C, ArrayCount(Types), Types), gl_error_OUT_OF_MEMORY);
-
-    command Command = {0};
-    Command.Type = command_CLEAR;
-    Command.Clear.SubpassIndex = SubpassIndex;
-    PushCommand(C, Command);
+    Clear(C, mask, Name);
 }
 void glClearBufferData(GLenum target, GLenum internalformat, GLenum format, GLenum type, const void * data) {}
 void glClearBufferSubData(GLenum target, GLenum internalformat, GLintptr offset, GLsizeiptr size, GLenum format, GLenum type, const void * data) {}
@@ -932,7 +1821,26 @@ void glClearStencil(GLint s) {
 }
 void glClearTexImage(GLuint texture, GLint level, GLenum format, GLenum type, const void * data) {}
 void glClearTexSubImage(GLuint texture, GLint level, GLint xoffset, GLint yoffset, GLint zoffset, GLsizei width, GLsizei height, GLsizei depth, GLenum format, GLenum type, const void * data) {}
-GLenum glClientWaitSync(GLsync sync, GLbitfield flags, GLuint64 timeout) {return GL_CONDITION_SATISFIED;}
+GLenum glClientWaitSync(GLsync sync, GLbitfield flags, GLuint64 timeout) {
+    const char *Name = "glClientWaitSync";
+    context *C = 0;
+    CheckGL(AcquireContext(&C, Name), gl_error_ACQUIRE_CONTEXT, GL_WAIT_FAILED);
+
+    object *Object = 0;
+    if(HandledCheckSyncGet(C, sync, &Object, Name)) {
+        return GL_WAIT_FAILED;
+    }
+    CheckGL(flags & ~GL_SYNC_FLUSH_COMMANDS_BIT, gl_error_CLIENT_WAIT_SYNC_FLAGS, GL_WAIT_FAILED);
+    // NOTE(blackedout): The frame of the fence is only submitted by `cuglSwapBuffers` on this thread, so waiting for it here
+    // can't succeed. Each swap finishes its frame, which signals all fences inserted during it.
+    if(C->SwapCounter >= Object->Sync.Frame) {
+        return GL_ALREADY_SIGNALED;
+    }
+    if(timeout > 0 || (flags & GL_SYNC_FLUSH_COMMANDS_BIT)) {
+        GenerateOther(C, GL_DEBUG_SOURCE_API, "glClientWaitSync: the fence is in the current frame, which only runs in cuglSwapBuffers, the wait can never succeed before that");
+    }
+    return GL_TIMEOUT_EXPIRED;
+}
 void glClipControl(GLenum origin, GLenum depth) {}
 void glColorMask(GLboolean red, GLboolean green, GLboolean blue, GLboolean alpha) {}
 void glColorMaski(GLuint index, GLboolean r, GLboolean g, GLboolean b, GLboolean a) {}
@@ -976,9 +1884,29 @@ void glCompressedTexSubImage3D(GLenum target, GLint level, GLint xoffset, GLint
 void glCompressedTextureSubImage1D(GLuint texture, GLint level, GLint xoffset, GLsizei width, GLenum format, GLsizei imageSize, const void * data) {}
 void glCompressedTextureSubImage2D(GLuint texture, GLint level, GLint xoffset, GLint yoffset, GLsizei width, GLsizei height, GLenum format, GLsizei imageSize, const void * data) {}
 void glCompressedTextureSubImage3D(GLuint texture, GLint level, GLint xoffset, GLint yoffset, GLint zoffset, GLsizei width, GLsizei height, GLsizei depth, GLenum format, GLsizei imageSize, const void * data) {}
-void glCopyBufferSubData(GLenum readTarget, GLenum writeTarget, GLintptr readOffset, GLintptr writeOffset, GLsizeiptr size) {}
+void glCopyBufferSubData(GLenum readTarget, GLenum writeTarget, GLintptr readOffset, GLintptr writeOffset, GLsizeiptr size) {
+    const char *Name = "glCopyBufferSubData";
+    context *C = 0;
+    CheckGL(AcquireContext(&C, Name), gl_error_ACQUIRE_CONTEXT);
+
+    object *Read = 0, *Write = 0;
+    if(HandledCheckBufferTargetGet(C, readTarget, &Read, Name) || HandledCheckBufferTargetGet(C, writeTarget, &Write, Name)) {
+        return;
+    }
+    CopyBufferSubData(C, Read, Write, readOffset, writeOffset, size, Name);
+}
 void glCopyImageSubData(GLuint srcName, GLenum srcTarget, GLint srcLevel, GLint srcX, GLint srcY, GLint srcZ, GLuint dstName, GLenum dstTarget, GLint dstLevel, GLint dstX, GLint dstY, GLint dstZ, GLsizei srcWidth, GLsizei srcHeight, GLsizei srcDepth) {}
-void glCopyNamedBufferSubData(GLuint readBuffer, GLuint writeBuffer, GLintptr readOffset, GLintptr writeOffset, GLsizeiptr size) {}
+void glCopyNamedBufferSubData(GLuint readBuffer, GLuint writeBuffer, GLintptr readOffset, GLintptr writeOffset, GLsizeiptr size) {
+    const char *Name = "glCopyNamedBufferSubData";
+    context *C = 0;
+    CheckGL(AcquireContext(&C, Name), gl_error_ACQUIRE_CONTEXT);
+
+    object *Read = 0, *Write = 0;
+    if(HandledCheckBufferGet(C, readBuffer, &Read, Name) || HandledCheckBufferGet(C, writeBuffer, &Write, Name)) {
+        return;
+    }
+    CopyBufferSubData(C, Read, Write, readOffset, writeOffset, size, Name);
+}
 void glCopyTexImage1D(GLenum target, GLint level, GLenum internalformat, GLint x, GLint y, GLsizei width, GLint border) {}
 void glCopyTexImage2D(GLenum target, GLint level, GLenum internalformat, GLint x, GLint y, GLsizei width, GLsizei height, GLint border) {}
 void glCopyTexSubImage1D(GLenum target, GLint level, GLint xoffset, GLint x, GLint y, GLsizei width) {}
@@ -1138,8 +2066,8 @@ void glDeleteSync(GLsync sync) {
     const char *Name = "glDeleteSync";
     context *C = 0;
     CheckGL(AcquireContext(&C, Name), gl_error_ACQUIRE_CONTEXT);
-    // TODO(blackedout): This pointer cast is potentially dangerous
-    DeleteObjects(C, 1, (GLuint *)&sync, object_SYNC);
+    GLuint Handle = (GLuint)(uintptr_t)sync;
+    DeleteObjects(C, 1, &Handle, object_SYNC);
 }
 void glDeleteTextures(GLsizei n, const GLuint * textures) {
     const char *Name = "glDeleteTextures";
@@ -1256,54 +2184,48 @@ void glDisableVertexAttribArray(GLuint index) {
     SetVertexInputAttributeEnabled(C, Object, 1, index, 0, Name);
 }
 void glDisablei(GLenum target, GLuint index) {}
-void glDispatchCompute(GLuint num_groups_x, GLuint num_groups_y, GLuint num_groups_z) {}
-void glDispatchComputeIndirect(GLintptr indirect) {}
+void glDispatchCompute(GLuint num_groups_x, GLuint num_groups_y, GLuint num_groups_z) {
+    const char *Name = "glDispatchCompute";
+    context *C = 0;
+    CheckGL(AcquireContext(&C, Name), gl_error_ACQUIRE_CONTEXT);
+
+    DispatchCompute(C, num_groups_x, num_groups_y, num_groups_z, 0, 0, Name);
+}
+void glDispatchComputeIndirect(GLintptr indirect) {
+    const char *Name = "glDispatchComputeIndirect";
+    context *C = 0;
+    CheckGL(AcquireContext(&C, Name), gl_error_ACQUIRE_CONTEXT);
+
+    DispatchCompute(C, 0, 0, 0, 1, indirect, Name);
+}
 void glDrawArrays(GLenum mode, GLint first, GLsizei count) {
     const char *Name = "glDrawArrays";
     context *C = 0;
     CheckGL(AcquireContext(&C, Name), gl_error_ACQUIRE_CONTEXT);
 
-    CheckGL(first < 0, gl_error_DRAW_FIRST_NEGATIVE);
-    CheckGL(count < 0, gl_error_DRAW_COUNT_NEGATIVE);
+    DrawArrays(C, mode, first, count, 1, 0, Name);
+}
+void glDrawArraysIndirect(GLenum mode, const void * indirect) {
+    const char *Name = "glDrawArraysIndirect";
+    context *C = 0;
+    CheckGL(AcquireContext(&C, Name), gl_error_ACQUIRE_CONTEXT);
 
-    primitive_info PrimitiveInfo = {0};
-    CheckGL(GetPrimitiveInfo(mode, &PrimitiveInfo), gl_error_DRAW_MODE);
+    DrawIndirect(C, mode, GL_NONE, indirect, 1, 0, 0, 0, Name);
+}
+void glDrawArraysInstanced(GLenum mode, GLint first, GLsizei count, GLsizei instancecount) {
+    const char *Name = "glDrawArraysInstanced";
+    context *C = 0;
+    CheckGL(AcquireContext(&C, Name), gl_error_ACQUIRE_CONTEXT);
 
-    if(mode == GL_LINE_LOOP) {
-        // TODO(blackedout): Handle special case
-    }
+    DrawArrays(C, mode, first, count, instancecount, 0, Name);
+}
+void glDrawArraysInstancedBaseInstance(GLenum mode, GLint first, GLsizei count, GLsizei instancecount, GLuint baseinstance) {
+    const char *Name = "glDrawArraysInstancedBaseInstance";
+    context *C = 0;
+    CheckGL(AcquireContext(&C, Name), gl_error_ACQUIRE_CONTEXT);
 
-    pipeline_state_primitive_type *State = GetCurrentPipelineState(C, pipeline_state_PRIMITIVE_TYPE);
-    State->Type = mode;
-    
-    u32 SubpassIndex = 0;
-    CheckGL(PotentiallySaveSubpass(C, &SubpassIndex), gl_error_OUT_OF_MEMORY);
-    pipeline_state_type Types[] = {
-        pipeline_state_VIEWPORT,
-        pipeline_state_SCISSOR,
-        pipeline_state_FRAMEBUFFER,
-        pipeline_state_DRAW_BUFFERS,
-        pipeline_state_VERTEX_INPUT_ATTRIBUTES,
-        pipeline_state_VERTEX_INPUT_BINDINGS,
-        pipeline_state_PROGRAM,
-        pipeline_state_PRIMITIVE_TYPE,
-    };
-    CheckGL(UseCurrentPipelineState(C, ArrayCount(Types), Types), gl_error_OUT_OF_MEMORY);
-
-    command Command = {
-        .Type = command_DRAW,
-        .Draw = {
-            .VertexCount = count,
-            .VertexOffset = first,
-            .InstanceCount = 1,
-            .InstanceOffset = 0,
-        },
-    };
-    CheckGL(PushCommand(C, Command), gl_error_OUT_OF_MEMORY);
+    DrawArrays(C, mode, first, count, instancecount, baseinstance, Name);
 }
-void glDrawArraysIndirect(GLenum mode, const void * indirect) {}
-void glDrawArraysInstanced(GLenum mode, GLint first, GLsizei count, GLsizei instancecount) {}
-void glDrawArraysInstancedBaseInstance(GLenum mode, GLint first, GLsizei count, GLsizei instancecount, GLuint baseinstance) {}
 void glDrawBuffer(GLenum buf) {
     const char *Name = "glDrawBuffer";
     context *C = 0;
@@ -1348,15 +2270,72 @@ void glDrawBuffers(GLsizei n, const GLenum * bufs) {
 
     ReleaseContext(C, Name);
 }
-void glDrawElements(GLenum mode, GLsizei count, GLenum type, const void * indices) {}
-void glDrawElementsBaseVertex(GLenum mode, GLsizei count, GLenum type, const void * indices, GLint basevertex) {}
-void glDrawElementsIndirect(GLenum mode, GLenum type, const void * indirect) {}
-void glDrawElementsInstanced(GLenum mode, GLsizei count, GLenum type, const void * indices, GLsizei instancecount) {}
-void glDrawElementsInstancedBaseInstance(GLenum mode, GLsizei count, GLenum type, const void * indices, GLsizei instancecount, GLuint baseinstance) {}
-void glDrawElementsInstancedBaseVertex(GLenum mode, GLsizei count, GLenum type, const void * indices, GLsizei instancecount, GLint basevertex) {}
-void glDrawElementsInstancedBaseVertexBaseInstance(GLenum mode, GLsizei count, GLenum type, const void * indices, GLsizei instancecount, GLint basevertex, GLuint baseinstance) {}
-void glDrawRangeElements(GLenum mode, GLuint start, GLuint end, GLsizei count, GLenum type, const void * indices) {}
-void glDrawRangeElementsBaseVertex(GLenum mode, GLuint start, GLuint end, GLsizei count, GLenum type, const void * indices, GLint basevertex) {}
+void glDrawElements(GLenum mode, GLsizei count, GLenum type, const void * indices) {
+    const char *Name = "glDrawElements";
+    context *C = 0;
+    CheckGL(AcquireContext(&C, Name), gl_error_ACQUIRE_CONTEXT);
+
+    DrawElements(C, mode, count, type, indices, 1, 0, 0, Name);
+}
+void glDrawElementsBaseVertex(GLenum mode, GLsizei count, GLenum type, const void * indices, GLint basevertex) {
+    const char *Name = "glDrawElementsBaseVertex";
+    context *C = 0;
+    CheckGL(AcquireContext(&C, Name), gl_error_ACQUIRE_CONTEXT);
+
+    DrawElements(C, mode, count, type, indices, 1, basevertex, 0, Name);
+}
+void glDrawElementsIndirect(GLenum mode, GLenum type, const void * indirect) {
+    const char *Name = "glDrawElementsIndirect";
+    context *C = 0;
+    CheckGL(AcquireContext(&C, Name), gl_error_ACQUIRE_CONTEXT);
+
+    DrawIndirect(C, mode, type, indirect, 1, 0, 0, 0, Name);
+}
+void glDrawElementsInstanced(GLenum mode, GLsizei count, GLenum type, const void * indices, GLsizei instancecount) {
+    const char *Name = "glDrawElementsInstanced";
+    context *C = 0;
+    CheckGL(AcquireContext(&C, Name), gl_error_ACQUIRE_CONTEXT);
+
+    DrawElements(C, mode, count, type, indices, instancecount, 0, 0, Name);
+}
+void glDrawElementsInstancedBaseInstance(GLenum mode, GLsizei count, GLenum type, const void * indices, GLsizei instancecount, GLuint baseinstance) {
+    const char *Name = "glDrawElementsInstancedBaseInstance";
+    context *C = 0;
+    CheckGL(AcquireContext(&C, Name), gl_error_ACQUIRE_CONTEXT);
+
+    DrawElements(C, mode, count, type, indices, instancecount, 0, baseinstance, Name);
+}
+void glDrawElementsInstancedBaseVertex(GLenum mode, GLsizei count, GLenum type, const void * indices, GLsizei instancecount, GLint basevertex) {
+    const char *Name = "glDrawElementsInstancedBaseVertex";
+    context *C = 0;
+    CheckGL(AcquireContext(&C, Name), gl_error_ACQUIRE_CONTEXT);
+
+    DrawElements(C, mode, count, type, indices, instancecount, basevertex, 0, Name);
+}
+void glDrawElementsInstancedBaseVertexBaseInstance(GLenum mode, GLsizei count, GLenum type, const void * indices, GLsizei instancecount, GLint basevertex, GLuint baseinstance) {
+    const char *Name = "glDrawElementsInstancedBaseVertexBaseInstance";
+    context *C = 0;
+    CheckGL(AcquireContext(&C, Name), gl_error_ACQUIRE_CONTEXT);
+
+    DrawElements(C, mode, count, type, indices, instancecount, basevertex, baseinstance, Name);
+}
+void glDrawRangeElements(GLenum mode, GLuint start, GLuint end, GLsizei count, GLenum type, const void * indices) {
+    const char *Name = "glDrawRangeElements";
+    context *C = 0;
+    CheckGL(AcquireContext(&C, Name), gl_error_ACQUIRE_CONTEXT);
+    CheckGL(end < start, gl_error_DRAW_RANGE_ELEMENTS_RANGE);
+
+    // NOTE(blackedout): The range is only a hint
+    DrawElements(C, mode, count, type, indices, 1, 0, 0, Name);
+}
+void glDrawRangeElementsBaseVertex(GLenum mode, GLuint start, GLuint end, GLsizei count, GLenum type, const void * indices, GLint basevertex) {
+    const char *Name = "glDrawRangeElementsBaseVertex";
+    context *C = 0;
+    CheckGL(AcquireContext(&C, Name), gl_error_ACQUIRE_CONTEXT);
+    CheckGL(end < start, gl_error_DRAW_RANGE_ELEMENTS_RANGE);
+
+    DrawElements(C, mode, count, type, indices, 1, basevertex, 0, Name);
+}
 void glDrawTransformFeedback(GLenum mode, GLuint id) {}
 void glDrawTransformFeedbackInstanced(GLenum mode, GLuint id, GLsizei instancecount) {}
 void glDrawTransformFeedbackStream(GLenum mode, GLuint id, GLuint stream) {}
@@ -1374,28 +2353,68 @@ void glEnableVertexArrayAttrib(GLuint vaobj, GLuint index) {
     CheckGL(AcquireContext(&C, Name), gl_error_ACQUIRE_CONTEXT);
 
     object *Object = 0;
-    CheckGL(CheckObjectTypeGet(C, C->BoundVao, object_VERTEX_ARRAY, &Object), gl_error_XABLE_VERTEX_ARRAY_ATTRIB_INVALID);
-    SetVertexInputAttributeEnabled(C, Object, C->BoundVao == vaobj, index, 1, Name);
+    CheckGL(CheckObjectTypeGet(C, C->BoundVao, object_VERTEX_ARRAY, &Object), gl_error_XABLE_VERTEX_ARRAY_ATTRIB_INVALID);
+    SetVertexInputAttributeEnabled(C, Object, C->BoundVao == vaobj, index, 1, Name);
+}
+void glEnableVertexAttribArray(GLuint index) {
+    const char *Name = "glEnableVertexAttribArray";
+    context *C = 0;
+    CheckGL(AcquireContext(&C, Name), gl_error_ACQUIRE_CONTEXT);
+
+    object *Object = 0;
+    CheckGL(CheckObjectTypeGet(C, C->BoundVao, object_VERTEX_ARRAY, &Object), gl_error_XABLE_VERTEX_ATTRIB_ARRAY_NONE_BOUND);
+    SetVertexInputAttributeEnabled(C, Object, 1, index, 1, Name);
+}
+void glEnablei(GLenum target, GLuint index) {}
+void glEndConditionalRender(void) {}
+void glEndQuery(GLenum target) {}
+void glEndQueryIndexed(GLenum target, GLuint index) {}
+void glEndTransformFeedback(void) {}
+GLsync glFenceSync(GLenum condition, GLbitfield flags) {
+    const char *Name = "glFenceSync";
+    context *C = 0;
+    CheckGL(AcquireContext(&C, Name), gl_error_ACQUIRE_CONTEXT, 0);
+    CheckGL(condition != GL_SYNC_GPU_COMMANDS_COMPLETE, gl_error_FENCE_SYNC_CONDITION, 0);
+    CheckGL(flags != 0, gl_error_FENCE_SYNC_FLAGS, 0);
+
+    if(ArrayRequireRoom(&C->Objects, 1, sizeof(object), INITIAL_OBJECT_CAPACITY)) {
+        GenerateErrorMsg(C, GL_OUT_OF_MEMORY, GL_DEBUG_SOURCE_API, "glFenceSync: failed to allocate sync object");
+        return 0;
+    }
+    GLuint Handle = 0;
+    object *Object = 0;
+    GenObject(C, &Handle, &Object);
+    Object->Type = object_SYNC;
+    Object->Sync.Frame = C->SwapCounter + 1;
+    CreateObject(C, Object);
+
+    ReleaseContext(C, Name);
+    return (GLsync)(uintptr_t)Handle;
+}
+void glFinish(void) {}
+void glFlush(void) {}
+void glFlushMappedBufferRange(GLenum target, GLintptr offset, GLsizeiptr length) {
+    const char *Name = "glFlushMappedBufferRange";
+    context *C = 0;
+    CheckGL(AcquireContext(&C, Name), gl_error_ACQUIRE_CONTEXT);
+
+    object *Object = 0;
+    if(HandledCheckBufferTargetGet(C, target, &Object, Name)) {
+        return;
+    }
+    FlushMappedBufferRange(C, Object, offset, length, Name);
 }
-void glEnableVertexAttribArray(GLuint index) {
-    const char *Name = "glEnableVertexAttribArray";
+void glFlushMappedNamedBufferRange(GLuint buffer, GLintptr offset, GLsizeiptr length) {
+    const char *Name = "glFlushMappedNamedBufferRange";
     context *C = 0;
     CheckGL(AcquireContext(&C, Name), gl_error_ACQUIRE_CONTEXT);
 
     object *Object = 0;
-    CheckGL(CheckObjectTypeGet(C, C->BoundVao, object_VERTEX_ARRAY, &Object), gl_error_XABLE_VERTEX_ATTRIB_ARRAY_NONE_BOUND);
-    SetVertexInputAttributeEnabled(C, Object, 1, index, 1, Name);
+    if(HandledCheckBufferGet(C, buffer, &Object, Name)) {
+        return;
+    }
+    FlushMappedBufferRange(C, Object, offset, length, Name);
 }
-void glEnablei(GLenum target, GLuint index) {}
-void glEndConditionalRender(void) {}
-void glEndQuery(GLenum target) {}
-void glEndQueryIndexed(GLenum target, GLuint index) {}
-void glEndTransformFeedback(void) {}
-GLsync glFenceSync(GLenum condition, GLbitfield flags) {return (GLsync)1;}
-void glFinish(void) {}
-void glFlush(void) {}
-void glFlushMappedBufferRange(GLenum target, GLintptr offset, GLsizeiptr length) {}
-void glFlushMappedNamedBufferRange(GLuint buffer, GLintptr offset, GLsizeiptr length) {}
 void glFramebufferParameteri(GLenum target, GLenum pname, GLint param) {}
 void glFramebufferRenderbuffer(GLenum target, GLenum attachment, GLenum renderbuffertarget, GLuint renderbuffer) {}
 void glFramebufferTexture(GLenum target, GLenum attachment, GLuint texture, GLint level) {}
@@ -1464,8 +2483,33 @@ void glGetBooleani_v(GLenum target, GLuint index, GLboolean * data) {}
 void glGetBooleanv(GLenum pname, GLboolean * data) {}
 void glGetBufferParameteri64v(GLenum target, GLenum pname, GLint64 * params) {}
 void glGetBufferParameteriv(GLenum target, GLenum pname, GLint * params) {}
-void glGetBufferPointerv(GLenum target, GLenum pname, void ** params) {}
-void glGetBufferSubData(GLenum target, GLintptr offset, GLsizeiptr size, void * data) {}
+void glGetBufferPointerv(GLenum target, GLenum pname, void ** params) {
+    const char *Name = "glGetBufferPointerv";
+    context *C = 0;
+    CheckGL(AcquireContext(&C, Name), gl_error_ACQUIRE_CONTEXT);
+
+    if(pname != GL_BUFFER_MAP_POINTER) {
+        const char *Msg = "An INVALID_ENUM error is generated if pname is not BUFFER_MAP_POINTER.";
+        GenerateErrorMsg(C, GL_INVALID_ENUM, GL_DEBUG_SOURCE_APPLICATION, Msg);
+        return;
+    }
+    object *Object = 0;
+    if(HandledCheckBufferTargetGet(C, target, &Object, Name)) {
+        return;
+    }
+    *params = Object->Buffer.IsMapped ? Object->Buffer.Mapped + Object->Buffer.MapOffset : 0;
+}
+void glGetBufferSubData(GLenum target, GLintptr offset, GLsizeiptr size, void * data) {
+    const char *Name = "glGetBufferSubData";
+    context *C = 0;
+    CheckGL(AcquireContext(&C, Name), gl_error_ACQUIRE_CONTEXT);
+
+    object *Object = 0;
+    if(HandledCheckBufferTargetGet(C, target, &Object, Name)) {
+        return;
+    }
+    GetBufferSubData(C, Object, offset, size, data, Name);
+}
 void glGetCompressedTexImage(GLenum target, GLint level, void * img) {}
 void glGetCompressedTextureImage(GLuint texture, GLint level, GLsizei bufSize, void * pixels) {}
 void glGetCompressedTextureSubImage(GLuint texture, GLint level, GLint xoffset, GLint yoffset, GLint zoffset, GLsizei width, GLsizei height, GLsizei depth, GLsizei bufSize, void * pixels) {}
@@ -1496,6 +2540,8 @@ void glGetIntegerv(GLenum pname, GLint * data) {
 #define MakeCase(K, V) case (K): *data = (V); break
     switch(pname) {
     MakeCase(GL_MAX_TEXTURE_IMAGE_UNITS, TEXTURE_SLOT_COUNT);
+    MakeCase(GL_MAX_SHADER_STORAGE_BUFFER_BINDINGS, SHADER_STORAGE_BINDING_COUNT);
+    MakeCase(GL_MAX_IMAGE_UNITS, IMAGE_UNIT_COUNT);
     }
 #undef MakeCase
 }
@@ -1505,7 +2551,17 @@ void glGetMultisamplefv(GLenum pname, GLuint index, GLfloat * val) {}
 void glGetNamedBufferParameteri64v(GLuint buffer, GLenum pname, GLint64 * params) {}
 void glGetNamedBufferParameteriv(GLuint buffer, GLenum pname, GLint * params) {}
 void glGetNamedBufferPointerv(GLuint buffer, GLenum pname, void ** params) {}
-void glGetNamedBufferSubData(GLuint buffer, GLintptr offset, GLsizeiptr size, void * data) {}
+void glGetNamedBufferSubData(GLuint buffer, GLintptr offset, GLsizeiptr size, void * data) {
+    const char *Name = "glGetNamedBufferSubData";
+    context *C = 0;
+    CheckGL(AcquireContext(&C, Name), gl_error_ACQUIRE_CONTEXT);
+
+    object *Object = 0;
+    if(HandledCheckBufferGet(C, buffer, &Object, Name)) {
+        return;
+    }
+    GetBufferSubData(C, Object, offset, size, data, Name);
+}
 void glGetNamedFramebufferAttachmentParameteriv(GLuint framebuffer, GLenum attachment, GLenum pname, GLint * params) {}
 void glGetNamedFramebufferParameteriv(GLuint framebuffer, GLenum pname, GLint * param) {}
 void glGetNamedRenderbufferParameteriv(GLuint renderbuffer, GLenum pname, GLint * params) {}
@@ -1540,7 +2596,27 @@ void glGetProgramInfoLog(GLuint program, GLsizei bufSize, GLsizei * length, GLch
 void glGetProgramInterfaceiv(GLuint program, GLenum programInterface, GLenum pname, GLint * params) {}
 void glGetProgramPipelineInfoLog(GLuint pipeline, GLsizei bufSize, GLsizei * length, GLchar * infoLog) {}
 void glGetProgramPipelineiv(GLuint pipeline, GLenum pname, GLint * params) {}
-GLuint glGetProgramResourceIndex(GLuint program, GLenum programInterface, const GLchar * name) {return 1;}
+GLuint glGetProgramResourceIndex(GLuint program, GLenum programInterface, const GLchar * name) {
+    const char *Name = "glGetProgramResourceIndex";
+    context *C = 0;
+    CheckGL(AcquireContext(&C, Name), gl_error_ACQUIRE_CONTEXT, GL_INVALID_INDEX);
+
+    object *Object = 0;
+    if(HandledCheckProgramGet(C, program, &Object, Name)) {
+        return GL_INVALID_INDEX;
+    }
+    if(programInterface != GL_SHADER_STORAGE_BLOCK) {
+        GenerateOther(C, GL_DEBUG_SOURCE_API, "GetProgramResourceIndex: only SHADER_STORAGE_BLOCK resources are supported");
+        return GL_INVALID_INDEX;
+    }
+    glslang_program *GlslangProgram = &Object->Program.GlslangProgram;
+    for(u32 I = 0; I < GlslangProgram->StorageBlockCount; ++I) {
+        if(strcmp(GlslangProgram->StorageBlocks[I].Name, name) == 0) {
+            return I;
+        }
+    }
+    return GL_INVALID_INDEX;
+}
 GLint glGetProgramResourceLocation(GLuint program, GLenum programInterface, const GLchar * name) {return 1;}
 GLint glGetProgramResourceLocationIndex(GLuint program, GLenum programInterface, const GLchar * name) {return 1;}
 void glGetProgramResourceName(GLuint program, GLenum programInterface, GLuint index, GLsizei bufSize, GLsizei * length, GLchar * name) {}
@@ -1668,7 +2744,31 @@ const GLubyte * glGetString(GLenum name) { return 0; }
 const GLubyte * glGetStringi(GLenum name, GLuint index) { return 0; }
 GLuint glGetSubroutineIndex(GLuint program, GLenum shadertype, const GLchar * name) {return 1;}
 GLint glGetSubroutineUniformLocation(GLuint program, GLenum shadertype, const GLchar * name) {return 1;}
-void glGetSynciv(GLsync sync, GLenum pname, GLsizei count, GLsizei * length, GLint * values) {}
+void glGetSynciv(GLsync sync, GLenum pname, GLsizei count, GLsizei * length, GLint * values) {
+    const char *Name = "glGetSynciv";
+    context *C = 0;
+    CheckGL(AcquireContext(&C, Name), gl_error_ACQUIRE_CONTEXT);
+
+    object *Object = 0;
+    if(HandledCheckSyncGet(C, sync, &Object, Name)) {
+        return;
+    }
+    CheckGL(count < 0, gl_error_GET_SYNCIV_COUNT);
+    GLint Value = 0;
+    switch(pname) {
+    case GL_OBJECT_TYPE: Value = GL_SYNC_FENCE; break;
+    case GL_SYNC_STATUS: Value = C->SwapCounter >= Object->Sync.Frame ? GL_SIGNALED : GL_UNSIGNALED; break;
+    case GL_SYNC_CONDITION: Value = GL_SYNC_GPU_COMMANDS_COMPLETE; break;
+    case GL_SYNC_FLAGS: Value = 0; break;
+    default: CheckGL(1, gl_error_GET_SYNCIV_PNAME);
+    }
+    if(count > 0) {
+        values[0] = Value;
+    }
+    if(length) {
+        *length = count > 0 ? 1 : 0;
+    }
+}
 void glGetTexImage(GLenum target, GLint level, GLenum format, GLenum type, void * pixels) {}
 void glGetTexLevelParameterfv(GLenum target, GLint level, GLenum pname, GLfloat * params) {}
 void glGetTexLevelParameteriv(GLenum target, GLint level, GLenum pname, GLint * params) {}
@@ -1726,12 +2826,70 @@ void glGetnUniformfv(GLuint program, GLint location, GLsizei bufSize, GLfloat *
 void glGetnUniformiv(GLuint program, GLint location, GLsizei bufSize, GLint * params) {}
 void glGetnUniformuiv(GLuint program, GLint location, GLsizei bufSize, GLuint * params) {}
 void glHint(GLenum target, GLenum mode) {}
-void glInvalidateBufferData(GLuint buffer) {}
-void glInvalidateBufferSubData(GLuint buffer, GLintptr offset, GLsizeiptr length) {}
-void glInvalidateFramebuffer(GLenum target, GLsizei numAttachments, const GLenum * attachments) {}
-void glInvalidateNamedFramebufferData(GLuint framebuffer, GLsizei numAttachments, const GLenum * attachments) {}
-void glInvalidateNamedFramebufferSubData(GLuint framebuffer, GLsizei numAttachments, const GLenum * attachments, GLint x, GLint y, GLsizei width, GLsizei height) {}
-void glInvalidateSubFramebuffer(GLenum target, GLsizei numAttachments, const GLenum * attachments, GLint x, GLint y, GLsizei width, GLsizei height) {}
+void glInvalidateBufferData(GLuint buffer) {
+    const char *Name = "glInvalidateBufferData";
+    context *C = 0;
+    CheckGL(AcquireContext(&C, Name), gl_error_ACQUIRE_CONTEXT);
+
+    object *Object = 0;
+    if(HandledCheckBufferGet(C, buffer, &Object, Name)) {
+        return;
+    }
+    InvalidateBufferSubData(C, Object, 0, Object->Buffer.ByteCount, Name);
+}
+void glInvalidateBufferSubData(GLuint buffer, GLintptr offset, GLsizeiptr length) {
+    const char *Name = "glInvalidateBufferSubData";
+    context *C = 0;
+    CheckGL(AcquireContext(&C, Name), gl_error_ACQUIRE_CONTEXT);
+
+    object *Object = 0;
+    if(HandledCheckBufferGet(C, buffer, &Object, Name)) {
+        return;
+    }
+    InvalidateBufferSubData(C, Object, offset, length, Name);
+}
+void glInvalidateFramebuffer(GLenum target, GLsizei numAttachments, const GLenum * attachments) {
+    const char *Name = "glInvalidateFramebuffer";
+    context *C = 0;
+    CheckGL(AcquireContext(&C, Name), gl_error_ACQUIRE_CONTEXT);
+
+    GLuint Fbo = 0;
+    switch(target) {
+    case GL_FRAMEBUFFER:
+    case GL_DRAW_FRAMEBUFFER: Fbo = C->BoundDrawFbo; break;
+    case GL_READ_FRAMEBUFFER: Fbo = C->BoundReadFbo; break;
+    default: CheckGL(1, gl_error_INVALIDATE_FRAMEBUFFER_TARGET);
+    }
+    InvalidateFramebuffer(C, Fbo, numAttachments, attachments, 0, 0, INT32_MAX, INT32_MAX, Name);
+}
+void glInvalidateNamedFramebufferData(GLuint framebuffer, GLsizei numAttachments, const GLenum * attachments) {
+    const char *Name = "glInvalidateNamedFramebufferData";
+    context *C = 0;
+    CheckGL(AcquireContext(&C, Name), gl_error_ACQUIRE_CONTEXT);
+    CheckGL(CheckObjectType(C, framebuffer, object_FRAMEBUFFER), gl_error_INVALIDATE_FRAMEBUFFER_NAME);
+    InvalidateFramebuffer(C, framebuffer, numAttachments, attachments, 0, 0, INT32_MAX, INT32_MAX, Name);
+}
+void glInvalidateNamedFramebufferSubData(GLuint framebuffer, GLsizei numAttachments, const GLenum * attachments, GLint x, GLint y, GLsizei width, GLsizei height) {
+    const char *Name = "glInvalidateNamedFramebufferSubData";
+    context *C = 0;
+    CheckGL(AcquireContext(&C, Name), gl_error_ACQUIRE_CONTEXT);
+    CheckGL(CheckObjectType(C, framebuffer, object_FRAMEBUFFER), gl_error_INVALIDATE_FRAMEBUFFER_NAME);
+    InvalidateFramebuffer(C, framebuffer, numAttachments, attachments, x, y, width, height, Name);
+}
+void glInvalidateSubFramebuffer(GLenum target, GLsizei numAttachments, const GLenum * attachments, GLint x, GLint y, GLsizei width, GLsizei height) {
+    const char *Name = "glInvalidateSubFramebuffer";
+    context *C = 0;
+    CheckGL(AcquireContext(&C, Name), gl_error_ACQUIRE_CONTEXT);
+
+    GLuint Fbo = 0;
+    switch(target) {
+    case GL_FRAMEBUFFER:
+    case GL_DRAW_FRAMEBUFFER: Fbo = C->BoundDrawFbo; break;
+    case GL_READ_FRAMEBUFFER: Fbo = C->BoundReadFbo; break;
+    default: CheckGL(1, gl_error_INVALIDATE_FRAMEBUFFER_TARGET);
+    }
+    InvalidateFramebuffer(C, Fbo, numAttachments, attachments, x, y, width, height, Name);
+}
 void glInvalidateTexImage(GLuint texture, GLint level) {}
 void glInvalidateTexSubImage(GLuint texture, GLint level, GLint xoffset, GLint yoffset, GLint zoffset, GLsizei width, GLsizei height, GLsizei depth) {}
 GLboolean glIsBuffer(GLuint buffer) {
@@ -1761,8 +2919,7 @@ GLboolean glIsShader(GLuint shader) {
     return NoContextIsObjectType(shader, object_SHADER, "glIsShader");
 }
 GLboolean glIsSync(GLsync sync) {
-    // TODO(blackedout): Cast
-    return NoContextIsObjectType((GLuint)sync, object_SYNC, "glIsSync");
+    return NoContextIsObjectType((GLuint)(uintptr_t)sync, object_SYNC, "glIsSync");
 }
 GLboolean glIsTexture(GLuint texture) {
     return NoContextIsObjectType(texture, object_TEXTURE, "glIsTexture");
@@ -1802,6 +2959,18 @@ void glLinkProgram(GLuint program) {
         return;
     }
 
+    // NOTE(blackedout): Storage blocks are bound per program, all of them count against the per stage limit
+    u32 StorageBlockCount = GlslangProgram->StorageBlockCount;
+    int AreStorageBlocksSupported = StorageBlockCount <= SHADER_STORAGE_BINDING_COUNT && StorageBlockCount <= C->DeviceInfo.Properties.limits.maxPerStageDescriptorStorageBuffers;
+    for(u32 I = 0; I < StorageBlockCount && AreStorageBlocksSupported; ++I) {
+        AreStorageBlocksSupported = GlslangProgram->StorageBlocks[I].Binding < SHADER_STORAGE_BINDING_COUNT;
+    }
+    if(AreStorageBlocksSupported == 0) {
+        GenerateOther(C, GL_DEBUG_SOURCE_SHADER_COMPILER, "LinkProgram: the program uses more shader storage blocks or higher binding points than MAX_SHADER_STORAGE_BUFFER_BINDINGS allows");
+        Object->Program.LinkStatus = GL_FALSE;
+        return;
+    }
+
     Object->Program.LinkStatus = GL_TRUE;
 
     for(u32 I = 0; I < Object->Program.AttachedShaderCount; ++I) {
@@ -1830,7 +2999,7 @@ void glLinkProgram(GLuint program) {
             .binding = 0,
             .descriptorType = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC,
             .descriptorCount = 1,
-            .stageFlags = VK_SHADER_STAGE_ALL_GRAPHICS,
+            .stageFlags = VK_SHADER_STAGE_ALL_GRAPHICS | VK_SHADER_STAGE_COMPUTE_BIT,
             .pImmutableSamplers = 0,
         }
     };
@@ -1870,31 +3039,205 @@ void glLinkProgram(GLuint program) {
     };
 
     VulkanCheckReturn(vkAllocateDescriptorSets(C->Device, &DescriptorSetAllocateInfo, &Object->Program.UniformDescriptorSet));
+
+    // NOTE(blackedout): Storage block I is at binding I of set 1, see `MakeVulkanCompatible`
+    vkDestroyDescriptorSetLayout(C->Device, Object->Program.StorageDescriptorSetLayout, 0);
+    Object->Program.StorageDescriptorSetLayout = VK_NULL_HANDLE;
+    Object->Program.StorageBufferInfos.Count = 0;
+    Object->Program.StorageDescriptorSetFrame = 0;
+    if(StorageBlockCount) {
+        VkDescriptorSetLayoutBinding StorageLayoutBindings[SHADER_STORAGE_BINDING_COUNT];
+        for(u32 I = 0; I < StorageBlockCount; ++I) {
+            VkDescriptorSetLayoutBinding Binding = {
+                .binding = I,
+                .descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER,
+                .descriptorCount = 1,
+                .stageFlags = VK_SHADER_STAGE_ALL,
+                .pImmutableSamplers = 0,
+            };
+            StorageLayoutBindings[I] = Binding;
+        }
+        VkDescriptorSetLayoutCreateInfo StorageSetLayoutCreateInfo = {
+            .sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO,
+            .pNext = 0,
+            .flags = 0,
+            .bindingCount = StorageBlockCount,
+            .pBindings = StorageLayoutBindings,
+        };
+        VulkanCheckReturn(vkCreateDescriptorSetLayout(C->Device, &StorageSetLayoutCreateInfo, 0, &Object->Program.StorageDescriptorSetLayout));
+    }
+
+    vkDestroyPipeline(C->Device, Object->Program.ComputePipeline, 0);
+    vkDestroyPipelineLayout(C->Device, Object->Program.ComputeLayout, 0);
+    Object->Program.ComputePipeline = VK_NULL_HANDLE;
+    Object->Program.ComputeLayout = VK_NULL_HANDLE;
+    for(u32 I = 0; I < Object->Program.AttachedShaderCount; ++I) {
+        object *ObjectS = Object->Program.AttachedShaders[I];
+        if(ObjectS->Shader.Type == GL_COMPUTE_SHADER && CreateComputePipeline(C, Object, ObjectS->Shader.VulkanModule)) {
+            Object->Program.LinkStatus = GL_FALSE;
+            return;
+        }
+    }
+
+    // NOTE(blackedout): Programs without uniforms still bind a (one byte) uniform buffer
     u64 MinAlignment = C->DeviceInfo.Properties.limits.minUniformBufferOffsetAlignment;
-    Object->Program.AlignedUniformByteCount = MinAlignment*((GlslangProgram->UniformByteCount + MinAlignment - 1)/MinAlignment);
+    Object->Program.AlignedUniformByteCount = MinAlignment*((Max(1, GlslangProgram->UniformByteCount) + MinAlignment - 1)/MinAlignment);
     CheckGL(ArrayRequireRoom(&Object->Program.UniformBuffer, 1, Object->Program.AlignedUniformByteCount, 1), gl_error_OUT_OF_MEMORY);
     Object->Program.UniformBuffer.Count = 1;
     memset(Object->Program.UniformBuffer.Data, 0, Object->Program.AlignedUniformByteCount);
+    Object->Program.LatestUniformsUsed = 0;
+    Object->Program.LatestUniformsResolved = 0;
+    if(Object->Program.UniformSnapshotTable.Capacity) {
+        ArrayClear(&Object->Program.UniformSnapshotTable, sizeof(uniform_snapshot_entry));
+    }
     printf("raw %u, aligned %u, %f wasted\n", Object->Program.GlslangProgram.UniformByteCount, Object->Program.AlignedUniformByteCount, 1 - (Object->Program.GlslangProgram.UniformByteCount/(double)Object->Program.AlignedUniformByteCount));
 }
 void glLogicOp(GLenum opcode) {}
-void * glMapBuffer(GLenum target, GLenum access) {return 0;}
-void * glMapBufferRange(GLenum target, GLintptr offset, GLsizeiptr length, GLbitfield access) {return 0;}
-void * glMapNamedBuffer(GLuint buffer, GLenum access) {return 0;}
-void * glMapNamedBufferRange(GLuint buffer, GLintptr offset, GLsizeiptr length, GLbitfield access) {return 0;}
-void glMemoryBarrier(GLbitfield barriers) {}
-void glMemoryBarrierByRegion(GLbitfield barriers) {}
+void * glMapBuffer(GLenum target, GLenum access) {
+    const char *Name = "glMapBuffer";
+    context *C = 0;
+    CheckGL(AcquireContext(&C, Name), gl_error_ACQUIRE_CONTEXT, 0);
+
+    object *Object = 0;
+    if(HandledCheckBufferTargetGet(C, target, &Object, Name)) {
+        return 0;
+    }
+    GLbitfield Access = 0;
+    CheckGL(GetMapBufferAccess(access, &Access), gl_error_MAP_BUFFER_ACCESS, 0);
+    return MapBufferRange(C, Object, 0, Object->Buffer.ByteCount, Access, Name);
+}
+void * glMapBufferRange(GLenum target, GLintptr offset, GLsizeiptr length, GLbitfield access) {
+    const char *Name = "glMapBufferRange";
+    context *C = 0;
+    CheckGL(AcquireContext(&C, Name), gl_error_ACQUIRE_CONTEXT, 0);
+
+    object *Object = 0;
+    if(HandledCheckBufferTargetGet(C, target, &Object, Name)) {
+        return 0;
+    }
+    return MapBufferRange(C, Object, offset, length, access, Name);
+}
+void * glMapNamedBuffer(GLuint buffer, GLenum access) {
+    const char *Name = "glMapNamedBuffer";
+    context *C = 0;
+    CheckGL(AcquireContext(&C, Name), gl_error_ACQUIRE_CONTEXT, 0);
+
+    object *Object = 0;
+    if(HandledCheckBufferGet(C, buffer, &Object, Name)) {
+        return 0;
+    }
+    GLbitfield Access = 0;
+    CheckGL(GetMapBufferAccess(access, &Access), gl_error_MAP_BUFFER_ACCESS, 0);
+    return MapBufferRange(C, Object, 0, Object->Buffer.ByteCount, Access, Name);
+}
+void * glMapNamedBufferRange(GLuint buffer, GLintptr offset, GLsizeiptr length, GLbitfield access) {
+    const char *Name = "glMapNamedBufferRange";
+    context *C = 0;
+    CheckGL(AcquireContext(&C, Name), gl_error_ACQUIRE_CONTEXT, 0);
+
+    object *Object = 0;
+    if(HandledCheckBufferGet(C, buffer, &Object, Name)) {
+        return 0;
+    }
+    return MapBufferRange(C, Object, offset, length, access, Name);
+}
+void glMemoryBarrier(GLbitfield barriers) {
+    const char *Name = "glMemoryBarrier";
+    context *C = 0;
+    CheckGL(AcquireContext(&C, Name), gl_error_ACQUIRE_CONTEXT);
+
+    PushMemoryBarrier(C, barriers, 0, Name);
+}
+void glMemoryBarrierByRegion(GLbitfield barriers) {
+    const char *Name = "glMemoryBarrierByRegion";
+    context *C = 0;
+    CheckGL(AcquireContext(&C, Name), gl_error_ACQUIRE_CONTEXT);
+
+    PushMemoryBarrier(C, barriers, 1, Name);
+}
 void glMinSampleShading(GLfloat value) {}
-void glMultiDrawArrays(GLenum mode, const GLint * first, const GLsizei * count, GLsizei drawcount) {}
-void glMultiDrawArraysIndirect(GLenum mode, const void * indirect, GLsizei drawcount, GLsizei stride) {}
-void glMultiDrawArraysIndirectCount(GLenum mode, const void * indirect, GLintptr drawcount, GLsizei maxdrawcount, GLsizei stride) {}
-void glMultiDrawElements(GLenum mode, const GLsizei * count, GLenum type, const void *const* indices, GLsizei drawcount) {}
-void glMultiDrawElementsBaseVertex(GLenum mode, const GLsizei * count, GLenum type, const void *const* indices, GLsizei drawcount, const GLint * basevertex) {}
-void glMultiDrawElementsIndirect(GLenum mode, GLenum type, const void * indirect, GLsizei drawcount, GLsizei stride) {}
-void glMultiDrawElementsIndirectCount(GLenum mode, GLenum type, const void * indirect, GLintptr drawcount, GLsizei maxdrawcount, GLsizei stride) {}
-void glNamedBufferData(GLuint buffer, GLsizeiptr size, const void * data, GLenum usage) {}
-void glNamedBufferStorage(GLuint buffer, GLsizeiptr size, const void * data, GLbitfield flags) {}
-void glNamedBufferSubData(GLuint buffer, GLintptr offset, GLsizeiptr size, const void * data) {}
+void glMultiDrawArrays(GLenum mode, const GLint * first, const GLsizei * count, GLsizei drawcount) {
+    const char *Name = "glMultiDrawArrays";
+    context *C = 0;
+    CheckGL(AcquireContext(&C, Name), gl_error_ACQUIRE_CONTEXT);
+
+    MultiDraw(C, mode, GL_NONE, first, count, 0, 0, drawcount, Name);
+}
+void glMultiDrawArraysIndirect(GLenum mode, const void * indirect, GLsizei drawcount, GLsizei stride) {
+    const char *Name = "glMultiDrawArraysIndirect";
+    context *C = 0;
+    CheckGL(AcquireContext(&C, Name), gl_error_ACQUIRE_CONTEXT);
+
+    DrawIndirect(C, mode, GL_NONE, indirect, drawcount, 0, 0, stride, Name);
+}
+void glMultiDrawArraysIndirectCount(GLenum mode, const void * indirect, GLintptr drawcount, GLsizei maxdrawcount, GLsizei stride) {
+    const char *Name = "glMultiDrawArraysIndirectCount";
+    context *C = 0;
+    CheckGL(AcquireContext(&C, Name), gl_error_ACQUIRE_CONTEXT);
+
+    DrawIndirect(C, mode, GL_NONE, indirect, maxdrawcount, 1, drawcount, stride, Name);
+}
+void glMultiDrawElements(GLenum mode, const GLsizei * count, GLenum type, const void *const* indices, GLsizei drawcount) {
+    const char *Name = "glMultiDrawElements";
+    context *C = 0;
+    CheckGL(AcquireContext(&C, Name), gl_error_ACQUIRE_CONTEXT);
+
+    MultiDraw(C, mode, type, 0, count, indices, 0, drawcount, Name);
+}
+void glMultiDrawElementsBaseVertex(GLenum mode, const GLsizei * count, GLenum type, const void *const* indices, GLsizei drawcount, const GLint * basevertex) {
+    const char *Name = "glMultiDrawElementsBaseVertex";
+    context *C = 0;
+    CheckGL(AcquireContext(&C, Name), gl_error_ACQUIRE_CONTEXT);
+
+    MultiDraw(C, mode, type, 0, count, indices, basevertex, drawcount, Name);
+}
+void glMultiDrawElementsIndirect(GLenum mode, GLenum type, const void * indirect, GLsizei drawcount, GLsizei stride) {
+    const char *Name = "glMultiDrawElementsIndirect";
+    context *C = 0;
+    CheckGL(AcquireContext(&C, Name), gl_error_ACQUIRE_CONTEXT);
+
+    DrawIndirect(C, mode, type, indirect, drawcount, 0, 0, stride, Name);
+}
+void glMultiDrawElementsIndirectCount(GLenum mode, GLenum type, const void * indirect, GLintptr drawcount, GLsizei maxdrawcount, GLsizei stride) {
+    const char *Name = "glMultiDrawElementsIndirectCount";
+    context *C = 0;
+    CheckGL(AcquireContext(&C, Name), gl_error_ACQUIRE_CONTEXT);
+
+    DrawIndirect(C, mode, type, indirect, maxdrawcount, 1, drawcount, stride, Name);
+}
+void glNamedBufferData(GLuint buffer, GLsizeiptr size, const void * data, GLenum usage) {
+    const char *Name = "glNamedBufferData";
+    context *C = 0;
+    CheckGL(AcquireContext(&C, Name), gl_error_ACQUIRE_CONTEXT);
+
+    object *Object = 0;
+    if(HandledCheckBufferGet(C, buffer, &Object, Name)) {
+        return;
+    }
+    BufferData(C, Object, size, data, usage, ALL_BUFFER_TARGET_VULKAN_USAGE, Name);
+}
+void glNamedBufferStorage(GLuint buffer, GLsizeiptr size, const void * data, GLbitfield flags) {
+    const char *Name = "glNamedBufferStorage";
+    context *C = 0;
+    CheckGL(AcquireContext(&C, Name), gl_error_ACQUIRE_CONTEXT);
+
+    object *Object = 0;
+    if(HandledCheckBufferGet(C, buffer, &Object, Name)) {
+        return;
+    }
+    BufferStorage(C, Object, size, data, flags, ALL_BUFFER_TARGET_VULKAN_USAGE, Name);
+}
+void glNamedBufferSubData(GLuint buffer, GLintptr offset, GLsizeiptr size, const void * data) {
+    const char *Name = "glNamedBufferSubData";
+    context *C = 0;
+    CheckGL(AcquireContext(&C, Name), gl_error_ACQUIRE_CONTEXT);
+
+    object *Object = 0;
+    if(HandledCheckBufferGet(C, buffer, &Object, Name)) {
+        return;
+    }
+    BufferSubData(C, Object, offset, size, data, Name);
+}
 void glNamedFramebufferDrawBuffer(GLuint framebuffer, GLenum buf) {}
 void glNamedFramebufferDrawBuffers(GLuint framebuffer, GLsizei n, const GLenum * bufs) {}
 void glNamedFramebufferParameteri(GLuint framebuffer, GLenum pname, GLint param) {}
@@ -2005,7 +3348,12 @@ void glProvokingVertex(GLenum mode) {}
 void glPushDebugGroup(GLenum source, GLuint id, GLsizei length, const GLchar * message) {}
 void glQueryCounter(GLuint id, GLenum target) {}
 void glReadBuffer(GLenum src) {}
-void glReadPixels(GLint x, GLint y, GLsizei width, GLsizei height, GLenum format, GLenum type, void * pixels) {}
+void glReadPixels(GLint x, GLint y, GLsizei width, GLsizei height, GLenum format, GLenum type, void * pixels) {
+    const char *Name = "glReadPixels";
+    context *C = 0;
+    CheckGL(AcquireContext(&C, Name), gl_error_ACQUIRE_CONTEXT);
+    ReadPixels(C, x, y, width, height, format, type, pixels, Name);
+}
 void glReadnPixels(GLint x, GLint y, GLsizei width, GLsizei height, GLenum format, GLenum type, GLsizei bufSize, void * data) {}
 void glReleaseShaderCompiler(void) {}
 void glRenderbufferStorage(GLenum target, GLenum internalformat, GLsizei width, GLsizei height) {}
@@ -2108,7 +3456,19 @@ void glShaderSource(GLuint shader, GLsizei count, const GLchar *const* string, c
         Source += length[I];
     }
 }
-void glShaderStorageBlockBinding(GLuint program, GLuint storageBlockIndex, GLuint storageBlockBinding) {}
+void glShaderStorageBlockBinding(GLuint program, GLuint storageBlockIndex, GLuint storageBlockBinding) {
+    const char *Name = "glShaderStorageBlockBinding";
+    context *C = 0;
+    CheckGL(AcquireContext(&C, Name), gl_error_ACQUIRE_CONTEXT);
+
+    object *Object = 0;
+    if(HandledCheckProgramGet(C, program, &Object, Name)) {
+        return;
+    }
+    glslang_program *GlslangProgram = &Object->Program.GlslangProgram;
+    CheckGL(storageBlockIndex >= GlslangProgram->StorageBlockCount || storageBlockBinding >= SHADER_STORAGE_BINDING_COUNT, gl_error_SHADER_STORAGE_BLOCK_BINDING_VALUE);
+    GlslangProgram->StorageBlocks[storageBlockIndex].Binding = storageBlockBinding;
+}
 void glSpecializeShader(GLuint shader, const GLchar * pEntryPoint, GLuint numSpecializationConstants, const GLuint * pConstantIndex, const GLuint * pConstantValue) {}
 void glStencilFunc(GLenum func, GLint ref, GLuint mask) {}
 void glStencilFuncSeparate(GLenum face, GLenum func, GLint ref, GLuint mask) {}
@@ -2320,27 +3680,83 @@ void glUniform4uiv(GLint location, GLsizei count, const GLuint * value) {
     NoContextSetUniformData(location, value, 4, count, GL_UNSIGNED_INT, __func__);
 }
 void glUniformBlockBinding(GLuint program, GLuint uniformBlockIndex, GLuint uniformBlockBinding) {}
-void glUniformMatrix2dv(GLint location, GLsizei count, GLboolean transpose, const GLdouble * value) {}
-void glUniformMatrix2fv(GLint location, GLsizei count, GLboolean transpose, const GLfloat * value) {}
-void glUniformMatrix2x3dv(GLint location, GLsizei count, GLboolean transpose, const GLdouble * value) {}
-void glUniformMatrix2x3fv(GLint location, GLsizei count, GLboolean transpose, const GLfloat * value) {}
-void glUniformMatrix2x4dv(GLint location, GLsizei count, GLboolean transpose, const GLdouble * value) {}
-void glUniformMatrix2x4fv(GLint location, GLsizei count, GLboolean transpose, const GLfloat * value) {}
-void glUniformMatrix3dv(GLint location, GLsizei count, GLboolean transpose, const GLdouble * value) {}
-void glUniformMatrix3fv(GLint location, GLsizei count, GLboolean transpose, const GLfloat * value) {}
-void glUniformMatrix3x2dv(GLint location, GLsizei count, GLboolean transpose, const GLdouble * value) {}
-void glUniformMatrix3x2fv(GLint location, GLsizei count, GLboolean transpose, const GLfloat * value) {}
-void glUniformMatrix3x4dv(GLint location, GLsizei count, GLboolean transpose, const GLdouble * value) {}
-void glUniformMatrix3x4fv(GLint location, GLsizei count, GLboolean transpose, const GLfloat * value) {}
-void glUniformMatrix4dv(GLint location, GLsizei count, GLboolean transpose, const GLdouble * value) {}
-void glUniformMatrix4fv(GLint location, GLsizei count, GLboolean transpose, const GLfloat * value) {}
-void glUniformMatrix4x2dv(GLint location, GLsizei count, GLboolean transpose, const GLdouble * value) {}
-void glUniformMatrix4x2fv(GLint location, GLsizei count, GLboolean transpose, const GLfloat * value) {}
-void glUniformMatrix4x3dv(GLint location, GLsizei count, GLboolean transpose, const GLdouble * value) {}
-void glUniformMatrix4x3fv(GLint location, GLsizei count, GLboolean transpose, const GLfloat * value) {}
+void glUniformMatrix2dv(GLint location, GLsizei count, GLboolean transpose, const GLdouble * value) {
+    NoContextSetUniformMatrixData(location, value, 2, 2, count, transpose, GL_DOUBLE, __func__);
+}
+void glUniformMatrix2fv(GLint location, GLsizei count, GLboolean transpose, const GLfloat * value) {
+    NoContextSetUniformMatrixData(location, value, 2, 2, count, transpose, GL_FLOAT, __func__);
+}
+void glUniformMatrix2x3dv(GLint location, GLsizei count, GLboolean transpose, const GLdouble * value) {
+    NoContextSetUniformMatrixData(location, value, 2, 3, count, transpose, GL_DOUBLE, __func__);
+}
+void glUniformMatrix2x3fv(GLint location, GLsizei count, GLboolean transpose, const GLfloat * value) {
+    NoContextSetUniformMatrixData(location, value, 2, 3, count, transpose, GL_FLOAT, __func__);
+}
+void glUniformMatrix2x4dv(GLint location, GLsizei count, GLboolean transpose, const GLdouble * value) {
+    NoContextSetUniformMatrixData(location, value, 2, 4, count, transpose, GL_DOUBLE, __func__);
+}
+void glUniformMatrix2x4fv(GLint location, GLsizei count, GLboolean transpose, const GLfloat * value) {
+    NoContextSetUniformMatrixData(location, value, 2, 4, count, transpose, GL_FLOAT, __func__);
+}
+void glUniformMatrix3dv(GLint location, GLsizei count, GLboolean transpose, const GLdouble * value) {
+    NoContextSetUniformMatrixData(location, value, 3, 3, count, transpose, GL_DOUBLE, __func__);
+}
+void glUniformMatrix3fv(GLint location, GLsizei count, GLboolean transpose, const GLfloat * value) {
+    NoContextSetUniformMatrixData(location, value, 3, 3, count, transpose, GL_FLOAT, __func__);
+}
+void glUniformMatrix3x2dv(GLint location, GLsizei count, GLboolean transpose, const GLdouble * value) {
+    NoContextSetUniformMatrixData(location, value, 3, 2, count, transpose, GL_DOUBLE, __func__);
+}
+void glUniformMatrix3x2fv(GLint location, GLsizei count, GLboolean transpose, const GLfloat * value) {
+    NoContextSetUniformMatrixData(location, value, 3, 2, count, transpose, GL_FLOAT, __func__);
+}
+void glUniformMatrix3x4dv(GLint location, GLsizei count, GLboolean transpose, const GLdouble * value) {
+    NoContextSetUniformMatrixData(location, value, 3, 4, count, transpose, GL_DOUBLE, __func__);
+}
+void glUniformMatrix3x4fv(GLint location, GLsizei count, GLboolean transpose, const GLfloat * value) {
+    NoContextSetUniformMatrixData(location, value, 3, 4, count, transpose, GL_FLOAT, __func__);
+}
+void glUniformMatrix4dv(GLint location, GLsizei count, GLboolean transpose, const GLdouble * value) {
+    NoContextSetUniformMatrixData(location, value, 4, 4, count, transpose, GL_DOUBLE, __func__);
+}
+void glUniformMatrix4fv(GLint location, GLsizei count, GLboolean transpose, const GLfloat * value) {
+    NoContextSetUniformMatrixData(location, value, 4, 4, count, transpose, GL_FLOAT, __func__);
+}
+void glUniformMatrix4x2dv(GLint location, GLsizei count, GLboolean transpose, const GLdouble * value) {
+    NoContextSetUniformMatrixData(location, value, 4, 2, count, transpose, GL_DOUBLE, __func__);
+}
+void glUniformMatrix4x2fv(GLint location, GLsizei count, GLboolean transpose, const GLfloat * value) {
+    NoContextSetUniformMatrixData(location, value, 4, 2, count, transpose, GL_FLOAT, __func__);
+}
+void glUniformMatrix4x3dv(GLint location, GLsizei count, GLboolean transpose, const GLdouble * value) {
+    NoContextSetUniformMatrixData(location, value, 4, 3, count, transpose, GL_DOUBLE, __func__);
+}
+void glUniformMatrix4x3fv(GLint location, GLsizei count, GLboolean transpose, const GLfloat * value) {
+    NoContextSetUniformMatrixData(location, value, 4, 3, count, transpose, GL_FLOAT, __func__);
+}
 void glUniformSubroutinesuiv(GLenum shadertype, GLsizei count, const GLuint * indices) {}
-GLboolean glUnmapBuffer(GLenum target) {return GL_TRUE;}
-GLboolean glUnmapNamedBuffer(GLuint buffer) {return GL_TRUE;}
+GLboolean glUnmapBuffer(GLenum target) {
+    const char *Name = "glUnmapBuffer";
+    context *C = 0;
+    CheckGL(AcquireContext(&C, Name), gl_error_ACQUIRE_CONTEXT, GL_FALSE);
+
+    object *Object = 0;
+    if(HandledCheckBufferTargetGet(C, target, &Object, Name)) {
+        return GL_FALSE;
+    }
+    return UnmapBuffer(C, Object, Name);
+}
+GLboolean glUnmapNamedBuffer(GLuint buffer) {
+    const char *Name = "glUnmapNamedBuffer";
+    context *C = 0;
+    CheckGL(AcquireContext(&C, Name), gl_error_ACQUIRE_CONTEXT, GL_FALSE);
+
+    object *Object = 0;
+    if(HandledCheckBufferGet(C, buffer, &Object, Name)) {
+        return GL_FALSE;
+    }
+    return UnmapBuffer(C, Object, Name);
+}
 void glUseProgram(GLuint program) {
     const char *Name = "glUseProgram";
     context *C = 0;
@@ -2399,8 +3815,31 @@ void glVertexArrayAttribLFormat(GLuint vaobj, GLuint attribindex, GLint size, GL
     CheckGL(CheckObjectTypeGet(C, vaobj, object_VERTEX_ARRAY, &Object), gl_error_VERTEX_ARRAY_ATTRIB_FORMAT_VAO_INVALID);
     SetVertexInputAttributeFormat(C, Object, C->BoundVao == vaobj, attribindex, size, type, relativeoffset, 0, Name);
 }
-void glVertexArrayBindingDivisor(GLuint vaobj, GLuint bindingindex, GLuint divisor) {}
-void glVertexArrayElementBuffer(GLuint vaobj, GLuint buffer) {}
+void glVertexArrayBindingDivisor(GLuint vaobj, GLuint bindingindex, GLuint divisor) {
+    const char *Name = "glVertexArrayBindingDivisor";
+    context *C = 0;
+    CheckGL(AcquireContext(&C, Name), gl_error_ACQUIRE_CONTEXT);
+
+    object *Object = 0;
+    CheckGL(CheckObjectTypeGet(C, vaobj, object_VERTEX_ARRAY, &Object), gl_error_VERTEX_ARRAY_BINDING_DIVISOR_VAO_INVALID);
+    SetVertexInputBindingDivisor(C, Object, C->BoundVao == vaobj, bindingindex, divisor, Name);
+}
+void glVertexArrayElementBuffer(GLuint vaobj, GLuint buffer) {
+    const char *Name = "glVertexArrayElementBuffer";
+    context *C = 0;
+    CheckGL(AcquireContext(&C, Name), gl_error_ACQUIRE_CONTEXT);
+
+    object *Object = 0;
+    CheckGL(CheckObjectTypeGet(C, vaobj, object_VERTEX_ARRAY, &Object), gl_error_VERTEX_ARRAY_ELEMENT_BUFFER_VAO);
+    CheckGL(buffer != 0 && CheckObjectType(C, buffer, object_BUFFER), gl_error_VERTEX_ARRAY_ELEMENT_BUFFER_BUFFER);
+
+    Object->VertexArray.ElementBuffer = buffer;
+    if(C->BoundVao == vaobj) {
+        buffer_target_info TargetInfo = {0};
+        Assert(0 == GetBufferTargetInfo(GL_ELEMENT_ARRAY_BUFFER, &TargetInfo));
+        C->BoundBuffers[TargetInfo.Index] = buffer;
+    }
+}
 void glVertexArrayVertexBuffer(GLuint vaobj, GLuint bindingindex, GLuint buffer, GLintptr offset, GLsizei stride) {
     const char *Name = "glVertexArrayVertexBuffer";
     context *C = 0;
@@ -2463,7 +3902,19 @@ void glVertexAttribBinding(GLuint attribindex, GLuint bindingindex) {
     CheckGL(CheckObjectTypeGet(C, C->BoundVao, object_VERTEX_ARRAY, &Object), gl_error_VERTEX_ATTRIB_BINDING_NONE_BOUND);
     SetVertexInputAttributeBinding(C, Object, 1, attribindex, bindingindex, Name);
 }
-void glVertexAttribDivisor(GLuint index, GLuint divisor) {}
+void glVertexAttribDivisor(GLuint index, GLuint divisor) {
+    const char *Name = "glVertexAttribDivisor";
+    context *C = 0;
+    CheckGL(AcquireContext(&C, Name), gl_error_ACQUIRE_CONTEXT);
+
+    object *Object = 0;
+    CheckGL(CheckObjectTypeGet(C, C->BoundVao, object_VERTEX_ARRAY, &Object), gl_error_VERTEX_BINDING_DIVISOR_NONE_BOUND);
+    CheckGL(index >= C->PipelineStateInfos[pipeline_state_VERTEX_INPUT_ATTRIBUTES].InstanceCount, gl_error_VERTEX_ATTRIB_DIVISOR_INDEX);
+
+    // NOTE(blackedout): Equivalent to binding the attribute to the binding of the same index and setting its divisor
+    SetVertexInputAttributeBinding(C, Object, 1, index, index, Name);
+    SetVertexInputBindingDivisor(C, Object, 1, index, divisor, Name);
+}
 void glVertexAttribFormat(GLuint attribindex, GLint size, GLenum type, GLboolean normalized, GLuint relativeoffset) {
     const char *Name = "glVertexAttribFormat";
     context *C = 0;
@@ -2561,7 +4012,15 @@ void glVertexAttribPointer(GLuint index, GLint size, GLenum type, GLboolean norm
     u32 IntegerHandlingBits = vertex_input_attribute_INTEGER_HANDLING_ENABLED | (normalized == GL_FALSE ? vertex_input_attribute_INTEGER_NORMALIZE : 0);
     SetVertexInputAttributePointer(C, Object, index, size, type, stride, pointer, IntegerHandlingBits, Name);
 }
-void glVertexBindingDivisor(GLuint bindingindex, GLuint divisor) {}
+void glVertexBindingDivisor(GLuint bindingindex, GLuint divisor) {
+    const char *Name = "glVertexBindingDivisor";
+    context *C = 0;
+    CheckGL(AcquireContext(&C, Name), gl_error_ACQUIRE_CONTEXT);
+
+    object *Object = 0;
+    CheckGL(CheckObjectTypeGet(C, C->BoundVao, object_VERTEX_ARRAY, &Object), gl_error_VERTEX_BINDING_DIVISOR_NONE_BOUND);
+    SetVertexInputBindingDivisor(C, Object, 1, bindingindex, divisor, Name);
+}
 void glViewport(GLint x, GLint y, GLsizei width, GLsizei height) {
     const char *Name = "glViewport";
     context *C = 0;
@@ -9,12 +9,12 @@ int GetBufferTargetInfo(GLenum Target, buffer_target_info *OutInfo) {
     MakeCase(GL_ATOMIC_COUNTER_BUFFER, 1, 0); // TODO
     MakeCase(GL_COPY_READ_BUFFER, 2, 0); // TODO
     MakeCase(GL_COPY_WRITE_BUFFER, 3, 0); // TODO
-    MakeCase(GL_DISPATCH_INDIRECT_BUFFER, 4, 0); // TODO
-    MakeCase(GL_DRAW_INDIRECT_BUFFER, 5); // TODO
+    MakeCase(GL_DISPATCH_INDIRECT_BUFFER, 4, VK_BUFFER_USAGE_INDIRECT_BUFFER_BIT);
+    MakeCase(GL_DRAW_INDIRECT_BUFFER, 5, VK_BUFFER_USAGE_INDIRECT_BUFFER_BIT);
     MakeCase(GL_ELEMENT_ARRAY_BUFFER, 6, VK_BUFFER_USAGE_INDEX_BUFFER_BIT);
-    MakeCase(GL_PARAMETER_BUFFER, 7, 0); // TODO
-    MakeCase(GL_PIXEL_PACK_BUFFER, 8, 0); // TODO
-    MakeCase(GL_PIXEL_UNPACK_BUFFER, 9, 0); // TODO
+    MakeCase(GL_PARAMETER_BUFFER, 7, VK_BUFFER_USAGE_INDIRECT_BUFFER_BIT);
+    MakeCase(GL_PIXEL_PACK_BUFFER, 8, VK_BUFFER_USAGE_TRANSFER_DST_BIT);
+    MakeCase(GL_PIXEL_UNPACK_BUFFER, 9, VK_BUFFER_USAGE_TRANSFER_SRC_BIT);
     MakeCase(GL_QUERY_BUFFER, 10, 0); // TODO
     MakeCase(GL_SHADER_STORAGE_BUFFER, 11, VK_BUFFER_USAGE_STORAGE_BUFFER_BIT);
     MakeCase(GL_TEXTURE_BUFFER, 12, VK_BUFFER_USAGE_STORAGE_TEXEL_BUFFER_BIT); // TODO
@@ -48,7 +48,7 @@ int GetPrimitiveInfo(GLenum Mode, primitive_info *OutInfo) {
     switch(Mode) {
     MakeCase(GL_POINTS, VK_PRIMITIVE_TOPOLOGY_POINT_LIST);
     MakeCase(GL_LINE_STRIP, VK_PRIMITIVE_TOPOLOGY_LINE_STRIP);
-    MakeCase(GL_LINE_LOOP, VK_PRIMITIVE_TOPOLOGY_LINE_STRIP); // TODO(blackedout): Not supported by Vulkan, handle custom
+    MakeCase(GL_LINE_LOOP, VK_PRIMITIVE_TOPOLOGY_LINE_STRIP); // NOTE(blackedout): Not supported by Vulkan, see `IsEmulatedPrimitive`
     MakeCase(GL_LINES, VK_PRIMITIVE_TOPOLOGY_LINE_LIST);
     MakeCase(GL_LINE_STRIP_ADJACENCY, VK_PRIMITIVE_TOPOLOGY_LINE_STRIP_WITH_ADJACENCY);
     MakeCase(GL_LINES_ADJACENCY, VK_PRIMITIVE_TOPOLOGY_LINE_LIST_WITH_ADJACENCY);
@@ -63,6 +63,17 @@ int GetPrimitiveInfo(GLenum Mode, primitive_info *OutInfo) {
 #undef MakeCase
 }
 
+int GetIndexTypeInfo(GLenum Type, index_type_info *OutInfo) {
+#define MakeCase(T, ...) case (T): { index_type_info I = { __VA_ARGS__ }; *OutInfo = I; } return 0
+    switch(Type) {
+    MakeCase(GL_UNSIGNED_BYTE, 1, 2, VK_INDEX_TYPE_UINT16);
+    MakeCase(GL_UNSIGNED_SHORT, 2, 2, VK_INDEX_TYPE_UINT16);
+    MakeCase(GL_UNSIGNED_INT, 4, 4, VK_INDEX_TYPE_UINT32);
+    default: return 1;
+    }
+#undef MakeCase
+}
+
 int GetVulkanBlendOp(GLenum mode, VkBlendOp *OutBlendOp) {
 #define MakeCase(Key, Value) case (Key): *OutBlendOp = (Value); break
     switch(mode) {
@@ -195,4 +206,109 @@ int GetColorAttachmentInfo(GLenum buf, u32 MaxColorAttachmentCount, color_attach
     }
 
     return 1;
-}
\ No newline at end of file
+}
+int GetMapBufferAccess(GLenum Access, GLbitfield *OutAccess) {
+#define MakeCase(T, A) case (T): *OutAccess = (A); return 0
+    switch(Access) {
+    MakeCase(GL_READ_ONLY, GL_MAP_READ_BIT);
+    MakeCase(GL_WRITE_ONLY, GL_MAP_WRITE_BIT);
+    MakeCase(GL_READ_WRITE, GL_MAP_READ_BIT | GL_MAP_WRITE_BIT);
+    default: return 1;
+    }
+#undef MakeCase
+}
+
+// NOTE(blackedout): Static data is uploaded once into device local memory. Dynamic data is written in place into host
+// visible memory that is preferably device local too. Stream data is written in place into coherent memory, it is
+// read once by the device anyway.
+int GetBufferUsageMemoryFlags(GLenum Usage, u32 *OutMemoryFlags) {
+#define MakeCase(U, F) case (U): *OutMemoryFlags = (F); return 0
+    switch(Usage) {
+    MakeCase(GL_STATIC_DRAW, 0);
+    MakeCase(GL_STATIC_READ, 0);
+    MakeCase(GL_STATIC_COPY, 0);
+    MakeCase(GL_DYNAMIC_DRAW, buffer_memory_HOST_VISIBLE | buffer_memory_DEVICE_LOCAL);
+    MakeCase(GL_DYNAMIC_READ, buffer_memory_HOST_VISIBLE | buffer_memory_HOST_READ);
+    MakeCase(GL_DYNAMIC_COPY, 0);
+    MakeCase(GL_STREAM_DRAW, buffer_memory_HOST_VISIBLE | buffer_memory_HOST_COHERENT);
+    MakeCase(GL_STREAM_READ, buffer_memory_HOST_VISIBLE | buffer_memory_HOST_COHERENT | buffer_memory_HOST_READ);
+    MakeCase(GL_STREAM_COPY, 0);
+    default: return 1;
+    }
+#undef MakeCase
+}
+
+#define SHADER_STAGES (VK_PIPELINE_STAGE_VERTEX_SHADER_BIT | VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT | VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT)
+// NOTE(blackedout): Only single bits, barriers of transform feedback aren't supported and have no consumers
+int GetMemoryBarrierInfo(GLbitfield Barrier, memory_barrier_info *OutInfo) {
+#define MakeCase(B, ...) case (B): { memory_barrier_info I = { __VA_ARGS__ }; *OutInfo = I; }; return 0;
+    switch(Barrier) {
+    MakeCase(GL_VERTEX_ATTRIB_ARRAY_BARRIER_BIT, VK_PIPELINE_STAGE_VERTEX_INPUT_BIT, VK_ACCESS_VERTEX_ATTRIBUTE_READ_BIT);
+    MakeCase(GL_ELEMENT_ARRAY_BARRIER_BIT, VK_PIPELINE_STAGE_VERTEX_INPUT_BIT, VK_ACCESS_INDEX_READ_BIT);
+    MakeCase(GL_UNIFORM_BARRIER_BIT, SHADER_STAGES, VK_ACCESS_UNIFORM_READ_BIT);
+    MakeCase(GL_TEXTURE_FETCH_BARRIER_BIT, SHADER_STAGES, VK_ACCESS_SHADER_READ_BIT);
+    MakeCase(GL_SHADER_IMAGE_ACCESS_BARRIER_BIT, SHADER_STAGES, VK_ACCESS_SHADER_READ_BIT | VK_ACCESS_SHADER_WRITE_BIT);
+    MakeCase(GL_COMMAND_BARRIER_BIT, VK_PIPELINE_STAGE_DRAW_INDIRECT_BIT, VK_ACCESS_INDIRECT_COMMAND_READ_BIT);
+    MakeCase(GL_PIXEL_BUFFER_BARRIER_BIT, VK_PIPELINE_STAGE_TRANSFER_BIT, VK_ACCESS_TRANSFER_READ_BIT | VK_ACCESS_TRANSFER_WRITE_BIT);
+    MakeCase(GL_TEXTURE_UPDATE_BARRIER_BIT, VK_PIPELINE_STAGE_TRANSFER_BIT, VK_ACCESS_TRANSFER_READ_BIT | VK_ACCESS_TRANSFER_WRITE_BIT);
+    MakeCase(GL_BUFFER_UPDATE_BARRIER_BIT, VK_PIPELINE_STAGE_TRANSFER_BIT | VK_PIPELINE_STAGE_HOST_BIT, VK_ACCESS_TRANSFER_READ_BIT | VK_ACCESS_TRANSFER_WRITE_BIT | VK_ACCESS_HOST_READ_BIT);
+    MakeCase(GL_CLIENT_MAPPED_BUFFER_BARRIER_BIT, VK_PIPELINE_STAGE_HOST_BIT, VK_ACCESS_HOST_READ_BIT);
+    MakeCase(GL_FRAMEBUFFER_BARRIER_BIT, VK_PIPELINE_STAGE_EARLY_FRAGMENT_TESTS_BIT | VK_PIPELINE_STAGE_LATE_FRAGMENT_TESTS_BIT | VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT,
+             VK_ACCESS_COLOR_ATTACHMENT_READ_BIT | VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT | VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_READ_BIT | VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT);
+    MakeCase(GL_TRANSFORM_FEEDBACK_BARRIER_BIT, 0, 0);
+    MakeCase(GL_ATOMIC_COUNTER_BARRIER_BIT, SHADER_STAGES, VK_ACCESS_SHADER_READ_BIT | VK_ACCESS_SHADER_WRITE_BIT);
+    MakeCase(GL_SHADER_STORAGE_BARRIER_BIT, SHADER_STAGES, VK_ACCESS_SHADER_READ_BIT | VK_ACCESS_SHADER_WRITE_BIT);
+    MakeCase(GL_QUERY_BUFFER_BARRIER_BIT, VK_PIPELINE_STAGE_TRANSFER_BIT, VK_ACCESS_TRANSFER_WRITE_BIT);
+    default: return 1;
+    }
+#undef MakeCase
+}
+#undef SHADER_STAGES
+
+// NOTE(blackedout): The formats of table 8.27
+int GetImageUnitFormat(GLenum Format, VkFormat *OutFormat) {
+#define MakeCase(F, V) case (F): *OutFormat = (V); return 0
+    switch(Format) {
+    MakeCase(GL_RGBA32F, VK_FORMAT_R32G32B32A32_SFLOAT);
+    MakeCase(GL_RGBA16F, VK_FORMAT_R16G16B16A16_SFLOAT);
+    MakeCase(GL_RG32F, VK_FORMAT_R32G32_SFLOAT);
+    MakeCase(GL_RG16F, VK_FORMAT_R16G16_SFLOAT);
+    MakeCase(GL_R11F_G11F_B10F, VK_FORMAT_B10G11R11_UFLOAT_PACK32);
+    MakeCase(GL_R32F, VK_FORMAT_R32_SFLOAT);
+    MakeCase(GL_R16F, VK_FORMAT_R16_SFLOAT);
+    MakeCase(GL_RGBA32UI, VK_FORMAT_R32G32B32A32_UINT);
+    MakeCase(GL_RGBA16UI, VK_FORMAT_R16G16B16A16_UINT);
+    MakeCase(GL_RGB10_A2UI, VK_FORMAT_A2B10G10R10_UINT_PACK32);
+    MakeCase(GL_RGBA8UI, VK_FORMAT_R8G8B8A8_UINT);
+    MakeCase(GL_RG32UI, VK_FORMAT_R32G32_UINT);
+    MakeCase(GL_RG16UI, VK_FORMAT_R16G16_UINT);
+    MakeCase(GL_RG8UI, VK_FORMAT_R8G8_UINT);
+    MakeCase(GL_R32UI, VK_FORMAT_R32_UINT);
+    MakeCase(GL_R16UI, VK_FORMAT_R16_UINT);
+    MakeCase(GL_R8UI, VK_FORMAT_R8_UINT);
+    MakeCase(GL_RGBA32I, VK_FORMAT_R32G32B32A32_SINT);
+    MakeCase(GL_RGBA16I, VK_FORMAT_R16G16B16A16_SINT);
+    MakeCase(GL_RGBA8I, VK_FORMAT_R8G8B8A8_SINT);
+    MakeCase(GL_RG32I, VK_FORMAT_R32G32_SINT);
+    MakeCase(GL_RG16I, VK_FORMAT_R16G16_SINT);
+    MakeCase(GL_RG8I, VK_FORMAT_R8G8_SINT);
+    MakeCase(GL_R32I, VK_FORMAT_R32_SINT);
+    MakeCase(GL_R16I, VK_FORMAT_R16_SINT);
+    MakeCase(GL_R8I, VK_FORMAT_R8_SINT);
+    MakeCase(GL_RGBA16, VK_FORMAT_R16G16B16A16_UNORM);
+    MakeCase(GL_RGB10_A2, VK_FORMAT_A2B10G10R10_UNORM_PACK32);
+    MakeCase(GL_RGBA8, VK_FORMAT_R8G8B8A8_UNORM);
+    MakeCase(GL_RG16, VK_FORMAT_R16G16_UNORM);
+    MakeCase(GL_RG8, VK_FORMAT_R8G8_UNORM);
+    MakeCase(GL_R16, VK_FORMAT_R16_UNORM);
+    MakeCase(GL_R8, VK_FORMAT_R8_UNORM);
+    MakeCase(GL_RGBA16_SNORM, VK_FORMAT_R16G16B16A16_SNORM);
+    MakeCase(GL_RGBA8_SNORM, VK_FORMAT_R8G8B8A8_SNORM);
+    MakeCase(GL_RG16_SNORM, VK_FORMAT_R16G16_SNORM);
+    MakeCase(GL_RG8_SNORM, VK_FORMAT_R8G8_SNORM);
+    MakeCase(GL_R16_SNORM, VK_FORMAT_R16_SNORM);
+    MakeCase(GL_R8_SNORM, VK_FORMAT_R8_SNORM);
+    default: return 1;
+    }
+#undef MakeCase
+}
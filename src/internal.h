@@ -12,6 +12,7 @@
 #include "vulkan/vulkan_core.h"
 
 typedef uint8_t u8;
+typedef uint16_t u16;
 typedef uint32_t u32;
 typedef uint64_t u64;
 
@@ -50,6 +51,19 @@ typedef struct free_array {
 
 void SetFlagsEnabledU32(u32 *InOut, u32 Mask, int DoEnable);
 void SetFlagsU32(u32 *InOut, u32 Mask, u32 Bits);
+u64 HashBytes(const void *Bytes, u64 ByteCount);
+
+// MARK: UNIFORM PACKING
+
+typedef struct uniform_pack_info {
+    u32 ColumnCount;
+    u32 RowCount;
+    u32 ScalarByteCount;
+    u32 MatrixStride;
+    u32 ArrayStride;
+} uniform_pack_info;
+
+void PackUniformElements(u8 *Dst, const void *Src, u32 Count, int Transpose, const uniform_pack_info *Info);
 
 // MARK: GL ENUM INFO
 
@@ -74,6 +88,19 @@ typedef struct primitive_info {
     VkPrimitiveTopology VulkanPrimitve;
 } primitive_info;
 
+typedef struct memory_barrier_info {
+    // NOTE(blackedout): Of the commands that consume shader writes made before the barrier
+    VkPipelineStageFlags VulkanStages;
+    VkAccessFlags VulkanAccess;
+} memory_barrier_info;
+
+typedef struct index_type_info {
+    // NOTE(blackedout): Byte indices are drawn from a copy widened to 16 bit, so the sizes differ for them
+    u32 ByteCount;
+    u32 VulkanByteCount;
+    VkIndexType VulkanIndexType;
+} index_type_info;
+
 typedef struct vertex_input_attribute_size_type_info {
     u32 ByteCount;
     VkFormat VulkanFormat;
@@ -96,17 +123,27 @@ typedef struct color_attachment_info {
 } color_attachment_info;
 
 #define BUFFER_TARGET_COUNT (15)
+// NOTE(blackedout): GL lets any buffer be bound to any target, so data stores allow every use of any target, no matter through
+// which target or named buffer command they were specified
+#define ALL_BUFFER_TARGET_VULKAN_USAGE (VK_BUFFER_USAGE_VERTEX_BUFFER_BIT | VK_BUFFER_USAGE_INDEX_BUFFER_BIT | VK_BUFFER_USAGE_INDIRECT_BUFFER_BIT | VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_STORAGE_TEXEL_BUFFER_BIT | VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT)
 #define TEXTURE_SLOT_COUNT (128)
+#define SHADER_STORAGE_BINDING_COUNT (16)
+#define IMAGE_UNIT_COUNT (8)
 #define TEXTURE_TARGET_COUNT (11)
 
 int GetBufferTargetInfo(GLenum Target, buffer_target_info *OutInfo);
 int GetTextureTargetInfo(GLenum Target, texture_target_info *OutInfo);
 int GetPrimitiveInfo(GLenum Mode, primitive_info *OutInfo);
+int GetIndexTypeInfo(GLenum Type, index_type_info *OutInfo);
 int GetVulkanBlendOp(GLenum mode, VkBlendOp *OutBlendOp);
 int GetVulkanBlendFactor(GLenum factor, VkBlendFactor *OutBlendFactor);
 int GetVertexInputAttributeSizeTypeInfo(GLint Size, GLenum Type, vertex_input_attribute_size_type_info *OutInfo);
 int GetShaderTypeInfo(GLenum type, shader_type_info *OutInfo);
 int GetColorAttachmentInfo(GLenum buf, u32 MaxColorAttachmentCount, color_attachment_info *OutInfo);
+int GetMapBufferAccess(GLenum Access, GLbitfield *OutAccess);
+int GetMemoryBarrierInfo(GLbitfield Barrier, memory_barrier_info *OutInfo);
+int GetImageUnitFormat(GLenum Format, VkFormat *OutFormat);
+int GetBufferUsageMemoryFlags(GLenum Usage, u32 *OutMemoryFlags);
 
 // MARK: CORE
 
@@ -114,6 +151,28 @@ int GetColorAttachmentInfo(GLenum buf, u32 MaxColorAttachmentCount, color_attach
 #define INITIAL_COMMAND_CAPACITY (1024)
 #define INITIAL_PIPELINE_STATE_CAPACITY (8)
 #define PIPELINE_UNUSED_SWAP_COUNTER_DELETE (120)
+#define INITIAL_UNIFORM_SNAPSHOT_TABLE_CAPACITY (16)
+#define INITIAL_ACQUIRE_BARRIER_CAPACITY (64)
+#define INITIAL_STAGING_BUFFER_CAPACITY (64)
+#define INITIAL_RETIRED_BUFFER_CAPACITY (16)
+#define INITIAL_COMMAND_DATA_CAPACITY (4096)
+#define INITIAL_MULTI_DRAW_DATA_CAPACITY (4096)
+#define INITIAL_PRIMITIVE_INDEX_BUFFER_CAPACITY (16)
+#define PRIMITIVE_INDEX_BUFFER_UNUSED_SWAP_COUNTER_DELETE (120)
+#define INITIAL_RENDER_PASS_CACHE_CAPACITY (8)
+#define RENDER_PASS_UNUSED_SWAP_COUNTER_DELETE (120)
+#define INITIAL_STORAGE_DESCRIPTOR_POOL_CAPACITY (4)
+#define STORAGE_DESCRIPTOR_POOL_SET_COUNT (256)
+#define STORAGE_DESCRIPTOR_POOL_DESCRIPTOR_COUNT (1024)
+#define INITIAL_BUFFER_COPY_CAPACITY (2)
+#define MAX_FREE_BUFFER_COPY_COUNT (4)
+#define INITIAL_BUFFER_POOL_CAPACITY (4)
+// NOTE(blackedout): Device local buffers up to this size are sub-allocated from pool buffers
+#define MAX_POOLED_BUFFER_BYTE_COUNT (256ull << 10)
+#define BUFFER_POOL_BYTE_COUNT (32ull << 20)
+#define MIN_BUFFER_POOL_ALIGNMENT (16)
+#define INITIAL_STAGING_RING_BYTE_COUNT (4ull << 20)
+#define DEFAULT_MAX_STAGING_RING_BYTE_COUNT (256ull << 20)
 
 #define VulkanCheckGoto(Call, Label) if(VulkanCheck(C, Call, #Call)) goto Label;
 #define VulkanCheckReturn(Call) if(VulkanCheck(C, Call, #Call)) return;
@@ -134,10 +193,75 @@ typedef struct vertex_array_attribute {
     u32 BindingIndex;
 } vertex_array_attribute;
 
+enum buffer_memory_flags {
+    buffer_memory_HOST_VISIBLE = 0x01,
+    buffer_memory_HOST_COHERENT = 0x02,
+    // NOTE(blackedout): Only a preference when allocating, host cached memory is used if there is any
+    buffer_memory_HOST_READ = 0x04,
+    // NOTE(blackedout): Also only a preference for host visible memory (resizable BAR or unified memory)
+    buffer_memory_DEVICE_LOCAL = 0x08,
+};
+
+// NOTE(blackedout): Memory of a buffer that was renamed away. Copies stay with their buffer, so that renaming it again
+// in a later frame doesn't allocate.
+typedef struct buffer_copy {
+    VkBuffer Buffer;
+    VmaAllocation Allocation;
+    // NOTE(blackedout): Range of a pool buffer if `VirtualAllocation` is set, `Allocation` belongs to the pool then
+    u64 Offset;
+    VmaVirtualAllocation VirtualAllocation;
+    u32 PoolIndex;
+    u8 *Mapped;
+    u32 MemoryFlags;
+} buffer_copy;
+
+typedef struct buffer_pool {
+    VkBuffer Buffer;
+    VmaAllocation Allocation;
+    VmaVirtualBlock Block;
+    VkBufferUsageFlags Usage;
+    u64 Alignment;
+} buffer_pool;
+
+// NOTE(blackedout): A generated index buffer for an emulated primitive mode, see `IsEmulatedPrimitive`
+typedef struct primitive_index_buffer {
+    GLenum Mode;
+    u32 VertexCount;
+    GLuint Buffer;
+} primitive_index_buffer;
+
+// NOTE(blackedout): A render pass shared by all framebuffers whose attachment descriptions and subpass layout serialize to
+// the same `Key`, see `AcquireRenderPass`
+typedef struct render_pass_cache_entry {
+    u64 Hash;
+    u8 *Key;
+    u32 KeyByteCount;
+    u32 ReferenceCount;
+    u64 LastUseSwapCounter;
+    VkRenderPass RenderPass;
+} render_pass_cache_entry;
+
+typedef struct indexed_buffer_binding {
+    GLuint Buffer;
+    GLintptr Offset;
+    // NOTE(blackedout): Zero if the whole buffer is bound (BindBufferBase)
+    GLsizeiptr Size;
+} indexed_buffer_binding;
+
+typedef struct image_unit_binding {
+    GLuint Texture;
+    GLint Level;
+    GLboolean Layered;
+    GLint Layer;
+    GLenum Access;
+    VkFormat VulkanFormat;
+} image_unit_binding;
+
 typedef struct vertex_array_binding {
     GLuint Vbo;
     GLintptr Offset;
     GLsizei Stride;
+    GLuint Divisor;
 } vertex_array_binding;
 
 typedef enum object_type {
@@ -177,6 +301,13 @@ typedef struct framebuffer_attachment {
     GLuint Rbo;
 } framebuffer_attachment;
 
+// NOTE(blackedout): Entry of a program's open addressing table of the uniform snapshots used this frame.
+// `Slot` is the index into `Program.UniformBuffer` plus one, zero means the entry is empty.
+typedef struct uniform_snapshot_entry {
+    u64 Hash;
+    u32 Slot;
+} uniform_snapshot_entry;
+
 typedef struct object {
     object_type Type;
     int IsCreated;
@@ -188,8 +319,40 @@ typedef struct object {
         struct {
             VkBuffer Buffer;
             VmaAllocation Allocation;
+            // NOTE(blackedout): Of the data store in `Buffer`, see `buffer_copy`
+            u64 Offset;
+            VmaVirtualAllocation VirtualAllocation;
+            u32 PoolIndex;
             VkBuffer StagingBuffer;
             VmaAllocation StagingAllocation;
+            u64 ByteCount;
+            VkBufferUsageFlags VulkanUsage;
+            // NOTE(blackedout): Of the current allocation, `Mapped` is its persistent mapping if it is host visible
+            u32 MemoryFlags;
+            u8 *Mapped;
+            // NOTE(blackedout): Requested from the usage hint, new memory of the data store is allocated with these
+            u32 PlacementFlags;
+            // NOTE(blackedout): `BUFFER_IMMUTABLE_STORAGE` and `BUFFER_STORAGE_FLAGS`
+            int IsImmutable;
+            GLbitfield StorageFlags;
+            // NOTE(blackedout): Specified with a *_READ usage or written by pixel reads, only such buffers move into host
+            // cached memory when the host reads them (see `GetBufferSubData`)
+            int IsReadBack;
+            // NOTE(blackedout): `SwapCounter` plus one of the last frame whose commands reference the buffer
+            u64 LastUseFrame;
+            // NOTE(blackedout): Like `LastUseFrame`, for commands that read the current memory, reset when it is renamed
+            u64 LastReadFrame;
+            int IsMapped;
+            GLbitfield MapAccess;
+            u64 MapOffset;
+            u64 MapLength;
+            // NOTE(blackedout): Hidden buffer with the contents widened to 16 bit for draws with GL_UNSIGNED_BYTE indices,
+            // see `HandledGetExpandedIndexBuffer`
+            GLuint ExpandedIndexBuffer;
+            int IsExpandedIndexBufferStale;
+            // NOTE(blackedout): Copies renamed away this frame and copies that are ready to be renamed to
+            array(buffer_copy) InUseCopies;
+            array(buffer_copy) FreeCopies;
         } Buffer;
         struct {
             VkImage Image;
@@ -209,10 +372,25 @@ typedef struct object {
             array(render_pass_state_subpass) StoredSubpasses;
             array(VkAttachmentReference) StoredSubpassAttachments;
             VkRenderPass RenderPass;
+            // NOTE(blackedout): Same as `RenderPass` but loading every attachment, continues the render pass after another
+            // framebuffer's pass that `MergeRenderPasses` couldn't move out of the way
+            VkRenderPass ResumeRenderPass;
             VkFramebuffer Framebuffer;
-            VkRenderPass OldRenderPass;
             VkFramebuffer OldFramebuffer;
             VkExtent2D Extent;
+            u32 AttachmentCount;
+            // NOTE(blackedout): Color attachments invalidated this frame (bit i is attachment i), before the first draw their
+            // contents need not be loaded, after the last one they need not be stored. See `InvalidateFramebuffer`.
+            u32 DiscardLoadMask;
+            u32 DiscardStoreMask;
+            u32 StoredDiscardLoadMask;
+            u32 StoredDiscardStoreMask;
+            // NOTE(blackedout): Color attachments cleared as a whole before the first draw this frame, they are cleared by the
+            // load op instead of a clear command. See `Clear`.
+            u32 ClearLoadMask;
+            u32 StoredClearLoadMask;
+            // NOTE(blackedout): Its render pass is begun again this frame after another framebuffer's, see `MergeRenderPasses`
+            int IsResumed;
         } Framebuffer;
         struct {
             u64 AttachedShaderCount;
@@ -226,11 +404,23 @@ typedef struct object {
             array(u8) UniformBuffer;
             u32 AlignedUniformByteCount;
             int LatestUniformsUsed;
+            int LatestUniformsResolved;
             u32 LatestUsedUniformsIndex;
+            array(uniform_snapshot_entry) UniformSnapshotTable;
             u64 LastUniformCount;
             VkBuffer VulkanUniformBuffer;
             VmaAllocation UniformBufferAllocation;
             VkDeviceMemory UniformMemory;
+            u64 LastUniformUploadFrame;
+            // NOTE(blackedout): Set 1 of the pipeline layouts if the program has storage blocks, see `HandledGetStorageDescriptorSet`
+            VkDescriptorSetLayout StorageDescriptorSetLayout;
+            VkDescriptorSet StorageDescriptorSet;
+            u64 StorageDescriptorSetFrame;
+            array(VkDescriptorBufferInfo) StorageBufferInfos;
+            // NOTE(blackedout): Only if a compute shader is attached, compute pipelines depend on nothing but the program
+            VkPipelineLayout ComputeLayout;
+            VkPipeline ComputePipeline;
+            u64 LastDispatchFrame;
         } Program;
         struct {
             GLenum Type;
@@ -244,12 +434,17 @@ typedef struct object {
             u64 SpirvByteCount;
             VkShaderModule VulkanModule;
         } Shader;
+        struct {
+            // NOTE(blackedout): `SwapCounter` plus one of the frame the fence was inserted in, it is signaled once that frame is done
+            u64 Frame;
+        } Sync;
         struct {
             texture_dimension Dimension;
         } Texture;
         struct {
             vertex_array_attribute *InputAttributes;
             vertex_array_binding *InputBindings;
+            GLuint ElementBuffer;
         } VertexArray;
     };
 } object;
@@ -262,7 +457,20 @@ typedef enum command_type {
     command_BIND_PIPELINE,
     command_BIND_UNIFORMS,
     command_BEGIN_RENDER_PASS,
-    command_NEXT_SUBPASS
+    command_NEXT_SUBPASS,
+    command_UPDATE_BUFFER,
+    command_COPY_BUFFER,
+    command_READ_PIXELS,
+    command_BIND_INDEX_BUFFER,
+    command_DRAW_INDEXED,
+    command_DRAW_INDIRECT,
+    command_DRAW_INDEXED_INDIRECT,
+    command_MULTI_DRAW,
+    command_MULTI_DRAW_INDEXED,
+    command_BIND_STORAGE_BUFFERS,
+    command_DISPATCH,
+    command_DISPATCH_INDIRECT,
+    command_MEMORY_BARRIER,
 } command_type;
 
 typedef struct command {
@@ -279,6 +487,9 @@ typedef struct command {
         } BindPipeline;
         struct {
             u32 SubpassIndex;
+            GLbitfield Mask;
+            int IsScissored;
+            VkRect2D Scissor;
         } Clear;
         struct {
             u64 VertexCount;
@@ -286,12 +497,94 @@ typedef struct command {
             u64 InstanceCount;
             u64 InstanceOffset;
         } Draw;
+        struct {
+            u64 IndexCount;
+            u64 FirstIndex;
+            int32_t VertexOffset;
+            u64 InstanceCount;
+            u64 InstanceOffset;
+            // NOTE(blackedout): gl_DrawID of the draw, nonzero for ranges of emulated multi draws
+            u32 DrawId;
+        } DrawIndexed;
+        struct {
+            VkBuffer Buffer;
+            u64 Offset;
+            // NOTE(blackedout): If set, the draw count is read from here and `DrawCount` is the maximum
+            VkBuffer CountBuffer;
+            u64 CountOffset;
+            u32 DrawCount;
+            u32 Stride;
+        } DrawIndirect;
+        struct {
+            // NOTE(blackedout): Into `C->MultiDrawData`
+            u64 DataOffset;
+            u32 DrawCount;
+        } MultiDraw;
+        struct {
+            VkBuffer Buffer;
+            VkDeviceSize Offset;
+            VkIndexType IndexType;
+        } BindIndexBuffer;
         struct {
             GLuint Fbo;
+            // NOTE(blackedout): Of the attachments in `ClearLoadMask`
+            VkClearColorValue ClearColor;
+            // NOTE(blackedout): Continues the framebuffer's render pass at `SubpassIndex` after another framebuffer was drawn to
+            int IsResume;
+            u32 SubpassIndex;
         } BeginRenderPass;
+        struct {
+            VkBuffer Buffer;
+            u64 Offset;
+            u64 ByteCount;
+            // NOTE(blackedout): Into `C->CommandData`
+            u64 DataOffset;
+        } UpdateBuffer;
+        struct {
+            VkBuffer SrcBuffer;
+            VkBuffer DstBuffer;
+            u64 SrcOffset;
+            u64 DstOffset;
+            u64 ByteCount;
+        } CopyBuffer;
+        struct {
+            VkBuffer Buffer;
+            u64 Offset;
+            VkOffset2D ImageOffset;
+            VkExtent2D ImageExtent;
+            // NOTE(blackedout): In pixels, the rectangle may have been clipped to the framebuffer
+            u32 RowLength;
+        } ReadPixels;
         struct {
             u32 Index;
         } BindUniforms;
+        struct {
+            VkDescriptorSet Set;
+            // NOTE(blackedout): The `VkDescriptorBufferInfo`s of the set in `CommandData`
+            u64 BufferInfoDataOffset;
+            u32 BufferInfoCount;
+        } BindStorageBuffers;
+        struct {
+            GLuint Program;
+            u32 UniformIndex;
+            VkDescriptorSet StorageSet;
+            u32 GroupCountX;
+            u32 GroupCountY;
+            u32 GroupCountZ;
+            // NOTE(blackedout): Of `command_DISPATCH_INDIRECT`
+            VkBuffer Buffer;
+            u64 Offset;
+            // NOTE(blackedout): The `VkDescriptorBufferInfo`s of the storage set in `CommandData` and which of them are written
+            u64 BufferInfoDataOffset;
+            u32 BufferInfoCount;
+            u32 WrittenBufferInfoMask;
+            // NOTE(blackedout): Set during replay if the dispatch runs on the async compute queue
+            int IsAsync;
+        } Dispatch;
+        struct {
+            VkPipelineStageFlags DstStages;
+            VkAccessFlags DstAccess;
+        } Barrier;
         struct {
             u32 SubpassIndex;
         } NextSubpass;
@@ -317,6 +610,10 @@ config GetDefaultConfig(int Width, int Height);
 typedef enum queue_type {
     queue_GRAPHICS,
     queue_SURFACE,
+    // NOTE(blackedout): A transfer only family if the device has one, the graphics family otherwise
+    queue_TRANSFER,
+    // NOTE(blackedout): A compute only family if async compute was requested and can be used, the graphics family otherwise
+    queue_COMPUTE,
     queue_COUNT,
 } queue_type;
 
@@ -331,6 +628,24 @@ typedef struct device_info {
     VkPresentModeKHR BestPresentMode;
     VkSampleCountFlagBits MaxSampleCount;
     VmaAllocationCreateFlags VmaCreateFlags;
+    // NOTE(blackedout): 1 unless VK_EXT_vertex_attribute_divisor is enabled
+    u32 MaxVertexAttribDivisor;
+    int HasShaderDrawParameters;
+    // NOTE(blackedout): VK_KHR_draw_indirect_count, see `context.CmdDrawIndirectCount`
+    int HasDrawIndirectCount;
+    // NOTE(blackedout): 0 only on portability implementations without them, see `IsEmulatedPrimitive`
+    int HasTriangleFans;
+    // NOTE(blackedout): 0 unless VK_EXT_multi_draw is enabled, see `context.CmdDrawMulti`
+    u32 MaxMultiDrawCount;
+    // NOTE(blackedout): Set if `queue_COMPUTE` is a family of its own, which also requires VK_KHR_timeline_semaphore
+    int HasAsyncCompute;
+    // NOTE(blackedout): The distinct families of graphics, transfer and compute queues, buffers are shared between them
+    // concurrently if there is async compute
+    u32 SharedQueueFamilyIndices[queue_COUNT];
+    u32 SharedQueueFamilyIndexCount;
+    // NOTE(blackedout): VK_KHR_dynamic_rendering, render passes begin from the attachment views directly and there are no
+    // render pass or framebuffer objects, see `context.CmdBeginRendering`
+    int HasDynamicRendering;
 } device_info;
 
 enum {
@@ -342,18 +657,23 @@ enum {
 enum {
     semaphore_PREV_PRESENT_DONE = 0,
     semaphore_RENDER_COMPLETE,
+    semaphore_TRANSFER_COMPLETE,
     semaphore_COUNT,
 };
 
 enum {
     command_buffer_GRAPHICS = 0,
-    command_buffer_TRANSFER,
     command_buffer_GRAPHICS2,
+    // NOTE(blackedout): Buffers before this one are allocated from the graphics pool, this one from the transfer pool
+    command_buffer_TRANSFER,
+    // NOTE(blackedout): Only allocated (from the compute pool) if there is async compute
+    command_buffer_COMPUTE,
     command_buffer_COUNT,
 };
 
 enum {
     fence_TRANSFER = 0,
+    fence_IMMEDIATE,
     fence_COUNT,
 };
 
@@ -378,6 +698,9 @@ typedef enum gl_error_type {
     gl_error_UNIFORM_COUNT_NEGATIVE,
     gl_error_UNIFORM_NO_PROGRAM,
     gl_error_UNIFORM_INVALID_LOCATION,
+    gl_error_UNIFORM_SIZE_MISMATCH,
+    gl_error_UNIFORM_TYPE_MISMATCH,
+    gl_error_UNIFORM_COUNT_NOT_ARRAY,
 
     gl_error_VERTEX_ATTRIB_FORMAT_NONE_BOUND,
     gl_error_VERTEX_ARRAY_ATTRIB_FORMAT_VAO_INVALID,
@@ -404,6 +727,11 @@ typedef enum gl_error_type {
     gl_error_VERTEX_ARRAY_ATTRIB_BINDING_ATTRIB_INDEX,
     gl_error_VERTEX_ARRAY_ATTRIB_BINDING_BINDING_INDEX,
 
+    gl_error_VERTEX_BINDING_DIVISOR_NONE_BOUND,
+    gl_error_VERTEX_ARRAY_BINDING_DIVISOR_VAO_INVALID,
+    gl_error_VERTEX_BINDING_DIVISOR_INDEX,
+    gl_error_VERTEX_ATTRIB_DIVISOR_INDEX,
+
     gl_error_VERTEX_ATTRIB_POINTER_NONE_BOUND,
 
     gl_error_XABLE_VERTEX_ATTRIB_ARRAY_NONE_BOUND,
@@ -435,6 +763,90 @@ typedef enum gl_error_type {
     gl_error_SCISSOR_COUNT_NEGATIVE,
     gl_error_SCISSOR_WIDTH_HEIGHT_NEGATIVE,
 
+    gl_error_BUFFER_TARGET,
+    gl_error_BUFFER_TARGET_ZERO_BOUND,
+    gl_error_BUFFER_NAME_INVALID,
+
+    gl_error_MAP_BUFFER_ACCESS,
+    gl_error_MAP_BUFFER_RANGE_VALUE,
+    gl_error_MAP_BUFFER_RANGE_LENGTH_ZERO,
+    gl_error_MAP_BUFFER_RANGE_MAPPED,
+    gl_error_MAP_BUFFER_RANGE_NO_READ_WRITE,
+    gl_error_MAP_BUFFER_RANGE_READ_INVALIDATE,
+    gl_error_MAP_BUFFER_RANGE_FLUSH_NO_WRITE,
+    gl_error_UNMAP_BUFFER_NOT_MAPPED,
+    gl_error_FLUSH_MAPPED_BUFFER_RANGE_VALUE,
+    gl_error_FLUSH_MAPPED_BUFFER_RANGE_NOT_MAPPED,
+    gl_error_BUFFER_SUB_DATA_VALUE,
+    gl_error_BUFFER_SUB_DATA_MAPPED,
+    gl_error_BUFFER_SUB_DATA_IMMUTABLE,
+    gl_error_MAP_BUFFER_RANGE_STORAGE_FLAGS,
+    gl_error_BUFFER_DATA_SIZE,
+    gl_error_BUFFER_DATA_USAGE,
+    gl_error_BUFFER_DATA_IMMUTABLE,
+    gl_error_BUFFER_STORAGE_SIZE,
+    gl_error_BUFFER_STORAGE_FLAGS,
+    gl_error_BUFFER_STORAGE_PERSISTENT,
+    gl_error_BUFFER_STORAGE_COHERENT,
+    gl_error_BUFFER_STORAGE_IMMUTABLE,
+    gl_error_COPY_BUFFER_SUB_DATA_NEGATIVE,
+    gl_error_COPY_BUFFER_SUB_DATA_RANGE,
+    gl_error_COPY_BUFFER_SUB_DATA_OVERLAP,
+    gl_error_COPY_BUFFER_SUB_DATA_MAPPED,
+    gl_error_GET_BUFFER_SUB_DATA_VALUE,
+    gl_error_GET_BUFFER_SUB_DATA_MAPPED,
+    gl_error_READ_PIXELS_SIZE_NEGATIVE,
+    gl_error_READ_PIXELS_PACK_MAPPED,
+    gl_error_READ_PIXELS_PACK_RANGE,
+    gl_error_FENCE_SYNC_CONDITION,
+    gl_error_FENCE_SYNC_FLAGS,
+    gl_error_SYNC_INVALID,
+    gl_error_CLIENT_WAIT_SYNC_FLAGS,
+    gl_error_GET_SYNCIV_PNAME,
+    gl_error_GET_SYNCIV_COUNT,
+    gl_error_INVALIDATE_BUFFER_SUB_DATA_VALUE,
+    gl_error_INVALIDATE_BUFFER_MAPPED,
+    gl_error_INVALIDATE_FRAMEBUFFER_TARGET,
+    gl_error_INVALIDATE_FRAMEBUFFER_NAME,
+    gl_error_INVALIDATE_FRAMEBUFFER_NEGATIVE,
+    gl_error_INVALIDATE_FRAMEBUFFER_ATTACHMENT,
+    gl_error_INVALIDATE_FRAMEBUFFER_ATTACHMENT_DEFAULT,
+    gl_error_INVALIDATE_FRAMEBUFFER_COLOR_INDEX,
+    gl_error_DRAW_INSTANCE_COUNT_NEGATIVE,
+    gl_error_DRAW_ELEMENTS_TYPE,
+    gl_error_DRAW_RANGE_ELEMENTS_RANGE,
+    gl_error_DRAW_BUFFER_MAPPED,
+    gl_error_VERTEX_ARRAY_ELEMENT_BUFFER_VAO,
+    gl_error_VERTEX_ARRAY_ELEMENT_BUFFER_BUFFER,
+    gl_error_DRAW_INDIRECT_NO_BUFFER,
+    gl_error_DRAW_INDIRECT_ALIGNMENT,
+    gl_error_DRAW_INDIRECT_RANGE,
+    gl_error_MULTI_DRAW_DRAW_COUNT_NEGATIVE,
+    gl_error_MULTI_DRAW_INDIRECT_MAX_DRAW_COUNT_NEGATIVE,
+    gl_error_MULTI_DRAW_INDIRECT_STRIDE,
+    gl_error_MULTI_DRAW_INDIRECT_COUNT_NO_BUFFER,
+    gl_error_MULTI_DRAW_INDIRECT_COUNT_ALIGNMENT,
+    gl_error_MULTI_DRAW_INDIRECT_COUNT_RANGE,
+    gl_error_BIND_BUFFER_INDEXED_TARGET,
+    gl_error_BIND_BUFFER_INDEXED_INDEX,
+    gl_error_BIND_BUFFER_INDEXED_BUFFER,
+    gl_error_BIND_BUFFER_RANGE_SIZE,
+    gl_error_BIND_BUFFER_RANGE_OFFSET,
+    gl_error_SHADER_STORAGE_BUFFER_MAPPED,
+    gl_error_SHADER_STORAGE_BLOCK_BINDING_VALUE,
+    gl_error_DISPATCH_NO_PROGRAM,
+    gl_error_DISPATCH_GROUP_COUNT,
+    gl_error_DISPATCH_INDIRECT_NO_BUFFER,
+    gl_error_DISPATCH_INDIRECT_OFFSET,
+    gl_error_DISPATCH_INDIRECT_RANGE,
+    gl_error_DISPATCH_INDIRECT_MAPPED,
+    gl_error_MEMORY_BARRIER_BITS,
+    gl_error_BIND_IMAGE_TEXTURE_UNIT,
+    gl_error_BIND_IMAGE_TEXTURE_TEXTURE,
+    gl_error_BIND_IMAGE_TEXTURE_LEVEL_LAYER,
+    gl_error_BIND_IMAGE_TEXTURE_ACCESS,
+    gl_error_BIND_IMAGE_TEXTURE_FORMAT,
+
     gl_error_COUNT
 } gl_error_type;
 
@@ -464,6 +876,55 @@ typedef enum pipeline_state_type {
     pipeline_state_COUNT
 } pipeline_state_type;
 
+typedef struct staging_buffer {
+    VkBuffer Buffer;
+    VmaAllocation Allocation;
+} staging_buffer;
+
+// NOTE(blackedout): One persistently mapped host buffer that all uploads sub-allocate from. `Head` and `Tail` only ever increase,
+// the byte range [Tail, Head) (modulo `ByteCount`) is in use by the recording and in flight transfer batches.
+typedef struct staging_ring {
+    VkBuffer Buffer;
+    VmaAllocation Allocation;
+    u8 *Mapped;
+    u64 ByteCount;
+    u64 Head;
+    u64 Tail;
+    u64 InFlightHead;
+    // NOTE(blackedout): Start of the ranges the command stream of the frame copies from, `Tail` doesn't pass it before the frame is done
+    u64 StreamTail;
+    int HasStreamRanges;
+} staging_ring;
+
+typedef struct staging_allocation {
+    VkBuffer Buffer;
+    u64 Offset;
+    void *Mapped;
+} staging_allocation;
+
+// NOTE(blackedout): Every stage and access that may consume data written by a transfer batch
+#define TRANSFER_BATCH_CONSUMER_STAGES (VK_PIPELINE_STAGE_DRAW_INDIRECT_BIT | VK_PIPELINE_STAGE_VERTEX_INPUT_BIT | VK_PIPELINE_STAGE_VERTEX_SHADER_BIT | VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT | VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT | VK_PIPELINE_STAGE_TRANSFER_BIT)
+#define TRANSFER_BATCH_CONSUMER_ACCESS (VK_ACCESS_INDIRECT_COMMAND_READ_BIT | VK_ACCESS_INDEX_READ_BIT | VK_ACCESS_VERTEX_ATTRIBUTE_READ_BIT | VK_ACCESS_UNIFORM_READ_BIT | VK_ACCESS_SHADER_READ_BIT | VK_ACCESS_TRANSFER_READ_BIT | VK_ACCESS_TRANSFER_WRITE_BIT)
+
+// NOTE(blackedout): Updates up to this size are stored in the command buffer by `vkCmdUpdateBuffer` (Vulkan allows up to 65536 bytes)
+#define MAX_INLINE_BUFFER_UPDATE_BYTE_COUNT (4096)
+#define IsInlineBufferUpdate(Offset, ByteCount) ((Offset) % 4 == 0 && (ByteCount) % 4 == 0 && (ByteCount) <= MAX_INLINE_BUFFER_UPDATE_BYTE_COUNT)
+// NOTE(blackedout): Buffer ranges written by a run of transfers that are tracked for hazards, more than that cost a barrier
+#define MAX_TRANSFER_RUN_WRITTEN_RANGE_COUNT (16)
+// NOTE(blackedout): Buffer ranges written by dispatches since the last memory barrier that are tracked for aliasing,
+// with more than that every dispatch consumes a pending barrier
+#define MAX_UNBARRIERED_WRITE_COUNT (32)
+// NOTE(blackedout): Buffer ranges of a frame that are checked for aliasing to tell which dispatches may run on the async
+// compute queue, frames with more than that run every dispatch on the graphics queue
+#define MAX_ASYNC_COMPUTE_RANGE_COUNT (256)
+// NOTE(blackedout): Buffer ranges written by shaders and pixel reads that are tracked while pending transfers are run ahead
+// of the stream, with more than that the remaining transfers stay in the stream
+#define MAX_FLUSH_BLOCKING_WRITE_COUNT (64)
+// NOTE(blackedout): Async dispatches are waited on by the next graphics work that may consume their writes
+#define ASYNC_COMPUTE_CONSUMER_STAGES (VK_PIPELINE_STAGE_DRAW_INDIRECT_BIT | VK_PIPELINE_STAGE_VERTEX_INPUT_BIT | VK_PIPELINE_STAGE_VERTEX_SHADER_BIT | VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT | VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT | VK_PIPELINE_STAGE_TRANSFER_BIT)
+// NOTE(blackedout): Vertex buffer bindings below this index are tracked during replay to skip redundant binds
+#define MAX_TRACKED_VERTEX_BINDING_COUNT (32)
+
 typedef struct pipeline_state_info {
     u32 ByteOffset;
     u32 InstaceByteCount;
@@ -477,12 +938,32 @@ typedef struct context {
     u64 NextFreeObjectIndex;
 
     array Commands;
+    // NOTE(blackedout): Inline data of `command_UPDATE_BUFFER`
+    array(u8) CommandData;
+    // NOTE(blackedout): Draw ranges of `command_MULTI_DRAW*`, see `MultiDraw`
+    array(u8) MultiDrawData;
+    VkBuffer MultiDrawBuffer;
+    VmaAllocation MultiDrawAllocation;
+    void *MultiDrawMapped;
+    u64 MultiDrawBufferByteCount;
+    array(primitive_index_buffer) PrimitiveIndexBuffers;
+    array(render_pass_cache_entry) RenderPasses;
+    array(u8) TmpRenderPassKey;
+    // NOTE(blackedout): Storage descriptor sets of the current frame, pools from `StorageDescriptorPoolIndex` on have room
+    array(VkDescriptorPool) StorageDescriptorPools;
+    u32 StorageDescriptorPoolIndex;
+    // NOTE(blackedout): Transfer and dispatch commands can't be recorded inside a render pass, they are inserted in front of it
+    int IsRenderPassRecorded;
+    u32 RenderPassCommandIndex;
+    GLuint RenderPassFbo;
 
     GLenum ErrorFlag;
     GLDEBUGPROC DebugCallback;
     const void *DebugCallbackUser;
 
     GLuint BoundBuffers[BUFFER_TARGET_COUNT];
+    indexed_buffer_binding ShaderStorageBindings[SHADER_STORAGE_BINDING_COUNT];
+    image_unit_binding ImageUnits[IMAGE_UNIT_COUNT];
     GLuint BoundFramebuffers[framebuffer_COUNT];
     GLuint BoundTextures[TEXTURE_TARGET_COUNT*TEXTURE_SLOT_COUNT];
     u32 ActiveTextureIndex;
@@ -498,6 +979,13 @@ typedef struct context {
     VkSurfaceKHR Surface;
     VkDevice Device;
     device_info DeviceInfo;
+    PFN_vkCmdDrawIndirectCountKHR CmdDrawIndirectCount;
+    PFN_vkCmdDrawIndexedIndirectCountKHR CmdDrawIndexedIndirectCount;
+    PFN_vkCmdDrawMultiEXT CmdDrawMulti;
+    PFN_vkCmdDrawMultiIndexedEXT CmdDrawMultiIndexed;
+    PFN_vkWaitSemaphoresKHR WaitSemaphores;
+    PFN_vkCmdBeginRenderingKHR CmdBeginRendering;
+    PFN_vkCmdEndRenderingKHR CmdEndRendering;
     VmaAllocator Allocator;
     VkSwapchainKHR Swapchain;
     u32 SwapchainImageCount;
@@ -505,6 +993,8 @@ typedef struct context {
     VkImageView *SwapchainImageViews;
     VkFramebuffer *SwapchainFramebuffers;
     VkCommandPool GraphicsCommandPool;
+    VkCommandPool TransferCommandPool;
+    VkCommandPool ComputeCommandPool;
     u64 SwapCounter;
 
     u32 SemaphoreCount;
@@ -513,6 +1003,29 @@ typedef struct context {
     VkCommandBuffer CommandBuffers[command_buffer_COUNT];
     VkFence Fences[fence_COUNT];
 
+    // NOTE(blackedout): Set from the create params before the device is picked, see `device_info.HasAsyncCompute`
+    int IsAsyncComputeRequested;
+    // NOTE(blackedout): Signaled by transfer batches and async dispatches with increasing values. Dispatches wait on the
+    // value of the last transfer batch, graphics work on the value of the last dispatches it hasn't waited on yet.
+    VkSemaphore ComputeTimeline;
+    u64 ComputeTimelineValue;
+    u64 TransferTimelineValue;
+    u64 UnwaitedComputeTimelineValue;
+
+    // NOTE(blackedout): Uploads of a frame are recorded into `command_buffer_TRANSFER` and submitted once by `cuglSwapBuffers`
+    int IsTransferBatchRecording;
+    int IsTransferBatchInFlight;
+    array(staging_buffer) RecordingStagingBuffers;
+    array(staging_buffer) InFlightStagingBuffers;
+    staging_ring StagingRing;
+    u64 MaxStagingByteCount;
+    // NOTE(blackedout): Buffer memory that was replaced while commands of the current frame still reference it
+    array(buffer_copy) RetiredBuffers;
+    array(buffer_pool) BufferPools;
+    // NOTE(blackedout): If uploads run on a dedicated transfer family, every buffer written by a batch is released by it and
+    // acquired by the graphics family at the start of the next graphics command buffer.
+    array(VkBufferMemoryBarrier) PendingAcquireBarriers;
+
     pipeline_state_info PipelineStateInfos[pipeline_state_COUNT];
     u32 PipelineStateByteCount;
     // NOTE(blackedout): [0] is always the current pipeline state
@@ -522,10 +1035,17 @@ typedef struct context {
     u32 LastPipelineIndex;
     u32 LastUniformIndex;
 
+    frame_stats FrameStats;
+    frame_stats LastFrameStats;
+
     array TmpSubpasses;
+    array(VkClearValue) TmpClearValues;
+    array(command) TmpCommands;
+    array(VkRenderingAttachmentInfoKHR) TmpRenderingAttachments;
 
     VkVertexInputBindingDescription *VertexInputBindingDescriptions;
     VkVertexInputAttributeDescription *VertexInputAttributeDescriptions;
+    VkVertexInputBindingDivisorDescriptionEXT *VertexInputBindingDivisorDescriptions;
 } context;
 
 int AcquireContext(context **OutC, const char *Name);
@@ -538,6 +1058,9 @@ void GenerateOther(context *C, GLenum Source, const char *Msg);
 int RequireRoomForNewObjects(context *C, u64 Count);
 int RequireRoomForNewCommands(context *C, u64 Count);
 int PushCommand(context *C, command Command);
+// NOTE(blackedout): Ranges of size VK_WHOLE_SIZE extend to the end of their buffer
+VkDescriptorBufferInfo MakeBufferRange(VkBuffer Buffer, u64 Offset, u64 Range);
+int IsBufferRangeAliased(VkDescriptorBufferInfo A, VkDescriptorBufferInfo B);
 
 // NOTE(blackedout): Return the handle of and pointer to a new zeroed out object.
 // IMPORTANT: The caller must ensure there is enough space to perform this operation voa `ArrayRequireRoom`.
@@ -565,6 +1088,8 @@ int HandledCheckShaderGet(context *C, GLuint H, object **OutObject, const char *
 void SetVertexInputAttributeFormat(context *C, object *Object, int IsCurrent, u32 Index, GLint Size, GLenum Type, GLuint RelativeOffset, u32 IntegerHandlingBits, const char *Name);
 void SetVertexInputBinding(context *C, object *Object, int IsCurrent, u32 Index, GLuint Vbo, GLintptr Offset, GLsizei Stride, const char *Name);
 void SetVertexInputAttributeBinding(context *C, object *Object, int IsCurrent, u32 AttributeIndex, u32 BindingIndex, const char *Name);
+void SetVertexInputBindingDivisor(context *C, object *Object, int IsCurrent, u32 Index, GLuint Divisor, const char *Name);
+void SetCurrentVertexInputBindings(context *C, object *Object);
 void SetVertexInputAttributePointer(context *C, object *Object, u32 Index, GLint Size, GLenum Type, GLsizei Stride, const void *Pointer, u32 IntegerHandlingBits, const char *Name);
 void SetVertexInputAttributeEnabled(context *C, object *Object, int IsCurrent, GLuint Index, int IsEnabled, const char *Name);
 
@@ -572,12 +1097,66 @@ void NoContextGenObjects(GLsizei Count, object_type Type, GLuint *OutHandles, co
 void NoContextCreateObjects(GLsizei Count, object_type Type, GLuint *OutHandles, const char *Name);
 GLboolean NoContextIsObjectType(GLuint H, object_type Type, const char *Name);
 void NoContextSetUniformData(GLint Location, const void *Bytes, u32 Num, GLsizei Count, GLenum Type, const char *Name);
+void NoContextSetUniformMatrixData(GLint Location, const void *Bytes, u32 ColumnCount, u32 RowCount, GLsizei Count, GLboolean Transpose, GLenum Type, const char *Name);
 
 void HandledCheckCapSet(context *C, GLenum Cap, int Enabled);
 int VulkanCheck(context *C, VkResult Result, const char *Call);
 
+int BeginTransferBatch(context *C, VkCommandBuffer *OutCommandBuffer);
+int PushStagingBuffer(context *C, VkBuffer Buffer, VmaAllocation Allocation);
+int AllocateStaging(context *C, u64 ByteCount, u64 Alignment, int IsStreamed, staging_allocation *OutAllocation);
+void ReleaseStreamStaging(context *C);
+int ReleaseUploadedBuffer(context *C, VkCommandBuffer TransferCommandBuffer, VkBuffer Buffer, u64 Offset, u64 ByteCount);
+void AcquireUploadedBuffers(context *C, VkCommandBuffer GraphicsCommandBuffer);
+int SubmitTransferBatch(context *C, VkQueue Queue, VkSemaphore *OutSignalSemaphore);
+int RecycleTransferBatch(context *C, int DoWait);
+
+int BeginImmediateCommands(context *C, VkCommandBuffer *OutCommandBuffer);
+int SubmitImmediateCommands(context *C);
+
+int HandledCheckBufferTargetGet(context *C, GLenum Target, object **OutObject, const char *Name);
+int HandledCheckBufferGet(context *C, GLuint H, object **OutObject, const char *Name);
+int HandledCheckSyncGet(context *C, GLsync Sync, object **OutObject, const char *Name);
+int RetireBufferMemory(context *C, VkBuffer Buffer, VmaAllocation Allocation);
+void DestroyRetiredBuffers(context *C);
+int RecordBufferUpload(context *C, VkBuffer Buffer, u64 Offset, const void *Data, u64 ByteCount);
+int RenameBufferMemory(context *C, object *Object, u32 MemoryFlags, int PreserveContents);
+int ReleaseBufferMemory(context *C, object *Object);
+void RecycleBufferCopies(context *C, object *Object);
+void BufferData(context *C, object *Object, GLsizeiptr Size, const void *Data, GLenum Usage, VkBufferUsageFlags VulkanUsage, const char *Name);
+void BufferStorage(context *C, object *Object, GLsizeiptr Size, const void *Data, GLbitfield Flags, VkBufferUsageFlags VulkanUsage, const char *Name);
+void BufferSubData(context *C, object *Object, GLintptr Offset, GLsizeiptr Size, const void *Data, const char *Name);
+void CopyBufferSubData(context *C, object *Read, object *Write, GLintptr ReadOffset, GLintptr WriteOffset, GLsizeiptr Size, const char *Name);
+void GetBufferSubData(context *C, object *Object, GLintptr Offset, GLsizeiptr Size, void *Data, const char *Name);
+void InvalidateBufferSubData(context *C, object *Object, GLintptr Offset, GLsizeiptr Length, const char *Name);
+void ReadPixels(context *C, GLint X, GLint Y, GLsizei Width, GLsizei Height, GLenum Format, GLenum Type, void *Pixels, const char *Name);
+void *MapBufferRange(context *C, object *Object, GLintptr Offset, GLsizeiptr Length, GLbitfield Access, const char *Name);
+GLboolean UnmapBuffer(context *C, object *Object, const char *Name);
+void FlushMappedBufferRange(context *C, object *Object, GLintptr Offset, GLsizeiptr Length, const char *Name);
+void BindBufferRange(context *C, GLenum Target, GLuint Index, GLuint Buffer, GLintptr Offset, GLsizeiptr Size, int IsRange, const char *Name);
+
+void ReleaseRenderPass(context *C, VkRenderPass RenderPass);
+void EvictRenderPasses(context *C);
+VkAttachmentLoadOp GetAttachmentLoadOp(GLuint Fbo, u32 ClearLoadMask, u32 DiscardLoadMask, u32 Index);
+VkAttachmentStoreOp GetAttachmentStoreOp(u32 DiscardStoreMask, u32 Index);
 int CheckFramebuffer(context *C, GLuint Fbo);
 int PotentiallySaveSubpass(context *C, u32 *OutSubpassIndex);
+void Clear(context *C, GLbitfield Mask, const char *Name);
+void InvalidateFramebuffer(context *C, GLuint Fbo, GLsizei Count, const GLenum *Attachments, GLint X, GLint Y, GLsizei Width, GLsizei Height, const char *Name);
+int RecordDrawState(context *C, GLenum Mode);
+void DrawArrays(context *C, GLenum Mode, GLint First, GLsizei Count, GLsizei InstanceCount, GLuint BaseInstance, const char *Name);
+void DrawElements(context *C, GLenum Mode, GLsizei Count, GLenum Type, const void *Indices, GLsizei InstanceCount, GLint BaseVertex, GLuint BaseInstance, const char *Name);
+void DrawIndirect(context *C, GLenum Mode, GLenum Type, const void *Indirect, GLsizei DrawCount, int HasCountBuffer, GLintptr CountOffset, GLsizei Stride, const char *Name);
+void MultiDraw(context *C, GLenum Mode, GLenum Type, const GLint *Firsts, const GLsizei *Counts, const void *const *Indices, const GLint *BaseVertices, GLsizei DrawCount, const char *Name);
+u32 GetMultiDrawRecordByteCount(context *C, int IsIndexed);
+int UploadMultiDrawData(context *C);
+int IsEmulatedPrimitive(context *C, GLenum Mode);
+void EvictPrimitiveIndexBuffers(context *C);
+void ResetStorageDescriptorPools(context *C);
+int CreateComputePipeline(context *C, object *Object, VkShaderModule Module);
+void DispatchCompute(context *C, GLuint GroupCountX, GLuint GroupCountY, GLuint GroupCountZ, int IsIndirect, GLintptr Indirect, const char *Name);
+void PushMemoryBarrier(context *C, GLbitfield Barriers, int IsByRegion, const char *Name);
+void BindImageTexture(context *C, GLuint Unit, GLuint Texture, GLint Level, GLboolean Layered, GLint Layer, GLenum Access, GLenum Format, const char *Name);
 
 typedef struct pipeline_state_header {
     int IsCreated;
@@ -609,6 +1188,8 @@ typedef vertex_array_attribute pipeline_state_vertex_input_attribute;
 typedef struct pipeline_state_vertex_input_binding {
     int IsEnabled;
     GLsizei Stride;
+    // NOTE(blackedout): 0 advances per vertex, anything else every `Divisor` instances
+    GLuint Divisor;
 } pipeline_state_vertex_input_binding;
 
 typedef struct pipeline_state_program {
@@ -641,6 +1222,7 @@ void CopyPipelineStateFromPtr(context *C, u64 DstStateIndex, void *SrcState, pip
 
 int UseCurrentPipelineState(context *C, u32 Count, pipeline_state_type *Types);
 void SetDefaultPipelineState(context *C, u32 PipelineIndex);
+int UploadProgramUniforms(context *C, GLuint Program);
 int CheckPipeline(context *C, u32 Index);
 
 // NOTE(blackedout):
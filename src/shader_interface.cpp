@@ -72,6 +72,9 @@ struct glsl_type_info {
     const char *Name;
     uint32_t ByteCount;
     uint32_t ByteAlignment;
+    uint32_t ColumnCount;
+    uint32_t RowCount;
+    uint32_t ScalarByteCount;
 };
 
 // NOTE(blackedout): 16.9.4 - https://registry.khronos.org/vulkan/specs/latest/html/vkspec.html#interfaces-resources-layout (2025-11-25)
@@ -79,51 +82,64 @@ struct glsl_type_info {
 #define FLOAT_ALIGNMENT 4
 #define INT_ALIGNMENT 4
 #define UINT_ALIGNMENT 4
+// NOTE(blackedout): std140: Matrix columns (and array elements) are rounded up to the base alignment of a vec4
+#define STD140_ALIGNMENT 16
 
 // TODO(blackedout): Verify these
 static glsl_type_info GlslTypeInfos[] = {
-    [glsl_type_NONE] = { "", 0, 0 },
-    [glsl_type_VOID] = { "void", 0, 0 },
-
-    [glsl_type_DOUBLE] = { "double", 8, DOUBLE_ALIGNMENT },
-    [glsl_type_FLOAT] = { "float", 4, FLOAT_ALIGNMENT },
-    [glsl_type_INT] = { "int", 4, INT_ALIGNMENT },
-    [glsl_type_UINT] = { "uint", 4, UINT_ALIGNMENT },
-
-    [glsl_type_DVEC2] = { "dvec2", 16, 2*DOUBLE_ALIGNMENT },
-    [glsl_type_VEC2] = { "vec2", 8, 2*FLOAT_ALIGNMENT },
-    [glsl_type_IVEC2] = { "ivec2", 8, 2*INT_ALIGNMENT },
-    [glsl_type_UVEC2] = { "uvec2", 8, 2*UINT_ALIGNMENT },
-    [glsl_type_DVEC3] = { "dvec3", 24, 4*DOUBLE_ALIGNMENT },
-    [glsl_type_VEC3] = { "vec3", 12, 4*FLOAT_ALIGNMENT },
-    [glsl_type_IVEC3] = { "ivec3", 12, 4*INT_ALIGNMENT },
-    [glsl_type_UVEC3] = { "uvec3", 12, 4*UINT_ALIGNMENT },
-    [glsl_type_DVEC4] = { "dvec4", 32, 4*DOUBLE_ALIGNMENT },
-    [glsl_type_VEC4] = { "vec4", 16, 4*FLOAT_ALIGNMENT },
-    [glsl_type_IVEC4] = { "ivec4", 16, 4*INT_ALIGNMENT },
-    [glsl_type_UVEC4] = { "uvec4", 16, 4*UINT_ALIGNMENT },
+    [glsl_type_NONE] = { "", 0, 0, 0, 0, 0 },
+    [glsl_type_VOID] = { "void", 0, 0, 0, 0, 0 },
+
+    [glsl_type_DOUBLE] = { "double", 8, DOUBLE_ALIGNMENT, 1, 1, 8 },
+    [glsl_type_FLOAT] = { "float", 4, FLOAT_ALIGNMENT, 1, 1, 4 },
+    [glsl_type_INT] = { "int", 4, INT_ALIGNMENT, 1, 1, 4 },
+    [glsl_type_UINT] = { "uint", 4, UINT_ALIGNMENT, 1, 1, 4 },
+
+    [glsl_type_DVEC2] = { "dvec2", 16, 2*DOUBLE_ALIGNMENT, 1, 2, 8 },
+    [glsl_type_VEC2] = { "vec2", 8, 2*FLOAT_ALIGNMENT, 1, 2, 4 },
+    [glsl_type_IVEC2] = { "ivec2", 8, 2*INT_ALIGNMENT, 1, 2, 4 },
+    [glsl_type_UVEC2] = { "uvec2", 8, 2*UINT_ALIGNMENT, 1, 2, 4 },
+    [glsl_type_DVEC3] = { "dvec3", 24, 4*DOUBLE_ALIGNMENT, 1, 3, 8 },
+    [glsl_type_VEC3] = { "vec3", 12, 4*FLOAT_ALIGNMENT, 1, 3, 4 },
+    [glsl_type_IVEC3] = { "ivec3", 12, 4*INT_ALIGNMENT, 1, 3, 4 },
+    [glsl_type_UVEC3] = { "uvec3", 12, 4*UINT_ALIGNMENT, 1, 3, 4 },
+    [glsl_type_DVEC4] = { "dvec4", 32, 4*DOUBLE_ALIGNMENT, 1, 4, 8 },
+    [glsl_type_VEC4] = { "vec4", 16, 4*FLOAT_ALIGNMENT, 1, 4, 4 },
+    [glsl_type_IVEC4] = { "ivec4", 16, 4*INT_ALIGNMENT, 1, 4, 4 },
+    [glsl_type_UVEC4] = { "uvec4", 16, 4*UINT_ALIGNMENT, 1, 4, 4 },
+    // NOTE(blackedout): Bools take up a uint in uniform blocks
+    [glsl_type_BOOL] = { "bool", 4, UINT_ALIGNMENT, 1, 1, 4 },
+    [glsl_type_BVEC2] = { "bvec2", 8, 2*UINT_ALIGNMENT, 1, 2, 4 },
+    [glsl_type_BVEC3] = { "bvec3", 12, 4*UINT_ALIGNMENT, 1, 3, 4 },
+    [glsl_type_BVEC4] = { "bvec4", 16, 4*UINT_ALIGNMENT, 1, 4, 4 },
 
     // NOTE(blackedout): NxM - N columns, M rows, stored in column major format
-    // mat2x3 = vec3[2] as far as the alignment is concerned
-    [glsl_type_MAT2] = { "mat2", 2*2*4, 2*FLOAT_ALIGNMENT },
-    [glsl_type_MAT2x2] = { "mat2x2", 2*2*4, 2*FLOAT_ALIGNMENT },
-    [glsl_type_MAT2x3] = { "mat2x3", 2*3*4, 4*FLOAT_ALIGNMENT },
-    [glsl_type_MAT2x4] = { "mat2x4", 2*4*4, 4*FLOAT_ALIGNMENT },
-    [glsl_type_MAT3] = { "mat3", 3*3*4, 4*FLOAT_ALIGNMENT },
-    [glsl_type_MAT3x3] = { "mat3x3", 3*3*4, 4*FLOAT_ALIGNMENT },
-    [glsl_type_MAT3x4] = { "mat3x4", 3*4*4, 4*FLOAT_ALIGNMENT },
-    [glsl_type_MAT4] = { "mat4", 4*4*4, 4*FLOAT_ALIGNMENT },
-    [glsl_type_MAT4x4] = { "mat4x4", 4*4*4, 4*FLOAT_ALIGNMENT },
-
-    [glsl_type_DMAT2] = { "dmat2", 2*2*8, 2*DOUBLE_ALIGNMENT },
-    [glsl_type_DMAT2x2] = { "dmat2x2", 2*2*8, 2*DOUBLE_ALIGNMENT },
-    [glsl_type_DMAT2x3] = { "dmat2x3", 2*3*8, 4*DOUBLE_ALIGNMENT },
-    [glsl_type_DMAT2x4] = { "dmat2x4", 2*4*8, 4*DOUBLE_ALIGNMENT },
-    [glsl_type_DMAT3] = { "dmat3", 3*3*8, 4*DOUBLE_ALIGNMENT },
-    [glsl_type_DMAT3x3] = { "dmat3x3", 3*3*8, 4*DOUBLE_ALIGNMENT },
-    [glsl_type_DMAT3x4] = { "dmat3x4", 3*4*8, 4*DOUBLE_ALIGNMENT },
-    [glsl_type_DMAT4] = { "dmat4", 4*4*8, 4*DOUBLE_ALIGNMENT },
-    [glsl_type_DMAT4x4] = { "dmat4x4", 4*4*8, 4*DOUBLE_ALIGNMENT },
+    // mat2x3 = vec3[2] as far as the alignment is concerned, so in std140 every column takes up (at least) 16 bytes
+    [glsl_type_MAT2] = { "mat2", 2*16, STD140_ALIGNMENT, 2, 2, 4 },
+    [glsl_type_MAT2x2] = { "mat2x2", 2*16, STD140_ALIGNMENT, 2, 2, 4 },
+    [glsl_type_MAT2x3] = { "mat2x3", 2*16, STD140_ALIGNMENT, 2, 3, 4 },
+    [glsl_type_MAT2x4] = { "mat2x4", 2*16, STD140_ALIGNMENT, 2, 4, 4 },
+    [glsl_type_MAT3] = { "mat3", 3*16, STD140_ALIGNMENT, 3, 3, 4 },
+    [glsl_type_MAT3x2] = { "mat3x2", 3*16, STD140_ALIGNMENT, 3, 2, 4 },
+    [glsl_type_MAT3x3] = { "mat3x3", 3*16, STD140_ALIGNMENT, 3, 3, 4 },
+    [glsl_type_MAT3x4] = { "mat3x4", 3*16, STD140_ALIGNMENT, 3, 4, 4 },
+    [glsl_type_MAT4] = { "mat4", 4*16, STD140_ALIGNMENT, 4, 4, 4 },
+    [glsl_type_MAT4x2] = { "mat4x2", 4*16, STD140_ALIGNMENT, 4, 2, 4 },
+    [glsl_type_MAT4x3] = { "mat4x3", 4*16, STD140_ALIGNMENT, 4, 3, 4 },
+    [glsl_type_MAT4x4] = { "mat4x4", 4*16, STD140_ALIGNMENT, 4, 4, 4 },
+
+    [glsl_type_DMAT2] = { "dmat2", 2*16, STD140_ALIGNMENT, 2, 2, 8 },
+    [glsl_type_DMAT2x2] = { "dmat2x2", 2*16, STD140_ALIGNMENT, 2, 2, 8 },
+    [glsl_type_DMAT2x3] = { "dmat2x3", 2*32, 4*DOUBLE_ALIGNMENT, 2, 3, 8 },
+    [glsl_type_DMAT2x4] = { "dmat2x4", 2*32, 4*DOUBLE_ALIGNMENT, 2, 4, 8 },
+    [glsl_type_DMAT3] = { "dmat3", 3*32, 4*DOUBLE_ALIGNMENT, 3, 3, 8 },
+    [glsl_type_DMAT3x2] = { "dmat3x2", 3*16, STD140_ALIGNMENT, 3, 2, 8 },
+    [glsl_type_DMAT3x3] = { "dmat3x3", 3*32, 4*DOUBLE_ALIGNMENT, 3, 3, 8 },
+    [glsl_type_DMAT3x4] = { "dmat3x4", 3*32, 4*DOUBLE_ALIGNMENT, 3, 4, 8 },
+    [glsl_type_DMAT4] = { "dmat4", 4*32, 4*DOUBLE_ALIGNMENT, 4, 4, 8 },
+    [glsl_type_DMAT4x2] = { "dmat4x2", 4*16, STD140_ALIGNMENT, 4, 2, 8 },
+    [glsl_type_DMAT4x3] = { "dmat4x3", 4*32, 4*DOUBLE_ALIGNMENT, 4, 3, 8 },
+    [glsl_type_DMAT4x4] = { "dmat4x4", 4*32, 4*DOUBLE_ALIGNMENT, 4, 4, 8 },
 };
 StaticAssert(ArrayCount(GlslTypeInfos) == glsl_type_COUNT);
 
@@ -138,15 +154,24 @@ const char *StorageQualifierStrings[] = {
     [storage_qualifier_OUT] = "out",
     [storage_qualifier_UNIFORM] = "uniform",
     [storage_qualifier_CONST] = "const",
+    [storage_qualifier_SHARED] = "shared",
 };
 StaticAssert(ArrayCount(StorageQualifierStrings) == storage_qualifier_COUNT);
 
+const char *MemoryQualifierStrings[] = {
+    "coherent", "volatile", "restrict", "readonly", "writeonly",
+};
+
 struct variable_layout {
     int LocationSet = 0;
     int BindingSet = 0;
     //uint32_t StdTokenIndex;
     uint32_t Location;
     uint32_t Binding;
+    // NOTE(blackedout): Token of the opening parenthesis and token range of the binding value, used to rewrite the layout
+    uint32_t OpenTokenIndex;
+    uint32_t BindingStartTokenIndex;
+    uint32_t BindingEndTokenIndex;
 };
 
 struct variable {
@@ -161,12 +186,24 @@ struct variable {
     uint32_t TokenLength;
 };
 
+// NOTE(blackedout): A `buffer` interface block, the members are not parsed
+struct storage_block_declaration {
+    int LayoutSet;
+    variable_layout Layout;
+    int IsReadOnly;
+    uint32_t NameTokenIndex;
+
+    uint32_t StartTokenIndex;
+    uint32_t TokenLength;
+};
+
 struct parsed_shader {
     int HasProfileDefinition;
     uint32_t ProfileTokenIndex;
     uint32_t VersionEndTokenIndex;
     uint32_t UniformCount;
     std::vector<variable> GlobalVariables;
+    std::vector<storage_block_declaration> StorageBlocks;
 };
 
 // MARK: Lex functions
@@ -436,6 +473,7 @@ static int ParseLayout(const std::vector<token> &Tokens, uint32_t *InOutTokenInd
     uint64_t Num = 0;
     int IsNegative = 0;
     TrueOrReturn1(I < Tokens.size() && Tokens[I].Start[0] == '(');
+    Layout.OpenTokenIndex = I;
     ++I;
     while(I < Tokens.size()) {
         if(Tokens[I].Type == token_SINGLE) {
@@ -459,13 +497,17 @@ static int ParseLayout(const std::vector<token> &Tokens, uint32_t *InOutTokenInd
                 ++I;
                 TrueOrReturn1(I < Tokens.size() && Tokens[I].Start[0] == '=');
                 ++I;
+                Layout.BindingStartTokenIndex = I;
                 ZeroOrReturn1(ParseInt(Tokens, &I, &Num, &IsNegative));
+                Layout.BindingEndTokenIndex = I;
                 Layout.Binding = Num;
                 Layout.BindingSet = 1;
             } else {
-                // NOTE(blackedout): Unknown layout specifier
-                Assert(0);
+                // NOTE(blackedout): Other specifiers (e.g. std430 or local_size_x = 64) are passed through unchanged
                 ++I;
+                while(I < Tokens.size() && (Tokens[I].Type != token_SINGLE || (Tokens[I].Start[0] != ',' && Tokens[I].Start[0] != ')'))) {
+                    ++I;
+                }
             }
         }
     }
@@ -659,6 +701,79 @@ static int ParseFunction(const std::vector<token> &Tokens, uint32_t *InOutTokenI
     return 0;
 }
 
+static int ParseStorageBlock(const std::vector<token> &Tokens, uint32_t *InOutTokenIndex, storage_block_declaration &OutBlock) {
+    storage_block_declaration Block = {};
+
+    uint32_t I = *InOutTokenIndex;
+    uint32_t StartI = I;
+    uint32_t MatchIndex = 0;
+    while(I < Tokens.size() && Tokens[I].Type == token_NAME) {
+        if(TokenEquals(Tokens[I], "layout")) {
+            ++I;
+            ZeroOrReturn1(ParseLayout(Tokens, &I, Block.Layout));
+            Block.LayoutSet = 1;
+        } else if(TokenEqualsAnyString(Tokens[I], MemoryQualifierStrings, ArrayCount(MemoryQualifierStrings), 0, &MatchIndex)) {
+            Block.IsReadOnly |= TokenEquals(Tokens[I], "readonly");
+            ++I;
+        } else {
+            break;
+        }
+    }
+
+    TrueOrReturn1(I < Tokens.size() && TokenEquals(Tokens[I], "buffer"));
+    ++I;
+    TrueOrReturn1(I < Tokens.size() && Tokens[I].Type == token_NAME);
+    Block.NameTokenIndex = I;
+    ++I;
+
+    TrueOrReturn1(I < Tokens.size() && Tokens[I].Type == token_SINGLE && Tokens[I].Start[0] == '{');
+    uint32_t CurlyDepth = 0;
+    do {
+        if(Tokens[I].Type == token_SINGLE) {
+            if(Tokens[I].Start[0] == '{') {
+                ++CurlyDepth;
+            } else if(Tokens[I].Start[0] == '}') {
+                --CurlyDepth;
+            }
+        }
+        ++I;
+    } while(I < Tokens.size() && CurlyDepth);
+    TrueOrReturn1(CurlyDepth == 0);
+
+    // NOTE(blackedout): Skip the optional instance name and its array dimensions
+    while(I < Tokens.size() && (Tokens[I].Type != token_SINGLE || Tokens[I].Start[0] != ';')) {
+        ++I;
+    }
+    TrueOrReturn1(I < Tokens.size());
+    ++I;
+
+    Block.StartTokenIndex = StartI;
+    Block.TokenLength = I - StartI;
+    OutBlock = Block;
+    *InOutTokenIndex = I;
+    return 0;
+}
+
+// NOTE(blackedout): Declarations like `layout(local_size_x = 64) in;` that only set a default layout
+static int ParseLayoutDeclaration(const std::vector<token> &Tokens, uint32_t *InOutTokenIndex) {
+    uint32_t I = *InOutTokenIndex;
+
+    TrueOrReturn1(I < Tokens.size() && TokenEquals(Tokens[I], "layout"));
+    ++I;
+    variable_layout Layout;
+    ZeroOrReturn1(ParseLayout(Tokens, &I, Layout));
+
+    const char *QualifierStrings[] = { "in", "out", "uniform", "buffer" };
+    uint32_t MatchIndex = 0;
+    TrueOrReturn1(I < Tokens.size() && Tokens[I].Type == token_NAME && TokenEqualsAnyString(Tokens[I], QualifierStrings, ArrayCount(QualifierStrings), 0, &MatchIndex));
+    ++I;
+    TrueOrReturn1(I < Tokens.size() && Tokens[I].Type == token_SINGLE && Tokens[I].Start[0] == ';');
+    ++I;
+
+    *InOutTokenIndex = I;
+    return 0;
+}
+
 static void ParseProgramGlobals(const std::vector<token> &Tokens, parsed_shader &OutParsed) {
     // NOTE(blackedout): Skip version first
     uint32_t I = 0;
@@ -679,14 +794,20 @@ static void ParseProgramGlobals(const std::vector<token> &Tokens, parsed_shader
         }
     }
     OutParsed.GlobalVariables.clear();
+    OutParsed.StorageBlocks.clear();
 
     variable Var;
+    storage_block_declaration Block;
     while(I < Tokens.size()) {
         if(0 == ParseVariable(Tokens, &I, Var)) {
             OutParsed.GlobalVariables.push_back(Var);
             if(Var.StorageQualifier == storage_qualifier_UNIFORM) {
                 ++OutParsed.UniformCount;
             }
+        } else if(0 == ParseStorageBlock(Tokens, &I, Block)) {
+            OutParsed.StorageBlocks.push_back(Block);
+        } else if(0 == ParseLayoutDeclaration(Tokens, &I)) {
+            // NOTE(blackedout): Passed through
         } else if(0 == ParseFunction(Tokens, &I)) {
             int X = 0;
         } else {
@@ -698,8 +819,18 @@ static void ParseProgramGlobals(const std::vector<token> &Tokens, parsed_shader
     return;
 }
 
-static void MakeVulkanCompatible(shader_type ShaderType, const std::vector<token> &Tokens, const parsed_shader &ParsedShader, std::string &Out, uniform_variable *Uniforms, uint32_t UniformCount) {
-    // NOTE(blackedout): IMPORTANT: `GlobalVariables` are expected to be in the order they are found in the program.
+static int FindStorageBlock(const token &NameToken, const storage_block *StorageBlocks, uint32_t StorageBlockCount, uint32_t *OutIndex) {
+    for(uint32_t I = 0; I < StorageBlockCount; ++I) {
+        if(TokenEquals(NameToken, StorageBlocks[I].Name)) {
+            *OutIndex = I;
+            return 0;
+        }
+    }
+    return 1;
+}
+
+static void MakeVulkanCompatible(shader_type ShaderType, const std::vector<token> &Tokens, const parsed_shader &ParsedShader, std::string &Out, uniform_variable *Uniforms, uint32_t UniformCount, const storage_block *StorageBlocks, uint32_t StorageBlockCount) {
+    // NOTE(blackedout): IMPORTANT: `GlobalVariables` and `StorageBlocks` are expected to be in the order they are found in the program.
 
     Out.clear();
     std::string &Result = Out;
@@ -713,15 +844,23 @@ static void MakeVulkanCompatible(shader_type ShaderType, const std::vector<token
 
     std::set<std::string> UniformNameSet;
     int HasUniformContents = 0;
-    std::string UniformString = "layout(binding=0) uniform ubo {\n";
+    // NOTE(blackedout): The explicit offsets make sure the block layout matches what the uniform setters write into the uniform buffer
+    std::string UniformString = "layout(std140, binding=0) uniform ubo {\n";
     for(uint32_t I = 0; I < UniformCount; ++I) {
         HasUniformContents = 1;
-        auto &Var = ParsedShader.GlobalVariables[Uniforms[I].VariableIndices[ShaderType]];
         glsl_type_info TypeInfo = GlslTypeInfos[Uniforms[I].Type];
         
+        UniformString += "layout(offset=";
+        UniformString += std::to_string(Uniforms[I].ByteOffset);
+        UniformString += ") ";
         UniformString.append(TypeInfo.Name);
         UniformString += ' ';
         UniformString.append(Uniforms[I].Name);
+        for(uint32_t J = 0; J < Uniforms[I].ArrayIndexCount; ++J) {
+            UniformString += '[';
+            UniformString += std::to_string(Uniforms[I].ArrayDimensions[J]);
+            UniformString += ']';
+        }
         UniformString += ';';
         UniformString += '\n';
 
@@ -729,6 +868,13 @@ static void MakeVulkanCompatible(shader_type ShaderType, const std::vector<token
     }
     UniformString += "} Ubo;\n";
 
+    // NOTE(blackedout): Draws that are split into single draws (without multiDrawIndirect) pass the index of their first draw,
+    // so gl_DrawID keeps counting across the split
+    int UsesDrawId = 0;
+    for(uint32_t I = ParsedShader.VersionEndTokenIndex; I < Tokens.size() && ShaderType == shader_VERTEX && UsesDrawId == 0; ++I) {
+        UsesDrawId = TokenEquals(Tokens[I], "gl_DrawID");
+    }
+
     const auto AppendTokensUntil = [&](uint32_t &I, uint32_t EndIndex) {
         for(; I < EndIndex; ++I) {
             const token &Token = Tokens[I];
@@ -741,6 +887,22 @@ static void MakeVulkanCompatible(shader_type ShaderType, const std::vector<token
                 if(It != UniformNameSet.end()) {
                     Result += "Ubo.";
                 }
+                // NOTE(blackedout): Vulkan GLSL has no gl_VertexID and gl_InstanceID. gl_VertexIndex includes the first vertex and
+                // base vertex like gl_VertexID does, but gl_InstanceIndex includes the base instance which gl_InstanceID does not.
+                // gl_DrawID and gl_BaseInstance are core in 460 and backed by shaderDrawParameters.
+                if(TokenString == "gl_VertexID") {
+                    Result += "gl_VertexIndex";
+                    LastTokenType = Token.Type;
+                    continue;
+                } else if(TokenString == "gl_InstanceID") {
+                    Result += "(gl_InstanceIndex - gl_BaseInstance)";
+                    LastTokenType = token_SINGLE;
+                    continue;
+                } else if(TokenString == "gl_DrawID" && UsesDrawId) {
+                    Result += "(gl_DrawID + CuglDraw.DrawIdBase)";
+                    LastTokenType = token_SINGLE;
+                    continue;
+                }
             }
             Result.append(Token.Start, Token.End);
             LastTokenType = Token.Type;
@@ -755,15 +917,48 @@ static void MakeVulkanCompatible(shader_type ShaderType, const std::vector<token
     if(HasUniformContents) {
         Result += UniformString;
     }
+    if(UsesDrawId) {
+        Result += "layout(push_constant) uniform cugl_draw {\nint DrawIdBase;\n} CuglDraw;\n";
+    }
+
+    // NOTE(blackedout): Storage blocks go into descriptor set 1, the binding of a block is its index in the program. The GL
+    // binding point is resolved when the descriptor set is written, so that it can be changed after linking.
+    const auto RewriteStorageBlockLayout = [&](uint32_t &I, const storage_block_declaration &Block) {
+        uint32_t BlockIndex = 0;
+        Assert(0 == FindStorageBlock(Tokens[Block.NameTokenIndex], StorageBlocks, StorageBlockCount, &BlockIndex));
+        std::string Binding = std::to_string(BlockIndex);
+        if(Block.LayoutSet == 0) {
+            AppendTokensUntil(I, Block.StartTokenIndex);
+            Result += "layout(set=1, binding=" + Binding + ") ";
+        } else if(Block.Layout.BindingSet) {
+            AppendTokensUntil(I, Block.Layout.OpenTokenIndex + 1);
+            Result += "set=1, ";
+            LastTokenType = token_SINGLE;
+            AppendTokensUntil(I, Block.Layout.BindingStartTokenIndex);
+            Result += Binding;
+            I = Block.Layout.BindingEndTokenIndex;
+        } else {
+            AppendTokensUntil(I, Block.Layout.OpenTokenIndex + 1);
+            Result += "set=1, binding=" + Binding + ", ";
+        }
+        LastTokenType = token_SINGLE;
+    };
 
     uint32_t TokenIndex = ParsedShader.VersionEndTokenIndex;
+    uint32_t BlockIndex = 0;
     for(uint32_t VarIndex = 0; VarIndex < ParsedShader.GlobalVariables.size(); ++VarIndex) {
         const variable &Var = ParsedShader.GlobalVariables[VarIndex];
+        for(; BlockIndex < ParsedShader.StorageBlocks.size() && ParsedShader.StorageBlocks[BlockIndex].StartTokenIndex < Var.StartTokenIndex; ++BlockIndex) {
+            RewriteStorageBlockLayout(TokenIndex, ParsedShader.StorageBlocks[BlockIndex]);
+        }
         if(Var.StorageQualifier == storage_qualifier_UNIFORM) {
             AppendTokensUntil(TokenIndex, Var.StartTokenIndex);
             TokenIndex += Var.TokenLength;
         }
     }
+    for(; BlockIndex < ParsedShader.StorageBlocks.size(); ++BlockIndex) {
+        RewriteStorageBlockLayout(TokenIndex, ParsedShader.StorageBlocks[BlockIndex]);
+    }
     AppendTokensUntil(TokenIndex, Tokens.size());
 }
 
@@ -926,11 +1121,20 @@ int GlslangProgramLink(glslang_program *Program) {
                 auto &Var = ParsedShader.GlobalVariables[I];
                 shader_variable DstVar = {
                     .Name = NameIt,
-                    .Location = Var.LayoutSet && Var.Layout.LocationSet ? (int)Var.Layout.Location : -1,
+                    .ArrayIndexCount = (uint32_t)Var.ArrayLengths.size(),
                     .ArrayLength = 1,
+                    .Location = Var.LayoutSet && Var.Layout.LocationSet ? (int)Var.Layout.Location : -1,
                     .StorageQualifier = Var.StorageQualifier,
                     .Type = Var.Type
                 };
+                if(DstVar.ArrayIndexCount > SHADER_MAX_ARRAY_DIMENSIONS) {
+                    return glslang_error_COMPILATION_FAILED;
+                }
+                // NOTE(blackedout): `ArrayLengths` is stored innermost dimension first
+                for(uint32_t K = 0; K < DstVar.ArrayIndexCount; ++K) {
+                    DstVar.ArrayDimensions[K] = Var.ArrayLengths[DstVar.ArrayIndexCount - 1 - K];
+                    DstVar.ArrayLength *= DstVar.ArrayDimensions[K];
+                }
                 token &NameToken = Tokens[Var.NameTokenIndex];
                 auto NameLength = NameToken.End - NameToken.Start;
                 memcpy(NameIt, NameToken.Start, NameLength);
@@ -975,7 +1179,9 @@ int GlslangProgramLink(glslang_program *Program) {
                         .LocationCount = (int)Var.ArrayLength,
                         .Name = Var.Name,
                         .Type = Var.Type,
+                        .ArrayIndexCount = Var.ArrayIndexCount,
                     };
+                    memcpy(NewUniformVariable.ArrayDimensions, Var.ArrayDimensions, sizeof(Var.ArrayDimensions));
                     Uniforms.push_back(NewUniformVariable);
                     UniformNames[NewUniformVariable.Name] = Uniforms.size() - 1;
                     UniformVariable = Uniforms.data() + (Uniforms.size() - 1);
@@ -1014,11 +1220,26 @@ int GlslangProgramLink(glslang_program *Program) {
         uint32_t UniformLocationCount = 0;
         for(auto &Uniform : Uniforms) {
             glsl_type_info TypeInfo = GlslTypeInfos[Uniform.Type];
-            if(ByteOffset % TypeInfo.ByteAlignment) {
-                ByteOffset += TypeInfo.ByteAlignment - (ByteOffset % TypeInfo.ByteAlignment);
+            uint32_t ByteAlignment = TypeInfo.ByteAlignment;
+            uint32_t ByteCount = TypeInfo.ByteCount;
+            Uniform.ColumnCount = TypeInfo.ColumnCount;
+            Uniform.RowCount = TypeInfo.RowCount;
+            Uniform.ScalarByteCount = TypeInfo.ScalarByteCount;
+            Uniform.MatrixStride = TypeInfo.ColumnCount > 1 ? TypeInfo.ByteCount/TypeInfo.ColumnCount : 0;
+            Uniform.ArrayStride = 0;
+            if(Uniform.ArrayIndexCount) {
+                // NOTE(blackedout): std140: Array elements are aligned like vec4s and the stride is a multiple of that
+                if(ByteAlignment < STD140_ALIGNMENT) {
+                    ByteAlignment = STD140_ALIGNMENT;
+                }
+                Uniform.ArrayStride = ByteAlignment*((ByteCount + ByteAlignment - 1)/ByteAlignment);
+                ByteCount = Uniform.ArrayStride*Uniform.LocationCount;
+            }
+            if(ByteOffset % ByteAlignment) {
+                ByteOffset += ByteAlignment - (ByteOffset % ByteAlignment);
             }
             Uniform.ByteOffset = ByteOffset;
-            ByteOffset += TypeInfo.ByteCount;
+            ByteOffset += ByteCount;
             UniformLocationCount += Uniform.LocationCount;
         }
         Program->UniformByteCount = ByteOffset;
@@ -1031,6 +1252,49 @@ int GlslangProgramLink(glslang_program *Program) {
         }
         Program->UniformCount = Uniforms.size();
         memcpy(Program->Uniforms, Uniforms.data(), Uniforms.size()*sizeof(uniform_variable));
+
+        // NOTE(blackedout): Storage blocks of the same name in different stages are the same block
+        std::vector<std::string> StorageBlockNames;
+        std::vector<storage_block> StorageBlocks;
+        uint32_t StorageBlockNameBufByteCount = 0;
+        for(uint32_t I = 0; I < shader_COUNT; ++I) {
+            for(auto &Block : ParsedShaders[I].StorageBlocks) {
+                const token &NameToken = ShaderTokens[I][Block.NameTokenIndex];
+                std::string BlockName(NameToken.Start, NameToken.End);
+                uint32_t J = 0;
+                while(J < StorageBlockNames.size() && StorageBlockNames[J] != BlockName) {
+                    ++J;
+                }
+                if(J == StorageBlockNames.size()) {
+                    StorageBlockNames.push_back(BlockName);
+                    StorageBlocks.push_back(storage_block{});
+                    StorageBlockNameBufByteCount += BlockName.length() + 1;
+                }
+                if(Block.LayoutSet && Block.Layout.BindingSet) {
+                    StorageBlocks[J].Binding = Block.Layout.Binding;
+                }
+                StorageBlocks[J].IsWritten |= Block.IsReadOnly == 0;
+            }
+        }
+        free(Program->StorageBlocks);
+        free(Program->StorageBlockNameBuf);
+        Program->StorageBlocks = 0;
+        Program->StorageBlockNameBuf = 0;
+        Program->StorageBlockCount = StorageBlocks.size();
+        if(StorageBlocks.size()) {
+            Program->StorageBlocks = (decltype(Program->StorageBlocks))calloc(StorageBlocks.size(), sizeof(storage_block));
+            Program->StorageBlockNameBuf = (decltype(Program->StorageBlockNameBuf))calloc(StorageBlockNameBufByteCount, 1);
+            if(Program->StorageBlocks == 0 || Program->StorageBlockNameBuf == 0) {
+                return glslang_error_OUT_OF_MEMORY;
+            }
+            char *NameIt = Program->StorageBlockNameBuf;
+            for(uint32_t I = 0; I < StorageBlocks.size(); ++I) {
+                memcpy(NameIt, StorageBlockNames[I].c_str(), StorageBlockNames[I].length());
+                StorageBlocks[I].Name = NameIt;
+                NameIt += StorageBlockNames[I].length() + 1;
+            }
+            memcpy(Program->StorageBlocks, StorageBlocks.data(), StorageBlocks.size()*sizeof(storage_block));
+        }
         for(uint32_t I = 0; I < shader_COUNT; ++I) {
             glslang_shader *Shader = Program->AttachedShaders[I];
             if(Shader == 0) {
@@ -1039,7 +1303,7 @@ int GlslangProgramLink(glslang_program *Program) {
 
             {
                 std::string Transformed;
-                MakeVulkanCompatible((shader_type)I, ShaderTokens[I], ParsedShaders[I], Transformed, Program->Uniforms, Program->UniformCount);
+                MakeVulkanCompatible((shader_type)I, ShaderTokens[I], ParsedShaders[I], Transformed, Program->Uniforms, Program->UniformCount, Program->StorageBlocks, Program->StorageBlockCount);
 
                 Shader->SourceLength = Transformed.length();
                 Shader->Source = (decltype(Shader->Source))calloc(Shader->SourceLength + 1, 1);
@@ -1094,6 +1358,8 @@ void GlslangProgramDelete(glslang_program *Program) {
 
     const auto GlslangProgram = (glslang::TProgram *)Program->Native;
     delete GlslangProgram;
+    free(Program->StorageBlocks);
+    free(Program->StorageBlockNameBuf);
     glslang_program EmptyProgram = {};
     *Program = EmptyProgram;
 }
@@ -13,6 +13,7 @@ typedef enum storage_qualifier {
     storage_qualifier_OUT,
     storage_qualifier_UNIFORM,
     storage_qualifier_CONST,
+    storage_qualifier_SHARED,
     storage_qualifier_COUNT
 } storage_qualifier;
 
@@ -37,15 +38,22 @@ typedef enum glsl_type {
     glsl_type_VEC4,
     glsl_type_IVEC4,
     glsl_type_UVEC4,
+    glsl_type_BOOL,
+    glsl_type_BVEC2,
+    glsl_type_BVEC3,
+    glsl_type_BVEC4,
 
     glsl_type_MAT2,
     glsl_type_MAT2x2,
     glsl_type_MAT2x3,
     glsl_type_MAT2x4,
     glsl_type_MAT3,
+    glsl_type_MAT3x2,
     glsl_type_MAT3x3,
     glsl_type_MAT3x4,
     glsl_type_MAT4,
+    glsl_type_MAT4x2,
+    glsl_type_MAT4x3,
     glsl_type_MAT4x4,
 
     glsl_type_DMAT2,
@@ -53,9 +61,12 @@ typedef enum glsl_type {
     glsl_type_DMAT2x3,
     glsl_type_DMAT2x4,
     glsl_type_DMAT3,
+    glsl_type_DMAT3x2,
     glsl_type_DMAT3x3,
     glsl_type_DMAT3x4,
     glsl_type_DMAT4,
+    glsl_type_DMAT4x2,
+    glsl_type_DMAT4x3,
     glsl_type_DMAT4x4,
     
     glsl_type_COUNT
@@ -89,10 +100,14 @@ typedef enum glslang_error_type {
     glslang_error_EXCEPTION,
 } glslang_error_type;
 
+#define SHADER_MAX_ARRAY_DIMENSIONS 4
+
 typedef struct shader_variable {
     const char *Name;
     uint32_t ArrayIndexCount;
     uint32_t ArrayLength;
+    // NOTE(blackedout): Outermost dimension first, e.g. `vec2[A][B] v[C][D]` is { C, D, A, B }
+    uint32_t ArrayDimensions[SHADER_MAX_ARRAY_DIMENSIONS];
     int Location;
     storage_qualifier StorageQualifier;
     glsl_type Type;
@@ -104,10 +119,28 @@ typedef struct uniform_variable {
     const char *Name;
     glsl_type Type;
     uint32_t ByteOffset;
+    // NOTE(blackedout): std140 layout of the uniform inside the uniform block. `MatrixStride` is the byte distance
+    // between two columns and zero for non-matrix types, `ArrayStride` is zero if the uniform is not an array.
+    uint32_t ColumnCount;
+    uint32_t RowCount;
+    uint32_t ScalarByteCount;
+    uint32_t MatrixStride;
+    uint32_t ArrayStride;
+    uint32_t ArrayIndexCount;
+    uint32_t ArrayDimensions[SHADER_MAX_ARRAY_DIMENSIONS];
     shader_flags VariableIndicesSet;
     uint32_t VariableIndices[shader_COUNT];
 } uniform_variable;
 
+typedef struct storage_block {
+    const char *Name;
+    // NOTE(blackedout): The GL binding point of the block. Its Vulkan binding in descriptor set 1 is the index of the block
+    // in `glslang_program.StorageBlocks`, see `MakeVulkanCompatible`.
+    uint32_t Binding;
+    // NOTE(blackedout): Zero if the block is `readonly` in every stage
+    uint32_t IsWritten;
+} storage_block;
+
 typedef struct glslang_shader {
     void *Native;
     const char *Source;
@@ -126,6 +159,9 @@ typedef struct glslang_program {
     uint32_t UniformCount;
     uint32_t UniformByteCount;
     uint32_t UniformLocationCount;
+    storage_block *StorageBlocks;
+    uint32_t StorageBlockCount;
+    char *StorageBlockNameBuf;
 } glslang_program;
 
 int GlslangShaderCreateAndParse(shader_type Type, const char *Source, uint64_t SourceLength, glslang_shader *OutShader);
@@ -0,0 +1,192 @@
+#include "internal.h"
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define UNIFORM_PACKING_SSE2 1
+#include <emmintrin.h>
+#endif
+#if defined(__AVX2__)
+#define UNIFORM_PACKING_AVX2 1
+#include <immintrin.h>
+#endif
+#if defined(__ARM_NEON) || defined(__ARM_NEON__)
+#define UNIFORM_PACKING_NEON 1
+#include <arm_neon.h>
+#endif
+
+// NOTE(blackedout): GL hands us elements that are tightly packed: `ColumnCount` columns of `RowCount` scalars in column major
+// order, or in row major order if transpose is set. The uniform buffer uses std140 where every matrix column starts at a
+// multiple of `MatrixStride` and every array element at a multiple of `ArrayStride` (see `GlslangProgramLink`).
+// Padding bytes are never written by the scalar path and always written as zero by the SIMD paths, so both produce
+// identical snapshots as long as the buffer starts out zeroed.
+
+static void PackUniformElementsScalar(u8 *Dst, const u8 *Src, u32 Count, int Transpose, const uniform_pack_info *Info) {
+    u32 ScalarByteCount = Info->ScalarByteCount;
+    u32 SrcColumnByteCount = Info->RowCount*ScalarByteCount;
+    u32 SrcElementByteCount = Info->ColumnCount*SrcColumnByteCount;
+    for(u32 I = 0; I < Count; ++I) {
+        const u8 *SrcElement = Src + I*SrcElementByteCount;
+        u8 *DstElement = Dst + I*Info->ArrayStride;
+        for(u32 Column = 0; Column < Info->ColumnCount; ++Column) {
+            u8 *DstColumn = DstElement + Column*Info->MatrixStride;
+            if(Transpose == 0) {
+                memcpy(DstColumn, SrcElement + Column*SrcColumnByteCount, SrcColumnByteCount);
+                continue;
+            }
+            for(u32 Row = 0; Row < Info->RowCount; ++Row) {
+                memcpy(DstColumn + Row*ScalarByteCount, SrcElement + (Row*Info->ColumnCount + Column)*ScalarByteCount, ScalarByteCount);
+            }
+        }
+    }
+}
+
+#if UNIFORM_PACKING_SSE2
+// NOTE(blackedout): Loads `Count` <= 4 floats without reading past them, the remaining lanes are zero
+static __m128 LoadFloatsSse(const float *Src, u32 Count) {
+    switch(Count) {
+    case 1: return _mm_load_ss(Src);
+    case 2: return _mm_castpd_ps(_mm_load_sd((const double *)Src));
+    case 3: return _mm_movelh_ps(_mm_castpd_ps(_mm_load_sd((const double *)Src)), _mm_load_ss(Src + 2));
+    default: return _mm_loadu_ps(Src);
+    }
+}
+
+static void PackUniformElementsSse(u8 *Dst, const float *Src, u32 Count, int Transpose, const uniform_pack_info *Info, u32 ColumnSlot) {
+    u32 SrcElementCount = Info->ColumnCount*Info->RowCount;
+    u32 I = 0;
+#if UNIFORM_PACKING_AVX2
+    // NOTE(blackedout): Transposes two elements at once, one per 128 bit lane
+    if(Transpose) {
+        for(; I + 2 <= Count; I += 2) {
+            const float *SrcA = Src + I*SrcElementCount;
+            const float *SrcB = SrcA + SrcElementCount;
+            __m256 Rows[4];
+            for(u32 Row = 0; Row < 4; ++Row) {
+                __m128 RowA = _mm_setzero_ps(), RowB = _mm_setzero_ps();
+                if(Row < Info->RowCount) {
+                    RowA = LoadFloatsSse(SrcA + Row*Info->ColumnCount, Info->ColumnCount);
+                    RowB = LoadFloatsSse(SrcB + Row*Info->ColumnCount, Info->ColumnCount);
+                }
+                Rows[Row] = _mm256_insertf128_ps(_mm256_castps128_ps256(RowA), RowB, 1);
+            }
+            __m256 T0 = _mm256_unpacklo_ps(Rows[0], Rows[1]);
+            __m256 T1 = _mm256_unpacklo_ps(Rows[2], Rows[3]);
+            __m256 T2 = _mm256_unpackhi_ps(Rows[0], Rows[1]);
+            __m256 T3 = _mm256_unpackhi_ps(Rows[2], Rows[3]);
+            __m256 Columns[4] = {
+                _mm256_shuffle_ps(T0, T1, _MM_SHUFFLE(1, 0, 1, 0)),
+                _mm256_shuffle_ps(T0, T1, _MM_SHUFFLE(3, 2, 3, 2)),
+                _mm256_shuffle_ps(T2, T3, _MM_SHUFFLE(1, 0, 1, 0)),
+                _mm256_shuffle_ps(T2, T3, _MM_SHUFFLE(3, 2, 3, 2)),
+            };
+            u8 *DstA = Dst + I*Info->ArrayStride;
+            u8 *DstB = DstA + Info->ArrayStride;
+            for(u32 Column = 0; Column < Info->ColumnCount; ++Column) {
+                _mm_storeu_ps((float *)(DstA + Column*ColumnSlot), _mm256_castps256_ps128(Columns[Column]));
+                _mm_storeu_ps((float *)(DstB + Column*ColumnSlot), _mm256_extractf128_ps(Columns[Column], 1));
+            }
+        }
+    }
+#endif
+    for(; I < Count; ++I) {
+        const float *SrcElement = Src + I*SrcElementCount;
+        u8 *DstElement = Dst + I*Info->ArrayStride;
+        if(Transpose == 0) {
+            for(u32 Column = 0; Column < Info->ColumnCount; ++Column) {
+                _mm_storeu_ps((float *)(DstElement + Column*ColumnSlot), LoadFloatsSse(SrcElement + Column*Info->RowCount, Info->RowCount));
+            }
+            continue;
+        }
+        __m128 Rows[4];
+        for(u32 Row = 0; Row < 4; ++Row) {
+            Rows[Row] = Row < Info->RowCount ? LoadFloatsSse(SrcElement + Row*Info->ColumnCount, Info->ColumnCount) : _mm_setzero_ps();
+        }
+        _MM_TRANSPOSE4_PS(Rows[0], Rows[1], Rows[2], Rows[3]);
+        for(u32 Column = 0; Column < Info->ColumnCount; ++Column) {
+            _mm_storeu_ps((float *)(DstElement + Column*ColumnSlot), Rows[Column]);
+        }
+    }
+}
+#endif
+
+#if UNIFORM_PACKING_NEON
+static float32x4_t LoadFloatsNeon(const float *Src, u32 Count) {
+    switch(Count) {
+    case 1: return vsetq_lane_f32(Src[0], vdupq_n_f32(0.0f), 0);
+    case 2: return vcombine_f32(vld1_f32(Src), vdup_n_f32(0.0f));
+    case 3: return vcombine_f32(vld1_f32(Src), vset_lane_f32(Src[2], vdup_n_f32(0.0f), 0));
+    default: return vld1q_f32(Src);
+    }
+}
+
+static void PackUniformElementsNeon(u8 *Dst, const float *Src, u32 Count, int Transpose, const uniform_pack_info *Info, u32 ColumnSlot) {
+    u32 SrcElementCount = Info->ColumnCount*Info->RowCount;
+    for(u32 I = 0; I < Count; ++I) {
+        const float *SrcElement = Src + I*SrcElementCount;
+        u8 *DstElement = Dst + I*Info->ArrayStride;
+        if(Transpose == 0) {
+            for(u32 Column = 0; Column < Info->ColumnCount; ++Column) {
+                vst1q_f32((float *)(DstElement + Column*ColumnSlot), LoadFloatsNeon(SrcElement + Column*Info->RowCount, Info->RowCount));
+            }
+            continue;
+        }
+        float32x4_t Columns[4];
+        if(Info->ColumnCount == 4 && Info->RowCount == 4) {
+            // NOTE(blackedout): The de-interleaving load is a 4x4 transpose
+            float32x4x4_t Loaded = vld4q_f32(SrcElement);
+            Columns[0] = Loaded.val[0];
+            Columns[1] = Loaded.val[1];
+            Columns[2] = Loaded.val[2];
+            Columns[3] = Loaded.val[3];
+        } else {
+            float32x4_t Rows[4];
+            for(u32 Row = 0; Row < 4; ++Row) {
+                Rows[Row] = Row < Info->RowCount ? LoadFloatsNeon(SrcElement + Row*Info->ColumnCount, Info->ColumnCount) : vdupq_n_f32(0.0f);
+            }
+            float32x4x2_t T01 = vtrnq_f32(Rows[0], Rows[1]);
+            float32x4x2_t T23 = vtrnq_f32(Rows[2], Rows[3]);
+            Columns[0] = vcombine_f32(vget_low_f32(T01.val[0]), vget_low_f32(T23.val[0]));
+            Columns[1] = vcombine_f32(vget_low_f32(T01.val[1]), vget_low_f32(T23.val[1]));
+            Columns[2] = vcombine_f32(vget_high_f32(T01.val[0]), vget_high_f32(T23.val[0]));
+            Columns[3] = vcombine_f32(vget_high_f32(T01.val[1]), vget_high_f32(T23.val[1]));
+        }
+        for(u32 Column = 0; Column < Info->ColumnCount; ++Column) {
+            vst1q_f32((float *)(DstElement + Column*ColumnSlot), Columns[Column]);
+        }
+    }
+}
+#endif
+
+void PackUniformElements(u8 *Dst, const void *Src, u32 Count, int Transpose, const uniform_pack_info *Info) {
+    if(Count == 0) {
+        return;
+    }
+
+    u32 SrcColumnByteCount = Info->RowCount*Info->ScalarByteCount;
+    u32 SrcElementByteCount = Info->ColumnCount*SrcColumnByteCount;
+    int IsColumnTight = Info->ColumnCount == 1 || Info->MatrixStride == SrcColumnByteCount;
+    int IsArrayTight = Count == 1 || Info->ArrayStride == SrcElementByteCount;
+    if(Transpose == 0 && IsColumnTight && IsArrayTight) {
+        // NOTE(blackedout): E.g. mat4, mat2x4 and vec4 arrays or any single non-matrix value
+        memcpy(Dst, Src, Count*SrcElementByteCount);
+        return;
+    }
+
+    // NOTE(blackedout): The SIMD paths write whole 16 byte columns (including padding), so they are only used when every
+    // column owns at least 16 bytes. That is the case for all float/int matrix columns and array elements in std140.
+    u32 ColumnSlot = Info->ColumnCount > 1 ? Info->MatrixStride : Info->ArrayStride;
+    int CanUseSimd = Info->ScalarByteCount == 4 && Info->RowCount <= 4 && Info->ColumnCount <= 4 && ColumnSlot >= 16;
+    (void)CanUseSimd;
+#if UNIFORM_PACKING_SSE2
+    if(CanUseSimd) {
+        PackUniformElementsSse(Dst, (const float *)Src, Count, Transpose, Info, ColumnSlot);
+        return;
+    }
+#elif UNIFORM_PACKING_NEON
+    if(CanUseSimd) {
+        PackUniformElementsNeon(Dst, (const float *)Src, Count, Transpose, Info, ColumnSlot);
+        return;
+    }
+#endif
+    // TODO(blackedout): Doubles only take the scalar path
+    PackUniformElementsScalar(Dst, (const u8 *)Src, Count, Transpose, Info);
+}
@@ -54,4 +54,22 @@ void SetFlagsEnabledU32(u32 *InOut, u32 Mask, int DoEnable) {
 
 void SetFlagsU32(u32 *InOut, u32 Mask, u32 Bits) {
     *InOut = ((*InOut) & ~Mask) | Bits;
-}
\ No newline at end of file
+}
+// NOTE(blackedout): Not cryptographic, only meant for lookups where a match is confirmed by comparing the bytes
+u64 HashBytes(const void *Bytes, u64 ByteCount) {
+    const u8 *It = (const u8 *)Bytes;
+    u64 Hash = 0x9E3779B97F4A7C15ull ^ ByteCount;
+    for(; ByteCount >= sizeof(u64); ByteCount -= sizeof(u64), It += sizeof(u64)) {
+        u64 Word;
+        memcpy(&Word, It, sizeof(u64));
+        Hash = (Hash ^ Word)*0xFF51AFD7ED558CCDull;
+        Hash ^= Hash >> 32;
+    }
+    for(; ByteCount; --ByteCount, ++It) {
+        Hash = (Hash ^ *It)*0x100000001B3ull;
+    }
+    Hash ^= Hash >> 33;
+    Hash *= 0xC4CEB9FE1A85EC53ull;
+    Hash ^= Hash >> 33;
+    return Hash;
+}
@@ -24,7 +24,8 @@ int VulkanCreateInstance(context *C, const char **RequiredInstanceExtensions, ui
             .applicationVersion = VK_MAKE_VERSION(1, 0, 0),
             .pEngineName = "",
             .engineVersion = VK_MAKE_VERSION(1, 0, 0),
-            .apiVersion = VK_API_VERSION_1_0,
+            // NOTE(blackedout): 1.1 for vkGetPhysicalDeviceFeatures2, which optional device extensions are queried with
+            .apiVersion = VK_API_VERSION_1_1,
         };
 
         uint32_t InstanceLayerPropertyCount;
@@ -182,8 +183,15 @@ int VulkanCreateDevice(context *C, VkSurfaceKHR Surface) {
             VulkanCheckGoto(vkEnumerateDeviceExtensionProperties(PhysicalDevice, 0, &ExtensionPropertyCount, ExtensionProperties), label_Error);
             
             feature_flags FeatureFlags = 0;
+            int HasDedicatedTransferQueue = 0;
+            int HasComputeOnlyQueue = 0;
             for(uint32_t J = 0; J < QueueFamilyPropertyCount; ++J) {
                 int IsGraphics = (QueueFamilyProperties[J].queueFlags & VK_QUEUE_GRAPHICS_BIT) != 0;
+                // NOTE(blackedout): Families that only transfer are usually backed by the copy engines (DMA), which run
+                // alongside graphics work. Graphics and compute families implicitly support transfers too, so they don't count.
+                int IsDedicatedTransfer = (QueueFamilyProperties[J].queueFlags & (VK_QUEUE_GRAPHICS_BIT | VK_QUEUE_COMPUTE_BIT | VK_QUEUE_TRANSFER_BIT)) == VK_QUEUE_TRANSFER_BIT;
+                // NOTE(blackedout): Likewise, families that compute but don't draw are usually backed by the async compute engines
+                int IsComputeOnly = (QueueFamilyProperties[J].queueFlags & (VK_QUEUE_GRAPHICS_BIT | VK_QUEUE_COMPUTE_BIT)) == VK_QUEUE_COMPUTE_BIT;
                 
                 VkBool32 IsSurfaceSupported;
                 VulkanCheckGoto(vkGetPhysicalDeviceSurfaceSupportKHR(PhysicalDevice, J, Surface, &IsSurfaceSupported), label_Error);
@@ -197,9 +205,26 @@ int VulkanCreateDevice(context *C, VkSurfaceKHR Surface) {
                     PhysicalDeviceInfo.QueueFamilyIndices[queue_SURFACE] = J;
                     FeatureFlags |= feature_HAS_SURFACE_QUEUE;
                 }
+                if(IsDedicatedTransfer && HasDedicatedTransferQueue == 0) {
+                    PhysicalDeviceInfo.QueueFamilyIndices[queue_TRANSFER] = J;
+                    HasDedicatedTransferQueue = 1;
+                }
+                if(IsComputeOnly && HasComputeOnlyQueue == 0) {
+                    PhysicalDeviceInfo.QueueFamilyIndices[queue_COMPUTE] = J;
+                    HasComputeOnlyQueue = 1;
+                }
+            }
+            if(HasDedicatedTransferQueue == 0) {
+                PhysicalDeviceInfo.QueueFamilyIndices[queue_TRANSFER] = PhysicalDeviceInfo.QueueFamilyIndices[queue_GRAPHICS];
             }
             
             VmaAllocatorCreateFlags VmaCreateFlags = 0;
+            int HasVertexAttributeDivisorExtension = 0;
+            int HasShaderDrawParametersExtension = 0;
+            int HasMultiDrawExtension = 0;
+            int HasTimelineSemaphoreExtension = 0;
+            // NOTE(blackedout): VK_KHR_dynamic_rendering and the extensions it requires on top of 1.1
+            u32 DynamicRenderingExtensionCount = 0;
             for(uint32_t J = 0; J < ExtensionPropertyCount; ++J) {
                 const char *ExtensionName = ExtensionProperties[J].extensionName;
                 if(strcmp(ExtensionName, VK_KHR_SWAPCHAIN_EXTENSION_NAME) == 0) {
@@ -210,6 +235,32 @@ int VulkanCreateDevice(context *C, VkSurfaceKHR Surface) {
                     FeatureFlags |= feature_HAS_PORTABILITY_SUBSET_EXTENSION;
                 }
 
+                if(strcmp(ExtensionName, VK_EXT_VERTEX_ATTRIBUTE_DIVISOR_EXTENSION_NAME) == 0) {
+                    HasVertexAttributeDivisorExtension = 1;
+                }
+
+                if(strcmp(ExtensionName, VK_KHR_SHADER_DRAW_PARAMETERS_EXTENSION_NAME) == 0) {
+                    HasShaderDrawParametersExtension = 1;
+                }
+
+                if(strcmp(ExtensionName, VK_KHR_DRAW_INDIRECT_COUNT_EXTENSION_NAME) == 0) {
+                    PhysicalDeviceInfo.HasDrawIndirectCount = 1;
+                }
+
+                if(strcmp(ExtensionName, VK_EXT_MULTI_DRAW_EXTENSION_NAME) == 0) {
+                    HasMultiDrawExtension = 1;
+                }
+
+                if(strcmp(ExtensionName, VK_KHR_TIMELINE_SEMAPHORE_EXTENSION_NAME) == 0) {
+                    HasTimelineSemaphoreExtension = 1;
+                }
+
+                if(strcmp(ExtensionName, VK_KHR_DYNAMIC_RENDERING_EXTENSION_NAME) == 0 ||
+                   strcmp(ExtensionName, VK_KHR_DEPTH_STENCIL_RESOLVE_EXTENSION_NAME) == 0 ||
+                   strcmp(ExtensionName, VK_KHR_CREATE_RENDERPASS_2_EXTENSION_NAME) == 0) {
+                    ++DynamicRenderingExtensionCount;
+                }
+
 #if 0
                 // NOTE(blackedout): Check if extension is part of the vma extensions, so that vma can be told that it will be enabled
                 for(uint32_t K = 0; K < ArrayCount(VmaExtensionMap); ++K) {
@@ -220,6 +271,102 @@ int VulkanCreateDevice(context *C, VkSurfaceKHR Surface) {
 #endif
             }
 
+            // NOTE(blackedout): Without the extension, instance rate attributes can only advance every instance.
+            // Shader draw parameters (gl_DrawID, gl_BaseInstance) are a 1.1 feature or an extension before that.
+            PhysicalDeviceInfo.MaxVertexAttribDivisor = 1;
+            PhysicalDeviceInfo.HasTriangleFans = 1;
+            if(PhysicalDeviceInfo.Properties.apiVersion >= VK_API_VERSION_1_1) {
+                void *FeaturesNext = 0;
+                VkPhysicalDeviceVertexAttributeDivisorFeaturesEXT DivisorFeatures = {
+                    .sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_VERTEX_ATTRIBUTE_DIVISOR_FEATURES_EXT,
+                    .pNext = 0,
+                };
+                if(HasVertexAttributeDivisorExtension) {
+                    DivisorFeatures.pNext = FeaturesNext;
+                    FeaturesNext = &DivisorFeatures;
+                }
+                VkPhysicalDeviceMultiDrawFeaturesEXT MultiDrawFeatures = {
+                    .sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_MULTI_DRAW_FEATURES_EXT,
+                    .pNext = 0,
+                };
+                if(HasMultiDrawExtension) {
+                    MultiDrawFeatures.pNext = FeaturesNext;
+                    FeaturesNext = &MultiDrawFeatures;
+                }
+                VkPhysicalDeviceTimelineSemaphoreFeaturesKHR TimelineSemaphoreFeatures = {
+                    .sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_TIMELINE_SEMAPHORE_FEATURES_KHR,
+                    .pNext = 0,
+                };
+                if(HasTimelineSemaphoreExtension) {
+                    TimelineSemaphoreFeatures.pNext = FeaturesNext;
+                    FeaturesNext = &TimelineSemaphoreFeatures;
+                }
+                VkPhysicalDeviceDynamicRenderingFeaturesKHR DynamicRenderingFeatures = {
+                    .sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_DYNAMIC_RENDERING_FEATURES_KHR,
+                    .pNext = 0,
+                };
+                if(DynamicRenderingExtensionCount == 3) {
+                    DynamicRenderingFeatures.pNext = FeaturesNext;
+                    FeaturesNext = &DynamicRenderingFeatures;
+                }
+                VkPhysicalDevicePortabilitySubsetFeaturesKHR PortabilityFeatures = {
+                    .sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_PORTABILITY_SUBSET_FEATURES_KHR,
+                    .pNext = 0,
+                };
+                if(FeatureFlags & feature_HAS_PORTABILITY_SUBSET_EXTENSION) {
+                    PortabilityFeatures.pNext = FeaturesNext;
+                    FeaturesNext = &PortabilityFeatures;
+                }
+                VkPhysicalDeviceShaderDrawParametersFeatures DrawParametersFeatures = {
+                    .sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_SHADER_DRAW_PARAMETERS_FEATURES,
+                    .pNext = FeaturesNext,
+                };
+                VkPhysicalDeviceFeatures2 Features2 = {
+                    .sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_FEATURES_2,
+                    .pNext = &DrawParametersFeatures,
+                };
+                vkGetPhysicalDeviceFeatures2(PhysicalDevice, &Features2);
+                PhysicalDeviceInfo.HasShaderDrawParameters = DrawParametersFeatures.shaderDrawParameters == VK_TRUE;
+                if(FeatureFlags & feature_HAS_PORTABILITY_SUBSET_EXTENSION) {
+                    PhysicalDeviceInfo.HasTriangleFans = PortabilityFeatures.triangleFans == VK_TRUE;
+                }
+                // NOTE(blackedout): Async dispatches have to wait on uploads and be waited on by the graphics queue, with
+                // binary semaphores each of these waits would need a semaphore of its own
+                PhysicalDeviceInfo.HasAsyncCompute = C->IsAsyncComputeRequested && HasComputeOnlyQueue && TimelineSemaphoreFeatures.timelineSemaphore == VK_TRUE;
+                PhysicalDeviceInfo.HasDynamicRendering = DynamicRenderingFeatures.dynamicRendering == VK_TRUE;
+
+                if(HasVertexAttributeDivisorExtension && DivisorFeatures.vertexAttributeInstanceRateDivisor) {
+                    VkPhysicalDeviceVertexAttributeDivisorPropertiesEXT DivisorProperties = {
+                        .sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_VERTEX_ATTRIBUTE_DIVISOR_PROPERTIES_EXT,
+                        .pNext = 0,
+                    };
+                    VkPhysicalDeviceProperties2 Properties2 = {
+                        .sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_PROPERTIES_2,
+                        .pNext = &DivisorProperties,
+                    };
+                    vkGetPhysicalDeviceProperties2(PhysicalDevice, &Properties2);
+                    PhysicalDeviceInfo.MaxVertexAttribDivisor = DivisorProperties.maxVertexAttribDivisor;
+                }
+
+                if(HasMultiDrawExtension && MultiDrawFeatures.multiDraw) {
+                    VkPhysicalDeviceMultiDrawPropertiesEXT MultiDrawProperties = {
+                        .sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_MULTI_DRAW_PROPERTIES_EXT,
+                        .pNext = 0,
+                    };
+                    VkPhysicalDeviceProperties2 Properties2 = {
+                        .sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_PROPERTIES_2,
+                        .pNext = &MultiDrawProperties,
+                    };
+                    vkGetPhysicalDeviceProperties2(PhysicalDevice, &Properties2);
+                    PhysicalDeviceInfo.MaxMultiDrawCount = MultiDrawProperties.maxMultiDrawCount;
+                }
+            } else {
+                PhysicalDeviceInfo.HasShaderDrawParameters = HasShaderDrawParametersExtension;
+            }
+            if(PhysicalDeviceInfo.HasAsyncCompute == 0) {
+                PhysicalDeviceInfo.QueueFamilyIndices[queue_COMPUTE] = PhysicalDeviceInfo.QueueFamilyIndices[queue_GRAPHICS];
+            }
+
             uint32_t DeviceTypeScore;
             switch(PhysicalDeviceInfo.Properties.deviceType) {
             case VK_PHYSICAL_DEVICE_TYPE_DISCRETE_GPU:
@@ -334,7 +481,7 @@ int VulkanCreateDevice(context *C, VkSurfaceKHR Surface) {
         }
 
         float QueuePriorities[] = { 1.0f };
-        VkDeviceQueueCreateInfo QueueCreateInfos[2] = {
+        VkDeviceQueueCreateInfo QueueCreateInfos[queue_COUNT] = {
             {
                 .sType = VK_STRUCTURE_TYPE_DEVICE_QUEUE_CREATE_INFO,
                 .pNext = 0,
@@ -345,11 +492,33 @@ int VulkanCreateDevice(context *C, VkSurfaceKHR Surface) {
             },
         };
 
+        // NOTE(blackedout): One queue per distinct family
         uint32_t QueueCreateInfoCount = 1;
-        if(BestPhysicalDeviceInfo.QueueFamilyIndices[queue_GRAPHICS] != BestPhysicalDeviceInfo.QueueFamilyIndices[queue_SURFACE]) {
-            QueueCreateInfos[1] = QueueCreateInfos[0];
-            QueueCreateInfos[1].queueFamilyIndex = BestPhysicalDeviceInfo.QueueFamilyIndices[queue_SURFACE];
-            QueueCreateInfoCount = 2;
+        for(uint32_t I = queue_GRAPHICS + 1; I < queue_COUNT; ++I) {
+            uint32_t FamilyIndex = BestPhysicalDeviceInfo.QueueFamilyIndices[I];
+            int IsNewFamily = 1;
+            for(uint32_t J = 0; J < QueueCreateInfoCount; ++J) {
+                if(QueueCreateInfos[J].queueFamilyIndex == FamilyIndex) {
+                    IsNewFamily = 0;
+                    break;
+                }
+            }
+            if(IsNewFamily) {
+                QueueCreateInfos[QueueCreateInfoCount] = QueueCreateInfos[0];
+                QueueCreateInfos[QueueCreateInfoCount].queueFamilyIndex = FamilyIndex;
+                ++QueueCreateInfoCount;
+            }
+        }
+
+        // NOTE(blackedout): Every created family but the surface family may access buffers
+        BestPhysicalDeviceInfo.SharedQueueFamilyIndexCount = 0;
+        for(uint32_t I = 0; I < QueueCreateInfoCount; ++I) {
+            uint32_t FamilyIndex = QueueCreateInfos[I].queueFamilyIndex;
+            if(FamilyIndex == BestPhysicalDeviceInfo.QueueFamilyIndices[queue_GRAPHICS] ||
+               FamilyIndex == BestPhysicalDeviceInfo.QueueFamilyIndices[queue_TRANSFER] ||
+               FamilyIndex == BestPhysicalDeviceInfo.QueueFamilyIndices[queue_COMPUTE]) {
+                BestPhysicalDeviceInfo.SharedQueueFamilyIndices[BestPhysicalDeviceInfo.SharedQueueFamilyIndexCount++] = FamilyIndex;
+            }
         }
 
         const char *ExtensionNames[] = {
@@ -370,13 +539,78 @@ int VulkanCreateDevice(context *C, VkSurfaceKHR Surface) {
             }
         }
 #else
-        const char **FinalExtensionNames = ExtensionNames;
-        uint32_t FinalExtensionNameCount = ArrayCount(ExtensionNames);
+        // NOTE(blackedout): Space for the optional extensions after the required ones
+        const char *FinalExtensionNames[ArrayCount(ExtensionNames) + 8];
+        uint32_t FinalExtensionNameCount = 0;
+        for(uint32_t I = 0; I < ArrayCount(ExtensionNames); ++I) {
+            FinalExtensionNames[FinalExtensionNameCount++] = ExtensionNames[I];
+        }
 #endif
 
+        const void *DeviceCreateInfoNext = 0;
+        VkPhysicalDeviceVertexAttributeDivisorFeaturesEXT DivisorFeatures = {
+            .sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_VERTEX_ATTRIBUTE_DIVISOR_FEATURES_EXT,
+            .pNext = 0,
+            .vertexAttributeInstanceRateDivisor = VK_TRUE,
+            .vertexAttributeInstanceRateZeroDivisor = VK_FALSE,
+        };
+        if(BestPhysicalDeviceInfo.MaxVertexAttribDivisor > 1) {
+            FinalExtensionNames[FinalExtensionNameCount++] = VK_EXT_VERTEX_ATTRIBUTE_DIVISOR_EXTENSION_NAME;
+            DivisorFeatures.pNext = (void *)DeviceCreateInfoNext;
+            DeviceCreateInfoNext = &DivisorFeatures;
+        }
+        VkPhysicalDeviceShaderDrawParametersFeatures DrawParametersFeatures = {
+            .sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_SHADER_DRAW_PARAMETERS_FEATURES,
+            .pNext = 0,
+            .shaderDrawParameters = VK_TRUE,
+        };
+        if(BestPhysicalDeviceInfo.HasShaderDrawParameters) {
+            if(BestPhysicalDeviceInfo.Properties.apiVersion >= VK_API_VERSION_1_1) {
+                DrawParametersFeatures.pNext = (void *)DeviceCreateInfoNext;
+                DeviceCreateInfoNext = &DrawParametersFeatures;
+            } else {
+                FinalExtensionNames[FinalExtensionNameCount++] = VK_KHR_SHADER_DRAW_PARAMETERS_EXTENSION_NAME;
+            }
+        }
+        if(BestPhysicalDeviceInfo.HasDrawIndirectCount) {
+            FinalExtensionNames[FinalExtensionNameCount++] = VK_KHR_DRAW_INDIRECT_COUNT_EXTENSION_NAME;
+        }
+        VkPhysicalDeviceMultiDrawFeaturesEXT MultiDrawFeatures = {
+            .sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_MULTI_DRAW_FEATURES_EXT,
+            .pNext = 0,
+            .multiDraw = VK_TRUE,
+        };
+        if(BestPhysicalDeviceInfo.MaxMultiDrawCount) {
+            FinalExtensionNames[FinalExtensionNameCount++] = VK_EXT_MULTI_DRAW_EXTENSION_NAME;
+            MultiDrawFeatures.pNext = (void *)DeviceCreateInfoNext;
+            DeviceCreateInfoNext = &MultiDrawFeatures;
+        }
+        VkPhysicalDeviceTimelineSemaphoreFeaturesKHR TimelineSemaphoreFeatures = {
+            .sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_TIMELINE_SEMAPHORE_FEATURES_KHR,
+            .pNext = 0,
+            .timelineSemaphore = VK_TRUE,
+        };
+        if(BestPhysicalDeviceInfo.HasAsyncCompute) {
+            FinalExtensionNames[FinalExtensionNameCount++] = VK_KHR_TIMELINE_SEMAPHORE_EXTENSION_NAME;
+            TimelineSemaphoreFeatures.pNext = (void *)DeviceCreateInfoNext;
+            DeviceCreateInfoNext = &TimelineSemaphoreFeatures;
+        }
+        VkPhysicalDeviceDynamicRenderingFeaturesKHR DynamicRenderingFeatures = {
+            .sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_DYNAMIC_RENDERING_FEATURES_KHR,
+            .pNext = 0,
+            .dynamicRendering = VK_TRUE,
+        };
+        if(BestPhysicalDeviceInfo.HasDynamicRendering) {
+            FinalExtensionNames[FinalExtensionNameCount++] = VK_KHR_DYNAMIC_RENDERING_EXTENSION_NAME;
+            FinalExtensionNames[FinalExtensionNameCount++] = VK_KHR_DEPTH_STENCIL_RESOLVE_EXTENSION_NAME;
+            FinalExtensionNames[FinalExtensionNameCount++] = VK_KHR_CREATE_RENDERPASS_2_EXTENSION_NAME;
+            DynamicRenderingFeatures.pNext = (void *)DeviceCreateInfoNext;
+            DeviceCreateInfoNext = &DynamicRenderingFeatures;
+        }
+
         VkDeviceCreateInfo DeviceCreateInfo = {
             .sType = VK_STRUCTURE_TYPE_DEVICE_CREATE_INFO,
-            .pNext = 0,
+            .pNext = DeviceCreateInfoNext,
             .flags = 0,
             .queueCreateInfoCount = QueueCreateInfoCount,
             .pQueueCreateInfos = QueueCreateInfos,
@@ -390,6 +624,22 @@ int VulkanCreateDevice(context *C, VkSurfaceKHR Surface) {
         VulkanCheckGoto(vkCreateDevice(BestPhysicalDeviceInfo.PhysicalDevice, &DeviceCreateInfo, 0, &C->Device), label_Error);
         C->DeviceInfo = BestPhysicalDeviceInfo;
 
+        if(C->DeviceInfo.HasDrawIndirectCount) {
+            C->CmdDrawIndirectCount = (PFN_vkCmdDrawIndirectCountKHR)vkGetDeviceProcAddr(C->Device, "vkCmdDrawIndirectCountKHR");
+            C->CmdDrawIndexedIndirectCount = (PFN_vkCmdDrawIndexedIndirectCountKHR)vkGetDeviceProcAddr(C->Device, "vkCmdDrawIndexedIndirectCountKHR");
+        }
+        if(C->DeviceInfo.MaxMultiDrawCount) {
+            C->CmdDrawMulti = (PFN_vkCmdDrawMultiEXT)vkGetDeviceProcAddr(C->Device, "vkCmdDrawMultiEXT");
+            C->CmdDrawMultiIndexed = (PFN_vkCmdDrawMultiIndexedEXT)vkGetDeviceProcAddr(C->Device, "vkCmdDrawMultiIndexedEXT");
+        }
+        if(C->DeviceInfo.HasAsyncCompute) {
+            C->WaitSemaphores = (PFN_vkWaitSemaphoresKHR)vkGetDeviceProcAddr(C->Device, "vkWaitSemaphoresKHR");
+        }
+        if(C->DeviceInfo.HasDynamicRendering) {
+            C->CmdBeginRendering = (PFN_vkCmdBeginRenderingKHR)vkGetDeviceProcAddr(C->Device, "vkCmdBeginRenderingKHR");
+            C->CmdEndRendering = (PFN_vkCmdEndRenderingKHR)vkGetDeviceProcAddr(C->Device, "vkCmdEndRenderingKHR");
+        }
+
         VmaAllocatorCreateInfo AllocatorCreateInfo = {
             .flags = 0, // TODO
             .physicalDevice = C->DeviceInfo.PhysicalDevice,